@@ -42,6 +42,8 @@ import shutil
 import struct
 import tempfile
 
+from opensand_collector.probe_batch import ProbeBatchDecoder
+
 LOGGER = logging.getLogger('sand-collector')
 
 
@@ -160,6 +162,13 @@ class Probe(object):
         """
         self._enabled = value
 
+    @property
+    def storage_type(self):
+        """
+        Get the probe storage type
+        """
+        return self._storage_type
+
     @property
     def displayed(self):
         """
@@ -244,6 +253,7 @@ class Program(object):
         self._probes = {}
         self._logs = {}
         self._initialized = False
+        self._batch_decoder = ProbeBatchDecoder()
 
         self._reg_probes = []
         self._reg_logs = []
@@ -418,6 +428,13 @@ class Program(object):
         """
         return self._logs.values()
 
+    @property
+    def batch_decoder(self):
+        """
+        Get the decoder of the probe batches
+        """
+        return self._batch_decoder
+
     @property
     def initialized(self):
         """ check if a program is initialized """
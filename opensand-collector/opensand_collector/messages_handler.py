@@ -54,6 +54,7 @@ MSG_CMD_ACK = 5
 MSG_CMD_RELAY = 7
 
 MSG_CMD_SEND_PROBES = 10
+MSG_CMD_SEND_PROBES_BATCH = 13
 MSG_CMD_SEND_LOG = 20
 
 MSG_CMD_ENABLE_PROBE = 11
@@ -220,21 +221,21 @@ class MessagesHandler(object):
         Handles a registration command.
         """
         prog_id, num_probes, num_logs, name_length = \
-                                      struct.unpack("!BBBB", data[0:4])
-        prog_name = data[4:4 + name_length]
+                                      struct.unpack("!BHBB", data[0:5])
+        prog_name = data[5:5 + name_length]
 
         if len(prog_name) != name_length:
             return False
 
-        pos = 4 + name_length
+        pos = 5 + name_length
 
         probe_list = []
         for _ in xrange(num_probes):
             probe_id, storage_type, name_length, unit_length = \
-                                  struct.unpack("!BBBB", data[pos:pos + 4])
+                                  struct.unpack("!HBBB", data[pos:pos + 5])
             enabled = bool(storage_type >> 7)
             storage_type = storage_type & ~(1 << 7)
-            pos += 4
+            pos += 5
 
             name = data[pos:pos + name_length]
             if len(name) != name_length:
@@ -293,6 +294,9 @@ class MessagesHandler(object):
         if sub_cmd == MSG_CMD_SEND_PROBES:
             return self._handle_cmd_send_probes(host, prog, data[2:])
 
+        if sub_cmd == MSG_CMD_SEND_PROBES_BATCH:
+            return self._handle_cmd_send_probes_batch(host, prog, data[2:])
+
         if sub_cmd == MSG_CMD_SEND_LOG:
             return self._handle_cmd_send_log(host, prog, data[2:])
 
@@ -307,8 +311,8 @@ class MessagesHandler(object):
         displayed_values = []
 
         while pos < total_length:
-            probe_id = struct.unpack("!B", data[pos])[0]
-            pos += 1
+            probe_id = struct.unpack("!H", data[pos:pos + 2])[0]
+            pos += 2
 
             try:
                 probe = prog.get_probe(probe_id)
@@ -333,6 +337,31 @@ class MessagesHandler(object):
 
         return True
 
+    def _handle_cmd_send_probes_batch(self, host, prog, data):
+        """
+        Handles a SEND_PROBES_BATCH command from a daemon.
+        """
+        batch = prog.batch_decoder.decode(data, prog)
+        if batch is None:
+            return False
+        timestamp, values = batch
+
+        displayed_values = []
+        for probe_id, probe, value in values:
+            probe.save_value(timestamp, value)
+
+            if probe.displayed:
+                displayed_values.append((probe_id, probe, value))
+
+        if not prog.initialized:
+            LOGGER.info("Program %s is not initialized, do not transmit probe "
+                        "to the manager" % prog)
+            return True
+
+        self._notify_manager_probes(host, prog, timestamp, displayed_values)
+
+        return True
+
     def _handle_cmd_send_log(self, host, prog, data):
         """
         Handles a SEND_LOG command from a daemon
@@ -417,7 +446,7 @@ class MessagesHandler(object):
             return
         data = data[2:]
         if cmd == MSG_MGR_SET_PROBE_STATUS:
-            probe_id, status = struct.unpack("!BB", data)
+            probe_id, status = struct.unpack("!HB", data)
 
             new_enabled = (status > 0)
             new_displayed = (status == 2)
@@ -436,7 +465,7 @@ class MessagesHandler(object):
 
             if host:  # Need to propagate the new enabled state upstream
                 LOGGER.info("The enabled of the above probe has been relayed.")
-                self._sock.sendto(struct.pack("!LBBBB", MAGIC_NUMBER,
+                self._sock.sendto(struct.pack("!LBBBH", MAGIC_NUMBER,
                                               MSG_CMD_RELAY, program_id, cmd,
                                               probe_id), host.address)
 
@@ -523,12 +552,12 @@ class MessagesHandler(object):
             LOGGER.error("Program name %s is too long, truncating.", host_name)
             host_name = host_name[0:255]
 
-#        message = struct.pack("!LBBBBBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
+#        message = struct.pack("!LBBBHBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
 #                              host_ident, prog_ident, len(probes),
 #                              len(logs), len(host_name)) + host_name
         message = None
         content = ""
-        header_length = 10 + len(host_name)
+        header_length = 11 + len(host_name)
         probe_nbr = 0
         log_nbr = 0
         reg_p = []
@@ -537,10 +566,10 @@ class MessagesHandler(object):
         for probe_id, name, unit, storage_type, enabled, displayed in probes:
             storage_type |= enabled << 7
             storage_type |= displayed << 6
-            if len(content) + header_length + 4 + len(name) + len(unit) > \
-              MAX_DATA_LENGHT or probe_nbr >= 255:
+            if len(content) + header_length + 5 + len(name) + len(unit) > \
+              MAX_DATA_LENGHT or probe_nbr >= 0xffff:
                 # max size, send a first register message
-                message = struct.pack("!LBBBBBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
+                message = struct.pack("!LBBBHBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
                                       host_ident, prog_ident, probe_nbr,
                                       log_nbr, len(host_name)) + host_name
                 message += content
@@ -554,7 +583,7 @@ class MessagesHandler(object):
 
             probe_nbr += 1
             reg_p.append(probe_id)
-            content += struct.pack("!BBBB", probe_id, storage_type, len(name), len(unit))
+            content += struct.pack("!HBBB", probe_id, storage_type, len(name), len(unit))
             content += name
             content += unit
 
@@ -562,7 +591,7 @@ class MessagesHandler(object):
             if len(content) + header_length + 3 + len(ident) > MAX_DATA_LENGHT or \
                log_nbr >= 255:
                 # max size, send a first register message
-                message = struct.pack("!LBBBBBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
+                message = struct.pack("!LBBBHBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
                                       host_ident, prog_ident, probe_nbr,
                                       log_nbr, len(host_name)) + host_name
                 message += content
@@ -581,7 +610,7 @@ class MessagesHandler(object):
             content += ident
             
         if len(content) > 0:
-            message = struct.pack("!LBBBBBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
+            message = struct.pack("!LBBBHBB", MAGIC_NUMBER, MSG_MGR_REGISTER_PROGRAM,
                                   host_ident, prog_ident, probe_nbr,
                                   log_nbr, len(host_name)) + host_name
             message += content
@@ -612,7 +641,7 @@ class MessagesHandler(object):
                               host.ident, prog.ident, timestamp)
 
         for probe_id, probe, value in displayed_values:
-            message += struct.pack("!B", probe_id)
+            message += struct.pack("!H", probe_id)
             message += probe.encode_value(value)
 
         if self._manager_addr:
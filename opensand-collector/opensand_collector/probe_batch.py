@@ -0,0 +1,166 @@
+#!/usr/bin/env python2
+# -*- coding: utf-8 -*-
+
+#
+#
+# OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+# satellite telecommunication system for research and engineering activities.
+#
+#
+# Copyright © 2019 TAS
+#
+#
+# This file is part of the OpenSAND testbed.
+#
+#
+# OpenSAND is free software : you can redistribute it and/or modify it under the
+# terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program. If not, see http://www.gnu.org/licenses/.
+#
+#
+
+"""
+probe_batch.py - Decoder of the probe batches sent by the OpenSAND programs.
+"""
+
+import logging
+import struct
+
+try:
+    import lz4.block
+    HAS_LZ4 = True
+except ImportError:
+    HAS_LZ4 = False
+
+LOGGER = logging.getLogger('sand-collector')
+
+PROBE_BATCH_VERSION = 1
+PROBE_BATCH_KEY = 0x01
+PROBE_BATCH_LZ4 = 0x02
+
+
+def read_varint(data, pos):
+    """
+    Read a varint (LEB128) at the specified position.
+    Returns the value and the new position.
+    """
+    value = 0
+    shift = 0
+    while True:
+        byte = ord(data[pos])
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+class BatchStream(object):
+    """
+    The state of a stream of batches sent by a thread of a program
+    """
+
+    def __init__(self):
+        self.sequence = 0
+        self.synchronized = False
+        self.previous = {}
+
+
+class ProbeBatchDecoder(object):
+    """
+    Decoder of the batches of a program, see ProbeBatch in opensand-output
+    for the format.
+    """
+
+    def __init__(self):
+        self._streams = {}
+
+    def decode(self, data, program):
+        """
+        Decode a batch, without the magic number and command.
+        Returns the timestamp and a list of (probe ID, probe, value), or None
+        if the batch is invalid or depends on a lost batch.
+        """
+        if len(data) < 9:
+            LOGGER.error("Probe batch too short (%d bytes)", len(data))
+            return None
+        version, flags, stream_id, sequence, timestamp = \
+            struct.unpack("!BBBHL", data[0:9])
+        if version != PROBE_BATCH_VERSION:
+            LOGGER.error("Unsupported probe batch version %d", version)
+            return None
+
+        stream = self._streams.setdefault(stream_id, BatchStream())
+        if flags & PROBE_BATCH_KEY:
+            stream.previous = {}
+            stream.synchronized = True
+        elif sequence != stream.sequence:
+            stream.synchronized = False
+        stream.sequence = (sequence + 1) & 0xffff
+        if not stream.synchronized:
+            LOGGER.debug("Skip probe batch %d, waiting for a key batch",
+                         sequence)
+            return None
+
+        entries = data[9:]
+        if flags & PROBE_BATCH_LZ4:
+            if not HAS_LZ4:
+                LOGGER.error("Cannot decompress probe batch, lz4 module "
+                             "is missing")
+                stream.synchronized = False
+                return None
+            if len(entries) < 2:
+                LOGGER.error("Compressed probe batch too short")
+                stream.synchronized = False
+                return None
+            size = struct.unpack("!H", entries[0:2])[0]
+            try:
+                entries = lz4.block.decompress(entries[2:],
+                                               uncompressed_size=size)
+            except Exception, err:
+                # the error raised depends on the lz4 module version
+                LOGGER.error("Cannot decompress probe batch: %s", err)
+                stream.synchronized = False
+                return None
+
+        values = []
+        probe_id = 0
+        pos = 0
+        try:
+            while pos < len(entries):
+                gap, pos = read_varint(entries, pos)
+                encoded, pos = read_varint(entries, pos)
+                probe_id += gap
+                probe = program.get_probe(probe_id)
+                previous = stream.previous.get(probe_id, 0)
+                if probe.storage_type == 0:
+                    delta = (encoded >> 1) ^ -(encoded & 1)
+                    bits = (previous + delta) & 0xffffffff
+                    value = struct.unpack("!i", struct.pack("!L", bits))[0]
+                elif probe.storage_type == 1:
+                    bits = struct.unpack("<L", struct.pack(">L", encoded))[0]
+                    bits ^= previous
+                    value = struct.unpack("!f", struct.pack("!L", bits))[0]
+                elif probe.storage_type == 2:
+                    bits = struct.unpack("<Q", struct.pack(">Q", encoded))[0]
+                    bits ^= previous
+                    value = struct.unpack("!d", struct.pack("!Q", bits))[0]
+                else:
+                    raise ValueError("Unknown storage type")
+                stream.previous[probe_id] = bits
+                values.append((probe_id, probe, value))
+        except (IndexError, KeyError, ValueError, struct.error), err:
+            LOGGER.error("Invalid probe batch: %s", err)
+            stream.synchronized = False
+            return None
+
+        return timestamp, values
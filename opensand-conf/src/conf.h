@@ -326,6 +326,8 @@
 #define SATCARRIER_UDP_RMEM         "satcarrier_udp_rmem"
 #define SATCARRIER_UDP_WMEM         "satcarrier_udp_wmem"
 #define SATCARRIER_UDP_STACK        "satcarrier_udp_stack"
+#define ENCAP_WORKERS               "encap_workers"
+#define DAMA_WORKERS                "dama_workers"
 
 //////////////////////////
 //     interconnect     //
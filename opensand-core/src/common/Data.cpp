@@ -32,6 +32,7 @@
  */
 
 #include "Data.h"
+#include "PacketBuffer.h"
 
 Data::Data(): std::basic_string<unsigned char>()
 {
@@ -53,7 +54,14 @@ Data::Data(unsigned char *data, unsigned int len):
 {
 }
 
-Data::Data(Data data, unsigned int pos, unsigned int len):
+Data::Data(const Data &data, unsigned int pos, unsigned int len):
 	std::basic_string<unsigned char>(data, pos, len)
 {
 }
+
+Data::Data(const PacketBuffer &buffer):
+	std::basic_string<unsigned char>(buffer.data() ? buffer.data() :
+	                                 (const unsigned char *)"",
+	                                 buffer.length())
+{
+}
@@ -37,10 +37,14 @@
 
 #include <string>
 
+class PacketBuffer;
 
 /**
  * @class Data
  * @brief A set of data for network packets
+ *
+ * The network containers keep their data in a PacketBuffer, a Data is a
+ * copy of it for the code that needs a string.
  */
 class Data: public std::basic_string<unsigned char>
 {
@@ -80,7 +84,14 @@ class Data: public std::basic_string<unsigned char>
 	 * @param pos   the index of first byte to copy from
 	 * @param len   the number of bytes to copy
 	 */
-	Data(Data data, unsigned int pos, unsigned int len);
+	Data(const Data &data, unsigned int pos, unsigned int len);
+
+	/**
+	 * Create a set of data from a packet buffer
+	 *
+	 * @param buffer  the packet buffer to copy data from
+	 */
+	explicit Data(const PacketBuffer &buffer);
 };
 
 #endif
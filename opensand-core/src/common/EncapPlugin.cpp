@@ -148,9 +148,13 @@ bool EncapPlugin::EncapPacketHandler::getEncapsulatedPackets(NetContainer *packe
 	{
 		NetPacket *current;
 		size_t current_length;
+		// the rest of the payload, it shares the buffer of the frame
+		PacketBuffer payload = packet->getBuffer().slice(
+			packet->getHeaderLength() + previous_length,
+			packet->getPayloadLength());
 
 		// Get the current packet length
-		current_length = this->getLength(packet->getPayload(previous_length).c_str());
+		current_length = payload.empty() ? 0 : this->getLength(payload.data());
 		if(current_length <= 0)
 		{
 			LOG(this->log, LEVEL_ERROR,
@@ -159,8 +163,9 @@ bool EncapPlugin::EncapPacketHandler::getEncapsulatedPackets(NetContainer *packe
 			goto destroy_packets;
 		}
 
-		// Get the current packet
-		current = this->build(packet->getPayload(previous_length), current_length,
+		// Get the current packet, without copying the frame if the
+		// handler can keep it in the frame buffer
+		current = this->build(payload.slice(0, current_length),
 			0x00, BROADCAST_TAL_ID, BROADCAST_TAL_ID);
 		if(!current)
 		{
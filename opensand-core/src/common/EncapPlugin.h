@@ -244,6 +244,19 @@ class EncapPlugin: public StackPlugin
 		 */
 		virtual NetBurst *flushAll() = 0;
 
+		/**
+		 * @brief Get the flow of a packet, the packets of a flow share the
+		 *        context state, such as a fragment ID, so they are always
+		 *        encapsulated in order by the same context
+		 *
+		 * @param packet  The packet
+		 * @return the flow, a destination and a QoS by default
+		 */
+		virtual unsigned int getFlow(const NetPacket *packet) const
+		{
+			return (packet->getDstTalId() << 3) | (packet->getQos() & 0x07);
+		};
+
 		/**
 		 * @brief Set the filter on destination TAL Id.
 		 *
@@ -291,6 +304,17 @@ class EncapPlugin: public StackPlugin
 		return static_cast<EncapContext *>(this->context);
 	};
 
+	/**
+	 * @brief Create a new context, independent from the plugin one
+	 *
+	 * @return the initialized context that should be released by the
+	 *         caller, NULL on error
+	 */
+	EncapContext *createContext()
+	{
+		return static_cast<EncapContext *>(StackPlugin::createContext());
+	};
+
 	/**
 	 * @brief Get the packet handler
 	 *
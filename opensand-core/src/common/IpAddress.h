@@ -75,6 +75,13 @@ class IpAddress
 	 * @return version of the IP address
 	 */
 	virtual int version() const = 0;
+
+	/**
+	 * Access a byte of the IP address, in network order
+	 * @param i  the byte we need to access
+	 * @return the value of this byte
+	 */
+	virtual unsigned char at(unsigned int i) const = 0;
 };
 
 #endif
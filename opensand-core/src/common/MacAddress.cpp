@@ -41,6 +41,11 @@
 
 MacAddress::MacAddress()
 {
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		this->mac[i] = 0;
+		this->generic_bytes[i] = false;
+	}
 }
 
 MacAddress::~MacAddress()
@@ -60,6 +65,10 @@ MacAddress::MacAddress(uint8_t b0,
 	this->mac[3] = b3;
 	this->mac[4] = b4;
 	this->mac[5] = b5;
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		this->generic_bytes[i] = false;
+	}
 }
 
 MacAddress::MacAddress(std::string mac_address)
@@ -136,3 +145,20 @@ bool MacAddress::matches(const MacAddress *addr) const
 	}
 	return true;
 }
+
+bool MacAddress::isGeneric() const
+{
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		if(this->generic_bytes[i])
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MacAddress::isGeneric(unsigned int i) const
+{
+	return (i < 6 && this->generic_bytes[i]);
+}
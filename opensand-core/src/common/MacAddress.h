@@ -105,6 +105,23 @@ class MacAddress
 	 * @return true if MAC addresses matches, false otherwise
 	 */
 	bool matches(const MacAddress *addr) const;
+
+	/**
+	 * @brief Check whether some bytes of the MAC address match all
+	 *        occurences
+	 *
+	 * @return true if there is a generic byte, false otherwise
+	 */
+	bool isGeneric() const;
+
+	/**
+	 * @brief Check whether a byte of the MAC address matches all
+	 *        occurences
+	 *
+	 * @param i  The byte we need to check
+	 * @return true if the byte is generic, false otherwise
+	 */
+	bool isGeneric(unsigned int i) const;
 };
 
 #endif
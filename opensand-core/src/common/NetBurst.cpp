@@ -111,7 +111,8 @@ Data NetBurst::data()
 	// add the data of each network packet of the burst
 	for(it = this->begin(); it != this->end(); it++)
 	{
-		data.append((*it)->getData());
+		const PacketBuffer &buffer = (*it)->getBuffer();
+		data.append(buffer.data(), buffer.length());
 	}
 
 	return data;
@@ -34,20 +34,48 @@
  */
 
 #include "NetContainer.h"
+#include "ObjectPool.h"
+
+#include <algorithm>
+
+
+/// The maximum size of the containers allocated in pool
+#define NET_CONTAINER_POOL_SIZE (sizeof(NetContainer) + 64)
+
+
+/**
+ * @brief Get the containers pool, created on first use
+ *
+ * @return the containers pool
+ */
+static ObjectPool &getPool(void)
+{
+	static ObjectPool pool("DvbFrame", NET_CONTAINER_POOL_SIZE);
+	return pool;
+}
+
+void *NetContainer::operator new(size_t size)
+{
+	return getPool().allocate(size);
+}
+
+void NetContainer::operator delete(void *p)
+{
+	ObjectPool::release(p);
+}
 
 
 NetContainer::NetContainer(const unsigned char *data, size_t length):
-	data(),
+	data(data, length),
 	name("unknown"),
 	header_length(0),
 	trailer_length(0),
 	spot(255)
 {
-	this->data.append(data, length);
 }
 
 NetContainer::NetContainer(const Data &data, size_t length):
-	data(data, 0, length),
+	data(data.c_str(), std::min(length, (size_t)data.length())),
 	name("unknown"),
 	header_length(0),
 	trailer_length(0),
@@ -64,6 +92,15 @@ NetContainer::NetContainer(const Data &data):
 {
 }
 
+NetContainer::NetContainer(const PacketBuffer &buffer):
+	data(buffer),
+	name("unknown"),
+	header_length(0),
+	trailer_length(0),
+	spot(255)
+{
+}
+
 NetContainer::NetContainer():
 	data(),
 	name("unknown"),
@@ -84,26 +121,36 @@ string NetContainer::getName() const
 }
 
 Data NetContainer::getData() const
+{
+	return this->data.toData();
+}
+
+const PacketBuffer &NetContainer::getBuffer() const
 {
 	return this->data;
 }
 
+unsigned char *NetContainer::reserveRoom(size_t headroom, size_t tailroom)
+{
+	return this->data.reserveRoom(headroom, tailroom);
+}
+
 Data NetContainer::getData(size_t pos) const
 {
-	return this->data.substr(pos, this->getTotalLength() - pos);
+	return this->data.slice(pos, this->getTotalLength() - pos).toData();
 }
 
 
 Data NetContainer::getPayload() const
 {
-	return this->data.substr(this->header_length,
-	                         this->getPayloadLength());
+	return this->data.slice(this->header_length,
+	                        this->getPayloadLength()).toData();
 }
 
 Data NetContainer::getPayload(size_t pos) const
 {
-	return this->data.substr(this->header_length + pos,
-	                         this->getPayloadLength());
+	return this->data.slice(this->header_length + pos,
+	                        this->getPayloadLength()).toData();
 }
 
 
@@ -37,6 +37,7 @@
 #define NET_CONTAINER_H
 
 #include "Data.h"
+#include "PacketBuffer.h"
 
 #include "OpenSandCore.h"
 
@@ -58,7 +59,7 @@ class NetContainer
  protected:
 
 	/// Internal buffer for packet data
-	Data data;
+	PacketBuffer data;
 
 	/// The name of the network protocol
 	string name;
@@ -98,6 +99,13 @@ class NetContainer
 	 */
 	NetContainer(const Data &data, size_t length);
 
+	/**
+	 * Build a generic OpenSAND network container
+	 *
+	 * @param buffer  buffer from which a network-layer packet can be created,
+	 *                its storage is shared, not copied
+	 */
+	NetContainer(const PacketBuffer &buffer);
 
 	/**
 	 * Build an empty generic OpenSAND network container
@@ -109,6 +117,22 @@ class NetContainer
 	 */
 	virtual ~NetContainer();
 
+	/**
+	 * Allocate a container in the containers pool, used by the DVB frames
+	 * as packets have their own pool
+	 *
+	 * @param size  The container size
+	 * @return the container memory
+	 */
+	void *operator new(size_t size);
+
+	/**
+	 * Release a container in its pool
+	 *
+	 * @param p  The container memory
+	 */
+	void operator delete(void *p);
+
 	/**
 	 * Get the name of the network protocol
 	 *
@@ -126,10 +150,27 @@ class NetContainer
 	/**
 	 * Get data string
 	 *
-	 * @return the data string
+	 * @return a copy of the data, use getBuffer to avoid it
 	 */
 	Data getData() const;
 
+	/**
+	 * Get the buffer holding the data
+	 *
+	 * @return the buffer, its copies share the data with the container
+	 */
+	const PacketBuffer &getBuffer() const;
+
+	/**
+	 * Make sure there is room around the data for the headers and trailers
+	 * written in place by an encapsulation library
+	 *
+	 * @param headroom  the room needed before the data
+	 * @param tailroom  the room needed after the data
+	 * @return the start of the room before the data
+	 */
+	unsigned char *reserveRoom(size_t headroom, size_t tailroom);
+
 	/**
 	 * Retrieve data from the desired position
 	 *
@@ -33,6 +33,33 @@
  */
 
 #include "NetPacket.h"
+#include "ObjectPool.h"
+
+
+/// The maximum size of the packets allocated in pool
+#define NET_PACKET_POOL_SIZE (sizeof(NetPacket) + 64)
+
+
+/**
+ * @brief Get the packets pool, created on first use
+ *
+ * @return the packets pool
+ */
+static ObjectPool &getPool(void)
+{
+	static ObjectPool pool("NetPacket", NET_PACKET_POOL_SIZE);
+	return pool;
+}
+
+void *NetPacket::operator new(size_t size)
+{
+	return getPool().allocate(size);
+}
+
+void NetPacket::operator delete(void *p)
+{
+	ObjectPool::release(p);
+}
 
 
 NetPacket::NetPacket(const unsigned char *data, size_t length):
@@ -65,8 +92,18 @@ NetPacket::NetPacket(const Data &data, size_t length):
 	this->name = "NetPacket";
 }
 
+NetPacket::NetPacket(const PacketBuffer &buffer):
+	NetContainer(buffer),
+	type(NET_PROTO_ERROR),
+	qos(),
+	src_tal_id(),
+	dst_tal_id()
+{
+	this->name = "NetPacket";
+}
+
 NetPacket::NetPacket(NetPacket *pkt):
-	NetContainer(pkt->getData(), pkt->getTotalLength()),
+	NetContainer(pkt->getBuffer()),
 	type(pkt->getType()),
 	qos(pkt->getQos()),
 	src_tal_id(pkt->getSrcTalId()),
@@ -104,6 +141,41 @@ NetPacket::NetPacket(const Data &data,
 	this->header_length = header_length;
 }
 
+NetPacket::NetPacket(const unsigned char *data,
+                     size_t length,
+                     string name,
+                     uint16_t type,
+                     uint8_t qos,
+                     uint8_t src_tal_id,
+                     uint8_t dst_tal_id,
+                     size_t header_length):
+	NetContainer(data, length),
+	type(type),
+	qos(qos),
+	src_tal_id(src_tal_id),
+	dst_tal_id(dst_tal_id)
+{
+	this->name = name;
+	this->header_length = header_length;
+}
+
+NetPacket::NetPacket(const PacketBuffer &buffer,
+                     string name,
+                     uint16_t type,
+                     uint8_t qos,
+                     uint8_t src_tal_id,
+                     uint8_t dst_tal_id,
+                     size_t header_length):
+	NetContainer(buffer),
+	type(type),
+	qos(qos),
+	src_tal_id(src_tal_id),
+	dst_tal_id(dst_tal_id)
+{
+	this->name = name;
+	this->header_length = header_length;
+}
+
 
 NetPacket::~NetPacket()
 {
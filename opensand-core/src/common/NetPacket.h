@@ -130,14 +130,21 @@ class NetPacket: public NetContainer
 	uint8_t dst_tal_id;
 
  public:
-#if 0
 
-// call new in Rt
-	void *operator new(size_t size) throw();
-	void *operator new[](size_t size) throw();
-	void operator delete(void *p) throw();
-	void operator delete[](void *p) throw();
-#endif
+	/**
+	 * Allocate a packet in the packets pool
+	 *
+	 * @param size  The packet size
+	 * @return the packet memory
+	 */
+	void *operator new(size_t size);
+
+	/**
+	 * Release a packet in the packets pool
+	 *
+	 * @param p  The packet memory
+	 */
+	void operator delete(void *p);
 
 	/**
 	 * Build a network-layer packet
@@ -160,7 +167,14 @@ class NetPacket: public NetContainer
 	NetPacket(const Data &data, size_t length);
 
 	/**
-	 * Build a network-layer packet
+	 * Build a network-layer packet sharing the content of a buffer
+	 *
+	 * @param buffer  buffer from which a network-layer packet can be created
+	 */
+	NetPacket(const PacketBuffer &buffer);
+
+	/**
+	 * Build a network-layer packet sharing the content of another one
 	 * @param pkt
 	 */
 	NetPacket(NetPacket *pkt);
@@ -191,6 +205,47 @@ class NetPacket: public NetContainer
 	          uint8_t dst_tal_id,
 	          size_t header_length);
 
+	/**
+	 * Build a network-layer packet initialized from raw data
+	 *
+	 * @param data              raw data from which a network-layer packet can be created
+	 * @param length            length of raw data
+	 * @param name              the name of the network protocol
+	 * @param type              the type of the network protocol
+	 * @param qos               the QoS value to associate with the packet
+	 * @param src_tal_id        the source terminal ID to associate with the packet
+	 * @param dst_tal_id        the destination terminal ID to associate with the packet
+	 * @param header_length     the header length of the packet
+	 */
+	NetPacket(const unsigned char *data,
+	          size_t length,
+	          string name,
+	          uint16_t type,
+	          uint8_t qos,
+	          uint8_t src_tal_id,
+	          uint8_t dst_tal_id,
+	          size_t header_length);
+
+	/**
+	 * Build a network-layer packet sharing the content of a buffer
+	 *
+	 * @param buffer            buffer from which a network-layer packet can be
+	 *                          created, its storage is shared, not copied
+	 * @param name              the name of the network protocol
+	 * @param type              the type of the network protocol
+	 * @param qos               the QoS value to associate with the packet
+	 * @param src_tal_id        the source terminal ID to associate with the packet
+	 * @param dst_tal_id        the destination terminal ID to associate with the packet
+	 * @param header_length     the header length of the packet
+	 */
+	NetPacket(const PacketBuffer &buffer,
+	          string name,
+	          uint16_t type,
+	          uint8_t qos,
+	          uint8_t src_tal_id,
+	          uint8_t dst_tal_id,
+	          size_t header_length);
+
 	/**
 	 * Destroy the network-layer packet
 	 */
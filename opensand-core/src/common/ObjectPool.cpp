@@ -0,0 +1,313 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file ObjectPool.cpp
+ * @brief A pool of objects of the same type shared between threads
+ */
+
+#include "ObjectPool.h"
+
+#include <cstdlib>
+#include <new>
+
+
+/// The next free object in a list
+#define NEXT_OBJECT(slot) (((void **)(slot))[0])
+/// The next batch of free objects in the pool
+#define NEXT_BATCH(slot) (((void **)(slot))[1])
+/// The number of objects in a batch of free objects
+#define BATCH_COUNT(slot) (((size_t *)(slot))[2])
+/// The pool of an allocated object
+#define OBJECT_POOL(slot) (((ObjectPool **)(slot))[0])
+
+
+__thread ObjectPool::pool_cache_t ObjectPool::caches[POOL_MAX_NUMBER];
+
+__thread bool ObjectPool::caches_tracked = false;
+
+pthread_key_t ObjectPool::caches_key;
+
+pthread_once_t ObjectPool::caches_key_once = PTHREAD_ONCE_INIT;
+
+ObjectPool *ObjectPool::pools[POOL_MAX_NUMBER];
+
+pthread_mutex_t ObjectPool::probes_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int32_t ObjectPool::pools_number = 0;
+
+
+ObjectPool::ObjectPool(const char *name, size_t object_size):
+	name(name),
+	id(-1),
+	object_size(object_size),
+	slot_size(0),
+	batches(NULL),
+	available(0),
+	allocated(0),
+	probe_allocated(NULL),
+	probe_available(NULL)
+{
+	int32_t id = __atomic_fetch_add(&ObjectPool::pools_number, 1,
+	                                __ATOMIC_RELAXED);
+	// keep the objects aligned as with malloc
+	this->slot_size = POOL_HEADER_SIZE +
+	                  (object_size + POOL_HEADER_SIZE - 1) /
+	                  POOL_HEADER_SIZE * POOL_HEADER_SIZE;
+	// the pool lives until the end of the process, so the objects released
+	// by the other static destructors can still be handled: never destroyed
+	pthread_mutex_init(&this->mutex, NULL);
+	if(id < POOL_MAX_NUMBER)
+	{
+		this->id = id;
+		__atomic_store_n(&ObjectPool::pools[id], this, __ATOMIC_RELEASE);
+		this->registerPoolProbes();
+	}
+}
+
+void *ObjectPool::allocate(size_t size)
+{
+	pool_cache_t *cache;
+	unsigned char *slot;
+
+	if(size > this->object_size || this->id < 0)
+	{
+		slot = (unsigned char *)malloc(POOL_HEADER_SIZE + size);
+		if(!slot)
+		{
+			throw std::bad_alloc();
+		}
+		OBJECT_POOL(slot) = NULL;
+		return slot + POOL_HEADER_SIZE;
+	}
+
+	cache = &ObjectPool::caches[this->id];
+	if(!cache->head)
+	{
+		this->refill(cache);
+	}
+	slot = (unsigned char *)cache->head;
+	cache->head = NEXT_OBJECT(slot);
+	cache->count--;
+
+	OBJECT_POOL(slot) = this;
+	return slot + POOL_HEADER_SIZE;
+}
+
+void ObjectPool::release(void *object)
+{
+	unsigned char *slot;
+	ObjectPool *pool;
+	pool_cache_t *cache;
+
+	if(!object)
+	{
+		return;
+	}
+	slot = (unsigned char *)object - POOL_HEADER_SIZE;
+	pool = OBJECT_POOL(slot);
+	if(!pool)
+	{
+		free(slot);
+		return;
+	}
+
+	// a thread may only release objects, its cache is also given back
+	if(!ObjectPool::caches_tracked)
+	{
+		ObjectPool::trackCaches();
+	}
+	cache = &ObjectPool::caches[pool->id];
+	NEXT_OBJECT(slot) = cache->head;
+	cache->head = slot;
+	cache->count++;
+	// keep a batch for the next allocations, give the other one back
+	if(cache->count >= 2 * POOL_BATCH_SIZE)
+	{
+		pool->flush(cache, POOL_BATCH_SIZE);
+	}
+}
+
+void ObjectPool::registerProbes(void)
+{
+	int32_t number = __atomic_load_n(&ObjectPool::pools_number,
+	                                 __ATOMIC_RELAXED);
+
+	for(int32_t id = 0; id < number && id < POOL_MAX_NUMBER; id++)
+	{
+		ObjectPool *pool = __atomic_load_n(&ObjectPool::pools[id],
+		                                   __ATOMIC_ACQUIRE);
+		if(pool)
+		{
+			pool->registerPoolProbes();
+		}
+	}
+}
+
+void ObjectPool::refill(pool_cache_t *cache)
+{
+	unsigned char *slab;
+	uint32_t allocated;
+	uint32_t available;
+
+	if(!ObjectPool::caches_tracked)
+	{
+		ObjectPool::trackCaches();
+	}
+
+	pthread_mutex_lock(&this->mutex);
+	if(this->batches)
+	{
+		cache->head = this->batches;
+		cache->count = BATCH_COUNT(this->batches);
+		this->batches = NEXT_BATCH(this->batches);
+		this->available -= cache->count;
+		allocated = this->allocated;
+		available = this->available;
+		pthread_mutex_unlock(&this->mutex);
+		this->updateProbes(allocated, available);
+		return;
+	}
+	this->allocated += POOL_BATCH_SIZE;
+	allocated = this->allocated;
+	available = this->available;
+	pthread_mutex_unlock(&this->mutex);
+	this->updateProbes(allocated, available);
+
+	// no free object in pool, allocate a new batch at once
+	slab = (unsigned char *)malloc(this->slot_size * POOL_BATCH_SIZE);
+	if(!slab)
+	{
+		throw std::bad_alloc();
+	}
+	for(unsigned int i = 0; i < POOL_BATCH_SIZE - 1; i++)
+	{
+		NEXT_OBJECT(slab + i * this->slot_size) =
+			slab + (i + 1) * this->slot_size;
+	}
+	NEXT_OBJECT(slab + (POOL_BATCH_SIZE - 1) * this->slot_size) = NULL;
+	cache->head = slab;
+	cache->count = POOL_BATCH_SIZE;
+}
+
+void ObjectPool::flush(pool_cache_t *cache, size_t count)
+{
+	void *batch = cache->head;
+	void *last = batch;
+	uint32_t allocated;
+	uint32_t available;
+
+	for(unsigned int i = 1; i < count; i++)
+	{
+		last = NEXT_OBJECT(last);
+	}
+	cache->head = NEXT_OBJECT(last);
+	cache->count -= count;
+	NEXT_OBJECT(last) = NULL;
+	BATCH_COUNT(batch) = count;
+
+	pthread_mutex_lock(&this->mutex);
+	NEXT_BATCH(batch) = this->batches;
+	this->batches = batch;
+	this->available += count;
+	allocated = this->allocated;
+	available = this->available;
+	pthread_mutex_unlock(&this->mutex);
+	this->updateProbes(allocated, available);
+}
+
+void ObjectPool::registerPoolProbes(void)
+{
+	Probe<int> *probe_allocated;
+	Probe<int> *probe_available;
+
+	// probes cannot be registered before output initialization
+	if(!Output::isInit())
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&ObjectPool::probes_mutex);
+	if(!this->probe_allocated)
+	{
+		probe_allocated =
+			Output::registerProbe<int>(false, SAMPLE_LAST,
+			                           "Pools.%s.allocated", this->name);
+		probe_available =
+			Output::registerProbe<int>(false, SAMPLE_LAST,
+			                           "Pools.%s.available", this->name);
+		// the threads use the probes once the allocated one is set
+		this->probe_available = probe_available;
+		__atomic_store_n(&this->probe_allocated, probe_allocated,
+		                 __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&ObjectPool::probes_mutex);
+}
+
+void ObjectPool::updateProbes(uint32_t allocated, uint32_t available)
+{
+	Probe<int> *probe_allocated = __atomic_load_n(&this->probe_allocated,
+	                                              __ATOMIC_ACQUIRE);
+
+	if(!probe_allocated)
+	{
+		return;
+	}
+	probe_allocated->put(allocated);
+	this->probe_available->put(available);
+}
+
+void ObjectPool::trackCaches(void)
+{
+	// the destructor is only called for a key with a value
+	pthread_once(&ObjectPool::caches_key_once, ObjectPool::createCachesKey);
+	pthread_setspecific(ObjectPool::caches_key, ObjectPool::caches);
+	ObjectPool::caches_tracked = true;
+}
+
+void ObjectPool::createCachesKey(void)
+{
+	pthread_key_create(&ObjectPool::caches_key, ObjectPool::releaseCaches);
+}
+
+void ObjectPool::releaseCaches(void *thread_caches)
+{
+	pool_cache_t *caches = (pool_cache_t *)thread_caches;
+
+	for(int32_t id = 0; id < POOL_MAX_NUMBER; id++)
+	{
+		ObjectPool *pool = __atomic_load_n(&ObjectPool::pools[id],
+		                                   __ATOMIC_ACQUIRE);
+		if(pool && caches[id].count > 0)
+		{
+			pool->flush(&caches[id], caches[id].count);
+		}
+	}
+	// objects released later by the thread are cached again
+	ObjectPool::caches_tracked = false;
+}
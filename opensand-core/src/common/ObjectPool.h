@@ -0,0 +1,210 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file ObjectPool.h
+ * @brief A pool of objects of the same type shared between threads
+ */
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <opensand_output/Output.h>
+
+#include <cstddef>
+#include <pthread.h>
+#include <stdint.h>
+
+
+/// The number of objects moved at once between a thread and the pool
+#define POOL_BATCH_SIZE 64
+
+/// The maximum number of pools, the other ones use malloc
+#define POOL_MAX_NUMBER 16
+
+/// The room kept before each object to find its pool on release
+#define POOL_HEADER_SIZE 16
+
+
+/**
+ * @class ObjectPool
+ * @brief A pool of objects of the same type shared between threads
+ *
+ * Each thread allocates and releases objects in its own cache without lock.
+ * The objects released by a thread are given back to the pool by batches,
+ * so they can be reused by the thread allocating them, which is usually
+ * not the same one in a pipeline of blocks.
+ * The memory is never given back to the system, so the pools should be
+ * static members of the classes using them, declared in their
+ * operator new and operator delete. The objects cached by a thread are
+ * given back to the pool when it exits.
+ */
+class ObjectPool
+{
+ public:
+
+	/**
+	 * @brief Create a pool
+	 *
+	 * @param name         The pool name, used for probes
+	 * @param object_size  The maximum size of the objects, bigger objects
+	 *                     are allocated with malloc
+	 */
+	ObjectPool(const char *name, size_t object_size);
+
+	/**
+	 * @brief Allocate an object, for operator new
+	 *
+	 * @param size  The object size
+	 * @return the object memory
+	 */
+	void *allocate(size_t size);
+
+	/**
+	 * @brief Release an object allocated by any pool, for operator delete
+	 *
+	 * @param object  The object memory
+	 */
+	static void release(void *object);
+
+	/**
+	 * @brief Register the probes of the pools created before the output
+	 *        initialization, to be called before Output::finishInit
+	 *        The pools created later register their probes on creation.
+	 */
+	static void registerProbes(void);
+
+ private:
+
+	/// The free objects of a pool cached by a thread
+	typedef struct
+	{
+		void *head;     ///< The first free object
+		size_t count;   ///< The number of free objects
+	} pool_cache_t;
+
+	/**
+	 * @brief Get a batch of free objects in the thread cache
+	 *
+	 * @param cache  The thread cache
+	 */
+	void refill(pool_cache_t *cache);
+
+	/**
+	 * @brief Give a batch of free objects from the thread cache back
+	 *        to the pool
+	 *
+	 * @param cache  The thread cache
+	 * @param count  The number of objects in the batch
+	 */
+	void flush(pool_cache_t *cache, size_t count);
+
+	/**
+	 * @brief Register the pool probes if the output is initialized
+	 */
+	void registerPoolProbes(void);
+
+	/**
+	 * @brief Update the pool probes, called without the lock
+	 *
+	 * @param allocated  The number of objects allocated from the system
+	 * @param available  The number of free objects in the shared batches
+	 */
+	void updateProbes(uint32_t allocated, uint32_t available);
+
+	/**
+	 * @brief Make sure the caches of the current thread are given back
+	 *        to the pools when it exits
+	 */
+	static void trackCaches(void);
+
+	/**
+	 * @brief Create the key releasing the thread caches
+	 */
+	static void createCachesKey(void);
+
+	/**
+	 * @brief Give the caches of an exiting thread back to the pools
+	 *
+	 * @param thread_caches  The caches of the thread
+	 */
+	static void releaseCaches(void *thread_caches);
+
+	/// The thread caches of all the pools
+	static __thread pool_cache_t caches[POOL_MAX_NUMBER];
+
+	/// Whether the caches of the thread are released when it exits
+	static __thread bool caches_tracked;
+
+	/// The key releasing the thread caches when they exit
+	static pthread_key_t caches_key;
+
+	/// The initialization of the key releasing the thread caches
+	static pthread_once_t caches_key_once;
+
+	/// The pools with thread caches, by index
+	static ObjectPool *pools[POOL_MAX_NUMBER];
+
+	/// The lock on the probes registration
+	static pthread_mutex_t probes_mutex;
+
+	/// The number of pools created
+	static int32_t pools_number;
+
+	/// The pool name
+	const char *name;
+
+	/// The pool index in the thread caches, -1 if there is no cache
+	int32_t id;
+
+	/// The maximum size of the objects
+	size_t object_size;
+
+	/// The size of the memory for an object, including the header
+	size_t slot_size;
+
+	/// The lock on the shared batches
+	pthread_mutex_t mutex;
+
+	/// The batches of free objects released by threads
+	void *batches;
+
+	/// The number of free objects in the shared batches
+	uint32_t available;
+
+	/// The number of objects allocated from the system
+	uint32_t allocated;
+
+	/// The number of objects in pool
+	Probe<int> *probe_allocated;
+
+	/// The number of free objects in the shared batches
+	Probe<int> *probe_available;
+};
+
+#endif
@@ -0,0 +1,344 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file PacketBuffer.cpp
+ * @brief A reference-counted buffer for network packets
+ */
+
+#include "PacketBuffer.h"
+#include "ObjectPool.h"
+
+#include <cstring>
+#include <stdexcept>
+
+
+/// The capacity of the storages in pool, enough for most packets
+#define PACKET_BUFFER_POOL_SIZE 2048
+
+/// The capacity of the storages for the received datagrams in pool
+#define PACKET_BUFFER_DATAGRAM_POOL_SIZE 9216
+
+
+/**
+ * @brief Get the storages pool, created on first use
+ *
+ * @return the storages pool
+ */
+static ObjectPool &getPool(void)
+{
+	static ObjectPool pool("PacketBuffer", PACKET_BUFFER_POOL_SIZE);
+	return pool;
+}
+
+/**
+ * @brief Get the pool of storages for the received datagrams,
+ *        created on first use
+ *
+ * @return the datagram storages pool
+ */
+static ObjectPool &getDatagramPool(void)
+{
+	static ObjectPool pool("Datagram", PACKET_BUFFER_DATAGRAM_POOL_SIZE);
+	return pool;
+}
+
+
+PacketBuffer::PacketBuffer():
+	store(NULL),
+	offset(0),
+	len(0)
+{
+}
+
+PacketBuffer::PacketBuffer(size_t length, size_t headroom):
+	store(NULL),
+	offset(0),
+	len(0)
+{
+	this->makeRoom(headroom, length + PACKET_BUFFER_TAILROOM);
+	this->len = length;
+}
+
+PacketBuffer::PacketBuffer(const unsigned char *data, size_t length,
+                           size_t headroom):
+	store(NULL),
+	offset(0),
+	len(0)
+{
+	this->makeRoom(headroom, length + PACKET_BUFFER_TAILROOM);
+	memcpy(this->bytes() + this->offset, data, length);
+	this->len = length;
+}
+
+PacketBuffer::PacketBuffer(const Data &data, size_t headroom):
+	store(NULL),
+	offset(0),
+	len(0)
+{
+	this->makeRoom(headroom, data.length() + PACKET_BUFFER_TAILROOM);
+	memcpy(this->bytes() + this->offset, data.c_str(), data.length());
+	this->len = data.length();
+}
+
+PacketBuffer::PacketBuffer(const PacketBuffer &other):
+	store(other.store),
+	offset(other.offset),
+	len(other.len)
+{
+	if(this->store)
+	{
+		__atomic_add_fetch(&this->store->refcount, 1, __ATOMIC_RELAXED);
+	}
+}
+
+PacketBuffer::~PacketBuffer()
+{
+	this->release();
+}
+
+PacketBuffer PacketBuffer::adopt(unsigned char *bytes, size_t offset,
+                                 size_t length)
+{
+	PacketBuffer buffer;
+
+	// the storage reference set by allocateStorage goes to the buffer
+	buffer.store = (storage_t *)bytes - 1;
+	buffer.offset = offset;
+	buffer.len = length;
+	return buffer;
+}
+
+unsigned char *PacketBuffer::allocateStorage(size_t capacity)
+{
+	storage_t *store;
+
+	store = (storage_t *)getDatagramPool().allocate(sizeof(storage_t) +
+	                                                capacity);
+	store->refcount = 1;
+	store->capacity = capacity;
+	return (unsigned char *)(store + 1);
+}
+
+void PacketBuffer::releaseStorage(unsigned char *bytes)
+{
+	if(!bytes)
+	{
+		return;
+	}
+	ObjectPool::release((storage_t *)bytes - 1);
+}
+
+PacketBuffer &PacketBuffer::operator=(const PacketBuffer &other)
+{
+	if(other.store)
+	{
+		__atomic_add_fetch(&other.store->refcount, 1, __ATOMIC_RELAXED);
+	}
+	this->release();
+	this->store = other.store;
+	this->offset = other.offset;
+	this->len = other.len;
+	return *this;
+}
+
+const unsigned char *PacketBuffer::data() const
+{
+	if(!this->store)
+	{
+		return NULL;
+	}
+	return this->bytes() + this->offset;
+}
+
+unsigned char *PacketBuffer::writableData()
+{
+	if(!this->store)
+	{
+		return NULL;
+	}
+	this->makeRoom(0, 0);
+	return this->bytes() + this->offset;
+}
+
+bool PacketBuffer::isShared() const
+{
+	return (this->store &&
+	        __atomic_load_n(&this->store->refcount, __ATOMIC_ACQUIRE) > 1);
+}
+
+unsigned char PacketBuffer::at(size_t pos) const
+{
+	if(pos >= this->len)
+	{
+		throw std::out_of_range("PacketBuffer::at");
+	}
+	return this->bytes()[this->offset + pos];
+}
+
+void PacketBuffer::reserve(size_t capacity)
+{
+	this->makeRoom(0, capacity > this->len ? capacity - this->len : 0);
+}
+
+unsigned char *PacketBuffer::reserveRoom(size_t headroom, size_t tailroom)
+{
+	this->makeRoom(headroom, tailroom);
+	return this->bytes() + this->offset - headroom;
+}
+
+unsigned char *PacketBuffer::prepend(size_t length)
+{
+	this->makeRoom(length, 0);
+	this->offset -= length;
+	this->len += length;
+	return this->bytes() + this->offset;
+}
+
+unsigned char *PacketBuffer::put(size_t length)
+{
+	unsigned char *room;
+
+	this->makeRoom(0, length);
+	room = this->bytes() + this->offset + this->len;
+	this->len += length;
+	return room;
+}
+
+void PacketBuffer::append(const unsigned char *data, size_t length)
+{
+	if(!length)
+	{
+		return;
+	}
+	memcpy(this->put(length), data, length);
+}
+
+void PacketBuffer::append(const PacketBuffer &other)
+{
+	const unsigned char *source;
+	unsigned char *room;
+	size_t length = other.len;
+
+	if(!length)
+	{
+		return;
+	}
+	room = this->put(length);
+	// other may be this buffer, its content may have moved
+	source = (&other == this) ? room - length : other.bytes() + other.offset;
+	memcpy(room, source, length);
+}
+
+bool PacketBuffer::strip(size_t length)
+{
+	if(length > this->len)
+	{
+		return false;
+	}
+	this->offset += length;
+	this->len -= length;
+	return true;
+}
+
+bool PacketBuffer::trim(size_t length)
+{
+	if(length > this->len)
+	{
+		return false;
+	}
+	this->len -= length;
+	return true;
+}
+
+PacketBuffer PacketBuffer::slice(size_t pos, size_t length) const
+{
+	PacketBuffer part(*this);
+
+	if(pos > this->len)
+	{
+		pos = this->len;
+	}
+	if(length > this->len - pos)
+	{
+		length = this->len - pos;
+	}
+	part.offset += pos;
+	part.len = length;
+	return part;
+}
+
+Data PacketBuffer::toData() const
+{
+	return Data(*this);
+}
+
+void PacketBuffer::makeRoom(size_t headroom, size_t tailroom)
+{
+	storage_t *copy;
+	size_t new_offset;
+	size_t capacity;
+
+	if(this->store && !this->isShared() &&
+	   this->offset >= headroom &&
+	   this->store->capacity - this->offset - this->len >= tailroom)
+	{
+		// the storage is ours and big enough
+		return;
+	}
+
+	// keep the default room around the data to avoid reallocating
+	// for each header
+	if(headroom < PACKET_BUFFER_HEADROOM && this->store)
+	{
+		headroom = PACKET_BUFFER_HEADROOM;
+	}
+	new_offset = headroom;
+	capacity = headroom + this->len + tailroom;
+	copy = (storage_t *)getPool().allocate(sizeof(storage_t) + capacity);
+	copy->refcount = 1;
+	copy->capacity = capacity;
+	if(this->len)
+	{
+		memcpy((unsigned char *)(copy + 1) + new_offset,
+		       this->bytes() + this->offset, this->len);
+	}
+	this->release();
+	this->store = copy;
+	this->offset = new_offset;
+}
+
+void PacketBuffer::release()
+{
+	if(this->store &&
+	   __atomic_sub_fetch(&this->store->refcount, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		ObjectPool::release(this->store);
+	}
+	this->store = NULL;
+}
@@ -0,0 +1,315 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file PacketBuffer.h
+ * @brief A reference-counted buffer for network packets
+ */
+
+#ifndef PACKET_BUFFER_H
+#define PACKET_BUFFER_H
+
+#include "Data.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+
+/// The room kept before the data for the headers added by encapsulation
+#define PACKET_BUFFER_HEADROOM 64
+
+/// The room kept after the data for the trailers added by encapsulation
+#define PACKET_BUFFER_TAILROOM 16
+
+
+/**
+ * @class PacketBuffer
+ * @brief A reference-counted buffer for network packets
+ *
+ * Copies and slices of a buffer share the same storage, so a packet can be
+ * given to several layers without copying its content. Headers are removed
+ * by moving the start of the buffer and added in the room kept before it,
+ * without moving the data. Some room is also kept after the data for the
+ * trailers.
+ * The storage is copied only when a shared buffer is modified.
+ * The storages are taken from pools shared between the threads, a buffer
+ * can also adopt a storage in which a datagram was received.
+ */
+class PacketBuffer
+{
+ public:
+
+	/**
+	 * Create an empty buffer
+	 */
+	PacketBuffer();
+
+	/**
+	 * Create a buffer of the given length, the content is not initialized
+	 *
+	 * @param length    the length of the buffer
+	 * @param headroom  the room to keep before the data
+	 */
+	explicit PacketBuffer(size_t length,
+	                      size_t headroom = PACKET_BUFFER_HEADROOM);
+
+	/**
+	 * Create a buffer from unsigned characters
+	 *
+	 * @param data      the unsigned characters to copy
+	 * @param length    the number of unsigned characters to copy
+	 * @param headroom  the room to keep before the data
+	 */
+	PacketBuffer(const unsigned char *data, size_t length,
+	             size_t headroom = PACKET_BUFFER_HEADROOM);
+
+	/**
+	 * Create a buffer from a set of data
+	 *
+	 * @param data      the set of data to copy
+	 * @param headroom  the room to keep before the data
+	 */
+	explicit PacketBuffer(const Data &data,
+	                      size_t headroom = PACKET_BUFFER_HEADROOM);
+
+	/**
+	 * Create a buffer sharing the storage of another one
+	 *
+	 * @param other  the buffer to share
+	 */
+	PacketBuffer(const PacketBuffer &other);
+
+	~PacketBuffer();
+
+	/**
+	 * Create a buffer owning a storage got with allocateStorage,
+	 * without copying its content
+	 *
+	 * @param bytes   the storage bytes, the buffer takes ownership of them
+	 * @param offset  the position of the data in storage
+	 * @param length  the length of the data
+	 * @return the buffer
+	 */
+	static PacketBuffer adopt(unsigned char *bytes, size_t offset,
+	                          size_t length);
+
+	/**
+	 * Allocate a storage that a buffer can adopt, for instance to receive
+	 * datagrams directly in it
+	 *
+	 * @param capacity  the number of bytes
+	 * @return the storage bytes
+	 */
+	static unsigned char *allocateStorage(size_t capacity);
+
+	/**
+	 * Release a storage got with allocateStorage that was not adopted
+	 *
+	 * @param bytes  the storage bytes
+	 */
+	static void releaseStorage(unsigned char *bytes);
+
+	/**
+	 * Share the storage of another buffer
+	 *
+	 * @param other  the buffer to share
+	 * @return this buffer
+	 */
+	PacketBuffer &operator=(const PacketBuffer &other);
+
+	/**
+	 * Get the buffer content
+	 *
+	 * @return the buffer content, NULL if the buffer is empty
+	 */
+	const unsigned char *data() const;
+
+	/**
+	 * Get the buffer content in order to modify it
+	 *        The storage is copied if it is shared
+	 *
+	 * @return the buffer content, NULL if the buffer is empty
+	 */
+	unsigned char *writableData();
+
+	/**
+	 * Get the buffer length
+	 *
+	 * @return the buffer length
+	 */
+	size_t length() const {return this->len;};
+
+	/**
+	 * Check if the buffer is empty
+	 *
+	 * @return true if the buffer is empty, false otherwise
+	 */
+	bool empty() const {return this->len == 0;};
+
+	/**
+	 * Check if the storage is shared with another buffer
+	 *
+	 * @return true if the storage is shared, false otherwise
+	 */
+	bool isShared() const;
+
+	/**
+	 * Get a byte of the buffer
+	 *
+	 * @param pos  the position of the byte
+	 * @return the byte
+	 * @throw std::out_of_range if the position is after the buffer end,
+	 *        as Data does
+	 */
+	unsigned char at(size_t pos) const;
+
+	/**
+	 * Make sure the buffer can grow up to the given length without
+	 * reallocating, the storage is copied if it is shared
+	 *
+	 * @param capacity  the length the buffer will grow up to
+	 */
+	void reserve(size_t capacity);
+
+	/**
+	 * Make sure there is room around the data for the headers and trailers
+	 * written in place by an encapsulation library
+	 *        The storage is copied if it is shared or too small
+	 *
+	 * @param headroom  the room needed before the data
+	 * @param tailroom  the room needed after the data
+	 * @return the start of the room before the data
+	 */
+	unsigned char *reserveRoom(size_t headroom, size_t tailroom);
+
+	/**
+	 * Add room before the data, for a header
+	 *        The room kept before the data is used if possible
+	 *
+	 * @param length  the length of the header
+	 * @return the start of the room added, where to write the header
+	 */
+	unsigned char *prepend(size_t length);
+
+	/**
+	 * Add room after the data
+	 *
+	 * @param length  the length to add
+	 * @return the start of the room added, where to write
+	 */
+	unsigned char *put(size_t length);
+
+	/**
+	 * Copy data after the buffer content
+	 *
+	 * @param data    the data to copy
+	 * @param length  the length of the data
+	 */
+	void append(const unsigned char *data, size_t length);
+
+	/**
+	 * Copy the content of another buffer after the buffer content
+	 *
+	 * @param other  the buffer to copy
+	 */
+	void append(const PacketBuffer &other);
+
+	/**
+	 * Remove data at the beginning of the buffer, for a header
+	 *
+	 * @param length  the length to remove
+	 * @return true on success, false if the buffer is too short
+	 */
+	bool strip(size_t length);
+
+	/**
+	 * Remove data at the end of the buffer, for a trailer
+	 *
+	 * @param length  the length to remove
+	 * @return true on success, false if the buffer is too short
+	 */
+	bool trim(size_t length);
+
+	/**
+	 * Get a part of the buffer, sharing its storage
+	 *
+	 * @param pos     the position of the first byte
+	 * @param length  the length of the part, it is truncated
+	 *                at the end of the buffer
+	 * @return the part of the buffer
+	 */
+	PacketBuffer slice(size_t pos, size_t length) const;
+
+	/**
+	 * Get a copy of the buffer content as a set of data
+	 *
+	 * @return the set of data
+	 */
+	Data toData() const;
+
+ private:
+
+	/// The storage shared by buffers, the bytes are allocated after it
+	typedef struct
+	{
+		uint32_t refcount;    ///< The number of buffers using the storage
+		size_t capacity;      ///< The number of bytes
+	} storage_t;
+
+	/**
+	 * @brief Get the start of the storage bytes
+	 *
+	 * @return the storage bytes
+	 */
+	unsigned char *bytes() const {return (unsigned char *)(this->store + 1);};
+
+	/**
+	 * @brief Get a storage that is only used by this buffer and that has
+	 *        at least the given room around the data
+	 *
+	 * @param headroom  the room needed before the data
+	 * @param tailroom  the room needed after the data
+	 */
+	void makeRoom(size_t headroom, size_t tailroom);
+
+	/**
+	 * @brief Stop using the storage, release it if it is not shared
+	 */
+	void release();
+
+	/// The storage, NULL if none was allocated
+	storage_t *store;
+
+	/// The position of the data in storage
+	size_t offset;
+
+	/// The length of the data
+	size_t len;
+};
+
+#endif
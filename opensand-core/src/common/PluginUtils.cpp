@@ -312,6 +312,8 @@ void PluginUtils::releasePlugins()
 		delete (*iter);
 	}
 
+	// the deferred logs refer to the formats in the plugins code
+	Output::flush();
 	for(vector<void *>::iterator iter = this->handlers.begin();
 	    iter != this->handlers.end(); ++iter)
 	{
@@ -37,14 +37,119 @@
 
 #include <algorithm>
 #include <vector>
+#include <cstring>
+#include <climits>
+
+
+/**
+ * @brief Get a bit of an address
+ *
+ * @param addr  the address bytes
+ * @param pos   the bit position, from the most significant one
+ * @return the bit value
+ */
+static inline unsigned int getBit(const unsigned char *addr, unsigned int pos)
+{
+	return (addr[pos / 8] >> (7 - pos % 8)) & 1;
+}
+
+/**
+ * @brief Check whether the first bits of two addresses are the same
+ *
+ * @param addr1  the first address bytes
+ * @param addr2  the second address bytes
+ * @param len    the number of bits to compare
+ * @return true if the bits are the same, false otherwise
+ */
+static inline bool matchBits(const unsigned char *addr1,
+                             const unsigned char *addr2,
+                             unsigned int len)
+{
+	unsigned char bitmask;
+
+	if(memcmp(addr1, addr2, len / 8) != 0)
+	{
+		return false;
+	}
+	if(len % 8 == 0)
+	{
+		return true;
+	}
+	bitmask = 0xff << (8 - len % 8);
+	return ((addr1[len / 8] ^ addr2[len / 8]) & bitmask) == 0;
+}
+
+/**
+ * @brief Get the key of a MAC address without generic bytes
+ *
+ * @param mac  the MAC address
+ * @return the key
+ */
+static inline uint64_t getMacKey(const MacAddress *mac)
+{
+	uint64_t key = 0;
+
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		key = (key << 8) | mac->at(i);
+	}
+	return key;
+}
+
+/**
+ * @brief Get the bytes of an IP address
+ *
+ * @param ip    the IP address
+ * @param addr  OUT: the address bytes, 16 bytes long
+ * @return the address length (in bits), 0 for an unknown version
+ */
+static unsigned int getIpBytes(const IpAddress *ip, unsigned char *addr)
+{
+	unsigned int len;
+
+	switch(ip->version())
+	{
+		case 4:
+			len = 4;
+			break;
+		case 6:
+			len = 16;
+			break;
+		default:
+			return 0;
+	}
+	memset(addr, 0, 16);
+	for(unsigned int i = 0; i < len; i++)
+	{
+		addr[i] = ip->at(i);
+	}
+	return len * 8;
+}
+
 
 // max_entries = SARP_MAX by default
 SarpTable::SarpTable(unsigned int max_entries):
 	ip_sarp(),
-	eth_sarp()
+	eth_sarp(),
+	ipv4_trie(),
+	ipv6_trie(),
+	eth_index(),
+	eth_generic(),
+	tal_index()
 {
+	sarpIpNode root;
+
 	this->max_entries = (max_entries == 0 ? SARP_MAX : max_entries);
 
+	// the roots match all the addresses
+	memset(root.prefix, 0, sizeof(root.prefix));
+	root.prefix_len = 0;
+	root.children[0] = -1;
+	root.children[1] = -1;
+	root.tal_id = -1;
+	this->ipv4_trie.push_back(root);
+	this->ipv6_trie.push_back(root);
+
 	// Output Log
 	this->log_sarp = Output::registerLog(LEVEL_WARNING,
 	                                     "LanAdaptation.SarpTable");
@@ -73,6 +178,8 @@ bool SarpTable::add(IpAddress *ip_addr, unsigned int mask_len,
 {
 	bool success = true;
 	sarpIpEntry *entry;
+	unsigned char prefix[16];
+	unsigned int addr_len;
 
 	LOG(this->log_sarp, LEVEL_INFO,
 	    "add new entry in SARP table (%s/%u)\n",
@@ -104,6 +211,15 @@ bool SarpTable::add(IpAddress *ip_addr, unsigned int mask_len,
 	// append entry to table
 	this->ip_sarp.push_back(entry);
 
+	// index the prefix, a mask longer than the address matches nothing
+	addr_len = getIpBytes(ip_addr, prefix);
+	if(mask_len <= addr_len)
+	{
+		SarpTable::addPrefix(addr_len == 32 ? this->ipv4_trie :
+		                                      this->ipv6_trie,
+		                     prefix, mask_len, tal);
+	}
+
 quit:
 	return success;
 }
@@ -113,6 +229,7 @@ bool SarpTable::add(MacAddress *mac_address,
 {
 	bool success = true;
 	sarpEthEntry *entry;
+	unsigned int rank;
 
 	LOG(this->log_sarp, LEVEL_INFO,
 	    "add new entry in SARP table (%s)\n",
@@ -144,76 +261,110 @@ bool SarpTable::add(MacAddress *mac_address,
 	entry->tal_id = tal;
 
 	// append entry to table
+	rank = this->eth_sarp.size();
 	this->eth_sarp.push_back(entry);
 
+	// index the entry, the first entries are used if they overlap
+	if(mac_address->isGeneric())
+	{
+		sarpEthGeneric generic;
+
+		generic.entry = entry;
+		generic.rank = rank;
+		this->eth_generic.push_back(generic);
+	}
+	else
+	{
+		sarpEthIndex index;
+
+		index.tal_id = tal;
+		index.rank = rank;
+		this->eth_index.insert(std::make_pair(getMacKey(mac_address),
+		                                      index));
+	}
+	this->tal_index.insert(std::make_pair(tal, entry));
+
 quit:
 	return success;
 }
 
 bool SarpTable::getTalByIp(IpAddress *ip, tal_id_t &tal_id) const
 {
-	sarpIpEntry *entry;
-	unsigned int max_mask_len;
+	unsigned char addr[16];
+	unsigned int addr_len;
 
-	max_mask_len = 0;
 	tal_id = this->default_dest; // if no set (-1) this will lead to an error
 
 	// search IP matching with longer mask
-	list <sarpIpEntry *>::const_iterator it;
-
-	for(it = this->ip_sarp.begin(); it != this->ip_sarp.end(); it++)
+	addr_len = getIpBytes(ip, addr);
+	if(addr_len == 0)
 	{
-		entry = *it;
-		if(entry->ip->matchAddressWithMask(ip, entry->mask_len))
-		{
-			if(entry->mask_len >= max_mask_len)
-			{
-				max_mask_len = entry->mask_len;
-				tal_id = entry->tal_id;
-				return true;
-			}
-		}
+		return false;
 	}
+	return SarpTable::matchPrefix(addr_len == 32 ? this->ipv4_trie :
+	                                               this->ipv6_trie,
+	                              addr, tal_id);
+}
 
-	return false;
+bool SarpTable::getTalByIp(uint8_t version, const unsigned char *addr,
+                           tal_id_t &tal_id) const
+{
+	tal_id = this->default_dest; // if no set (-1) this will lead to an error
+
+	switch(version)
+	{
+		case 4:
+			return SarpTable::matchPrefix(this->ipv4_trie, addr, tal_id);
+		case 6:
+			return SarpTable::matchPrefix(this->ipv6_trie, addr, tal_id);
+		default:
+			return false;
+	}
 }
 
 bool SarpTable::getTalByMac(MacAddress mac_address, tal_id_t &tal_id) const
 {
-	sarpEthEntry *entry;
+	unordered_map<uint64_t, sarpEthIndex>::const_iterator it;
+	vector<sarpEthGeneric>::const_iterator generic;
+	unsigned int rank = UINT_MAX;
+	bool found = false;
 
 	tal_id = this->default_dest; // if no set (-1) this will lead to an error
 
-	list <sarpEthEntry *>::const_iterator it;
-	for(it = this->eth_sarp.begin(); it != this->eth_sarp.end(); it++)
+	it = this->eth_index.find(getMacKey(&mac_address));
+	if(it != this->eth_index.end())
+	{
+		tal_id = (*it).second.tal_id;
+		rank = (*it).second.rank;
+		found = true;
+	}
+
+	// a generic entry before in table has priority
+	for(generic = this->eth_generic.begin();
+	    generic != this->eth_generic.end() && (*generic).rank < rank;
+	    ++generic)
 	{
-		entry = *it;
-		if(entry->mac->matches(&mac_address))
+		if((*generic).entry->mac->matches(&mac_address))
 		{
-			tal_id = entry->tal_id;
+			tal_id = (*generic).entry->tal_id;
 			return true;
 		}
 	}
 
-	return false;
+	return found;
 }
 
 bool SarpTable::getMacByTal(tal_id_t tal_id, vector<MacAddress> &mac_address) const
 {
-	sarpEthEntry *entry;
+	unordered_map<tal_id_t, sarpEthEntry *>::const_iterator it;
 
-	list <sarpEthEntry *>::const_iterator it;
-	for(it = this->eth_sarp.begin(); it != this->eth_sarp.end(); it++)
+	it = this->tal_index.find(tal_id);
+	if(it == this->tal_index.end())
 	{
-		entry = *it;
-		if(entry->tal_id == tal_id)
-		{
-			mac_address.push_back(MacAddress(entry->mac->str()));
-			return true;
-		}
+		return false;
 	}
-
-	return false;
+	mac_address.push_back(MacAddress((*it).second->mac->str()));
+	return true;
 }
 
 void SarpTable::setDefaultTal(tal_id_t dflt)
@@ -221,4 +372,106 @@ void SarpTable::setDefaultTal(tal_id_t dflt)
 	this->default_dest = dflt;
 }
 
+void SarpTable::addPrefix(vector<sarpIpNode> &trie,
+                          const unsigned char *prefix,
+                          unsigned int prefix_len,
+                          tal_id_t tal)
+{
+	sarpIpNode node;
+	unsigned int current = 0;
+
+	// the prefix node, without the bits after the prefix
+	memset(node.prefix, 0, sizeof(node.prefix));
+	memcpy(node.prefix, prefix, (prefix_len + 7) / 8);
+	if(prefix_len % 8 != 0)
+	{
+		node.prefix[prefix_len / 8] &= 0xff << (8 - prefix_len % 8);
+	}
+	node.prefix_len = prefix_len;
+	node.children[0] = -1;
+	node.children[1] = -1;
+	node.tal_id = tal;
+
+	// the current node prefix is always a part of the new prefix
+	while(trie[current].prefix_len < prefix_len)
+	{
+		unsigned int bit = getBit(node.prefix, trie[current].prefix_len);
+		int child = trie[current].children[bit];
+		unsigned int common;
+		sarpIpNode split;
+
+		if(child < 0)
+		{
+			trie.push_back(node);
+			trie[current].children[bit] = trie.size() - 1;
+			return;
+		}
+
+		// get the length of the prefix common with the child
+		common = trie[current].prefix_len + 1;
+		while(common < trie[child].prefix_len && common < prefix_len &&
+		      getBit(trie[child].prefix, common) == getBit(node.prefix, common))
+		{
+			common++;
+		}
+		if(common == trie[child].prefix_len)
+		{
+			current = child;
+			continue;
+		}
+
+		// split the child on the common part
+		memset(split.prefix, 0, sizeof(split.prefix));
+		memcpy(split.prefix, node.prefix, (common + 7) / 8);
+		if(common % 8 != 0)
+		{
+			split.prefix[common / 8] &= 0xff << (8 - common % 8);
+		}
+		split.prefix_len = common;
+		split.children[getBit(trie[child].prefix, common)] = child;
+		split.children[1 - getBit(trie[child].prefix, common)] = -1;
+		split.tal_id = -1;
+		trie.push_back(split);
+		trie[current].children[bit] = trie.size() - 1;
+		current = trie.size() - 1;
+	}
+
+	// keep the first entry if the prefix is already in table
+	if(trie[current].tal_id < 0)
+	{
+		trie[current].tal_id = tal;
+	}
+}
+
+bool SarpTable::matchPrefix(const vector<sarpIpNode> &trie,
+                            const unsigned char *addr,
+                            tal_id_t &tal_id)
+{
+	const sarpIpNode *node = &trie[0];
+	bool found = false;
+
+	while(true)
+	{
+		int child;
 
+		if(node->tal_id >= 0)
+		{
+			tal_id = node->tal_id;
+			found = true;
+		}
+		// a full address has no child
+		if(node->children[0] < 0 && node->children[1] < 0)
+		{
+			break;
+		}
+		child = node->children[getBit(addr, node->prefix_len)];
+		if(child < 0 ||
+		   !matchBits(trie[child].prefix, addr, trie[child].prefix_len))
+		{
+			break;
+		}
+		node = &trie[child];
+	}
+
+	return found;
+}
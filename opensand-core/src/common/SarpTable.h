@@ -42,9 +42,11 @@
 
 #include <list>
 #include <vector>
+#include <tr1/unordered_map>
 
 using std::list;
 using std::vector;
+using std::tr1::unordered_map;
 
 /// SARP table entry for IP
 typedef struct
@@ -71,6 +73,29 @@ class SarpTable
 {
  private:
 
+	/// A node of the IP prefixes trie, that contains a prefix
+	typedef struct
+	{
+		unsigned char prefix[16];  ///< The prefix bytes, next bits are 0
+		unsigned int prefix_len;   ///< The prefix length (in bits)
+		int children[2];           ///< The nodes for next bit 0 and 1, or -1
+		int tal_id;                ///< The tal ID for this prefix, or -1
+	} sarpIpNode;
+
+	/// A MAC address entry in the SARP table index
+	typedef struct
+	{
+		tal_id_t tal_id;     ///< The tal ID
+		unsigned int rank;   ///< The rank of the entry in table
+	} sarpEthIndex;
+
+	/// A MAC address entry with generic bytes
+	typedef struct
+	{
+		sarpEthEntry *entry; ///< The entry
+		unsigned int rank;   ///< The rank of the entry in table
+	} sarpEthGeneric;
+
 	unsigned int max_entries;    ///< maximum number of entries in SARP table
 	// TODO we have only one of these two list that is used each time so we
 	//      need only one of these
@@ -78,6 +103,44 @@ class SarpTable
 	list<sarpEthEntry *> eth_sarp; ///< The Ethernet entries in SARP table
 	tal_id_t default_dest;  ///< the default terminal ID if no entry is found
 
+	/// The IPv4 prefixes trie, the first node is the root
+	vector<sarpIpNode> ipv4_trie;
+	/// The IPv6 prefixes trie, the first node is the root
+	vector<sarpIpNode> ipv6_trie;
+
+	/// The MAC addresses without generic bytes indexed by value
+	unordered_map<uint64_t, sarpEthIndex> eth_index;
+	/// The MAC addresses with generic bytes, checked in table order
+	vector<sarpEthGeneric> eth_generic;
+	/// The first MAC address of each terminal
+	unordered_map<tal_id_t, sarpEthEntry *> tal_index;
+
+	/**
+	 * Add a prefix in an IP prefixes trie
+	 *
+	 * @param trie        the trie
+	 * @param prefix      the prefix bytes
+	 * @param prefix_len  the prefix length (in bits)
+	 * @param tal         the tal ID associated with the prefix
+	 */
+	static void addPrefix(vector<sarpIpNode> &trie,
+	                      const unsigned char *prefix,
+	                      unsigned int prefix_len,
+	                      tal_id_t tal);
+
+	/**
+	 * Get the tal ID of the longest prefix matching an address in
+	 * an IP prefixes trie
+	 *
+	 * @param trie    the trie
+	 * @param addr    the address bytes
+	 * @param tal_id  the tal ID associated with the longest prefix
+	 * @return true if a prefix matches, false otherwise
+	 */
+	static bool matchPrefix(const vector<sarpIpNode> &trie,
+	                        const unsigned char *addr,
+	                        tal_id_t &tal_id);
+
  protected:
 	// Output Log
 	OutputLog *log_sarp;	
@@ -120,7 +183,8 @@ class SarpTable
 	bool add(MacAddress *mac_address, tal_id_t tal);
 
 	/**
-	 * Get the tal ID associated with the IP address in the SARP table
+	 * Get the tal ID associated with the IP address in the SARP table,
+	 * using the entry with the longest matching mask
 	 *
 	 * @param ip the IP address to search for
 	 * @param tal_id  the tal ID associated with the IP address if found
@@ -129,6 +193,19 @@ class SarpTable
 	 */
 	bool getTalByIp(IpAddress *ip, tal_id_t &tal_id) const;
 
+	/**
+	 * Get the tal ID associated with the IP address bytes in the SARP
+	 * table, using the entry with the longest matching mask
+	 *
+	 * @param version  the IP version (4 or 6)
+	 * @param addr     the IP address bytes, as in the IP header
+	 * @param tal_id   the tal ID associated with the IP address if found
+	 *                 the default tal_id otherwise (false will be returned)
+	 * @return true on success, false otherwise
+	 */
+	bool getTalByIp(uint8_t version, const unsigned char *addr,
+	                tal_id_t &tal_id) const;
+
 	/**
 	 * Get the tal ID associated with the MAC address in the SARP table
 	 *
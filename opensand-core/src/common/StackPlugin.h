@@ -105,6 +105,28 @@ class StackPlugin: public OpenSandPlugin
 		                         uint8_t src_tal_id,
 		                         uint8_t dst_tal_id) const = 0;
 
+		/**
+		 * @brief Create a NetPacket from a part of a buffer, for instance
+		 *        a packet in a frame.
+		 *        The data is copied, the handlers that can keep their
+		 *        packets in the buffer override this.
+		 *
+		 * @param buffer      The packet data
+		 * @param qos         The QoS value to associate with the packet
+		 * @param src_tal_id  The source terminal ID to associate with the packet
+		 * @param dst_tal_id  The destination terminal ID to associate with the packet
+		 *
+		 * @return The packet
+		 */
+		virtual NetPacket *build(const PacketBuffer &buffer,
+		                         uint8_t qos,
+		                         uint8_t src_tal_id,
+		                         uint8_t dst_tal_id) const
+		{
+			return this->build(buffer.toData(), buffer.length(),
+			                   qos, src_tal_id, dst_tal_id);
+		};
+
 		/**
 		 * @brief Get a packet length
 		 *
@@ -365,6 +387,7 @@ class StackPlugin: public OpenSandPlugin
 	StackPlugin(uint16_t ether_type): OpenSandPlugin()
 	{
 		this->ether_type = ether_type;
+		this->context_factory = NULL;
 	};
 
 
@@ -391,6 +414,30 @@ class StackPlugin: public OpenSandPlugin
 	 */
 	StackContext *getContext() const {return this->context;};
 
+	/**
+	 * @brief Create a new context, independent from the plugin one,
+	 *        for a thread that needs its own context state
+	 *
+	 * @return the initialized context that should be released by the
+	 *         caller, NULL on error
+	 */
+	StackContext *createContext()
+	{
+		StackContext *context;
+
+		if(!this->context_factory)
+		{
+			return NULL;
+		}
+		context = this->context_factory(*this);
+		if(!context->init())
+		{
+			delete context;
+			return NULL;
+		}
+		return context;
+	};
+
 	/**
 	 * @brief Get the encapsulation packet handler
 	 *
@@ -417,6 +464,7 @@ class StackPlugin: public OpenSandPlugin
 		Context *context = new Context(*plugin);
 		Handler *handler = new Handler(*plugin);
 		plugin->context = context;
+		plugin->context_factory = &StackPlugin::newContext<Plugin, Context>;
 		plugin->packet_handler = handler;
 		plugin->name = name;
 		plugin->conf_path = conf_path;
@@ -450,6 +498,18 @@ class StackPlugin: public OpenSandPlugin
 
  protected:
 
+	/**
+	 * @brief Build a context of the plugin, for createContext
+	 *
+	 * @param plugin  The plugin
+	 * @return the context
+	 */
+	template<class Plugin, class Context>
+	static StackContext *newContext(StackPlugin &plugin)
+	{
+		return new Context(static_cast<Plugin &>(plugin));
+	};
+
 	/// The EtherType (or EtherType like) of the associated protocol
 	uint16_t ether_type;
 
@@ -460,6 +520,9 @@ class StackPlugin: public OpenSandPlugin
 	/// The context
 	StackContext *context;
 
+	/// Build a new context of the plugin
+	StackContext *(*context_factory)(StackPlugin &plugin);
+
 	/// The packet handler
 	StackPacketHandler *packet_handler;
 
@@ -44,6 +44,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <unistd.h>
+#include <netinet/udp.h>
 //#include <netinet/in.h>
 
 
@@ -83,8 +84,16 @@ UdpChannel::UdpChannel(string name,
 	init_success(false),
 	sock_channel(-1),
 	m_multicast(multicast),
+	send_len(0),
+	send_count(0),
+#ifdef UDP_SEGMENT
+	gso(true),
+#else
+	gso(false),
+#endif
 	stacked_ip(""),
-	max_stack(stack)
+	max_stack(stack),
+	probe_datagrams_per_syscall(NULL)
 {
 	struct ip_mreq imr;
 	unsigned char ttl = 1;
@@ -144,6 +153,11 @@ UdpChannel::UdpChannel(string name,
 		}
 		m_remoteIPAddress.sin_family = AF_INET;
 		m_remoteIPAddress.sin_port = htons(port);
+
+		this->probe_datagrams_per_syscall =
+			Output::registerProbe<float>(false, SAMPLE_AVG,
+			                             "%s.Channel_%u.Datagrams_per_syscall",
+			                             name.c_str(), channel_id);
 		m_socketAddr.sin_addr.s_addr = inet_addr(local_ip_addr.c_str());
 
 		// creation of the link between the socket and its port
@@ -255,6 +269,7 @@ error:
  */
 UdpChannel::~UdpChannel()
 {
+	this->flush();
 	close(this->sock_channel);
 	this->udp_counters.clear();
 	for(map<string, UdpStack *>::iterator it = this->stacks.begin();
@@ -320,15 +335,6 @@ spot_id_t UdpChannel::getSpotId()
 }
 
 
-/**
- * @brief Get the message in NetSocketEvent
- *
- * @param event    The NetSocketEvent on fd
- * @param buf      pointer to a char buffer
- * @param data_len length of the received data
- * @return         0 on success, 1 if the function should be
- *                 called another time, -1 on error
- */
 // TODO why not work directly with Data here instead of buf, length
 int UdpChannel::receive(NetSocketEvent *const event,
                                      unsigned char **buf, size_t &data_len)
@@ -340,7 +346,6 @@ int UdpChannel::receive(NetSocketEvent *const event,
 	uint8_t current_sequencing;
 	unsigned char *data;
 	size_t recv_len;
-	unsigned char *recv_data;
 
 	if(!this->stacked_ip.empty())
 	{
@@ -368,7 +373,7 @@ int UdpChannel::receive(NetSocketEvent *const event,
 	{
 		LOG(this->log_sat_carrier, LEVEL_ERROR,
 		    "socket not opened !\n");
-		goto error;
+		goto drop;
 	}
 
 	// error if channel doesn't accept incoming data
@@ -377,14 +382,19 @@ int UdpChannel::receive(NetSocketEvent *const event,
 		LOG(this->log_sat_carrier, LEVEL_ERROR,
 		    "channel %d does not accept data\n",
 		    this->getChannelID());
-		goto error;
+		goto drop;
 	}
 
-	// we need to memcpy as the start pointer cannot be reused
-	recv_len = event->getSize() - 1;
-	recv_data = (unsigned char *)calloc(recv_len, sizeof(unsigned char));
+	// keep the whole datagram, the payload is after the sequencing field
+	if(event->getSize() <= UDP_SEQ_LEN)
+	{
+		LOG(this->log_sat_carrier, LEVEL_ERROR,
+		    "datagram too short on channel %d (%zu bytes)\n",
+		    this->getChannelID(), event->getSize());
+		goto drop;
+	}
+	recv_len = event->getSize() - UDP_SEQ_LEN;
 	data = event->getData();
-	memcpy(recv_data, data + 1, recv_len);
 	remote_addr = event->getSrcAddr();
 
 	// get the IP address of the sender
@@ -392,7 +402,6 @@ int UdpChannel::receive(NetSocketEvent *const event,
 
 	// check the sequencing of the datagramm
 	nb_sequencing = data[0];
-	free(data);
 	ip_count_it = this->udp_counters.find(ip_address);
 	if(ip_count_it == this->udp_counters.end())
 	{
@@ -406,7 +415,8 @@ int UdpChannel::receive(NetSocketEvent *const event,
 			    this->getChannelID(), ip_address.c_str(),
 			    nb_sequencing);
 		}
-		this->stacks[ip_address] = new UdpStack();
+		this->stacks[ip_address] =
+			new UdpStack(event->getAllocator().release);
 		current_sequencing = nb_sequencing;
 	}
 	else
@@ -417,7 +427,7 @@ int UdpChannel::receive(NetSocketEvent *const event,
 		    ip_address.c_str(), current_sequencing);
 	}
 	// add the new packet in stack
-	this->stacks[ip_address]->add(nb_sequencing, recv_data, recv_len);
+	this->stacks[ip_address]->add(nb_sequencing, data, recv_len);
 	this->stacked_ip = ip_address;
 	// send the current packet
 	if(this->stacks[ip_address]->hasNext(current_sequencing))
@@ -468,6 +478,10 @@ end:
 stacked:
 	return 1;
 
+drop:
+	// release the datagram, it would be reported as not handled on
+	// the next reception
+	event->releaseData(event->getData());
 error:
 	return -1;
 }
@@ -525,7 +539,18 @@ void UdpChannel::handleStack(unsigned char **buf, size_t &data_len,
 
 bool UdpChannel::send(const unsigned char *data, size_t length)
 {
-	ssize_t slen;
+	if(!this->enqueue(data, length))
+	{
+		return false;
+	}
+	return this->flush();
+}
+
+
+bool UdpChannel::enqueue(const unsigned char *data, size_t length)
+{
+	size_t slen = length + UDP_SEQ_LEN;
+	unsigned char *datagram;
 
 	LOG(this->log_sat_carrier, LEVEL_INFO,
 	    "data are trying to be send on channel %d\n", m_channel_id);
@@ -547,27 +572,44 @@ bool UdpChannel::send(const unsigned char *data, size_t length)
 		goto error;
 	}
 
-	// add a sequencing field
-	bzero(this->send_buffer, sizeof(this->send_buffer));
-	this->send_buffer[0] = this->counter;
-	memcpy(send_buffer + 1, data, length);
-	slen = length + 1;
-
-	if(sendto(this->sock_channel, this->send_buffer, slen, 0,
-	          (struct sockaddr *) &this->m_remoteIPAddress,
-	          sizeof(this->m_remoteIPAddress)) < slen)
+	if(slen > MAX_SOCK_SIZE)
 	{
 		LOG(this->log_sat_carrier, LEVEL_ERROR,
-		    "Error:  sendto(..,0,..) errno %s (%d)\n",
-		    strerror(errno), errno);
+		    "too many data to send on channel %d (%zu > %d)\n",
+		    m_channel_id, slen, MAX_SOCK_SIZE);
 		goto error;
 	}
 
+	// send the queued datagrams if there is no more space
+	if(this->send_count >= UDP_SEND_BATCH ||
+	   this->send_len + slen > UDP_SEND_BUFFER_SIZE)
+	{
+		if(!this->flush())
+		{
+			goto error;
+		}
+	}
+
+	// add a sequencing field
+	datagram = this->send_buffer + this->send_len;
+	datagram[0] = this->counter;
+	memcpy(datagram + UDP_SEQ_LEN, data, length);
+
+	this->send_iovecs[this->send_count].iov_base = datagram;
+	this->send_iovecs[this->send_count].iov_len = slen;
+	memset(&this->send_msgs[this->send_count], 0, sizeof(struct mmsghdr));
+	this->send_msgs[this->send_count].msg_hdr.msg_name = &this->m_remoteIPAddress;
+	this->send_msgs[this->send_count].msg_hdr.msg_namelen = sizeof(this->m_remoteIPAddress);
+	this->send_msgs[this->send_count].msg_hdr.msg_iov = &this->send_iovecs[this->send_count];
+	this->send_msgs[this->send_count].msg_hdr.msg_iovlen = 1;
+	this->send_count++;
+	this->send_len += slen;
+
 	// update of the counter
 	this->counter = (this->counter + 1) % 256;
 
 	LOG(this->log_sat_carrier, LEVEL_INFO,
-	    "==> SAT_Channel_Send [%d] (%s:%d): len=%zd, counter: %d\n",
+	    "==> SAT_Channel_Send [%d] (%s:%d): len=%zu, counter: %d\n",
 	    m_channel_id, inet_ntoa(this->m_remoteIPAddress.sin_addr),
 	    ntohs(this->m_remoteIPAddress.sin_port), slen,
 	    this->counter);
@@ -578,3 +620,135 @@ bool UdpChannel::send(const unsigned char *data, size_t length)
 	return false;
 }
 
+
+bool UdpChannel::flush(void)
+{
+	unsigned int sent = 0;
+	int ret;
+
+	if(!this->send_count)
+	{
+		return true;
+	}
+
+	ret = this->flushSegments();
+	if(ret > 0)
+	{
+		goto end;
+	}
+	else if(ret < 0)
+	{
+		goto error;
+	}
+
+	while(sent < this->send_count)
+	{
+		ret = sendmmsg(this->sock_channel, this->send_msgs + sent,
+		               this->send_count - sent, 0);
+		if(ret < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			LOG(this->log_sat_carrier, LEVEL_ERROR,
+			    "Error:  sendmmsg(..,0) errno %s (%d), %u datagrams lost\n",
+			    strerror(errno), errno, this->send_count - sent);
+			goto error;
+		}
+		sent += ret;
+		if(this->probe_datagrams_per_syscall)
+		{
+			this->probe_datagrams_per_syscall->put(ret);
+		}
+	}
+
+ end:
+	this->send_count = 0;
+	this->send_len = 0;
+	return true;
+
+ error:
+	this->send_count = 0;
+	this->send_len = 0;
+	return false;
+}
+
+
+int UdpChannel::flushSegments(void)
+{
+#ifdef UDP_SEGMENT
+	char control[CMSG_SPACE(sizeof(uint16_t))];
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct iovec iov;
+	size_t seg_len = this->send_iovecs[0].iov_len;
+	ssize_t ret;
+
+	if(!this->gso || this->send_count < 2)
+	{
+		return 0;
+	}
+
+	// all segments have the same size, only the last one may be shorter
+	for(unsigned int i = 1; i < this->send_count; i++)
+	{
+		if(this->send_iovecs[i].iov_len > seg_len ||
+		   (this->send_iovecs[i].iov_len != seg_len &&
+		    i != this->send_count - 1))
+		{
+			return 0;
+		}
+	}
+
+	// the datagrams are contiguous in send buffer
+	iov.iov_base = this->send_buffer;
+	iov.iov_len = this->send_len;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &this->m_remoteIPAddress;
+	msg.msg_namelen = sizeof(this->m_remoteIPAddress);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type = UDP_SEGMENT;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+	*((uint16_t *)CMSG_DATA(cmsg)) = seg_len;
+
+	ret = sendmsg(this->sock_channel, &msg, 0);
+	if(ret < 0)
+	{
+		if(errno == EIO || errno == EINVAL || errno == ENOPROTOOPT ||
+		   errno == EOPNOTSUPP)
+		{
+			// not supported by the kernel or the device, do not try again
+			LOG(this->log_sat_carrier, LEVEL_NOTICE,
+			    "UDP segmentation offload not available on channel %d: "
+			    "%s (%d)\n", m_channel_id, strerror(errno), errno);
+			this->gso = false;
+			return 0;
+		}
+		LOG(this->log_sat_carrier, LEVEL_ERROR,
+		    "Error:  sendmsg(..,0,..) errno %s (%d), %u datagrams lost\n",
+		    strerror(errno), errno, this->send_count);
+		return -1;
+	}
+	if(ret < (ssize_t)this->send_len)
+	{
+		// errno is not set on a short write
+		LOG(this->log_sat_carrier, LEVEL_ERROR,
+		    "Error:  sendmsg(..,0,..) sent %zd/%zu bytes, datagrams lost\n",
+		    ret, this->send_len);
+		return -1;
+	}
+	if(this->probe_datagrams_per_syscall)
+	{
+		this->probe_datagrams_per_syscall->put(this->send_count);
+	}
+	return 1;
+#else
+	return 0;
+#endif
+}
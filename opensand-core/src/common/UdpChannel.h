@@ -51,6 +51,16 @@
 #include <OpenSandCore.h>
 
 
+/// The length of the sequencing field at the beginning of each datagram
+#define UDP_SEQ_LEN 1
+
+/// The maximum number of datagrams sent in one system call
+#define UDP_SEND_BATCH 32
+
+/// The size of the buffer holding the datagrams waiting to be sent,
+/// this is the maximum UDP payload so it can be sent with one GSO call
+#define UDP_SEND_BUFFER_SIZE 65507
+
 class UdpStack;
 
 /*
@@ -91,6 +101,39 @@ class UdpChannel
 	 * @return true on success, false otherwise
 	 */
 	bool send(const unsigned char *data, size_t length);
+
+	/**
+	 * @brief Queue data to be sent on the satellite carrier
+	 *        The queued data are sent on the next flush, or when
+	 *        there is no more space in queue
+	 *
+	 * @param data        The data to send
+	 * @param length      The length of the data
+	 * @return true on success, false otherwise
+	 */
+	bool enqueue(const unsigned char *data, size_t length);
+
+	/**
+	 * @brief Send the queued data on the satellite carrier
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool flush(void);
+
+	/**
+	 * @brief Get the message in NetSocketEvent
+	 *
+	 * The datagram is not copied: buf is the buffer read on the socket
+	 * and the payload starts UDP_SEQ_LEN bytes after it.
+	 * Once handled, the buffer should be given back with
+	 * event->releaseData(buf).
+	 *
+	 * @param event    The NetSocketEvent on fd
+	 * @param buf      OUT: the datagram buffer
+	 * @param data_len OUT: the length of the payload
+	 * @return         0 on success, 1 if the function should be
+	 *                 called another time, -1 on error
+	 */
 	int receive(NetSocketEvent *const event,
 	            unsigned char **buf, size_t &data_len);
 
@@ -160,7 +203,20 @@ class UdpChannel
 	uint8_t counter;
 
 	/// internal buffer to build and send udp datagramms
-	unsigned char send_buffer[MAX_SOCK_SIZE];
+	unsigned char send_buffer[UDP_SEND_BUFFER_SIZE];
+
+	/// The length of the queued datagrams in send buffer
+	size_t send_len;
+
+	/// The number of queued datagrams
+	unsigned int send_count;
+
+	/// The queued datagrams for sendmmsg
+	struct iovec send_iovecs[UDP_SEND_BATCH];
+	struct mmsghdr send_msgs[UDP_SEND_BATCH];
+
+	/// Whether the queued datagrams can be sent with UDP segmentation offload
+	bool gso;
 
 	/// sometimes an UDP datagram containing unfragmented IP packet overtake one
 	/// containing fragmented IP packets during its reassembly
@@ -174,9 +230,22 @@ class UdpChannel
 	/// The maximum number of packets buffered in the software stack before sending content
 	unsigned int max_stack;
 
+	/// The number of datagrams sent per system call
+	Probe<float> *probe_datagrams_per_syscall;
+
 	/// Output Log
 	OutputLog *log_sat_carrier;
 	OutputLog *log_init;
+
+ private:
+
+	/**
+	 * @brief Send the queued datagrams in one system call with UDP
+	 *        segmentation offload if their sizes allow it
+	 *
+	 * @return 1 if sent, 0 if GSO cannot be used, -1 on error
+	 */
+	int flushSegments(void);
 };
 
 /*
@@ -191,8 +260,10 @@ class UdpStack: vector<pair<unsigned char *, size_t> >
 	/**
 	 * @brief Create the stack
 	 *
+	 * @param release  The function releasing the datagram buffers
 	 */
-	UdpStack()
+	UdpStack(void (*release)(unsigned char *)):
+		release_buffer(release)
 	{
 		// Output log
 		this->log_sat_carrier = Output::registerLog(LEVEL_WARNING,
@@ -216,8 +287,8 @@ class UdpStack: vector<pair<unsigned char *, size_t> >
 	 * @brief Add a packet in the stack
 	 *
 	 * @param udp_counter  The position of the packet in the stack
-	 * @param data         The packet to store
-	 * @param data_length  The packet length
+	 * @param data         The datagram buffer to store
+	 * @param data_length  The payload length
 	 */
 	void add(uint8_t udp_counter, unsigned char *data, size_t data_length)
 	{
@@ -227,7 +298,7 @@ class UdpStack: vector<pair<unsigned char *, size_t> >
 			    "new data for UDP stack at position %u, erase "
 			    "previous data\n", udp_counter);
 			this->counter--;
-			delete (this->at(udp_counter).first);
+			this->release_buffer(this->at(udp_counter).first);
 		}
 		this->at(udp_counter).first = data;
 		this->at(udp_counter).second = data_length;
@@ -285,7 +356,7 @@ class UdpStack: vector<pair<unsigned char *, size_t> >
 		{
 			if((*it).first)
 			{
-				delete (*it).first;
+				this->release_buffer((*it).first);
 				(*it).first = NULL;
 				(*it).second = 0;
 			}
@@ -299,6 +370,9 @@ class UdpStack: vector<pair<unsigned char *, size_t> >
 	//  we handle a packet
 	uint8_t counter;
 
+	/// The function releasing the datagram buffers
+	void (*release_buffer)(unsigned char *);
+
 	// Output log
 	OutputLog *log_sat_carrier;
 };
@@ -0,0 +1,273 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file WorkerPool.cpp
+ * @brief The threads sharing a computation by work stealing
+ */
+
+
+#include "WorkerPool.h"
+
+
+__thread WorkerPool *WorkerPool::current_pool = NULL;
+__thread unsigned int WorkerPool::current_index = 0;
+
+
+WorkerPool::WorkerPool():
+	workers(),
+	queued(0),
+	stopping(false),
+	log(NULL)
+{
+	pthread_mutex_init(&this->lock, NULL);
+	pthread_cond_init(&this->queued_cond, NULL);
+
+	// the calling thread worker
+	worker_t *worker = new worker_t;
+	worker->pool = this;
+	worker->index = 0;
+	worker->started = false;
+	pthread_mutex_init(&worker->lock, NULL);
+	this->workers.push_back(worker);
+}
+
+WorkerPool::~WorkerPool()
+{
+	vector<worker_t *>::iterator it;
+
+	pthread_mutex_lock(&this->lock);
+	this->stopping = true;
+	pthread_cond_broadcast(&this->queued_cond);
+	pthread_mutex_unlock(&this->lock);
+	// the threads look at the queues of all the workers until they stop
+	for(it = this->workers.begin(); it != this->workers.end(); ++it)
+	{
+		if((*it)->started)
+		{
+			pthread_join((*it)->thread, NULL);
+		}
+	}
+	for(it = this->workers.begin(); it != this->workers.end(); ++it)
+	{
+		pthread_mutex_destroy(&(*it)->lock);
+		delete *it;
+	}
+	pthread_cond_destroy(&this->queued_cond);
+	pthread_mutex_destroy(&this->lock);
+}
+
+bool WorkerPool::start(unsigned int workers_number, OutputLog *log)
+{
+	this->log = log;
+
+	// create all the workers before starting the threads that steal
+	// from them
+	for(unsigned int i = this->workers.size(); i < workers_number; i++)
+	{
+		worker_t *worker = new worker_t;
+
+		worker->pool = this;
+		worker->index = i;
+		worker->started = false;
+		pthread_mutex_init(&worker->lock, NULL);
+		this->workers.push_back(worker);
+	}
+	for(unsigned int i = 1; i < this->workers.size(); i++)
+	{
+		worker_t *worker = this->workers[i];
+
+		if(worker->started)
+		{
+			continue;
+		}
+		if(pthread_create(&worker->thread, NULL,
+		                  WorkerPool::runWorker, worker) != 0)
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "cannot start worker %u\n", i);
+			return false;
+		}
+		worker->started = true;
+	}
+	return true;
+}
+
+unsigned int WorkerPool::getWorkersNumber() const
+{
+	return this->workers.size();
+}
+
+void WorkerPool::run(worker_task_t task, const vector<void *> &args)
+{
+	unsigned int index = this->getCurrentWorker();
+	worker_t *worker = this->workers[index];
+	unsigned int pending = args.size();
+	vector<void *>::const_iterator it;
+	bool done;
+
+	if(this->workers.size() == 1 || args.size() <= 1)
+	{
+		for(it = args.begin(); it != args.end(); ++it)
+		{
+			task(*it);
+		}
+		return;
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	for(it = args.begin(); it != args.end(); ++it)
+	{
+		worker_job_t job;
+
+		job.task = task;
+		job.arg = *it;
+		job.pending = &pending;
+		worker->jobs.push_back(job);
+	}
+	pthread_mutex_unlock(&worker->lock);
+
+	pthread_mutex_lock(&this->lock);
+	__atomic_add_fetch(&this->queued, args.size(), __ATOMIC_RELAXED);
+	pthread_cond_broadcast(&this->queued_cond);
+	pthread_mutex_unlock(&this->lock);
+
+	// help while there are jobs, including the ones queued by the stolen
+	// jobs, otherwise sleep until there are or the run is done
+	while(true)
+	{
+		if(this->execute(index))
+		{
+			continue;
+		}
+		pthread_mutex_lock(&this->lock);
+		while(pending > 0 &&
+		      __atomic_load_n(&this->queued, __ATOMIC_RELAXED) == 0)
+		{
+			pthread_cond_wait(&this->queued_cond, &this->lock);
+		}
+		done = (pending == 0);
+		pthread_mutex_unlock(&this->lock);
+		if(done)
+		{
+			break;
+		}
+	}
+}
+
+bool WorkerPool::execute(unsigned int index)
+{
+	unsigned int workers_number = this->workers.size();
+	worker_t *worker = this->workers[index];
+	worker_job_t job;
+	bool found = false;
+
+	// the last queued job of the worker first, it is the most
+	// likely to be nested in the one being executed
+	pthread_mutex_lock(&worker->lock);
+	if(!worker->jobs.empty())
+	{
+		job = worker->jobs.back();
+		worker->jobs.pop_back();
+		found = true;
+	}
+	pthread_mutex_unlock(&worker->lock);
+
+	// then steal the oldest job of another worker
+	for(unsigned int i = 1; i < workers_number && !found; i++)
+	{
+		worker_t *victim = this->workers[(index + i) % workers_number];
+
+		pthread_mutex_lock(&victim->lock);
+		if(!victim->jobs.empty())
+		{
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+			found = true;
+		}
+		pthread_mutex_unlock(&victim->lock);
+	}
+	if(!found)
+	{
+		return false;
+	}
+
+	__atomic_sub_fetch(&this->queued, 1, __ATOMIC_RELAXED);
+	job.task(job.arg);
+
+	// the caller may be sleeping, the pending counter is on its stack
+	// so it is only accessed under the lock
+	pthread_mutex_lock(&this->lock);
+	(*job.pending)--;
+	if(*job.pending == 0)
+	{
+		pthread_cond_broadcast(&this->queued_cond);
+	}
+	pthread_mutex_unlock(&this->lock);
+	return true;
+}
+
+unsigned int WorkerPool::getCurrentWorker() const
+{
+	if(WorkerPool::current_pool != this)
+	{
+		return 0;
+	}
+	return WorkerPool::current_index;
+}
+
+void *WorkerPool::runWorker(void *arg)
+{
+	worker_t *worker = (worker_t *)arg;
+	WorkerPool *pool = worker->pool;
+	bool stopping;
+
+	WorkerPool::current_pool = pool;
+	WorkerPool::current_index = worker->index;
+	while(true)
+	{
+		if(pool->execute(worker->index))
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->lock);
+		while(__atomic_load_n(&pool->queued, __ATOMIC_RELAXED) == 0 &&
+		      !pool->stopping)
+		{
+			pthread_cond_wait(&pool->queued_cond, &pool->lock);
+		}
+		stopping = pool->stopping;
+		pthread_mutex_unlock(&pool->lock);
+		if(stopping)
+		{
+			break;
+		}
+	}
+	return NULL;
+}
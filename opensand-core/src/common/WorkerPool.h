@@ -0,0 +1,180 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file WorkerPool.h
+ * @brief The threads sharing a computation by work stealing
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+
+#include <opensand_output/Output.h>
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+using std::deque;
+using std::vector;
+
+
+/// A task, called with one of the arguments given to the pool
+typedef void (*worker_task_t)(void *arg);
+
+/**
+ * @class WorkerPool
+ * @brief The threads sharing a computation by work stealing
+ *
+ * Each worker has its own queue of tasks. The tasks of a run are queued
+ * on the worker of the calling thread, the idle workers steal them from
+ * the other queues. The calling thread executes tasks too while it waits
+ * for its own tasks, so a task can run other tasks in the pool (the DAMA
+ * of the spots, then of the carriers groups of each spot). A thread that
+ * is not a worker of the pool uses the first queue.
+ *
+ * The tasks write their results in their own argument, the caller merges
+ * them once the run is over, so the order of execution does not change
+ * the results. An argument is given to one task at a time, whatever the
+ * thread running it, so it can also hold a state that is not shared
+ * (the contexts of an encapsulation flow, a ROHC compressor). When there is no job left to execute, the caller sleeps
+ * until jobs are queued or its last task is done.
+ */
+class WorkerPool
+{
+ public:
+
+	/**
+	 * @brief Build a pool with one worker, the calling thread
+	 */
+	WorkerPool();
+
+	/**
+	 * @brief Stop the worker threads
+	 */
+	~WorkerPool();
+
+	/**
+	 * @brief Start the workers
+	 *
+	 * @param workers_number  The number of workers, including the calling
+	 *                        thread
+	 * @param log             The log for the workers errors
+	 * @return true on success, false otherwise
+	 */
+	bool start(unsigned int workers_number, OutputLog *log);
+
+	/**
+	 * @brief Get the number of workers
+	 *
+	 * @return the number of workers
+	 */
+	unsigned int getWorkersNumber() const;
+
+	/**
+	 * @brief Run a task for each argument and wait for all of them
+	 *
+	 * @param task  The task
+	 * @param args  The arguments of each task
+	 */
+	void run(worker_task_t task, const vector<void *> &args);
+
+ private:
+
+	/// A task queued on a worker
+	typedef struct
+	{
+		worker_task_t task;        ///< The task
+		void *arg;               ///< The task argument
+		unsigned int *pending;   ///< The tasks of the run not done yet,
+		                         ///< protected by the pool lock
+	} worker_job_t;
+
+	/// A worker
+	typedef struct
+	{
+		WorkerPool *pool;    ///< The pool of the worker
+		unsigned int index;      ///< The index of the worker
+		pthread_t thread;        ///< The worker thread
+		bool started;            ///< Whether the thread is started
+		pthread_mutex_t lock;    ///< The lock on the jobs
+		deque<worker_job_t> jobs;  ///< The jobs queued on the worker
+	} worker_t;
+
+	/**
+	 * @brief Execute one job, from the worker queue or stolen
+	 *        from another worker
+	 *
+	 * @param index  The index of the worker
+	 * @return true if a job was executed, false if there is none
+	 */
+	bool execute(unsigned int index);
+
+	/**
+	 * @brief Get the index of the worker of the calling thread
+	 *
+	 * @return the worker index
+	 */
+	unsigned int getCurrentWorker() const;
+
+	/**
+	 * @brief The worker threads loop
+	 *
+	 * @param arg  The worker
+	 * @return NULL
+	 */
+	static void *runWorker(void *arg);
+
+	/// The workers
+	vector<worker_t *> workers;
+
+	/// The lock protecting the idle workers wake up and the runs
+	pthread_mutex_t lock;
+
+	/// Signaled when jobs are queued or when a run is done
+	pthread_cond_t queued_cond;
+
+	/// The number of queued jobs
+	unsigned int queued;
+
+	/// Whether the workers should stop
+	bool stopping;
+
+	/// The log for the workers errors
+	OutputLog *log;
+
+	/// The pool of the calling thread, if it is a worker
+	static __thread WorkerPool *current_pool;
+
+	/// The index of the calling thread in its pool
+	static __thread unsigned int current_index;
+};
+
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file TestTimer.h
+ * @brief The clock of the tests and benchmarks measuring durations
+ *
+ * The programs named after the module they check are run by make check,
+ * they may print the durations of what they check. The bench_* programs
+ * are only built, they measure without checking.
+ */
+
+#ifndef TEST_TIMER_H
+#define TEST_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+
+/**
+ * @brief Get a monotonic time in ns
+ *
+ * @return the time
+ */
+static inline uint64_t getNanoseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+
+#endif
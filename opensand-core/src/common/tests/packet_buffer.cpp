@@ -0,0 +1,145 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file packet_buffer.cpp
+ * @brief Check the sharing of packet buffers
+ */
+
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+
+#include <PacketBuffer.h>
+
+int main()
+{
+	const unsigned char payload[] = "0123456789";
+	const unsigned char header[] = "HDR";
+	bool failure;
+
+	failure = false;
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	PacketBuffer buffer(payload, 10);
+	const unsigned char *start = buffer.data();
+
+	check(buffer.length() == 10 &&
+	      !memcmp(buffer.data(), payload, 10), "create");
+
+	// prepend in headroom without moving data
+	memcpy(buffer.prepend(3), header, 3);
+	check(buffer.length() == 13 && buffer.data() == start - 3 &&
+	      !memcmp(buffer.data(), "HDR0123456789", 13), "prepend in headroom");
+
+	check(buffer.strip(3) && buffer.data() == start, "strip header");
+	check(buffer.trim(2) && buffer.length() == 8, "trim trailer");
+	check(!buffer.strip(9) && !buffer.trim(9), "strip too much");
+
+	// slices share the storage
+	PacketBuffer part = buffer.slice(2, 4);
+	check(part.isShared() && buffer.isShared() &&
+	      part.data() == start + 2 && part.length() == 4, "slice");
+	check(buffer.slice(6, 10).length() == 2 &&
+	      buffer.slice(10, 1).length() == 0, "slice truncated");
+
+	// writing in a shared buffer copies it
+	part.writableData()[0] = 'x';
+	check(!part.isShared() && !buffer.isShared() &&
+	      part.data() != start + 2 && buffer.data()[2] == '2' &&
+	      part.data()[0] == 'x', "copy on write");
+
+	// a header added to a shared buffer does not overwrite the other one
+	PacketBuffer copy(buffer);
+	memcpy(copy.prepend(3), header, 3);
+	check(buffer.data() == start && copy.data() != start - 3 &&
+	      !memcmp(copy.data(), "HDR01234567", 11), "prepend shared");
+
+	copy.append(payload, 10);
+	check(copy.length() == 21 && copy.data()[20] == '9', "append");
+
+	// compatibility with Data
+	Data data = copy.toData();
+	PacketBuffer from_data(data);
+	check(data.length() == 21 && Data(from_data) == data, "data adapter");
+
+	// helpers used by the network containers
+	copy.append(copy);
+	check(copy.length() == 42 && copy.at(21) == 'H' && copy.at(41) == '9',
+	      "append itself");
+	try
+	{
+		copy.at(42);
+		check(false, "at out of range");
+	}
+	catch(std::out_of_range &)
+	{
+		check(true, "at out of range");
+	}
+	copy.reserve(100);
+	start = copy.data();
+	copy.append(payload, 10);
+	check(copy.data() == start, "reserve");
+
+	// room around the data for a library writing headers in place
+	PacketBuffer pdu(payload, 10);
+	start = pdu.data();
+	check(pdu.reserveRoom(13, 4) == start - 13 && pdu.data() == start,
+	      "reserve room");
+	PacketBuffer pdu_copy(pdu);
+	check(pdu_copy.reserveRoom(13, 4) + 13 != start && !pdu.isShared() &&
+	      pdu.data() == start, "reserve room shared");
+
+	PacketBuffer empty;
+	check(empty.empty() && empty.data() == NULL &&
+	      empty.toData().length() == 0, "empty");
+	empty = part;
+	check(empty.isShared() && empty.data() == part.data(), "assign");
+
+	// a datagram received in a storage is used without copy
+	unsigned char *datagram = PacketBuffer::allocateStorage(100);
+	memcpy(datagram, "S0123456789", 11);
+	PacketBuffer received = PacketBuffer::adopt(datagram, 1, 10);
+	check(received.data() == datagram + 1 && received.length() == 10 &&
+	      received.at(0) == '0' && !received.isShared(), "adopt");
+	received.append(payload, 10);
+	check(received.data() == datagram + 1 && received.length() == 20,
+	      "adopt room");
+	PacketBuffer::releaseStorage(PacketBuffer::allocateStorage(20000));
+
+	return (failure ? 1 : 0);
+}
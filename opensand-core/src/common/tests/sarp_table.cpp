@@ -0,0 +1,234 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file sarp_table.cpp
+ * @brief Check the SARP table lookups against a linear search and
+ *        measure the lookup cost with the number of entries
+ */
+
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <opensand_output/Output.h>
+
+#include <SarpTable.h>
+#include <Ipv4Address.h>
+#include <Ipv6Address.h>
+#include <TestTimer.h>
+
+/// The number of lookups measured for each table size
+#define SARP_LOOKUPS 100000
+
+/// A prefix in the reference table
+typedef struct
+{
+	Ipv4Address *ip;
+	unsigned int mask_len;
+	tal_id_t tal_id;
+} prefix_t;
+
+
+/**
+ * @brief Search the longest prefix matching an address linearly,
+ *        as the SARP table used to
+ *
+ * @param prefixes  the prefixes
+ * @param ip        the address
+ * @param tal_id    the tal ID of the longest prefix
+ * @return true if a prefix matches, false otherwise
+ */
+static bool linearSearch(const std::vector<prefix_t> &prefixes,
+                         const IpAddress *ip, tal_id_t &tal_id)
+{
+	int best = -1;
+
+	for(unsigned int i = 0; i < prefixes.size(); i++)
+	{
+		if(prefixes[i].ip->matchAddressWithMask(ip, prefixes[i].mask_len) &&
+		   (best < 0 || prefixes[i].mask_len > prefixes[best].mask_len))
+		{
+			best = i;
+		}
+	}
+	if(best < 0)
+	{
+		return false;
+	}
+	tal_id = prefixes[best].tal_id;
+	return true;
+}
+
+int main()
+{
+	unsigned int sizes[] = {10, 1000, 100000};
+	bool failure;
+
+	failure = false;
+	Output::init(false);
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	SarpTable table;
+	tal_id_t tal_id;
+	table.setDefaultTal(99);
+	table.add(new Ipv4Address("192.168.0.0"), 16, 1);
+	table.add(new Ipv4Address("192.168.18.0"), 24, 2);
+	table.add(new Ipv4Address("192.168.18.128"), 25, 3);
+	table.add(new Ipv4Address("0.0.0.0"), 0, 4);
+	table.add(new Ipv6Address("2001:660:6602:102::"), 64, 5);
+	Ipv4Address ip1("192.168.18.200");
+	Ipv4Address ip2("192.168.18.1");
+	Ipv4Address ip3("192.168.19.1");
+	Ipv4Address ip4("10.0.0.1");
+	Ipv6Address ip5("2001:660:6602:102::12");
+	Ipv6Address ip6("2001:660:6602:103::12");
+	check(table.getTalByIp(&ip1, tal_id) && tal_id == 3,
+	      "longest IPv4 prefix");
+	check(table.getTalByIp(&ip2, tal_id) && tal_id == 2,
+	      "shorter IPv4 prefix");
+	check(table.getTalByIp(&ip3, tal_id) && tal_id == 1,
+	      "shortest IPv4 prefix");
+	check(table.getTalByIp(&ip4, tal_id) && tal_id == 4,
+	      "IPv4 default route");
+	check(table.getTalByIp(&ip5, tal_id) && tal_id == 5, "IPv6 prefix");
+	check(!table.getTalByIp(&ip6, tal_id) && tal_id == 99,
+	      "IPv6 no prefix");
+
+	table.add(new MacAddress("00:00:00:00:00:01"), 1);
+	table.add(new MacAddress("00:00:00:00:**:**"), 2);
+	table.add(new MacAddress("00:00:00:00:00:02"), 3);
+	table.add(new MacAddress("00:00:00:00:00:01"), 4);
+	check(table.getTalByMac(MacAddress(0, 0, 0, 0, 0, 1), tal_id) &&
+	      tal_id == 1, "MAC address");
+	check(table.getTalByMac(MacAddress(0, 0, 0, 0, 0, 2), tal_id) &&
+	      tal_id == 2, "generic MAC address first");
+	check(!table.getTalByMac(MacAddress(0, 0, 0, 1, 0, 2), tal_id) &&
+	      tal_id == 99, "unknown MAC address");
+	std::vector<MacAddress> macs;
+	check(table.getMacByTal(3, macs) && macs.size() == 1 &&
+	      macs[0].str() == "00:00:00:00:00:02", "terminal MAC address");
+
+	// compare with a linear search on random prefixes and addresses,
+	// then measure the lookup cost
+	printf("%10s %15s %15s\n", "entries", "table (ns)", "linear (ns)");
+	for(unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		SarpTable sarp(sizes[i]);
+		std::vector<prefix_t> prefixes;
+		std::vector<Ipv4Address *> addresses;
+		unsigned int seed = 42;
+		unsigned int lookups;
+		tal_id_t tal1 = 0;
+		tal_id_t tal2 = 0;
+		bool match = true;
+		uint64_t start;
+		double table_duration;
+		double linear_duration;
+
+		sarp.setDefaultTal(0);
+		for(unsigned int j = 0; j < sizes[i]; j++)
+		{
+			prefix_t prefix;
+			uint32_t addr = rand_r(&seed);
+
+			prefix.mask_len = 8 + rand_r(&seed) % 25;
+			prefix.tal_id = j % 1000;
+			prefix.ip = new Ipv4Address(addr >> 24, addr >> 16,
+			                            addr >> 8, addr);
+			prefixes.push_back(prefix);
+			sarp.add(new Ipv4Address(prefix.ip->str()),
+			         prefix.mask_len, prefix.tal_id);
+		}
+		for(unsigned int j = 0; j < 1000; j++)
+		{
+			// addresses in the prefixes or random ones
+			uint32_t addr = rand_r(&seed);
+			if(j % 2)
+			{
+				Ipv4Address *ip = prefixes[j % sizes[i]].ip;
+				addr = (ip->at(0) << 24) | (ip->at(1) << 16) |
+				       (ip->at(2) << 8) | (addr & 0xff);
+			}
+			addresses.push_back(new Ipv4Address(addr >> 24, addr >> 16,
+			                                    addr >> 8, addr));
+		}
+
+		for(unsigned int j = 0; j < addresses.size(); j++)
+		{
+			bool found1 = sarp.getTalByIp(addresses[j], tal1);
+			bool found2 = linearSearch(prefixes, addresses[j], tal2);
+			if(found1 != found2 || (found1 && tal1 != tal2))
+			{
+				match = false;
+			}
+		}
+		check(match, "same prefixes as linear search");
+
+		lookups = SARP_LOOKUPS;
+		start = getNanoseconds();
+		for(unsigned int j = 0; j < lookups; j++)
+		{
+			sarp.getTalByIp(addresses[j % addresses.size()], tal1);
+		}
+		table_duration = (double)(getNanoseconds() - start) / lookups;
+
+		// the linear search is too slow for many lookups
+		lookups = SARP_LOOKUPS / sizes[i] + 10;
+		start = getNanoseconds();
+		for(unsigned int j = 0; j < lookups; j++)
+		{
+			linearSearch(prefixes, addresses[j % addresses.size()], tal2);
+		}
+		linear_duration = (double)(getNanoseconds() - start) / lookups;
+		printf("%10u %15.1f %15.1f\n", sizes[i],
+		       table_duration, linear_duration);
+
+		for(unsigned int j = 0; j < prefixes.size(); j++)
+		{
+			delete prefixes[j].ip;
+		}
+		for(unsigned int j = 0; j < addresses.size(); j++)
+		{
+			delete addresses[j];
+		}
+	}
+
+	return (failure ? 1 : 0);
+}
@@ -84,53 +84,63 @@ bool BlockDvb::DvbDownward::sendBursts(list<DvbFrame *> *complete_frames,
                                        uint8_t carrier_id)
 {
 	list<DvbFrame *>::iterator frame_it;
+	vector<rt_msg_t> &messages = this->burst_messages;
 	bool status = true;
 
-	// send all complete DVB-RCS frames
+	// send all complete DVB-RCS frames in one batch
 	LOG(this->log_send, LEVEL_DEBUG,
 	    "send all %zu complete DVB frames...\n",
 	    complete_frames->size());
+	messages.clear();
 	for(frame_it = complete_frames->begin();
 	    frame_it != complete_frames->end();
 	    ++frame_it)
 	{
-		// Send DVB frames to lower layer
-		if(!this->sendDvbFrame(*frame_it, carrier_id))
+		DvbFrame *dvb_frame = *frame_it;
+		rt_msg_t message;
+
+		if(!this->prepareDvbFrame(dvb_frame, carrier_id))
 		{
 			status = false;
-			if(*frame_it)
-			{
-				delete *frame_it;
-			}
+			delete dvb_frame;
 			continue;
 		}
 
-		// DVB frame is now sent, so delete its content
-		LOG(this->log_send, LEVEL_INFO,
-		    "complete DVB frame sent to carrier %u\n", carrier_id);
+		message.data = dvb_frame;
+		message.length = 0;
+		message.type = 0;
+		messages.push_back(message);
 	}
 	// clear complete DVB frames
 	complete_frames->clear();
 
+	// Send DVB frames to lower layer
+	if(!this->enqueueMessages(messages))
+	{
+		LOG(this->log_send, LEVEL_ERROR,
+		    "failed to send %zu DVB frames to lower layer\n",
+		    messages.size());
+		for(vector<rt_msg_t>::iterator it = messages.begin();
+		    it != messages.end(); ++it)
+		{
+			delete (DvbFrame *)(*it).data;
+		}
+		messages.clear();
+		return false;
+	}
+
+	// DVB frames are now sent
+	LOG(this->log_send, LEVEL_INFO,
+	    "complete DVB frames sent to carrier %u\n", carrier_id);
+
 	return status;
 }
 
 bool BlockDvb::DvbDownward::sendDvbFrame(DvbFrame *dvb_frame,
                                          uint8_t carrier_id)
 {
-	if(!dvb_frame)
-	{
-		LOG(this->log_send, LEVEL_ERROR,
-		    "frame is %p\n", dvb_frame);
-		goto error;
-	}
-
-	dvb_frame->setCarrierId(carrier_id);
-
-	if(dvb_frame->getTotalLength() <= 0)
+	if(!this->prepareDvbFrame(dvb_frame, carrier_id))
 	{
-		LOG(this->log_send, LEVEL_ERROR,
-		    "empty frame, header and payload are not present\n");
 		goto error;
 	}
 
@@ -154,6 +164,25 @@ error:
 	return false;
 }
 
+bool BlockDvb::DvbDownward::prepareDvbFrame(DvbFrame *dvb_frame,
+                                            uint8_t carrier_id)
+{
+	if(!dvb_frame)
+	{
+		LOG(this->log_send, LEVEL_ERROR,
+		    "frame is %p\n", dvb_frame);
+		return false;
+	}
+	if(dvb_frame->getTotalLength() <= 0)
+	{
+		LOG(this->log_send, LEVEL_ERROR,
+		    "empty frame, header and payload are not present\n");
+		return false;
+	}
+	dvb_frame->setCarrierId(carrier_id);
+	return true;
+}
+
 
 bool BlockDvb::DvbDownward::onRcvEncapPacket(NetPacket *packet,
                                              DvbFifo *fifo,
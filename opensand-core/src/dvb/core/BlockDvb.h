@@ -116,7 +116,8 @@ class BlockDvb: public Block
 	 public:
 		DvbDownward(const string &name):
 			DvbChannel(),
-			RtDownward(name)
+			RtDownward(name),
+			burst_messages()
 		{
 		};
 
@@ -167,6 +168,20 @@ class BlockDvb: public Block
 		 * Update the statistics
 		 */
 		virtual void updateStats(void) = 0;
+
+	 private:
+		/**
+		 * @brief Check a DVB frame before sending it and set its carrier
+		 *
+		 * @param frame       the DVB frame, not released on error
+		 * @param carrier_id  the carrier ID used to send the frame
+		 * @return            true if the frame can be sent, false otherwise
+		 */
+		bool prepareDvbFrame(DvbFrame *frame, uint8_t carrier_id);
+
+		/// The messages of the bursts, kept between the superframes
+		/// to reuse their memory
+		vector<rt_msg_t> burst_messages;
 	};
 };
 
@@ -161,6 +161,8 @@ BlockDvbNcc::Downward::Downward(const string &name, tal_id_t mac_id):
 	mac_id(mac_id),
 	fwd_frame_counter(0),
 	fwd_timer(-1),
+	dama_workers(),
+	superframe_budget(),
 	probe_frame_interval(NULL)
 {
 }
@@ -174,6 +176,7 @@ bool BlockDvbNcc::Downward::onInit(void)
 {
 	bool result = true;
 	const char *scheme;
+	unsigned int workers_number;
 	map<spot_id_t, DvbChannel *>::iterator spot_iter;
 
 	// TODO initSatType is done in initCommon too
@@ -218,6 +221,23 @@ bool BlockDvbNcc::Downward::onInit(void)
 		return false;
 	}
 
+	// get the number of DAMA workers
+	if(!Conf::getValue(Conf::section_map[ADV_SECTION],
+	                   DAMA_WORKERS, workers_number) ||
+	   workers_number == 0)
+	{
+		LOG(this->log_init, LEVEL_ERROR,
+		    "section '%s': missing or invalid parameter '%s'\n",
+		    ADV_SECTION, DAMA_WORKERS);
+		return false;
+	}
+	if(!this->dama_workers.start(workers_number, this->log_init))
+	{
+		LOG(this->log_init, LEVEL_ERROR,
+		    "failed to start the DAMA workers\n");
+		return false;
+	}
+
 	for(spot_iter = this->spots.begin(); 
 	    spot_iter != this->spots.end(); ++spot_iter)
 	{
@@ -259,6 +279,7 @@ bool BlockDvbNcc::Downward::onInit(void)
 		}
 		(*spot_iter).second = spot;
 		result &= spot->onInit();
+		spot->setDamaWorkers(&this->dama_workers);
 	}
 
 	// initialize the timers
@@ -308,6 +329,8 @@ bool BlockDvbNcc::Downward::onInit(void)
 	this->probe_frame_interval = Output::registerProbe<float>("Perf.Frames_interval",
 	                                                          "ms", true,
 	                                                          SAMPLE_LAST);
+	this->superframe_budget.init(this->ret_up_frame_duration_ms,
+	                             this->log_receive);
 
 	return result;
 }
@@ -421,11 +444,16 @@ bool BlockDvbNcc::Downward::onEvent(const RtEvent *const event)
 				switch(msg_type)
 				{
 					case MSG_TYPE_SAC: // when physical layer is enabled
+					{
+						uint64_t start_ns = SuperframeBudget::getTime();
+
 						if(!spot->handleSac(dvb_frame))
 						{
 							goto error;
 						}
+						this->superframe_budget.addDuration(sf_phase_sac, start_ns);
 						break;
+					}
 
 					case MSG_TYPE_SESSION_LOGON_REQ:
 						if(!this->handleLogonReq(dvb_frame, spot))
@@ -580,11 +608,22 @@ bool BlockDvbNcc::Downward::onEvent(const RtEvent *const event)
 				}
 
 				// we reached the end of a superframe
+				if(this->super_frame_counter > 0)
+				{
+					this->superframe_budget.closeSuperframe(this->super_frame_counter);
+				}
+
 				// beginning of a new one, send SOF and run allocation
 				// algorithms (DAMA)
 				// increase the superframe number and reset
 				// counter of frames per superframe
 				this->super_frame_counter++;
+
+				if(!this->handleFrameTimer())
+				{
+					return false;
+				}
+				break;
 			}
 
 			bool find_pep = false; 
@@ -600,41 +639,26 @@ bool BlockDvbNcc::Downward::onEvent(const RtEvent *const event)
 					return false;
 				}
 
-				if(*event == this->frame_timer)
+				if(*event == this->fwd_timer)
 				{
-					// send Start Of Frame
-					this->sendSOF(spot->getSofCarrierId());
+					uint64_t start_ns = SuperframeBudget::getTime();
+					bool is_done;
 
-					if(spot->checkDama())
-					{
-						continue;
-					}
-
-					// Update Fmt here for TTP
-					spot->updateFmt();
-
-					if(!spot->handleFrameTimer(this->super_frame_counter))
-					{
-						// do not quit if this fail in one spot
-						continue;
-					}
-
-					// send TTP computed by DAMA
-					this->sendTTP(spot);
-				}
-
-				else if(*event == this->fwd_timer)
-				{
 					this->fwd_frame_counter++;
-					if(!spot->handleFwdFrameTimer(this->fwd_frame_counter))
+					is_done = spot->handleFwdFrameTimer(this->fwd_frame_counter);
+					start_ns = this->superframe_budget.addDuration(sf_phase_fwd_scheduling,
+					                                               start_ns);
+					if(!is_done)
 					{
 						// do not break if this fail in one spot
 						continue;
 					}
 
 					// send the scheduled frames
-					if(!this->sendBursts(&spot->getCompleteDvbFrames(),
-					                     spot->getDataCarrierId()))
+					is_done = this->sendBursts(&spot->getCompleteDvbFrames(),
+					                           spot->getDataCarrierId());
+					this->superframe_budget.addDuration(sf_phase_send, start_ns);
+					if(!is_done)
 					{
 						LOG(this->log_receive, LEVEL_ERROR,
 						    "failed to build and send DVB/BB "
@@ -1048,6 +1072,82 @@ error:
 
 }
 
+bool BlockDvbNcc::Downward::handleFrameTimer(void)
+{
+	map<spot_id_t, DvbChannel *>::iterator spot_iter;
+	vector<dama_spot_t> dama_spots;
+	vector<void *> args;
+	uint64_t start_ns = SuperframeBudget::getTime();
+
+	for(spot_iter = this->spots.begin();
+	    spot_iter != this->spots.end(); ++spot_iter)
+	{
+		SpotDownward *spot;
+		spot = dynamic_cast<SpotDownward *>((*spot_iter).second);
+		if(!spot)
+		{
+			LOG(this->log_receive, LEVEL_WARNING,
+			    "Error when getting spot\n");
+			return false;
+		}
+
+		// send Start Of Frame
+		this->sendSOF(spot->getSofCarrierId());
+		start_ns = this->superframe_budget.addDuration(sf_phase_send, start_ns);
+
+		if(spot->checkDama())
+		{
+			continue;
+		}
+
+		// Update Fmt here for TTP
+		spot->updateFmt();
+		start_ns = this->superframe_budget.addDuration(sf_phase_dama, start_ns);
+
+		dama_spot_t dama_spot;
+		dama_spot.spot = spot;
+		dama_spot.super_frame_counter = this->super_frame_counter;
+		dama_spots.push_back(dama_spot);
+	}
+
+	// the spots DAMA are independent, share them between the workers
+	for(vector<dama_spot_t>::iterator it = dama_spots.begin();
+	    it != dama_spots.end(); ++it)
+	{
+		args.push_back(&(*it));
+	}
+	this->dama_workers.run(BlockDvbNcc::Downward::runSpotDama, args);
+	start_ns = this->superframe_budget.addDuration(sf_phase_dama, start_ns);
+
+	for(vector<dama_spot_t>::iterator it = dama_spots.begin();
+	    it != dama_spots.end(); ++it)
+	{
+		SpotDownward *spot = it->spot;
+		bool is_done;
+
+		// the simulated terminals send SAC
+		start_ns = SuperframeBudget::getTime();
+		is_done = spot->handleFrameTimer();
+		this->superframe_budget.addDuration(sf_phase_sac, start_ns);
+		if(!is_done)
+		{
+			// do not quit if this fail in one spot
+			continue;
+		}
+
+		// send TTP computed by DAMA
+		this->sendTTP(spot);
+	}
+	return true;
+}
+
+void BlockDvbNcc::Downward::runSpotDama(void *arg)
+{
+	dama_spot_t *dama_spot = (dama_spot_t *)arg;
+
+	dama_spot->spot->runDama(dama_spot->super_frame_counter);
+}
+
 void BlockDvbNcc::Downward::sendSOF(unsigned int carrier_id)
 {
 	Sof *sof = new Sof(this->super_frame_counter);
@@ -1067,17 +1167,24 @@ void BlockDvbNcc::Downward::sendSOF(unsigned int carrier_id)
 
 void BlockDvbNcc::Downward::sendTTP(SpotDownward *spot)
 {
+	uint64_t start_ns = SuperframeBudget::getTime();
 	Ttp *ttp = new Ttp(this->mac_id, this->super_frame_counter);
+	bool is_sent;
+
 	// Build TTP
 	if(!spot->buildTtp(ttp))
 	{
 		delete ttp;
+		this->superframe_budget.addDuration(sf_phase_ttp_build, start_ns);
 		LOG(this->log_send, LEVEL_DEBUG,
 		    "Dama didn't build TTP\bn");
 		return;
 	};
+	start_ns = this->superframe_budget.addDuration(sf_phase_ttp_build, start_ns);
 
-	if(!this->sendDvbFrame((DvbFrame *)ttp, spot->getCtrlCarrierId()))
+	is_sent = this->sendDvbFrame((DvbFrame *)ttp, spot->getCtrlCarrierId());
+	this->superframe_budget.addDuration(sf_phase_send, start_ns);
+	if(!is_sent)
 	{
 		delete ttp;
 		LOG(this->log_send, LEVEL_ERROR,
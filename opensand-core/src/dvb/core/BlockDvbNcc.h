@@ -71,6 +71,7 @@
 
 #include "SpotUpward.h"
 #include "SpotDownward.h"
+#include "SuperframeBudget.h"
 
 /**
  * @brief  The list of spots for GW channels and other common elements
@@ -232,6 +233,21 @@ class BlockDvbNcc: public BlockDvb
 		 */
 		bool initTimers(void);
 		
+		/**
+		 * @brief Handle the frame timer: send the SOF, run the spots
+		 *        DAMA then send the TTP
+		 *
+		 * @return true on success, false otherwise
+		 */
+		bool handleFrameTimer(void);
+
+		/**
+		 * @brief Run the DAMA of a spot, called by the DAMA workers
+		 *
+		 * @param arg  The spot and the superframe counter
+		 */
+		static void runSpotDama(void *arg);
+
 		/**
 		 * Send a Terminal Time Plan
 		 */
@@ -287,6 +303,19 @@ class BlockDvbNcc: public BlockDvb
 		/// Delay for allocation requests from PEP (in ms)
 		int pep_alloc_delay;
 
+		/// A spot DAMA run by the DAMA workers
+		typedef struct
+		{
+			SpotDownward *spot;             ///< The spot
+			time_sf_t super_frame_counter;  ///< The superframe counter
+		} dama_spot_t;
+
+		/// The workers sharing the spots and carriers groups DAMA
+		WorkerPool dama_workers;
+
+		/// The processing time of the superframes
+		SuperframeBudget superframe_budget;
+
 		// Frame interval
 		Probe<float> *probe_frame_interval;
 	};
@@ -120,7 +120,7 @@ bool FileSimulator::simulation(list<DvbFrame *>* msgs,
 		}
 		else if(5 ==
 		        sscanf(this->simu_buffer,
-		               "SF%hu LOGON st%hu rt=%hu rbdc=%hu vbdc=%hu",
+		               "SF%hu LOGON st%hu rt=%u rbdc=%u vbdc=%u",
 		               &sf_nr, &st_id, &st_rt, &st_rbdc, &st_vbdc))
 		{
 			event_selected = logon;
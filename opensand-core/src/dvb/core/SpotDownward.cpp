@@ -792,14 +792,25 @@ bool SpotDownward::checkDama()
 }
 
 
-bool SpotDownward::handleFrameTimer(time_sf_t super_frame_counter)
+void SpotDownward::setDamaWorkers(WorkerPool *workers)
+{
+	if(this->dama_ctrl)
+	{
+		this->dama_ctrl->setWorkers(workers);
+	}
+}
+
+void SpotDownward::runDama(time_sf_t super_frame_counter)
 {
 	// Upate the superframe counter
 	this->super_frame_counter = super_frame_counter;
 
 	// run the allocation algorithms (DAMA)
 	this->dama_ctrl->runOnSuperFrameChange(this->super_frame_counter);
+}
 
+bool SpotDownward::handleFrameTimer(void)
+{
 	list<DvbFrame *> msgs;
 	list<DvbFrame *>::iterator msg;
 
@@ -110,12 +110,29 @@ class SpotDownward: public DvbChannel, public DvbFmt
 	bool checkDama();
 	
 	/**
-	 * @brief handler a frame timer and update frame counter
+	 * @brief Set the workers sharing the DAMA computation
+	 *
+	 * @param workers  The DAMA workers
+	 */
+	void setDamaWorkers(WorkerPool *workers);
+
+	/**
+	 * @brief Update the frame counter and run the allocation
+	 *        algorithms (DAMA)
+	 *
+	 * The spots DAMA are independent, they can run in parallel
 	 *
 	 * @param super_frame_counter  the superframe counter
+	 */
+	void runDama(time_sf_t super_frame_counter);
+
+	/**
+	 * @brief handler a frame timer once the DAMA was run
+	 *        (simulated terminals)
+	 *
 	 * @return true on success, false otherwise
 	 */
-	bool handleFrameTimer(time_sf_t super_frame_counter);
+	bool handleFrameTimer(void);
 	
 	/**
 	 * @brief handler a forward frame timer and update forward frame counter
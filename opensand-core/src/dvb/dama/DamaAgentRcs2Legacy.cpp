@@ -144,7 +144,11 @@ vol_kb_t DamaAgentRcs2Legacy::computeVbdcRequest()
 	    vbdc_need_kb, this->vbdc_credit_kb);
 
 	/* compute VBDC request: actual Vbdc request to be sent */
-	vbdc_request_kb = max(0, (vbdc_need_kb - this->vbdc_credit_kb));
+	vbdc_request_kb = 0;
+	if(vbdc_need_kb > this->vbdc_credit_kb)
+	{
+		vbdc_request_kb = vbdc_need_kb - this->vbdc_credit_kb;
+	}
 	LOG(this->log_request, LEVEL_DEBUG,
 	    "SF#%u: theoretical VBDC request = %u kbits",
 	    this->current_superframe_sf,
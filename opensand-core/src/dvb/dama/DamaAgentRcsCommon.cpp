@@ -41,9 +41,9 @@
 #include <algorithm>
 
 // constants
-const rate_kbps_t C_MAX_RBDC_IN_SAC = 16320.0; // 16320 kbits/s, limitation due
+const rate_kbps_t C_MAX_RBDC_IN_SAC = 1044480; // 1044480 kbits/s, limitation due
                                                // to CR value size in to SAC field
-const vol_kb_t C_MAX_VBDC_IN_SAC = 4080;       // 4080 packets/ceils, limitation
+const vol_kb_t C_MAX_VBDC_IN_SAC = 1044480;    // 1044480 kbits, limitation
                                                // due to CR value size in to SAC field
 
 using std::max;
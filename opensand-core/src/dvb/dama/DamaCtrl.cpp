@@ -62,6 +62,8 @@ DamaCtrl::DamaCtrl(spot_id_t spot):
 	input_modcod_def(NULL),
 	roll_off(0.0),
 	simulated(false),
+	event_file(NULL),
+	workers(NULL),
 	spot_id(spot)
 {
 	// Output Log
@@ -486,10 +488,19 @@ bool DamaCtrl::hereIsLogoff(const Logoff *logoff)
 		category = (*category_it).second;
 		if(!category->removeTerminal(terminal))
 		{
+			this->removeTerminal(&terminal);
 			return false;
 		}
 	}
 
+	// release the terminal context and its slot in the store
+	if(!this->removeTerminal(&terminal))
+	{
+		LOG(this->log_logon, LEVEL_ERROR,
+		    "Cannot remove ST #%u\n", tal_id);
+		return false;
+	}
+
 	if(tal_id > BROADCAST_TAL_ID)
 	{
 		DC_RECORD_EVENT("LOGOFF st%d", tal_id);
@@ -627,6 +638,11 @@ void DamaCtrl::setRecordFile(FILE *event_stream)
 	DC_RECORD_EVENT("%s", "# --------------------------------------\n");
 }
 
+void DamaCtrl::setWorkers(WorkerPool *workers)
+{
+	this->workers = workers;
+}
+
 // TODO disable timers on probes if output is disabled
 // and event to reactivate them ?!
 void DamaCtrl::updateStatistics(time_ms_t UNUSED(period_ms))
@@ -40,12 +40,14 @@
 #include "Sac.h"
 #include "Ttp.h"
 #include "TerminalContextDama.h"
+#include "TerminalStoreDama.h"
 #include "TerminalCategoryDama.h"
 #include "StFmtSimu.h"
 #include "PepRequest.h"
 #include "OpenSandFrames.h"
 #include "Logon.h"
 #include "Logoff.h"
+#include "WorkerPool.h"
 
 #include <opensand_output/Output.h>
 
@@ -169,6 +171,13 @@ class DamaCtrl
 	 */
 	virtual void setRecordFile(FILE * event_stream);
 
+	/**
+	 * @brief Set the workers sharing the allocations computation
+	 *
+	 * @param workers  The workers, NULL to compute in the calling thread
+	 */
+	void setWorkers(WorkerPool *workers);
+
 	/**
 	 * @brief    Get a pointer to the categories
 	 * @warning  the categories can be modified
@@ -237,6 +246,14 @@ class DamaCtrl
 	                            time_sf_t rbdc_timeout_sf,
 	                            vol_kb_t max_vbdc_kb) = 0;
 
+	/**
+	 * @brief  Remove a terminal context.
+	 *
+	 * @param   terminal  The terminal to remove, set to NULL
+	 * @return  true on success, false otherwise.
+	 */
+	virtual bool removeTerminal(TerminalContextDama **terminal) = 0;
+
 	/**
 	 * @brief  Reset the capacity of carriers
 	 *
@@ -312,6 +329,10 @@ class DamaCtrl
 	// Helper to simplify context manipulation
 	typedef map<tal_id_t, TerminalContextDama *> DamaTerminalList;
 
+	/** The values of the registered terminals, the store MUST outlive the
+	 *  terminal contexts */
+	TerminalStoreDama terminal_store;
+
 	/** List of registered terminals */
 	DamaTerminalList terminals;
 
@@ -367,6 +388,9 @@ class DamaCtrl
 	/// if set to other than NULL, the fd where recording events
 	FILE *event_file;
 
+	/// The workers sharing the allocations computation, may be NULL
+	WorkerPool *workers;
+
 	/// Output probe and stats
 
 	typedef map<tal_id_t, Probe<int> *> ProbeListPerTerminal;
@@ -42,6 +42,30 @@
 
 #include <math.h>
 #include <string>
+#include <algorithm>
+
+
+/**
+ * @brief Whether a terminal has a RBDC request or a RBDC credit
+ *
+ * @param terminal  The terminal
+ * @return true if the terminal may get RBDC, false otherwise
+ */
+static bool hasRbdcRequest(const TerminalContextDamaRcs *terminal)
+{
+	return terminal->getRequiredRbdc() > 0 || terminal->getRbdcCredit() > 0.0;
+}
+
+/**
+ * @brief Whether a terminal has no RBDC credit
+ *
+ * @param terminal  The terminal
+ * @return true if the terminal has no credit, false otherwise
+ */
+static bool hasNoRbdcCredit(const TerminalContextDamaRcs *terminal)
+{
+	return terminal->getRbdcCredit() <= 0.0;
+}
 
 /**
  * Constructor
@@ -57,6 +81,13 @@ DamaCtrlRcs2Legacy::DamaCtrlRcs2Legacy(spot_id_t spot):
  */
 DamaCtrlRcs2Legacy::~DamaCtrlRcs2Legacy()
 {
+	map<unsigned int, UnitConverter *>::iterator it;
+
+	for(it = this->carriers_converter.begin();
+	    it != this->carriers_converter.end(); ++it)
+	{
+		delete it->second;
+	}
 }
 
 bool DamaCtrlRcs2Legacy::init()
@@ -143,44 +174,160 @@ bool DamaCtrlRcs2Legacy::init()
 	return true;
 }
 
+bool DamaCtrlRcs2Legacy::hereIsSAC(const Sac *sac)
+{
+	TerminalContextDamaRcs *terminal;
+	tal_id_t tal_id = sac->getTerminalId();
+
+	if(!DamaCtrlRcs2::hereIsSAC(sac))
+	{
+		return false;
+	}
+
+	// only keep track of the terminals with a request, the allocation
+	// will not consider the other ones
+	terminal = (TerminalContextDamaRcs *)this->getTerminalContext(tal_id);
+	if(terminal == NULL)
+	{
+		return true;
+	}
+	if(hasRbdcRequest(terminal))
+	{
+		this->rbdc_requests.insert(tal_id);
+	}
+	this->updateVbdcRequest(terminal);
+
+	return true;
+}
+
+bool DamaCtrlRcs2Legacy::applyPepCommand(const PepRequest *request)
+{
+	TerminalContextDamaRcs *terminal;
+	tal_id_t tal_id = request->getStId();
+
+	if(!DamaCtrlRcs2::applyPepCommand(request))
+	{
+		return false;
+	}
+
+	// the command may inject a RBDC request
+	terminal = (TerminalContextDamaRcs *)this->getTerminalContext(tal_id);
+	if(terminal != NULL && hasRbdcRequest(terminal))
+	{
+		this->rbdc_requests.insert(tal_id);
+	}
+
+	return true;
+}
+
+bool DamaCtrlRcs2Legacy::removeTerminal(TerminalContextDama **terminal)
+{
+	tal_id_t tal_id = (*terminal)->getTerminalId();
+
+	this->rbdc_requests.erase(tal_id);
+	this->removeVbdcRequest(tal_id);
+
+	return DamaCtrlRcs2::removeTerminal(terminal);
+}
+
+bool DamaCtrlRcs2Legacy::resetTerminalsAllocations()
+{
+	bool ret = true;
+	vector<carrier_dama_t>::iterator carrier_it;
+	set<tal_id_t>::const_iterator it;
+
+	// only the terminals served on the previous superframe have RBDC, VBDC
+	// or FCA allocations, the CRA allocations are kept while their carriers
+	// group does not change
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		vector<tal_id_t>::const_iterator tal_it;
+
+		for(tal_it = carrier_it->allocated.begin();
+		    tal_it != carrier_it->allocated.end();
+		    ++tal_it)
+		{
+			TerminalContextDama *terminal = this->getTerminalContext(*tal_it);
+
+			if(terminal == NULL)
+			{
+				// logged off
+				continue;
+			}
+			terminal->setRbdcAllocation(0);
+			terminal->setVbdcAllocation(0);
+			terminal->setFcaAllocation(0);
+		}
+		carrier_it->allocated.clear();
+	}
+
+	// the RBDC timer and credit only matter for the terminals
+	// with a RBDC request or credit
+	for(it = this->rbdc_requests.begin(); it != this->rbdc_requests.end(); ++it)
+	{
+		TerminalContextDamaRcs *terminal;
+
+		terminal = (TerminalContextDamaRcs *)this->getTerminalContext(*it);
+		if(terminal == NULL)
+		{
+			continue;
+		}
+		terminal->decrementTimer();
+		if(!this->updateRbdcCredit(terminal))
+		{
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
 bool DamaCtrlRcs2Legacy::computeTerminalsCraAllocation()
 {
 	bool stat = true;
 	rate_kbps_t gw_cra_request_kbps = 0;
-	TerminalCategories<TerminalCategoryDama>::const_iterator category_it;
+	vector<carrier_dama_t>::const_iterator carrier_it;
+	DamaTerminalList::const_iterator tal_it;
 
 	this->gw_cra_alloc_kbps = 0;
 
-	for(category_it = this->categories.begin();
-	    category_it != this->categories.end();
-	    ++category_it)
+	// Output probes and stats
+	// the next allocations only handle the terminals with a request
+	// so reset the allocation probes of the other ones here
+	for(tal_it = this->terminals.begin();
+	    tal_it != this->terminals.end() && tal_it->first < BROADCAST_TAL_ID;
+	    ++tal_it)
 	{
-		TerminalCategoryDama *category = category_it->second;
-		vector<CarriersGroupDama *> carriers_group;
-		vector<CarriersGroupDama *>::const_iterator carrier_it;
-
-		// we can compute CRA per carriers group because a terminal
-		// is assigned to one on each frame, depending on its DRA
-		carriers_group = category->getCarriersGroups();
-		for(carrier_it = carriers_group.begin();
-		    carrier_it != carriers_group.end();
-		    ++carrier_it)
+		this->probes_st_rbdc_alloc[tal_it->first]->put(0);
+		this->probes_st_vbdc_alloc[tal_it->first]->put(0);
+		if(this->fca_kbps != 0)
 		{
-			rate_kbps_t cra_request_kbps = 0;
-			rate_kbps_t cra_alloc_kbps = 0;
+			this->probes_st_fca_alloc[tal_it->first]->put(0);
+		}
+	}
 
-			this->computeDamaCraPerCarrier(*carrier_it,
-			                               category,
-				                           cra_request_kbps,
-				                           cra_alloc_kbps);
-			gw_cra_request_kbps += cra_request_kbps;
-			this->gw_cra_alloc_kbps += cra_alloc_kbps;;
+	// we can compute CRA per carriers group because a terminal
+	// is assigned to one on each frame, depending on its DRA
+	if(!this->prepareCarriers(dama_pass_cra))
+	{
+		return false;
+	}
+	this->runCarriers();
 
-			if(cra_alloc_kbps < cra_request_kbps)
-			{
-				stat = false;
-			}
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		gw_cra_request_kbps += carrier_it->request_rate_kbps;
+		this->gw_cra_alloc_kbps += carrier_it->alloc_rate_kbps;
+
+		if(carrier_it->alloc_rate_kbps < carrier_it->request_rate_kbps)
+		{
+			stat = false;
 		}
+		this->mergeCarrier(*carrier_it, this->probes_st_cra_alloc);
 	}
 	//this->probe_gw_cra_request->put(this->gw_cra_request_kbps);
 
@@ -191,34 +338,24 @@ bool DamaCtrlRcs2Legacy::computeTerminalsRbdcAllocation()
 {
 	rate_kbps_t gw_rbdc_request_kbps = 0;
 	rate_kbps_t gw_rbdc_alloc_kbps = 0;
+	vector<carrier_dama_t>::const_iterator carrier_it;
 
-	TerminalCategories<TerminalCategoryDama>::const_iterator category_it;
-	vector<CarriersGroupDama *>::const_iterator carrier_it;
-
-	for(category_it = this->categories.begin();
-	    category_it != this->categories.end();
-	    ++category_it)
-	{
-		TerminalCategoryDama *category = (*category_it).second;
-		vector<CarriersGroupDama *> carriers_group;
+	// we ca compute RBDC per carriers group because a terminal
+	// is assigned to one on each frame, depending on its DRA
+	this->prepareCarriers(dama_pass_rbdc);
 
-		// we ca compute RBDC per carriers group because a terminal
-		// is assigned to one on each frame, depending on its DRA
-		carriers_group = category->getCarriersGroups();
-		for(carrier_it = carriers_group.begin();
-		    carrier_it != carriers_group.end();
-		    ++carrier_it)
-		{
-			rate_kbps_t rbdc_request_kbps = 0;
-			rate_kbps_t rbdc_alloc_kbps = 0;
+	// only the terminals with a request or a credit may get RBDC
+	this->dispatchRbdcRequests();
+	this->runCarriers();
 
-			this->computeDamaRbdcPerCarrier(*carrier_it,
-			                            category,
-			                            rbdc_request_kbps,
-			                            rbdc_alloc_kbps);
-			gw_rbdc_request_kbps += rbdc_request_kbps;
-			gw_rbdc_alloc_kbps += rbdc_alloc_kbps;
-		}
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		gw_rbdc_request_kbps += carrier_it->request_rate_kbps;
+		gw_rbdc_alloc_kbps += carrier_it->alloc_rate_kbps;
+		this->gw_rbdc_req_num += carrier_it->requests_number;
+		this->mergeCarrier(*carrier_it, this->probes_st_rbdc_alloc);
 	}
 	// Output stats and probes
 	this->probe_gw_rbdc_req_num->put(gw_rbdc_req_num);
@@ -234,31 +371,32 @@ bool DamaCtrlRcs2Legacy::computeTerminalsVbdcAllocation()
 {
 	vol_kb_t gw_vbdc_request_kb = 0;
 	vol_kb_t gw_vbdc_alloc_kb = 0;
-	TerminalCategories<TerminalCategoryDama>::const_iterator category_it;
-	vector<CarriersGroupDama *>::const_iterator carrier_it;
+	vector<carrier_dama_t>::const_iterator carrier_it;
 
-	for(category_it = this->categories.begin();
-	    category_it != this->categories.end();
-	    ++category_it)
+	this->prepareCarriers(dama_pass_vbdc);
+
+	// only the terminals with a request may get VBDC
+	this->dispatchVbdcRequests();
+	this->runCarriers();
+
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
 	{
-		TerminalCategoryDama *category = (*category_it).second;
-		vector<CarriersGroupDama *> carriers_group;
+		vector<TerminalContextDamaRcs *>::const_iterator tal_it;
 
-		carriers_group = category->getCarriersGroups();
-		for(carrier_it = carriers_group.begin();
-		    carrier_it != carriers_group.end();
-		    ++carrier_it)
+		// the allocations decreased the requests of the served terminals
+		for(tal_it = carrier_it->requests.begin();
+		    tal_it != carrier_it->requests.end();
+		    ++tal_it)
 		{
-			vol_kb_t vbdc_request_kb = 0;
-			vol_kb_t vbdc_alloc_kb = 0;
-
-			this->computeDamaVbdcPerCarrier(*carrier_it,
-			                            category,
-			                            vbdc_request_kb,
-			                            vbdc_alloc_kb);
-			gw_vbdc_request_kb += vbdc_request_kb;
-			gw_vbdc_alloc_kb += vbdc_alloc_kb;
+			this->updateVbdcRequest(*tal_it);
 		}
+
+		gw_vbdc_request_kb += carrier_it->request_vol_kb;
+		gw_vbdc_alloc_kb += carrier_it->alloc_vol_kb;
+		this->gw_vbdc_req_num += carrier_it->requests_number;
+		this->mergeCarrier(*carrier_it, this->probes_st_vbdc_alloc);
 	}
 
 	// Output stats and probes
@@ -274,8 +412,7 @@ bool DamaCtrlRcs2Legacy::computeTerminalsVbdcAllocation()
 bool DamaCtrlRcs2Legacy::computeTerminalsFcaAllocation()
 {
 	rate_kbps_t gw_fca_alloc_kbps = 0;
-	TerminalCategories<TerminalCategoryDama>::const_iterator category_it;
-	vector<CarriersGroupDama *>::const_iterator carrier_it;
+	vector<carrier_dama_t>::const_iterator carrier_it;
 
 	if(this->fca_kbps == 0)
 	{
@@ -284,25 +421,18 @@ bool DamaCtrlRcs2Legacy::computeTerminalsFcaAllocation()
 		return true;
 	}
 
-	for(category_it = this->categories.begin();
-	    category_it != this->categories.end();
-	    ++category_it)
-	{
-		TerminalCategoryDama *category = (*category_it).second;
-		vector<CarriersGroupDama *> carriers_group;
+	this->prepareCarriers(dama_pass_fca);
 
-		carriers_group = category->getCarriersGroups();
-		for(carrier_it = carriers_group.begin();
-		    carrier_it != carriers_group.end();
-		    ++carrier_it)
-		{
-			rate_kbps_t fca_alloc_kbps = 0;
+	// only the terminals with a RBDC request may have a credit
+	this->dispatchRbdcRequests();
+	this->runCarriers();
 
-			this->computeDamaFcaPerCarrier(*carrier_it,
-			                            category,
-			                            fca_alloc_kbps);
-			gw_fca_alloc_kbps += fca_alloc_kbps;
-		}
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		gw_fca_alloc_kbps += carrier_it->alloc_rate_kbps;
+		this->mergeCarrier(*carrier_it, this->probes_st_fca_alloc);
 	}
 
 	// Be careful to use probes only if FCA is enabled
@@ -312,73 +442,308 @@ bool DamaCtrlRcs2Legacy::computeTerminalsFcaAllocation()
 	return true;
 }
 
-void DamaCtrlRcs2Legacy::computeDamaCraPerCarrier(CarriersGroupDama *carriers,
-                                                  const TerminalCategoryDama *category,
-                                                  rate_kbps_t &request_rate_kbps,
-                                                  rate_kbps_t &alloc_rate_kbps)
+bool DamaCtrlRcs2Legacy::prepareCarriers(dama_pass_t pass)
+{
+	TerminalCategories<TerminalCategoryDama>::const_iterator category_it;
+	vector<carrier_dama_t>::iterator carrier_it;
+
+	if(pass == dama_pass_cra)
+	{
+		TerminalStoreDama *store = &this->terminal_store;
+		unsigned int size = store->getSize();
+		unsigned int count = 0;
+		bool moved = store->isMoved();
+
+		// list the carriers groups again, the CRA allocation of a carriers
+		// group is kept while its terminals, their CRA and their MODCOD
+		// do not change
+		this->carriers_index.clear();
+		for(category_it = this->categories.begin();
+		    category_it != this->categories.end();
+		    ++category_it)
+		{
+			TerminalCategoryDama *category = category_it->second;
+			vector<CarriersGroupDama *> carriers_group;
+			vector<CarriersGroupDama *>::const_iterator group_it;
+
+			carriers_group = category->getCarriersGroups();
+			for(group_it = carriers_group.begin();
+			    group_it != carriers_group.end();
+			    ++group_it)
+			{
+				unsigned int carrier_id = (*group_it)->getCarriersId();
+				UnitConverter *converter;
+
+				converter = this->getCarrierConverter(carrier_id);
+				if(converter == NULL)
+				{
+					this->carriers_dama.resize(count);
+					store->clearChanges();
+					return false;
+				}
+				if(count == this->carriers_dama.size())
+				{
+					this->carriers_dama.push_back(carrier_dama_t());
+				}
+				carrier_dama_t &carrier = this->carriers_dama[count];
+				if(carrier.carriers != *group_it || carrier.category != category)
+				{
+					// another carriers group, list its terminals
+					moved = true;
+					carrier.cra_valid = false;
+				}
+				else if(store->isCarrierChanged(carrier_id))
+				{
+					carrier.cra_valid = false;
+				}
+				carrier.dama = this;
+				carrier.carriers = *group_it;
+				carrier.category = category;
+				carrier.label = category->getLabel();
+				carrier.converter = converter;
+				this->carriers_index[carrier_id] = count;
+				count++;
+			}
+		}
+		if(count != this->carriers_dama.size())
+		{
+			this->carriers_dama.resize(count);
+			moved = true;
+		}
+		store->clearChanges();
+
+		// bucket the terminals by carriers group in one pass on the store
+		// when they moved, the carriers IDs are unique in the spot so the
+		// carrier ID is enough to select the terminals of the category
+		if(moved)
+		{
+			for(carrier_it = this->carriers_dama.begin();
+			    carrier_it != this->carriers_dama.end();
+			    ++carrier_it)
+			{
+				carrier_it->slots.clear();
+				carrier_it->real_slots.clear();
+				carrier_it->terminals.clear();
+			}
+			for(unsigned int slot = 0; slot < size; ++slot)
+			{
+				map<unsigned int, unsigned int>::const_iterator index_it;
+
+				index_it = this->carriers_index.find(store->getCarrierId(slot));
+				if(index_it == this->carriers_index.end())
+				{
+					continue;
+				}
+				carrier_dama_t &carrier = this->carriers_dama[index_it->second];
+				carrier.slots.push_back(slot);
+				if(store->getTerminalId(slot) <= BROADCAST_TAL_ID)
+				{
+					carrier.real_slots.push_back(slot);
+				}
+				carrier.terminals.push_back((TerminalContextDamaRcs *)store->getTerminal(slot));
+			}
+		}
+	}
+
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		carrier_it->pass = pass;
+		carrier_it->requests.clear();
+		carrier_it->request_rate_kbps = 0;
+		carrier_it->alloc_rate_kbps = 0;
+		carrier_it->request_vol_kb = 0;
+		carrier_it->alloc_vol_kb = 0;
+		carrier_it->requests_number = 0;
+		carrier_it->used_capacity.clear();
+		carrier_it->simu_put = false;
+		carrier_it->simu_alloc = 0;
+	}
+
+	return true;
+}
+
+void DamaCtrlRcs2Legacy::runCarriers()
+{
+	vector<void *> args;
+	vector<carrier_dama_t>::iterator carrier_it;
+
+	for(carrier_it = this->carriers_dama.begin();
+	    carrier_it != this->carriers_dama.end();
+	    ++carrier_it)
+	{
+		args.push_back(&(*carrier_it));
+	}
+
+	if(this->workers != NULL)
+	{
+		this->workers->run(DamaCtrlRcs2Legacy::computeCarrier, args);
+		return;
+	}
+	for(vector<void *>::iterator it = args.begin(); it != args.end(); ++it)
+	{
+		DamaCtrlRcs2Legacy::computeCarrier(*it);
+	}
+}
+
+void DamaCtrlRcs2Legacy::computeCarrier(void *arg)
+{
+	carrier_dama_t *carrier = (carrier_dama_t *)arg;
+
+	switch(carrier->pass)
+	{
+		case dama_pass_cra:
+			carrier->dama->computeDamaCraPerCarrier(*carrier);
+			break;
+		case dama_pass_rbdc:
+			carrier->dama->computeDamaRbdcPerCarrier(*carrier);
+			break;
+		case dama_pass_vbdc:
+			carrier->dama->computeDamaVbdcPerCarrier(*carrier);
+			break;
+		case dama_pass_fca:
+			carrier->dama->computeDamaFcaPerCarrier(*carrier);
+			break;
+	}
+}
+
+void DamaCtrlRcs2Legacy::mergeCarrier(const carrier_dama_t &carrier,
+                                      ProbeListPerTerminal &probes)
+{
+	unsigned int carrier_id = carrier.carriers->getCarriersId();
+	vector<rate_symps_t>::const_iterator used_it;
+
+	// Output probes and stats
+	// update the capacity in the allocations order to get the same
+	// rounding as if the carriers groups were computed one by one
+	for(used_it = carrier.used_capacity.begin();
+	    used_it != carrier.used_capacity.end();
+	    ++used_it)
+	{
+		this->carrier_return_remaining_capacity[carrier.label][carrier_id] -= *used_it;
+		this->category_return_remaining_capacity[carrier.label] -= *used_it;
+		this->gw_remaining_capacity -= *used_it;
+	}
+	if(carrier.simu_put)
+	{
+		probes[0]->put(carrier.simu_alloc);
+	}
+}
+
+UnitConverter *DamaCtrlRcs2Legacy::getCarrierConverter(unsigned int carrier_id)
+{
+	map<unsigned int, UnitConverter *>::iterator it;
+	UnitConverter *converter;
+
+	// the converter keeps the modulation efficiency of the terminal
+	// being served, so each carriers group needs its own one
+	it = this->carriers_converter.find(carrier_id);
+	if(it != this->carriers_converter.end())
+	{
+		return it->second;
+	}
+
+	converter = this->generateUnitConverter();
+	if(converter == NULL)
+	{
+		LOG(this->log_run_dama, LEVEL_ERROR,
+		    "SF#%u: cannot generate the unit converter of carrier %u\n",
+		    this->current_superframe_sf, carrier_id);
+		return NULL;
+	}
+	this->carriers_converter[carrier_id] = converter;
+	return converter;
+}
+
+void DamaCtrlRcs2Legacy::computeDamaCraPerCarrier(carrier_dama_t &carrier)
 {
 	ostringstream buf;
-	string label = category->getLabel();
 	string debug;
 
-	vector<TerminalContextDamaRcs *> tal;
-	TerminalContextDamaRcs *terminal;
+	CarriersGroupDama *carriers = carrier.carriers;
+	UnitConverter *converter = carrier.converter;
+	TerminalStoreDama *store = &this->terminal_store;
 	unsigned int carrier_id = carriers->getCarriersId();
+	vector<unsigned int>::const_iterator slot_it;
 	rate_pktpf_t remaining_capacity_pktpf;
 	rate_pktpf_t total_capacity_pktpf;
-	vector<TerminalContextDamaRcs *>::iterator tal_it;
 	tal_id_t tal_id;
 	rate_kbps_t simu_cra_kbps = 0;
 
 	buf << "SF#" << this->current_superframe_sf << " carrier "
-	    << carrier_id << ", category " << label << ":";
+	    << carrier_id << ", category " << carrier.label << ":";
 	debug = buf.str();
 
 	// Get the remaining capacity in timeslot number (per frame)
 	remaining_capacity_pktpf = carriers->getRemainingCapacity();
-	total_capacity_pktpf = this->converter->symToPkt(carriers->getTotalCapacity());
+	total_capacity_pktpf = converter->symToPkt(carriers->getTotalCapacity());
 
 	LOG(this->log_run_dama, LEVEL_INFO,
 	    "%s remaining capacity = %u packets per superframe before CRA allocation (total: %u packets)\n",
 	    debug.c_str(), remaining_capacity_pktpf, total_capacity_pktpf);
 
-	tal = category->getTerminalsInCarriersGroup<TerminalContextDamaRcs>(carrier_id);
+	if(carrier.cra_valid && carrier.cra_capacity_pktpf == remaining_capacity_pktpf)
+	{
+		// nothing changed in the carriers group since the previous
+		// superframe, the terminals keep their CRA allocation
+		remaining_capacity_pktpf -= carrier.cra_pktpf;
+		carrier.request_rate_kbps = carrier.cra_request_kbps;
+		carrier.alloc_rate_kbps = carrier.cra_alloc_kbps;
+		simu_cra_kbps = carrier.cra_simu_kbps;
 
-	// get total CRA allocation
-	for(tal_it = tal.begin(); tal_it != tal.end(); ++tal_it)
+		// Output probes and stats
+		for(slot_it = carrier.real_slots.begin();
+		    slot_it != carrier.real_slots.end();
+		    ++slot_it)
+		{
+			tal_id = store->getTerminalId(*slot_it);
+			this->probes_st_cra_alloc[tal_id]->put(
+				store->getTerminal(*slot_it)->getCraAllocation());
+		}
+		goto end;
+	}
+
+	// get total CRA allocation, going through the store slots
+	// of the carriers terminals
+	for(slot_it = carrier.slots.begin();
+	    slot_it != carrier.slots.end();
+	    ++slot_it)
 	{
+		unsigned int slot = *slot_it;
 		FmtDefinition *fmt_def;
 		rate_pktpf_t cra_pktpf;
 		rate_kbps_t cra_kbps;
 
-		terminal = *tal_it;
-		tal_id = terminal->getTerminalId();
-		fmt_def = terminal->getFmt();
+		tal_id = store->getTerminalId(slot);
+		store->setCraAllocation(slot, 0);
+
+		fmt_def = store->getFmt(slot);
 		if(fmt_def == NULL)
 		{
 			continue;
 		}
-		this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+		converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
-		cra_kbps = terminal->getRequiredCra();
+		cra_kbps = store->getRequiredCra(slot);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: CRA %u kb/s",
 		    debug.c_str(), tal_id, cra_kbps);
 
-		request_rate_kbps += cra_kbps;
+		carrier.request_rate_kbps += cra_kbps;
 
 		cra_kbps = fmt_def->addFec(cra_kbps);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: CRA with FEC %u kb/s",
 		    debug.c_str(), tal_id, cra_kbps);
 
-		cra_pktpf = this->converter->kbpsToPktpf(cra_kbps);
+		cra_pktpf = converter->kbpsToPktpf(cra_kbps);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: CRA %u packets per frame",
 		    debug.c_str(), tal_id, cra_pktpf);
 
 		// Evaluate the real requested rate (multiple of the timeslot rate)
-		cra_kbps = this->converter->pktpfToKbps(cra_pktpf);
+		cra_kbps = converter->pktpfToKbps(cra_pktpf);
 		cra_kbps = fmt_def->removeFec(cra_kbps);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: Updated CRA %u kb/s to timeslot use consequence",
@@ -392,8 +757,8 @@ void DamaCtrlRcs2Legacy::computeDamaCraPerCarrier(CarriersGroupDama *carriers,
 			continue;
 		}
 		remaining_capacity_pktpf -= cra_pktpf;
-		alloc_rate_kbps += cra_kbps;
-		terminal->setCraAllocation(cra_kbps);
+		carrier.alloc_rate_kbps += cra_kbps;
+		store->setCraAllocation(slot, cra_kbps);
 
 		// Output probes and stats
 		if(tal_id > BROADCAST_TAL_ID)
@@ -406,10 +771,17 @@ void DamaCtrlRcs2Legacy::computeDamaCraPerCarrier(CarriersGroupDama *carriers,
 		}
 	}
 
-	if(this->simulated)
-	{
-		this->probes_st_cra_alloc[0]->put(simu_cra_kbps);
-	}
+	// keep the allocation for the next superframes
+	carrier.cra_valid = true;
+	carrier.cra_capacity_pktpf = carriers->getRemainingCapacity();
+	carrier.cra_pktpf = carrier.cra_capacity_pktpf - remaining_capacity_pktpf;
+	carrier.cra_request_kbps = carrier.request_rate_kbps;
+	carrier.cra_alloc_kbps = carrier.alloc_rate_kbps;
+	carrier.cra_simu_kbps = simu_cra_kbps;
+
+end:
+	carrier.simu_put = this->simulated;
+	carrier.simu_alloc = simu_cra_kbps;
 
 	LOG(this->log_run_dama, LEVEL_INFO,
 	    "%s remaining capacity = %u packets per superframe after CRA allocation (total: %u packets)\n",
@@ -418,10 +790,7 @@ void DamaCtrlRcs2Legacy::computeDamaCraPerCarrier(CarriersGroupDama *carriers,
 	carriers->setRemainingCapacity(remaining_capacity_pktpf);
 }
 
-void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
-                                                   const TerminalCategoryDama *category,
-                                                   rate_kbps_t &request_rate_kbps,
-                                                   rate_kbps_t &alloc_rate_kbps)
+void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(carrier_dama_t &carrier)
 {
 	rate_pktpf_t total_request_pktpf = 0;
 	rate_pktpf_t request_pktpf;
@@ -429,7 +798,9 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 	rate_kbps_t rbdc_alloc_kbps;
 	double fair_share;
 	rate_pktpf_t rbdc_alloc_pktpf = 0;
-	vector<TerminalContextDamaRcs *> tal;
+	CarriersGroupDama *carriers = carrier.carriers;
+	UnitConverter *converter = carrier.converter;
+	vector<TerminalContextDamaRcs *> &tal = carrier.requests;
 	TerminalContextDamaRcs *terminal;
 	unsigned int carrier_id = carriers->getCarriersId();
 	rate_pktpf_t remaining_capacity_pktpf;
@@ -438,22 +809,17 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 	int simu_rbdc = 0;
 	tal_id_t tal_id;
 	ostringstream buf;
-	string label = category->getLabel();
 	string debug;
 
-	map<tal_id_t, rate_pktpf_t> tal_request_pktpf;
-
-	// set default values
-	request_rate_kbps = 0;
-	alloc_rate_kbps = 0;
+	vector<rate_pktpf_t> tal_request_pktpf;
 
 	buf << "SF#" << this->current_superframe_sf << " carrier "
-	    << carrier_id << ", category " << label << ":";
+	    << carrier_id << ", category " << carrier.label << ":";
 	debug = buf.str();
 
 	// Get the remaining capacity in timeslot number (per frame)
 	remaining_capacity_pktpf = carriers->getRemainingCapacity();
-	total_capacity_pktpf = this->converter->symToPkt(carriers->getTotalCapacity());
+	total_capacity_pktpf = converter->symToPkt(carriers->getTotalCapacity());
 
 	if(remaining_capacity_pktpf == 0)
 	{
@@ -467,7 +833,8 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 	    "%s remaining capacity = %u packets per superframe before RBDC allocation (total: %u packets)\n",
 	    debug.c_str(), remaining_capacity_pktpf, total_capacity_pktpf);
 
-	tal = category->getTerminalsInCarriersGroup<TerminalContextDamaRcs>(carrier_id);
+	// only the terminals with a request or a credit were given
+	tal_request_pktpf.assign(tal.size(), 0);
 
 	// get total RBDC requests
 	for(tal_it = tal.begin(); tal_it != tal.end(); ++tal_it)
@@ -480,7 +847,7 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		{
 			continue;
 		}
-		this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+		converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
 		request_kbps = terminal->getRequiredRbdc();
 		LOG(this->log_run_dama, LEVEL_DEBUG,
@@ -492,14 +859,14 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		    "%s ST%d: RBDC request with FEC %u kb/s",
 		    debug.c_str(), tal_id, request_kbps);
 
-		request_pktpf = this->converter->kbpsToPktpf(request_kbps);
+		request_pktpf = converter->kbpsToPktpf(request_kbps);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: RBDC request %u packets per frame",
 		    debug.c_str(), tal_id, request_pktpf);
-		tal_request_pktpf[tal_id] = request_pktpf;
+		tal_request_pktpf[tal_it - tal.begin()] = request_pktpf;
 
 		// Evaluate the real requested rate (multiple of the timeslot rate)
-		request_kbps = this->converter->pktpfToKbps(request_pktpf);
+		request_kbps = converter->pktpfToKbps(request_pktpf);
 		request_kbps = fmt_def->removeFec(request_kbps);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: Updated RBDC request %u kb/s to timeslot use consequence",
@@ -509,10 +876,10 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 
 		// Output stats and probes
 		if (request_pktpf > 0)
-			this->gw_rbdc_req_num++;
+			carrier.requests_number++;
 
 		// Output stats and probes
-		request_rate_kbps += request_kbps;
+		carrier.request_rate_kbps += request_kbps;
 	}
 
 	if(total_request_pktpf == 0)
@@ -521,19 +888,8 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		    "%s no RBDC request for this frame.\n", debug.c_str());
 
 		// Output stats and probes
-		for(tal_it = tal.begin(); tal_it != tal.end(); ++tal_it)
-		{
-			terminal = *tal_it;
-			tal_id_t tal_id = terminal->getTerminalId();
-			if(tal_id < BROADCAST_TAL_ID)
-			{
-				this->probes_st_rbdc_alloc[tal_id]->put(0);
-			}
-		}
-		if(this->simulated)
-		{
-			this->probes_st_rbdc_alloc[0]->put(0);
-		}
+		carrier.simu_put = this->simulated;
+		carrier.simu_alloc = 0;
 
 		return;
 	}
@@ -554,11 +910,10 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 	    total_request_pktpf, fair_share);
 
 	// first step : serve the integer part of the fair RBDC
-	alloc_rate_kbps = 0;
+	carrier.alloc_rate_kbps = 0;
 	for(tal_it = tal.begin(); tal_it != tal.end(); ++tal_it)
 	{
 		FmtDefinition *fmt_def;
-		rate_symps_t rbdc_alloc_symps;
 		double fair_rbdc_pktpf;
 
 		terminal = *tal_it;
@@ -572,10 +927,10 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 			}
 			continue;
 		}
-		this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+		converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
 		// apply the fair share coef to all requests
-		request_pktpf = tal_request_pktpf[tal_id];
+		request_pktpf = tal_request_pktpf[tal_it - tal.begin()];
 		fair_rbdc_pktpf = (double) (request_pktpf / fair_share);
 
 		// take the integer part of fair RBDC
@@ -584,7 +939,7 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		    "%s ST%d: RBDC allocation %u packets per frame",
 		    debug.c_str(), tal_id, rbdc_alloc_pktpf);
 
-		rbdc_alloc_kbps = this->converter->pktpfToKbps(rbdc_alloc_pktpf);
+		rbdc_alloc_kbps = converter->pktpfToKbps(rbdc_alloc_pktpf);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%d: RBDC allocation with FEC %u kb/s",
 		    debug.c_str(), tal_id, rbdc_alloc_kbps);
@@ -595,7 +950,8 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		    debug.c_str(), tal_id, rbdc_alloc_kbps);
 
 		terminal->setRbdcAllocation(rbdc_alloc_kbps);
-		alloc_rate_kbps += rbdc_alloc_kbps;
+		carrier.allocated.push_back(tal_id);
+		carrier.alloc_rate_kbps += rbdc_alloc_kbps;
 
 		// decrease the total capacity
 		remaining_capacity_pktpf -= rbdc_alloc_pktpf;
@@ -609,17 +965,14 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 		{
 			this->probes_st_rbdc_alloc[tal_id]->put(rbdc_alloc_kbps);
 		}
-		rbdc_alloc_symps = this->converter->pktpfToSymps(rbdc_alloc_pktpf);
-		this->carrier_return_remaining_capacity[label][carrier_id] -= rbdc_alloc_symps;
-		this->category_return_remaining_capacity[label] -= rbdc_alloc_symps;
-		this->gw_remaining_capacity -= rbdc_alloc_symps;
+		carrier.used_capacity.push_back(converter->pktpfToSymps(rbdc_alloc_pktpf));
 
 		if(fair_share > 1.0)
 		{
 			// add the decimal part of the fair RBDC
 			double rbdc_credit_kbps = (fair_rbdc_pktpf - rbdc_alloc_pktpf)
-				* this->converter->getPacketBitLength()
-				/ (double)(this->converter->getFrameDuration());
+				* converter->getPacketBitLength()
+				/ (double)(converter->getFrameDuration());
 			rbdc_credit_kbps /= (fmt_def->getCodingRate());
 			terminal->addRbdcCredit(rbdc_credit_kbps);
 
@@ -628,15 +981,14 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 				debug.c_str(), tal_id, rbdc_credit_kbps);
 		}
 	}
-	if(this->simulated)
-	{
-		this->probes_st_rbdc_alloc[0]->put(simu_rbdc);
-	}
+	carrier.simu_put = this->simulated;
+	carrier.simu_alloc = simu_rbdc;
 
 	// second step : RBDC decimal part treatment
 	if(fair_share > 1.0)
 	{
-		// sort terminal according to their remaining credit
+		// sort terminal according to their remaining credit,
+		// the terminals with the same credit are sorted by ID
 		std::stable_sort(tal.begin(), tal.end(),
 		                 TerminalContextDamaRcs::sortByRemainingCredit);
 		for(tal_it = tal.begin(); tal_it != tal.end() && remaining_capacity_pktpf > 0; ++tal_it)
@@ -652,9 +1004,9 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 			{
 				continue;
 			}
-			this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+			converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
-			slot_kbps = fmt_def->removeFec(this->converter->pktpfToKbps(1));
+			slot_kbps = fmt_def->removeFec(converter->pktpfToKbps(1));
 			credit_kbps = terminal->getRbdcCredit();
 			LOG(this->log_run_dama, LEVEL_DEBUG,
 			    "%s step 2 scanning ST%u remaining capacity=%u packet "
@@ -670,22 +1022,18 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 				cra_kbps = terminal->getCraAllocation();
 				rbdc_alloc_kbps = terminal->getRbdcAllocation();
 
-				if(max_rbdc_kbps - rbdc_alloc_kbps - cra_kbps > slot_kbps)
+				if(max_rbdc_kbps > rbdc_alloc_kbps + cra_kbps + slot_kbps)
 				{
-					rate_symps_t slot_symps;
 					// enough capacity to allocate
 					terminal->setRbdcAllocation(rbdc_alloc_kbps + slot_kbps);
-					terminal->addRbdcCredit(-slot_kbps);
-					alloc_rate_kbps += slot_kbps;
+					terminal->addRbdcCredit(-(double)slot_kbps);
+					carrier.alloc_rate_kbps += slot_kbps;
 					remaining_capacity_pktpf--;
 					LOG(this->log_run_dama, LEVEL_DEBUG,
 					    "%s step 2 allocating 1 timeslot to ST%u\n",
 					    debug.c_str(), tal_id);
 					// Update probes and stats
-					slot_symps = this->converter->pktpfToSymps(1);
-					this->carrier_return_remaining_capacity[label][carrier_id] -= slot_symps;
-					this->category_return_remaining_capacity[label] -= slot_symps;
-					this->gw_remaining_capacity -= slot_symps;
+					carrier.used_capacity.push_back(converter->pktpfToSymps(1));
 				}
 			}
 		}
@@ -698,12 +1046,11 @@ void DamaCtrlRcs2Legacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 	carriers->setRemainingCapacity(remaining_capacity_pktpf);
 }
 
-void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
-                                                   const TerminalCategoryDama *category,
-                                                   vol_kb_t &request_vol_kb,
-                                                   vol_kb_t &alloc_vol_kb)
+void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(carrier_dama_t &carrier)
 {
-	vector<TerminalContextDamaRcs *> tal;
+	CarriersGroupDama *carriers = carrier.carriers;
+	UnitConverter *converter = carrier.converter;
+	vector<TerminalContextDamaRcs *> &tal = carrier.requests;
 	TerminalContextDamaRcs *terminal;
 	unsigned int carrier_id = carriers->getCarriersId();
 	rate_pktpf_t remaining_capacity_pktpf;
@@ -711,21 +1058,16 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 	vector<TerminalContextDamaRcs *>::iterator tal_it;
 	int simu_vbdc = 0;
 	ostringstream buf;
-	string label = category->getLabel();
 	string debug;
 
-	request_vol_kb = 0;
-	alloc_vol_kb = 0;
-
 	buf << "SF#" << this->current_superframe_sf << " carrier "
-	    << carrier_id << ", category " << label << ":";
+	    << carrier_id << ", category " << carrier.label << ":";
 	debug = buf.str();
 
 	// Get the remaining capacity in timeslot number (per frame)
 	remaining_capacity_pktpf = carriers->getRemainingCapacity();
-	total_capacity_pktpf = this->converter->symToPkt(carriers->getTotalCapacity());
+	total_capacity_pktpf = converter->symToPkt(carriers->getTotalCapacity());
 
-	tal = category->getTerminalsInCarriersGroup<TerminalContextDamaRcs>(carrier_id);
 	if(remaining_capacity_pktpf == 0)
 	{
 		LOG(this->log_run_dama, LEVEL_NOTICE,
@@ -733,19 +1075,8 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		    "capacity\n", debug.c_str());
 
 		// Output stats and probes
-		for(tal_it = tal.begin(); tal_it != tal.end(); ++tal_it)
-		{
-			terminal = *tal_it;
-			tal_id_t tal_id = terminal->getTerminalId();
-			if(tal_id < BROADCAST_TAL_ID)
-			{
-				this->probes_st_vbdc_alloc[tal_id]->put(0);
-			}
-		}
-		if(this->simulated)
-		{
-			this->probes_st_vbdc_alloc[0]->put(0);
-		}
+		carrier.simu_put = this->simulated;
+		carrier.simu_alloc = 0;
 
 		return;
 	}
@@ -754,28 +1085,22 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 	    "%s remaining capacity = %u packets per superframe before VBDC allocation (total: %u packets)\n",
 	    debug.c_str(), remaining_capacity_pktpf, total_capacity_pktpf);
 
-	// sort terminal according to their VBDC requests
-	std::stable_sort(tal.begin(), tal.end(),
-	                 TerminalContextDamaRcs::sortByVbdcReq);
-	tal_it = tal.begin();
-	if(tal_it == tal.end())
+	// only the terminals with a request were given
+	if(tal.empty())
 	{
 		// no ST
 		return;
 	}
 
 	// try to serve the required VBDC
-	// the setVbdcAllocation functions had updated the VBDC requests
-	// sort terminal according to their new VBDC requests
-	std::stable_sort(tal.begin(), tal.end(),
-	                 TerminalContextDamaRcs::sortByVbdcReq);
+	// the terminals were given by decreasing request,
+	// the terminals with the same request by ID
 	for(tal_it = tal.begin(); tal_it != tal.end() && 0 < remaining_capacity_pktpf; ++tal_it)
 	{
 		vol_kb_t request_kb;
 		vol_pkt_t request_pkt;
 		vol_kb_t alloc_kb;
 		vol_pkt_t alloc_pkt;
-		rate_symps_t alloc_symps;
 		FmtDefinition *fmt_def;
 
 		terminal = *tal_it;
@@ -790,7 +1115,7 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 			}
 			continue;
 		}
-		this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+		converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
 		request_kb = terminal->getRequiredVbdc();
 		LOG(this->log_run_dama, LEVEL_DEBUG,
@@ -802,7 +1127,7 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		    "%s ST%u: VBDC request with FEC %u kb",
 		    debug.c_str(), tal_id, request_kb);
 
-		request_pkt = this->converter->kbitsToPkt(request_kb);
+		request_pkt = converter->kbitsToPkt(request_kb);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%u: VBDC request %u packets",
 		    debug.c_str(), tal_id, request_pkt);
@@ -811,8 +1136,8 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		{
 			continue;
 		}
-		this->gw_vbdc_req_num++;
-		request_vol_kb += request_kb;
+		carrier.requests_number++;
+		carrier.request_vol_kb += request_kb;
 
 		if(request_pkt <= remaining_capacity_pktpf)
 		{
@@ -829,7 +1154,7 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		    debug.c_str(), tal_id, alloc_pkt);
 		remaining_capacity_pktpf -= alloc_pkt;
 
-		alloc_kb = this->converter->pktToKbits(alloc_pkt);
+		alloc_kb = converter->pktToKbits(alloc_pkt);
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%u: VBDC allocation with FEC %u kb",
 		    debug.c_str(), tal_id, alloc_kb);
@@ -840,7 +1165,8 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		    debug.c_str(), tal_id, alloc_kb);
 
 		terminal->setVbdcAllocation(alloc_kb);
-		alloc_vol_kb += alloc_kb;
+		carrier.allocated.push_back(tal_id);
+		carrier.alloc_vol_kb += alloc_kb;
 
 		// Output probes and stats
 		if(tal_id > BROADCAST_TAL_ID)
@@ -851,16 +1177,11 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		{
 			this->probes_st_vbdc_alloc[tal_id]->put(alloc_kb);
 		}
-		alloc_symps = this->converter->pktpfToSymps(alloc_pkt);
-		this->carrier_return_remaining_capacity[label][carrier_id] -= alloc_symps;
-		this->category_return_remaining_capacity[label] -= alloc_symps;
-		this->gw_remaining_capacity -= alloc_symps;
+		carrier.used_capacity.push_back(converter->pktpfToSymps(alloc_pkt));
 	}
 
-	if(this->simulated)
-	{
-		this->probes_st_vbdc_alloc[0]->put(simu_vbdc);
-	}
+	carrier.simu_put = this->simulated;
+	carrier.simu_alloc = simu_vbdc;
 
 	// Check if other terminals required capacity
 	for(; tal_it != tal.end(); ++tal_it)
@@ -870,8 +1191,8 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 		request_kb = terminal->getRequiredVbdc();
 		if(request_kb > 0)
 		{
-			request_vol_kb += request_kb;
-			this->gw_vbdc_req_num++;
+			carrier.request_vol_kb += request_kb;
+			carrier.requests_number++;
 		}
 	}
 
@@ -886,56 +1207,42 @@ void DamaCtrlRcs2Legacy::computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
 //      we try to move some terminals not totally served in supported carriers
 //      (in the same category and with supported MODCOD value) in which there
 //      is still capacity
-void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
-                                                  const TerminalCategoryDama *category,
-                                                  rate_kbps_t &alloc_rate_kbps)
+void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(carrier_dama_t &carrier)
 {
-	vector<TerminalContextDamaRcs *> tal;
+	CarriersGroupDama *carriers = carrier.carriers;
+	UnitConverter *converter = carrier.converter;
+	vector<TerminalContextDamaRcs *> &credited = carrier.requests;
 	TerminalContextDamaRcs *terminal;
 	unsigned int carrier_id = carriers->getCarriersId();
+	const vector<TerminalContextDamaRcs *> &tal = carrier.terminals;
 	rate_pktpf_t remaining_capacity_pktpf;
 	rate_pktpf_t total_capacity_pktpf;
 	rate_pktpf_t fca_pktpf;
 	int simu_fca = 0;
-	vector<TerminalContextDamaRcs *>::iterator tal_it;
+	size_t pos;
 	ostringstream buf;
-	string label = category->getLabel();
 	string debug;
 
-	alloc_rate_kbps = 0;
-
 	buf << "SF#" << this->current_superframe_sf << " carrier "
-	    << carrier_id << ", category " << label << ":";
+	    << carrier_id << ", category " << carrier.label << ":";
 	debug = buf.str();
 
-	tal = category->getTerminalsInCarriersGroup<TerminalContextDamaRcs>(carrier_id);
-	tal_it = tal.begin();
-	if(tal_it == tal.end())
+	// the carrier terminals were listed when they moved
+	if(tal.empty())
 	{
 		// no ST
 		return;
 	}
 
 	remaining_capacity_pktpf = carriers->getRemainingCapacity();
-	total_capacity_pktpf = this->converter->symToPkt(carriers->getTotalCapacity());
+	total_capacity_pktpf = converter->symToPkt(carriers->getTotalCapacity());
 
 	if(remaining_capacity_pktpf <= 0)
 	{
 		// Be careful to use probes only if FCA is enabled
 		// Output probes and stats
-		while(tal_it != tal.end())
-		{
-			tal_id_t tal_id = (*tal_it)->getTerminalId();
-			if(tal_id < BROADCAST_TAL_ID)
-			{
-				this->probes_st_fca_alloc[tal_id]->put(0);
-			}
-			tal_it++;
-		}
-		if(this->simulated)
-		{
-			this->probes_st_fca_alloc[0]->put(0);
-		}
+		carrier.simu_put = this->simulated;
+		carrier.simu_alloc = 0;
 
 		LOG(this->log_run_dama, LEVEL_NOTICE,
 		    "%s skipping FCA dama computaiton. Not enough "
@@ -949,23 +1256,44 @@ void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
 
 	// sort terminal according to their remaining credit
 	// this is a random but logical choice
-	std::stable_sort(tal.begin(), tal.end(),
+	// only the terminals with a RBDC request may have a credit, serve them
+	// first then the other ones in the carrier order
+	credited.erase(std::remove_if(credited.begin(), credited.end(),
+	                              hasNoRbdcCredit),
+	               credited.end());
+	std::stable_sort(credited.begin(), credited.end(),
 	                 TerminalContextDamaRcs::sortByRemainingCredit);
 
-	while(tal_it != tal.end() && 0 < remaining_capacity_pktpf)
+	pos = 0;
+	while(pos < credited.size() + tal.size() && 0 < remaining_capacity_pktpf)
 	{
 		rate_pktpf_t fca_alloc_pktpf;
 		rate_kbps_t fca_alloc_kbps;
 		FmtDefinition *fmt_def;
-		terminal = *tal_it;
+
+		if(pos < credited.size())
+		{
+			terminal = credited[pos];
+		}
+		else
+		{
+			terminal = tal[pos - credited.size()];
+		}
+		pos++;
+		if(pos > credited.size() && terminal->getRbdcCredit() > 0.0)
+		{
+			// already served with the credited terminals
+			continue;
+		}
 		tal_id_t tal_id = terminal->getTerminalId();
 		fmt_def = terminal->getFmt();
 		if(fmt_def == NULL)
 		{
 			continue;
 		}
+		converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
 
-		fca_pktpf = this->converter->kbpsToPktpf(fmt_def->addFec(this->fca_kbps));
+		fca_pktpf = converter->kbpsToPktpf(fmt_def->addFec(this->fca_kbps));
 		if (remaining_capacity_pktpf > fca_pktpf)
 		{
 			fca_alloc_pktpf = fca_pktpf;
@@ -980,12 +1308,13 @@ void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
 		    "%s ST%u: FCA alloc %u packets per superframe",
 		    debug.c_str(), tal_id, fca_alloc_pktpf);
 
-		fca_alloc_kbps = fmt_def->removeFec(this->converter->pktpfToKbps(fca_alloc_pktpf));
+		fca_alloc_kbps = fmt_def->removeFec(converter->pktpfToKbps(fca_alloc_pktpf));
 		LOG(this->log_run_dama, LEVEL_DEBUG,
 		    "%s ST%u: FCA alloc %u kb/s",
 		    debug.c_str(), tal_id, fca_alloc_kbps);
 		terminal->setFcaAllocation(fca_alloc_kbps);
-		alloc_rate_kbps += fca_alloc_kbps;
+		carrier.allocated.push_back(tal_id);
+		carrier.alloc_rate_kbps += fca_alloc_kbps;
 
 		// Output probes and stats
 		if(tal_id > BROADCAST_TAL_ID)
@@ -996,16 +1325,10 @@ void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
 		{
 			this->probes_st_fca_alloc[tal_id]->put(fca_alloc_kbps);
 		}
-		this->carrier_return_remaining_capacity[label][carrier_id] -= fca_alloc_kbps;
-		this->category_return_remaining_capacity[label] -= fca_alloc_kbps;
-		this->gw_remaining_capacity -= fca_alloc_kbps;
-
-		tal_it++;
-	}
-	if(this->simulated)
-	{
-		this->probes_st_fca_alloc[0]->put(simu_fca);
+		carrier.used_capacity.push_back(fca_alloc_kbps);
 	}
+	carrier.simu_put = this->simulated;
+	carrier.simu_alloc = simu_fca;
 
 	LOG(this->log_run_dama, LEVEL_INFO,
 	    "%s remaining capacity = %u packets per superframe after FCA allocation (total: %u packets)\n",
@@ -1013,3 +1336,90 @@ void DamaCtrlRcs2Legacy::computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
 
 	carriers->setRemainingCapacity(remaining_capacity_pktpf);
 }
+
+void DamaCtrlRcs2Legacy::dispatchRbdcRequests()
+{
+	set<tal_id_t>::iterator it = this->rbdc_requests.begin();
+
+	// the terminals are given by increasing ID
+	while(it != this->rbdc_requests.end())
+	{
+		TerminalContextDamaRcs *terminal;
+
+		terminal = (TerminalContextDamaRcs *)this->getTerminalContext(*it);
+		if(terminal == NULL || !hasRbdcRequest(terminal))
+		{
+			// no more request
+			this->rbdc_requests.erase(it++);
+			continue;
+		}
+		this->dispatchTerminal(terminal);
+		++it;
+	}
+}
+
+void DamaCtrlRcs2Legacy::dispatchVbdcRequests()
+{
+	set<vbdc_request_t, ltVbdcRequest>::const_iterator it;
+
+	// the terminals are kept in the allocation order so their carriers
+	// group does not need to sort them
+	for(it = this->vbdc_requests.begin(); it != this->vbdc_requests.end(); ++it)
+	{
+		TerminalContextDamaRcs *terminal;
+
+		terminal = (TerminalContextDamaRcs *)this->getTerminalContext(it->second);
+		if(terminal != NULL)
+		{
+			this->dispatchTerminal(terminal);
+		}
+	}
+}
+
+void DamaCtrlRcs2Legacy::dispatchTerminal(TerminalContextDamaRcs *terminal)
+{
+	map<unsigned int, unsigned int>::const_iterator index_it;
+
+	index_it = this->carriers_index.find(terminal->getCarrierId());
+	if(index_it == this->carriers_index.end())
+	{
+		return;
+	}
+	carrier_dama_t &carrier = this->carriers_dama[index_it->second];
+	if(terminal->getCurrentCategory() == carrier.label)
+	{
+		carrier.requests.push_back(terminal);
+	}
+}
+
+void DamaCtrlRcs2Legacy::updateVbdcRequest(const TerminalContextDamaRcs *terminal)
+{
+	tal_id_t tal_id = terminal->getTerminalId();
+	vol_kb_t request_kb = terminal->getRequiredVbdc();
+	map<tal_id_t, vol_kb_t>::iterator it;
+
+	it = this->vbdc_request_kb.find(tal_id);
+	if(it != this->vbdc_request_kb.end() && it->second == request_kb)
+	{
+		return;
+	}
+	this->removeVbdcRequest(tal_id);
+	if(request_kb > 0)
+	{
+		this->vbdc_request_kb[tal_id] = request_kb;
+		this->vbdc_requests.insert(vbdc_request_t(request_kb, tal_id));
+	}
+}
+
+void DamaCtrlRcs2Legacy::removeVbdcRequest(tal_id_t tal_id)
+{
+	map<tal_id_t, vol_kb_t>::iterator it;
+
+	it = this->vbdc_request_kb.find(tal_id);
+	if(it == this->vbdc_request_kb.end())
+	{
+		return;
+	}
+	this->vbdc_requests.erase(vbdc_request_t(it->second, tal_id));
+	this->vbdc_request_kb.erase(it);
+}
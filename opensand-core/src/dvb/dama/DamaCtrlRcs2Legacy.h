@@ -44,6 +44,16 @@
 #include "CarriersGroup.h"
 #include "TerminalCategoryDama.h"
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
 /**
  *  @class DamaCtrlRcs2Legacy
  *  @brief This library defines the legacy DAMA controller.
@@ -56,6 +66,20 @@ class DamaCtrlRcs2Legacy: public DamaCtrlRcs2
 	DamaCtrlRcs2Legacy(spot_id_t spot);
 	virtual ~DamaCtrlRcs2Legacy();
 
+	// Process DVB frames
+	virtual bool hereIsSAC(const Sac *sac);
+
+	// Apply a PEP command
+	virtual bool applyPepCommand(const PepRequest* request);
+
+ protected:
+
+	/// Remove a terminal context
+	virtual bool removeTerminal(TerminalContextDama **terminal);
+
+	/// Reset the terminals allocations
+	virtual bool resetTerminalsAllocations();
+
  private:
 	
 	/// initialize
@@ -73,56 +97,199 @@ class DamaCtrlRcs2Legacy: public DamaCtrlRcs2
 	/// FCA allocation
 	virtual bool computeTerminalsFcaAllocation();
 
+	/// The allocation passes run per carriers group
+	typedef enum
+	{
+		dama_pass_cra,
+		dama_pass_rbdc,
+		dama_pass_vbdc,
+		dama_pass_fca,
+	} dama_pass_t;
+
+	/**
+	 * @brief The allocation of a carriers group for a pass, computed by
+	 *        one worker. The carriers groups are independent, the values
+	 *        shared with the other ones are only updated once all the
+	 *        carriers groups are done.
+	 */
+	typedef struct
+	{
+		DamaCtrlRcs2Legacy *dama;                  ///< The DAMA controller
+		dama_pass_t pass;                          ///< The current pass
+		CarriersGroupDama *carriers;               ///< The carriers group
+		const TerminalCategoryDama *category;      ///< The category of the carriers
+		string label;                              ///< The category label
+		UnitConverter *converter;                  ///< The converter of the carriers
+		vector<unsigned int> slots;                ///< The store slots of the terminals
+		                                           ///< of the carriers, listed again
+		                                           ///< when terminals move
+		vector<unsigned int> real_slots;           ///< The store slots of the terminals
+		                                           ///< that are not simulated
+		vector<TerminalContextDamaRcs *> terminals; ///< The terminals of the carriers,
+		                                           ///< in the slots order
+		vector<TerminalContextDamaRcs *> requests; ///< The terminals with a request
+		vector<tal_id_t> allocated;                ///< The terminals given RBDC, VBDC
+		                                           ///< or FCA on the superframe
+		bool cra_valid;                            ///< Whether the CRA below can be
+		                                           ///< kept from a superframe to another
+		rate_pktpf_t cra_capacity_pktpf;           ///< The capacity the CRA was
+		                                           ///< allocated from
+		rate_pktpf_t cra_pktpf;                    ///< The capacity taken by CRA
+		rate_kbps_t cra_request_kbps;              ///< The requested CRA (kb/s)
+		rate_kbps_t cra_alloc_kbps;                ///< The allocated CRA (kb/s)
+		int cra_simu_kbps;                         ///< The simulated terminals CRA
+		rate_kbps_t request_rate_kbps;             ///< The requested rate (kb/s)
+		rate_kbps_t alloc_rate_kbps;               ///< The allocated rate (kb/s)
+		vol_kb_t request_vol_kb;                   ///< The requested volume (kb)
+		vol_kb_t alloc_vol_kb;                     ///< The allocated volume (kb)
+		int requests_number;                       ///< The number of requests
+		vector<rate_symps_t> used_capacity;        ///< The capacity taken by each
+		                                           ///< allocation, in order
+		bool simu_put;                             ///< Whether there is a simulated
+		                                           ///< terminals allocation
+		int simu_alloc;                            ///< The simulated terminals
+		                                           ///< allocation
+	} carrier_dama_t;
+
+	/// The VBDC request of a terminal
+	typedef std::pair<vol_kb_t, tal_id_t> vbdc_request_t;
+
+	/// Sort the VBDC requests by decreasing volume, then by increasing ID
+	struct ltVbdcRequest
+	{
+		bool operator()(const vbdc_request_t &r1, const vbdc_request_t &r2) const
+		{
+			if(r1.first != r2.first)
+			{
+				return r1.first > r2.first;
+			}
+			return r1.second < r2.second;
+		}
+	};
+
+	/**
+	 * @brief Prepare the carriers groups for a pass, the carriers groups
+	 *        are listed again by the CRA pass, with the store slots of
+	 *        their terminals if they moved
+	 *
+	 * @param pass  The pass
+	 * @return true on success, false otherwise
+	 */
+	bool prepareCarriers(dama_pass_t pass);
+
+	/**
+	 * @brief Compute the current pass for each carriers group, with the
+	 *        workers if any
+	 */
+	void runCarriers();
+
+	/**
+	 * @brief Compute the current pass of a carriers group
+	 *
+	 * @param arg  The carriers group allocation
+	 */
+	static void computeCarrier(void *arg);
+
+	/**
+	 * @brief Update the shared capacity and probes with the result of a
+	 *        carriers group pass, in the carriers groups order
+	 *
+	 * @param carrier  The carriers group allocation
+	 * @param probes   The per terminal allocation probes of the pass
+	 */
+	void mergeCarrier(const carrier_dama_t &carrier,
+	                  ProbeListPerTerminal &probes);
+
+	/**
+	 * @brief Get the unit converter of a carriers group
+	 *
+	 * @param carrier_id  The carriers group ID
+	 * @return the unit converter, NULL on error
+	 */
+	UnitConverter *getCarrierConverter(unsigned int carrier_id);
+
 	/**
 	 * @brief Compute CRA per carriers group
 	 *
-	 * @param carriers           The carrier group
-	 * @param category           The terminal category containing the carrier
-	 * @param request_rate_kbps  The requested rate in kbit/s
-	 * @param alloc_rate_kbps    The allocated rate in kbit/s
+	 * @param carrier  The carriers group allocation
 	 */
-	void computeDamaCraPerCarrier(CarriersGroupDama *carriers,
-	                              const TerminalCategoryDama *category,
-	                              rate_kbps_t &request_rate_kbps,
-	                              rate_kbps_t &alloc_rate_kbps);
+	void computeDamaCraPerCarrier(carrier_dama_t &carrier);
 
 	/**
 	 * @brief Compute RBDC per carriers group
 	 *
-	 * @param carriers           The carrier group
-	 * @param category           The terminal category containing the carrier
-	 * @param request_rate_kbps  The requested rate in kbit/s
-	 * @param alloc_rate_kbps    The allocated rate in kbit/s
+	 * @param carrier  The carriers group allocation
 	 */
-	void computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
-	                               const TerminalCategoryDama *category,
-	                               rate_kbps_t &request_rate_kbps,
-	                               rate_kbps_t &alloc_rate_kbps);
+	void computeDamaRbdcPerCarrier(carrier_dama_t &carrier);
 
 	/**
 	 * @brief Compute VBDC per carriers group
 	 *
-	 * @param carriers        The carrier group
-	 * @param category        The terminal category containing the carrier
-	 * @param request_vol_kb  The requested volume in kbit
-	 * @param alloc_vol_kb    The allocated volume in kbit
+	 * @param carrier  The carriers group allocation
 	 */
-	void computeDamaVbdcPerCarrier(CarriersGroupDama *carriers,
-	                               const TerminalCategoryDama *category,
-	                               vol_kb_t &request_vol_kb,
-	                               vol_kb_t &alloc_vol_kb);
+	void computeDamaVbdcPerCarrier(carrier_dama_t &carrier);
 
 	/**
 	 * @brief Compute FCA per carriers group
 	 *
-	 * @param carriers           The carrier group
-	 * @param category           The terminal category containing the carrier
-	 * @param alloc_rate_kbps    The allocated rate in kbit/s
+	 * @param carrier  The carriers group allocation
+	 */
+	void computeDamaFcaPerCarrier(carrier_dama_t &carrier);
+
+	/**
+	 * @brief Give the terminals with a pending RBDC request or credit to
+	 *        their carriers group, by increasing ID
+	 *
+	 * Terminals that have no more request are removed from the pending
+	 * requests.
+	 */
+	void dispatchRbdcRequests();
+
+	/**
+	 * @brief Give the terminals with a pending VBDC request to their
+	 *        carriers group, by decreasing request
+	 */
+	void dispatchVbdcRequests();
+
+	/**
+	 * @brief Give a terminal with a pending request to its carriers group
+	 *
+	 * @param terminal  The terminal
+	 */
+	void dispatchTerminal(TerminalContextDamaRcs *terminal);
+
+	/**
+	 * @brief Move a terminal in the VBDC requests after its
+	 *        request changed
+	 *
+	 * @param terminal  The terminal
+	 */
+	void updateVbdcRequest(const TerminalContextDamaRcs *terminal);
+
+	/**
+	 * @brief Remove a terminal from the VBDC requests
+	 *
+	 * @param tal_id  The terminal ID
 	 */
-	void computeDamaFcaPerCarrier(CarriersGroupDama *carriers,
-	                              const TerminalCategoryDama *category,
-	                              rate_kbps_t &alloc_rate_kbps);
+	void removeVbdcRequest(tal_id_t tal_id);
+
+	/// The terminals with a RBDC request or credit
+	set<tal_id_t> rbdc_requests;
+
+	/// The terminals with a VBDC request, in the allocation order
+	set<vbdc_request_t, ltVbdcRequest> vbdc_requests;
+
+	/// The request of each terminal in the VBDC requests
+	map<tal_id_t, vol_kb_t> vbdc_request_kb;
+
+	/// The carriers groups allocations, in the categories order
+	vector<carrier_dama_t> carriers_dama;
+
+	/// The index of each carriers group in the allocations
+	map<unsigned int, unsigned int> carriers_index;
 
+	/// The unit converter of each carriers group
+	map<unsigned int, UnitConverter *> carriers_converter;
 };
 
 #endif
@@ -140,7 +140,14 @@ bool DamaCtrlRcsCommon::hereIsSAC(const Sac *sac)
 
 				// remove the CRA of the RBDC request
 				// the CRA is not taken into acount on ST side
-				request_kbps = max(request_kbps - terminal->getRequiredCra(), 0);
+				if(request_kbps > terminal->getRequiredCra())
+				{
+					request_kbps -= terminal->getRequiredCra();
+				}
+				else
+				{
+					request_kbps = 0;
+				}
 				LOG(this->log_sac, LEVEL_INFO,
 				    "SF#%u: ST%u updated RBDC requests %u kb/s (removing CRA %u kb/s)\n",
 				    this->current_superframe_sf, tal_id, request_kbps, terminal->getRequiredCra());
@@ -376,7 +383,8 @@ bool DamaCtrlRcsCommon::createTerminal(TerminalContextDama **terminal,
 	fmt_id_t fmt_id;
 	TerminalContextDamaRcs *term;
 
-	term = new TerminalContextDamaRcs(tal_id,
+	term = new TerminalContextDamaRcs(&this->terminal_store,
+	                                  tal_id,
 	                                  cra_kbps,
 	                                  max_rbdc_kbps,
 	                                  rbdc_timeout_sf,
@@ -420,46 +428,61 @@ bool DamaCtrlRcsCommon::removeTerminal(TerminalContextDama **terminal)
 bool DamaCtrlRcsCommon::resetTerminalsAllocations()
 {
 	bool ret = true;
-	DamaTerminalList::iterator it;
+	TerminalStoreDama *store = &this->terminal_store;
+	unsigned int size = store->getSize();
+
+	// Reset allocation (in slots)
+	store->resetAllocations();
 
-	for(it = this->terminals.begin(); it != this->terminals.end(); it++)
+	// Update timer
+	store->decrementTimers();
+
+	for(unsigned int slot = 0; slot < size; ++slot)
 	{
-		TerminalContextDamaRcs *terminal = (TerminalContextDamaRcs *)(it->second);
-		double credit_kbps = terminal->getRbdcCredit();
-		rate_kbps_t request_kbps = terminal->getRequiredRbdc();
-
-		// Reset allocation (in slots)
-		terminal->setCraAllocation(0);
-		terminal->setRbdcAllocation(0);
-		terminal->setVbdcAllocation(0);
-		terminal->setFcaAllocation(0);
-
-		// Update timer
-		terminal->decrementTimer();
-		if(0 < terminal->getTimer() && 0.0 < credit_kbps)
+		if(store->getTimer(slot) == 0 || store->getRbdcCredit(slot) <= 0.0)
 		{
-			rate_kbps_t timeslot_kbps;
-			FmtDefinition *fmt_def = terminal->getFmt();
-			if(fmt_def == NULL)
-			{
-				terminal->setRbdcCredit(0.0);
-				ret = false;
-				continue;
-			}
-			this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
-
-			timeslot_kbps = this->converter->pktpfToKbps(1);
-			
-			// Update RBDC request and credit (in kb/s)
-			credit_kbps = max(credit_kbps - timeslot_kbps, 0.0);
-			request_kbps += timeslot_kbps;
+			continue;
+		}
 
-			// Set RBDC request and credit (in kb/s)
-			terminal->setRequiredRbdc(request_kbps);
-			terminal->setRbdcCredit(credit_kbps);
+		if(!this->updateRbdcCredit((TerminalContextDamaRcs *)store->getTerminal(slot)))
+		{
+			ret = false;
 		}
 	}
 
 	return ret;
 }
 
+bool DamaCtrlRcsCommon::updateRbdcCredit(TerminalContextDamaRcs *terminal)
+{
+	double credit_kbps = terminal->getRbdcCredit();
+	rate_kbps_t request_kbps;
+	rate_kbps_t timeslot_kbps;
+	FmtDefinition *fmt_def;
+
+	if(terminal->getTimer() == 0 || credit_kbps <= 0.0)
+	{
+		return true;
+	}
+
+	fmt_def = terminal->getFmt();
+	if(fmt_def == NULL)
+	{
+		terminal->setRbdcCredit(0.0);
+		return false;
+	}
+	this->converter->setModulationEfficiency(fmt_def->getModulationEfficiency());
+
+	timeslot_kbps = this->converter->pktpfToKbps(1);
+
+	// Update RBDC request and credit (in kb/s)
+	credit_kbps = max(credit_kbps - timeslot_kbps, 0.0);
+	request_kbps = terminal->getRequiredRbdc() + timeslot_kbps;
+
+	// Set RBDC request and credit (in kb/s)
+	terminal->setRequiredRbdc(request_kbps);
+	terminal->setRbdcCredit(credit_kbps);
+
+	return true;
+}
+
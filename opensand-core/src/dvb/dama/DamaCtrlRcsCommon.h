@@ -92,6 +92,16 @@ class DamaCtrlRcsCommon: public DamaCtrl
 
 	/// Reset all terminals allocations
 	virtual bool resetTerminalsAllocations();
+
+	/**
+	 * @brief Update the RBDC request and credit of a terminal at the
+	 *        beginning of a superframe, while its RBDC timer runs
+	 *
+	 * @param terminal  The terminal
+	 * @return false if the terminal has a credit but no MODCOD,
+	 *         true otherwise
+	 */
+	bool updateRbdcCredit(TerminalContextDamaRcs *terminal);
 };
 
 
@@ -581,11 +581,11 @@ void DamaCtrlRcsLegacy::computeDamaRbdcPerCarrier(CarriersGroupDama *carriers,
 				rate_kbps_t max_rbdc_kbps;
 				max_rbdc_kbps = terminal->getMaxRbdc();
 				rbdc_alloc_kbps = terminal->getRbdcAllocation();
-				if(max_rbdc_kbps - rbdc_alloc_kbps > slot_kbps)
+				if(max_rbdc_kbps > rbdc_alloc_kbps + slot_kbps)
 				{
 					// enough capacity to allocate
 					terminal->setRbdcAllocation(rbdc_alloc_kbps + slot_kbps);
-					terminal->addRbdcCredit(-slot_kbps);
+					terminal->addRbdcCredit(-(double)slot_kbps);
 					alloc_rate_kbps += slot_kbps;
 					remaining_capacity_pktpf--;
 					LOG(this->log_run_dama, LEVEL_DEBUG,
@@ -0,0 +1,287 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file bench_dama_ctrl.cpp
+ * @brief Measure the superframe processing of the DVB-RCS2 legacy DAMA
+ *        controller with the number of terminals
+ *
+ * The terminals are logged in a congested carrier, then on each superframe
+ * the active ones send RBDC and VBDC requests before the allocations are
+ * computed, as on the NCC. The other terminals stay idle.
+ *
+ * The terminals are spread over several categories, each one with its own
+ * carrier, to measure the carriers computed by several DAMA workers.
+ */
+
+
+#include "DamaCtrlRcs2Legacy.h"
+#include "WorkerPool.h"
+#include "UnitConverterFixedSymbolLength.h"
+#include "TestTimer.h"
+
+#include <opensand_output/Output.h>
+
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <stdint.h>
+
+/// The number of superframes measured for each number of terminals
+#define BENCH_SUPERFRAMES 200
+
+/// The frame duration (ms)
+#define BENCH_FRAME_DURATION 26
+
+/// The burst length (symbols)
+#define BENCH_BURST_LENGTH 536
+
+/// The symbol rate of the carrier for each active terminal (sym/s)
+#define BENCH_SYMBOL_RATE 200E3
+
+/// The percentage of active terminals, sending a SAC on each superframe
+#define BENCH_ACTIVE_RATIO 10
+
+/// The number of DAMA workers, and of categories when they are spread
+#define BENCH_WORKERS 4
+
+
+/**
+ * @class BenchDamaCtrl
+ * @brief The legacy DAMA controller, without the configuration
+ */
+class BenchDamaCtrl: public DamaCtrlRcs2Legacy
+{
+ public:
+
+	BenchDamaCtrl():
+		DamaCtrlRcs2Legacy(1)
+	{
+	};
+
+	/**
+	 * @brief Get the sum of the terminals allocations
+	 *
+	 * @return the allocated rate (kb/s)
+	 */
+	rate_kbps_t getTotalAllocation() const
+	{
+		rate_kbps_t alloc_kbps = 0;
+		DamaTerminalList::const_iterator it;
+
+		for(it = this->terminals.begin(); it != this->terminals.end(); ++it)
+		{
+			alloc_kbps += it->second->getTotalRateAllocation();
+		}
+		return alloc_kbps;
+	};
+
+ protected:
+
+	UnitConverter *generateUnitConverter() const
+	{
+		return new UnitConverterFixedSymbolLength(this->frame_duration_ms,
+		                                          0, BENCH_BURST_LENGTH);
+	};
+};
+
+
+/**
+ * @brief Log terminals in a DAMA controller then measure the superframes
+ *
+ * @param modcod_def         The MODCOD definitions
+ * @param number             The number of terminals
+ * @param categories_number  The number of categories, with one carrier each
+ * @param workers            The DAMA workers
+ * @param duration           OUT: The duration of a superframe (us)
+ * @param alloc_kbps         OUT: The mean allocation on a superframe (kb/s)
+ * @return true on success, false otherwise
+ */
+static bool bench(FmtDefinitionTable *modcod_def, unsigned int number,
+                  unsigned int categories_number, WorkerPool *workers,
+                  double &duration, double &alloc_kbps)
+{
+	TerminalCategories<TerminalCategoryDama> categories;
+	TerminalMapping<TerminalCategoryDama> terminal_affectation;
+	vector<TerminalCategoryDama *> category;
+	FmtGroup *fmt_group;
+	BenchDamaCtrl *dama;
+	unsigned int seed = 42;
+	uint64_t start;
+	uint64_t total = 0;
+	bool ret = false;
+
+	fmt_group = new FmtGroup(1, "7", modcod_def);
+	for(unsigned int i = 0; i < categories_number; i++)
+	{
+		std::ostringstream label;
+
+		label << "Standard" << i;
+		category.push_back(new TerminalCategoryDama(label.str(), DAMA));
+		category[i]->addCarriersGroup(i + 1, fmt_group, 1,
+		                              BENCH_SYMBOL_RATE * number * BENCH_ACTIVE_RATIO / 100 /
+		                              categories_number, DAMA);
+		category[i]->updateCarriersGroups(1, BENCH_FRAME_DURATION);
+		categories[category[i]->getLabel()] = category[i];
+	}
+	// the terminals are spread over the categories
+	for(unsigned int i = 0; i < number; i++)
+	{
+		terminal_affectation[BROADCAST_TAL_ID + 1 + i] = category[i % categories_number];
+	}
+
+	dama = new BenchDamaCtrl();
+	if(!dama->initParent(BENCH_FRAME_DURATION, 16, 10,
+	                     categories, terminal_affectation, category[0],
+	                     NULL, modcod_def, false) ||
+	   !static_cast<DamaCtrlRcsCommon *>(dama)->init())
+	{
+		fprintf(stderr, "cannot initialize the DAMA controller\n");
+		goto release;
+	}
+	dama->setWorkers(workers);
+
+	// simulated terminals, without probes
+	for(unsigned int i = 0; i < number; i++)
+	{
+		LogonRequest logon(BROADCAST_TAL_ID + 1 + i, 10, 2048, 1000);
+		if(!dama->hereIsLogon(&logon))
+		{
+			fprintf(stderr, "cannot log terminal %u\n", i);
+			goto release;
+		}
+	}
+
+	duration = 0.0;
+	alloc_kbps = 0.0;
+	for(time_sf_t sf = 1; sf <= BENCH_SUPERFRAMES; sf++)
+	{
+		for(unsigned int i = 0; i < number * BENCH_ACTIVE_RATIO / 100; i++)
+		{
+			Sac sac(BROADCAST_TAL_ID + 1 + i);
+			sac.addRequest(0, access_dama_rbdc, rand_r(&seed) % 1024);
+			sac.addRequest(0, access_dama_vbdc, rand_r(&seed) % 128);
+			if(!dama->hereIsSAC(&sac))
+			{
+				fprintf(stderr, "cannot handle SAC\n");
+				goto release;
+			}
+		}
+
+		start = getNanoseconds();
+		dama->runOnSuperFrameChange(sf);
+		total += getNanoseconds() - start;
+		alloc_kbps += dama->getTotalAllocation();
+	}
+	duration = (double)total / BENCH_SUPERFRAMES / 1000;
+	alloc_kbps /= BENCH_SUPERFRAMES;
+	ret = true;
+
+release:
+	// the categories are released by the controller
+	delete dama;
+	delete fmt_group;
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int sizes[] = {100, 1000, 10000};
+	unsigned int categories_numbers[] = {1, BENCH_WORKERS};
+	WorkerPool single_worker;
+	WorkerPool workers;
+	char modcod_file[] = "/tmp/bench_dama_ctrl_XXXXXX";
+	FmtDefinitionTable *modcod_def;
+	int is_failure = 0;
+	FILE *file;
+	int fd;
+
+	Output::init(false);
+	Sac::sac_log = Output::registerLog(LEVEL_WARNING, "Dvb.SAC");
+	Ttp::ttp_log = Output::registerLog(LEVEL_WARNING, "Dvb.TTP");
+	if(!workers.start(BENCH_WORKERS,
+	                  Output::registerLog(LEVEL_WARNING, "Dvb.DamaWorkers")))
+	{
+		fprintf(stderr, "cannot start the DAMA workers\n");
+		return 1;
+	}
+	modcod_def = new FmtDefinitionTable();
+
+	// a single QPSK 5/6 MODCOD
+	fd = mkstemp(modcod_file);
+	if(fd < 0 || (file = fdopen(fd, "w")) == NULL)
+	{
+		fprintf(stderr, "cannot create the MODCOD definition file\n");
+		delete modcod_def;
+		return 1;
+	}
+	fprintf(file, "nb_fmt = 1\n7 QPSK 5/6 1.60 6.68 %u\n",
+	        BENCH_BURST_LENGTH);
+	fclose(file);
+	if(!modcod_def->load(modcod_file, BENCH_BURST_LENGTH))
+	{
+		fprintf(stderr, "cannot load the MODCOD definition file\n");
+		unlink(modcod_file);
+		delete modcod_def;
+		return 1;
+	}
+	unlink(modcod_file);
+
+	printf("%10s %10s %10s %15s %15s\n", "terminals", "categories",
+	       "workers", "superframe (us)", "alloc (kb/s)");
+	for(unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		for(unsigned int j = 0;
+		    j < sizeof(categories_numbers) / sizeof(categories_numbers[0]);
+		    j++)
+		{
+			WorkerPool *pools[] = {&single_worker, &workers};
+
+			// the allocations should not depend on the number of workers
+			for(unsigned int k = 0; k < sizeof(pools) / sizeof(pools[0]); k++)
+			{
+				double duration;
+				double alloc_kbps;
+
+				if(!bench(modcod_def, sizes[i], categories_numbers[j], pools[k],
+				          duration, alloc_kbps))
+				{
+					is_failure = 1;
+					continue;
+				}
+				printf("%10u %10u %10u %15.1f %15.0f\n", sizes[i],
+				       categories_numbers[j], pools[k]->getWorkersNumber(),
+				       duration, alloc_kbps);
+			}
+		}
+	}
+	delete modcod_def;
+
+	return is_failure;
+}
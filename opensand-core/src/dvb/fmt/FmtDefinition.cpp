@@ -244,7 +244,7 @@ unsigned int FmtDefinition::addFec(unsigned int length) const
 /* remove FEC to data length */
 unsigned int FmtDefinition::removeFec(unsigned int length) const
 {
-	return ceil(length * this->coding_rate);
+	return ceil(length * (double)this->coding_rate);
 }
 
 void FmtDefinition::print(void) const
@@ -109,7 +109,7 @@ bool BBFrame::addPacket(NetPacket *packet)
 void BBFrame::empty(void)
 {
 	// remove the payload
-	this->data.erase(sizeof(T_DVB_BBFRAME));
+	this->data.trim(this->data.length() - sizeof(T_DVB_BBFRAME));
 	this->num_packets = 0;
 
 	// update the BB frame header
@@ -117,17 +117,35 @@ class DvbFrameTpl: public NetContainer
 		this->header_length = sizeof(T);
 	};
 
+	/**
+	 * Build a DVB frame sharing the content of a buffer
+	 *
+	 * @param buffer  the buffer from which a DVB frame can be created
+	 */
+	DvbFrameTpl(const PacketBuffer &buffer):
+		NetContainer(buffer),
+		max_size(sizeof(T)),
+		num_packets(0),
+		carrier_id(0)
+	{
+		this->name = "DvbFrame";
+		this->trailer_length = this->getTotalLength() - this->getMessageLength();
+		this->header_length = sizeof(T);
+	};
+
 	/**
 	 * Duplicate a DVB frame
 	 *
 	 * @param frame  the DVB frame to duplicate
 	 */
 	DvbFrameTpl(DvbFrameTpl<> *frame):
-		NetContainer(frame->getData()),
+		NetContainer(frame->getBuffer()),
 		max_size(frame->getMaxSize()),
 		carrier_id(frame->getCarrierId())
 	{
 		this->name = frame->getName();
+		// this also gets a storage that is not shared with the
+		// duplicated frame, as the headers are written in place
 		this->data.reserve(this->max_size);
 		this->trailer_length = this->getTotalLength() - this->getMessageLength();
 		this->header_length = sizeof(T);
@@ -294,7 +312,7 @@ class DvbFrameTpl: public NetContainer
 			return false;
 		}
 
-		this->data.append(packet->getData());
+		this->data.append(packet->getBuffer());
 		this->num_packets++;
 
 		return true;
@@ -323,8 +341,7 @@ class DvbFrameTpl: public NetContainer
 	double getCn(void) const
 	{
 		size_t msg_length = this->getMessageLength();
-		Data phy_data = this->getData(msg_length);
-		T_DVB_PHY *phy = (T_DVB_PHY *)(phy_data.c_str());
+		T_DVB_PHY *phy = (T_DVB_PHY *)(this->data.data() + msg_length);
 		return ncntoh(phy->cn_previous);
 	};
 
@@ -345,17 +362,25 @@ class DvbFrameTpl: public NetContainer
 		else
 		{
 			size_t msg_length = this->getMessageLength();
-			this->data.replace(msg_length, this->trailer_length,
-			                   (unsigned char *)(&phy), this->trailer_length);
+			memcpy(this->data.writableData() + msg_length,
+			       &phy, this->trailer_length);
 		}
 	};
 
 	/**
 	 * @brief Accessor on the frame data
 	 */
-	T *frame(void) const
+	T *frame(void)
+	{
+		return (T *)this->data.writableData();
+	}
+
+	/**
+	 * @brief Accessor on the frame data
+	 */
+	const T *frame(void) const
 	{
-		return (T *)this->data.c_str();
+		return (const T *)this->data.data();
 	}
 
 	// Overloaded cast
@@ -103,7 +103,7 @@ bool DvbRcsFrame::addPacket(NetPacket *packet)
 void DvbRcsFrame::empty(void)
 {
 	// remove the payload
-	this->data.erase(sizeof(T_DVB_ENCAP_BURST));
+	this->data.trim(this->data.length() - sizeof(T_DVB_ENCAP_BURST));
 	this->num_packets = 0;
 
 	// update the DVB-RCS frame header
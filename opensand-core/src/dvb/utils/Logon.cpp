@@ -46,9 +46,9 @@ LogonRequest::LogonRequest(tal_id_t mac,
 	this->setMessageType(MSG_TYPE_SESSION_LOGON_REQ);
 	this->setMessageLength(sizeof(T_DVB_LOGON_REQ));
 	this->frame()->mac = htons(mac);
-	this->frame()->rt_bandwidth = htons(rt_bandwidth);
-	this->frame()->max_rbdc = htons(max_rbdc);
-	this->frame()->max_vbdc = htons(max_vbdc);
+	this->frame()->rt_bandwidth = htonl(rt_bandwidth);
+	this->frame()->max_rbdc = htonl(max_rbdc);
+	this->frame()->max_vbdc = htonl(max_vbdc);
 	this->frame()->is_scpc = false;
 }
 
@@ -62,9 +62,9 @@ LogonRequest::LogonRequest(tal_id_t mac,
 	this->setMessageType(MSG_TYPE_SESSION_LOGON_REQ);
 	this->setMessageLength(sizeof(T_DVB_LOGON_REQ));
 	this->frame()->mac = htons(mac);
-	this->frame()->rt_bandwidth = htons(rt_bandwidth);
-	this->frame()->max_rbdc = htons(max_rbdc);
-	this->frame()->max_vbdc = htons(max_vbdc);
+	this->frame()->rt_bandwidth = htonl(rt_bandwidth);
+	this->frame()->max_rbdc = htonl(max_rbdc);
+	this->frame()->max_vbdc = htonl(max_vbdc);
 	this->frame()->is_scpc = is_scpc;
 }
 
@@ -84,17 +84,17 @@ tal_id_t LogonRequest::getMac(void) const
 
 rate_kbps_t LogonRequest::getRtBandwidth(void) const
 {
-	return ntohs(this->frame()->rt_bandwidth);
+	return ntohl(this->frame()->rt_bandwidth);
 }
 
 rate_kbps_t LogonRequest::getMaxRbdc(void) const
 {
-	return ntohs(this->frame()->max_rbdc);
+	return ntohl(this->frame()->max_rbdc);
 }
 
 rate_kbps_t LogonRequest::getMaxVbdc(void) const
 {
-	return ntohs(this->frame()->max_vbdc);
+	return ntohl(this->frame()->max_vbdc);
 }
 
 bool LogonRequest::getIsScpc(void) const
@@ -33,6 +33,33 @@
 
 
 #include "MacFifoElement.h"
+#include "ObjectPool.h"
+
+
+/// The maximum size of the elements allocated in pool
+#define FIFO_ELEMENT_POOL_SIZE (sizeof(MacFifoElement))
+
+
+/**
+ * @brief Get the elements pool, created on first use
+ *
+ * @return the elements pool
+ */
+static ObjectPool &getPool(void)
+{
+	static ObjectPool pool("MacFifoElement", FIFO_ELEMENT_POOL_SIZE);
+	return pool;
+}
+
+void *MacFifoElement::operator new(size_t size)
+{
+	return getPool().allocate(size);
+}
+
+void MacFifoElement::operator delete(void *p)
+{
+	ObjectPool::release(p);
+}
 
 MacFifoElement::MacFifoElement(NetContainer *elem,
                                time_t tick_in, time_t tick_out):
@@ -69,6 +69,21 @@ class MacFifoElement
 	 */
 	~MacFifoElement();
 
+	/**
+	 * Allocate an element in the elements pool
+	 *
+	 * @param size  The element size
+	 * @return the element memory
+	 */
+	void *operator new(size_t size);
+
+	/**
+	 * Release an element in the elements pool
+	 *
+	 * @param p  The element memory
+	 */
+	void operator delete(void *p);
+
 	/**
 	 * Get the FIFO elelement
 	 * @return The FIFO element
@@ -43,15 +43,18 @@
 #define DVB_CR_RBDC_GRANULARITY             2
 #define DVB_CR_RBDC_SCALING_FACTOR         16
 #define DVB_CR_RBDC_SCALING_FACTOR2        32
+#define DVB_CR_RBDC_SCALING_FACTOR3      2048
 #define DVB_CR_VBDC_SCALING_FACTOR         16
+#define DVB_CR_VBDC_SCALING_FACTOR2       256
+#define DVB_CR_VBDC_SCALING_FACTOR3      4096
 #define DVB_CR_VBDC_SCALING_FACTOR_OFFSET 255
 #define DVB_CR_RBDC_SCALING_FACTOR_OFFSET 510
 
 OutputLog *Sac::sac_log = NULL;
 
 static void getScaleAndValue(cr_info_t cr_info, uint8_t &scale, uint8_t &value);
-static uint8_t getEncodedRequestValue(uint16_t value, unsigned int step);
-static uint16_t getDecodedCrValue(const emu_cr_t &cr);
+static uint8_t getEncodedRequestValue(uint32_t value, unsigned int step);
+static uint32_t getDecodedCrValue(const emu_cr_t &cr);
 
 Sac::Sac(tal_id_t tal_id, group_id_t group_id):
 	DvbFrameTpl<T_DVB_SAC>(),
@@ -162,12 +165,26 @@ static void getScaleAndValue(cr_info_t cr_info, uint8_t &scale, uint8_t &value)
 				value = cr_info.value;
 				scale = 0;
 			}
-			else
+			else if(cr_info.value <= DVB_CR_VBDC_SCALING_FACTOR_OFFSET *
+			                         DVB_CR_VBDC_SCALING_FACTOR)
 			{
 				value = getEncodedRequestValue(cr_info.value,
 				                               DVB_CR_VBDC_SCALING_FACTOR);
 				scale = 1;
 			}
+			else if(cr_info.value <= DVB_CR_VBDC_SCALING_FACTOR_OFFSET *
+			                         DVB_CR_VBDC_SCALING_FACTOR2)
+			{
+				value = getEncodedRequestValue(cr_info.value,
+				                               DVB_CR_VBDC_SCALING_FACTOR2);
+				scale = 2;
+			}
+			else
+			{
+				value = getEncodedRequestValue(cr_info.value,
+				                               DVB_CR_VBDC_SCALING_FACTOR3);
+				scale = 3;
+			}
 			break;
 
 		case access_dama_rbdc:
@@ -185,13 +202,21 @@ static void getScaleAndValue(cr_info_t cr_info, uint8_t &scale, uint8_t &value)
 				                               DVB_CR_RBDC_SCALING_FACTOR);
 				scale = 1;
 			}
-			else
+			else if(cr_info.value <= DVB_CR_RBDC_SCALING_FACTOR_OFFSET *
+			                         DVB_CR_RBDC_SCALING_FACTOR2)
 			{
 				value = getEncodedRequestValue(cr_info.value,
 				                               DVB_CR_RBDC_GRANULARITY *
 				                               DVB_CR_RBDC_SCALING_FACTOR2);
 				scale = 2;
 			}
+			else
+			{
+				value = getEncodedRequestValue(cr_info.value,
+				                               DVB_CR_RBDC_GRANULARITY *
+				                               DVB_CR_RBDC_SCALING_FACTOR3);
+				scale = 3;
+			}
 			break;
 	}
 }
@@ -201,28 +226,28 @@ static void getScaleAndValue(cr_info_t cr_info, uint8_t &scale, uint8_t &value)
  *
  * @param value the request value
  * @param the step for encaoded value computation
- * @return the encoded value
+ * @return the encoded value, saturated to the largest one
  */
-static uint8_t getEncodedRequestValue(uint16_t value, unsigned int step)
+static uint8_t getEncodedRequestValue(uint32_t value, unsigned int step)
 {
-	uint8_t div_quot;
-	uint8_t div_rem;
+	uint32_t div_quot;
+	uint32_t div_rem;
 
 	/* compute quotient and reminder of integer division */
 	div_quot = value / step;
 	div_rem = value % step;
 
-	/* approximate to the nearest value : */
-	/* previous value */
-	if(div_rem < (step / 2))
+	/* approximate to the nearest value */
+	if(div_rem >= (step / 2))
 	{
-		return div_quot;
+		div_quot++;
 	}
-	/* or next value */
-	else
+	/* the request cannot be larger than the largest encoded value */
+	if(div_quot > 0xff)
 	{
-		return div_quot + 1;
+		return 0xff;
 	}
+	return div_quot;
 };
 
 /**
@@ -232,17 +257,21 @@ static uint8_t getEncodedRequestValue(uint16_t value, unsigned int step)
  * @param cr the emulated capacity request
  * @return the capacity request value
  */
-static uint16_t getDecodedCrValue(const emu_cr_t &cr)
+static uint32_t getDecodedCrValue(const emu_cr_t &cr)
 {
-	uint16_t request = 0;
+	uint32_t request = 0;
 
 	switch(cr.type)
 	{
 		case access_dama_vbdc:
 			if(cr.scale == 0)
 				request = cr.value;
-			else
+			else if(cr.scale == 1)
 				request = cr.value * DVB_CR_VBDC_SCALING_FACTOR;
+			else if(cr.scale == 2)
+				request = cr.value * DVB_CR_VBDC_SCALING_FACTOR2;
+			else
+				request = cr.value * DVB_CR_VBDC_SCALING_FACTOR3;
 			break;
 
 		case access_dama_rbdc:
@@ -251,9 +280,12 @@ static uint16_t getDecodedCrValue(const emu_cr_t &cr)
 			else if(cr.scale == 1)
 				request = cr.value * DVB_CR_RBDC_GRANULARITY
 				                   * DVB_CR_RBDC_SCALING_FACTOR;
-			else
+			else if(cr.scale == 2)
 				request = cr.value * DVB_CR_RBDC_GRANULARITY
 				                   * DVB_CR_RBDC_SCALING_FACTOR2;
+			else
+				request = cr.value * DVB_CR_RBDC_GRANULARITY
+				                   * DVB_CR_RBDC_SCALING_FACTOR3;
 			break;
 	}
 
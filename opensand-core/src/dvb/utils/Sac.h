@@ -77,6 +77,8 @@ typedef struct
 	                   //   below (should be as small as possible):
 	                   //   for DVB-RCS: 00 => 1
 	                   //   01 => 16
+	                   //   the two other scales are only used by the
+	                   //   emulation for rates above 16 Mb/s
 	uint8_t value;     ///< The request value
 	                   //   (the final requeted rate will be scale * value)
 #elif __BYTE_ORDER == __LITTLE_ENDIAN
@@ -85,6 +87,8 @@ typedef struct
 	                   //   below (should be as small as possible):
 	                   //   for DVB-RCS: 00 => 1
 	                   //   01 => 16
+	                   //   the two other scales are only used by the
+	                   //   emulation for rates above 16 Mb/s
 	uint8_t type:4;    ///< The CR type
 	                   //   for DVB-RCS: 00 => VBDC
 	                   //                01 => RBDC
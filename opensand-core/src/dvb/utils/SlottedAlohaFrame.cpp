@@ -115,7 +115,7 @@ bool SlottedAlohaFrame::addPacket(NetPacket *packet)
 void SlottedAlohaFrame::empty()
 {
 	// remove the payload
-	this->data.erase(sizeof(T_DVB_SALOHA));
+	this->data.trim(this->data.length() - sizeof(T_DVB_SALOHA));
 	this->num_packets = 0;
 
 	// update the DVB-RCS frame header
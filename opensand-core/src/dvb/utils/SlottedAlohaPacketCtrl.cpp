@@ -36,6 +36,7 @@
 
 #include "SlottedAlohaPacketCtrl.h"
 
+#include <string.h>
 #include <arpa/inet.h>
 
 
@@ -51,7 +52,8 @@ SlottedAlohaPacketCtrl::SlottedAlohaPacketCtrl(const Data &data,
 	header.type = ctrl_type;
 	header.tal_id = htons(tal_id);
 	header.total_length = htons(this->header_length + this->data.length());
-	this->data.insert(0, (unsigned char*)&header, this->header_length);
+	memcpy(this->data.prepend(this->header_length), &header,
+	       this->header_length);
 }
 
 SlottedAlohaPacketCtrl::SlottedAlohaPacketCtrl(const unsigned char *data,
@@ -70,7 +72,7 @@ uint8_t SlottedAlohaPacketCtrl::getCtrlType() const
 {
 	saloha_ctrl_hdr_t *header;
 	
-	header = (saloha_ctrl_hdr_t *)this->data.c_str();
+	header = (saloha_ctrl_hdr_t *)this->data.data();
 	return header->type;
 }
 
@@ -78,14 +80,15 @@ uint16_t SlottedAlohaPacketCtrl::getTerminalId() const
 {
 	saloha_ctrl_hdr_t *header;
 	
-	header = (saloha_ctrl_hdr_t *)this->data.c_str();
+	header = (saloha_ctrl_hdr_t *)this->data.data();
 	return (ntohs)(header->tal_id);
 }
 
 saloha_id_t SlottedAlohaPacketCtrl::getId() const
 {
-	return this->data.substr(sizeof(saloha_ctrl_hdr_t),
-	                         this->getTotalLength() - sizeof(saloha_ctrl_hdr_t));
+	return this->data.slice(sizeof(saloha_ctrl_hdr_t),
+	                        this->getTotalLength() -
+	                        sizeof(saloha_ctrl_hdr_t)).toData();
 }
 
 saloha_id_t SlottedAlohaPacketCtrl::getUniqueId(void) const
@@ -97,7 +100,7 @@ size_t SlottedAlohaPacketCtrl::getTotalLength() const
 {
 	saloha_ctrl_hdr_t *header;
 	
-	header = (saloha_ctrl_hdr_t *)this->data.c_str();
+	header = (saloha_ctrl_hdr_t *)this->data.data();
 	return ntohs(header->total_length);
 }
 
@@ -67,11 +67,12 @@ SlottedAlohaPacketData::SlottedAlohaPacketData(const Data &data,
 	tmp_head.seq = htons(seq);
 	tmp_head.pdu_nb = htons(pdu_nb);
 	tmp_head.nb_replicas = 0;
-	this->data.insert(0, (unsigned char *)&tmp_head, this->header_length);
+	memcpy(this->data.prepend(this->header_length), &tmp_head,
+	       this->header_length);
 
 	this->setReplicas(NULL, nb_replicas);
 	this->header_length = sizeof(saloha_data_hdr_t) + nb_replicas * sizeof(uint16_t);
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.writableData();
 	header->total_length = htons(this->data.length());
 }
 
@@ -90,7 +91,7 @@ saloha_pdu_id_t SlottedAlohaPacketData::getId() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	// if uint64_t
 	//return be64toh(header->id);
 	// if uint32_t
@@ -101,7 +102,7 @@ uint16_t SlottedAlohaPacketData::getTs() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return ntohs(header->ts);
 }
 
@@ -109,7 +110,7 @@ uint16_t SlottedAlohaPacketData::getSeq() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return ntohs(header->seq);
 }
 
@@ -117,7 +118,7 @@ uint16_t SlottedAlohaPacketData::getPduNb() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return ntohs(header->pdu_nb);
 }
 
@@ -135,7 +136,7 @@ uint16_t SlottedAlohaPacketData::getNbReplicas() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return ntohs(header->nb_replicas);
 }
 
@@ -153,7 +154,7 @@ uint16_t SlottedAlohaPacketData::getReplica(uint16_t pos) const
 	{
 		return 0;
 	}
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	replicas = header->replicas;
 	return ntohs(replicas[pos]);
 }
@@ -162,7 +163,7 @@ uint8_t SlottedAlohaPacketData::getQos() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return header->qos;
 }
 
@@ -170,7 +171,7 @@ void SlottedAlohaPacketData::setTs(uint16_t ts)
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.writableData();
 	header->ts = htons(ts);
 }
 
@@ -188,19 +189,23 @@ void SlottedAlohaPacketData::setReplicas(uint16_t *replicas, size_t nb_replicas)
 	if(this->getNbReplicas() < nb_replicas)
 	{
 		size_t diff = (nb_replicas - this->getNbReplicas()) * sizeof(uint16_t);
-		std::string zero(diff, 0);
-		this->data.insert(this->header_length,
-		                  (unsigned char *)zero.c_str(),
-		                  diff);
+		// move the header in the room before it
+		unsigned char *start = this->data.prepend(diff);
+		memmove(start, start + diff, this->header_length);
+		memset(start + this->header_length, 0, diff);
 	}
 	if(this->getNbReplicas() > nb_replicas)
 	{
 		size_t diff = (this->getNbReplicas() - nb_replicas) * sizeof(uint16_t);
-		this->data.erase(this->header_length,
-		                 diff * sizeof(uint16_t));
+		size_t erased = std::min(diff * sizeof(uint16_t),
+		                         this->data.length() - this->header_length);
+		// move the header over the removed replicas
+		unsigned char *start = this->data.writableData();
+		memmove(start + erased, start, this->header_length);
+		this->data.strip(erased);
 	}
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.writableData();
 	header->nb_replicas = htons(nb_replicas);
 	if(!replicas)
 	{
@@ -242,7 +247,7 @@ size_t SlottedAlohaPacketData::getTotalLength() const
 {
 	saloha_data_hdr_t *header;
 
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.data();
 	return ntohs(header->total_length);
 }
 
@@ -256,15 +261,15 @@ void SlottedAlohaPacketData::setQos(qos_t qos)
 	saloha_data_hdr_t *header;
 
 	NetPacket::setQos(qos);
-	header = (saloha_data_hdr_t *)this->data.c_str();
+	header = (saloha_data_hdr_t *)this->data.writableData();
 	header->qos = qos;
 }
 
 Data SlottedAlohaPacketData::getPayload() const
 {
-	return this->data.substr(sizeof(saloha_data_hdr_t) +
-	                         this->getReplicasLength(),
-	                         this->getPayloadLength());
+	return this->data.slice(sizeof(saloha_data_hdr_t) +
+	                        this->getReplicasLength(),
+	                        this->getPayloadLength()).toData();
 }
 
 size_t SlottedAlohaPacketData::getPacketLength(const Data &data)
@@ -0,0 +1,242 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file    SuperframeBudget.cpp
+ * @brief   The processing time of the superframes on the NCC
+ */
+
+#include "SuperframeBudget.h"
+
+#include <cstdio>
+
+
+/// The names of the phases in the probes and logs, then the total
+static const char *sf_phase_names[SF_PHASES_NUMBER + 1] =
+{
+	"SAC",
+	"DAMA",
+	"Fwd_scheduling",
+	"TTP_build",
+	"Send",
+	"Total",
+};
+
+/// The percentiles exported as probes
+static const unsigned int sf_percentiles[SF_PERCENTILES_NUMBER] =
+{
+	50,
+	99,
+};
+
+/// The bound of the first histogram bucket (us)
+#define SF_HISTOGRAM_FIRST_BOUND 32
+
+
+SuperframeBudget::SuperframeBudget():
+	frame_duration_ns(0),
+	overruns(0),
+	log(NULL),
+	probe_total(NULL),
+	probe_overruns(NULL)
+{
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER + 1; phase++)
+	{
+		for(unsigned int bucket = 0; bucket < SF_HISTOGRAM_BUCKETS; bucket++)
+		{
+			this->histograms[phase][bucket] = 0;
+		}
+		for(unsigned int rank = 0; rank < SF_PERCENTILES_NUMBER; rank++)
+		{
+			this->probe_percentiles[phase][rank] = NULL;
+		}
+	}
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER; phase++)
+	{
+		this->durations_ns[phase] = 0;
+		this->slowest_overruns[phase] = 0;
+		this->probe_slowest_overruns[phase] = NULL;
+	}
+}
+
+SuperframeBudget::~SuperframeBudget()
+{
+}
+
+void SuperframeBudget::init(time_ms_t frame_duration_ms, OutputLog *log)
+{
+	char probe_name[128];
+
+	this->frame_duration_ns = (uint64_t)frame_duration_ms * 1000000;
+	this->log = log;
+
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER + 1; phase++)
+	{
+		for(unsigned int rank = 0; rank < SF_PERCENTILES_NUMBER; rank++)
+		{
+			snprintf(probe_name, sizeof(probe_name),
+			         "Perf.Superframe.%s.P%u",
+			         sf_phase_names[phase], sf_percentiles[rank]);
+			this->probe_percentiles[phase][rank] =
+				Output::registerProbe<int>(probe_name, "us",
+				                           true, SAMPLE_LAST);
+		}
+	}
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER; phase++)
+	{
+		snprintf(probe_name, sizeof(probe_name),
+		         "Perf.Superframe.Overruns.%s", sf_phase_names[phase]);
+		this->probe_slowest_overruns[phase] =
+			Output::registerProbe<int>(probe_name, "superframes",
+			                           true, SAMPLE_LAST);
+	}
+	this->probe_total = Output::registerProbe<int>("Perf.Superframe.Duration",
+	                                               "us", true, SAMPLE_MAX);
+	this->probe_overruns = Output::registerProbe<int>("Perf.Superframe.Overruns.Total",
+	                                                  "superframes", true,
+	                                                  SAMPLE_LAST);
+}
+
+void SuperframeBudget::closeSuperframe(time_sf_t superframe_sf)
+{
+	uint64_t total_ns = 0;
+	unsigned int slowest = 0;
+	unsigned int bucket;
+
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER; phase++)
+	{
+		bucket = getBucket(this->durations_ns[phase]);
+		this->histograms[phase][bucket]++;
+
+		total_ns += this->durations_ns[phase];
+		if(this->durations_ns[phase] > this->durations_ns[slowest])
+		{
+			slowest = phase;
+		}
+	}
+	bucket = getBucket(total_ns);
+	this->histograms[SF_PHASES_NUMBER][bucket]++;
+	if(this->probe_total)
+	{
+		this->probe_total->put(total_ns / 1000);
+		for(unsigned int phase = 0; phase < SF_PHASES_NUMBER + 1; phase++)
+		{
+			for(unsigned int rank = 0; rank < SF_PERCENTILES_NUMBER; rank++)
+			{
+				this->probe_percentiles[phase][rank]->put(
+					this->getPercentile(phase, sf_percentiles[rank]));
+			}
+		}
+	}
+
+	if(this->frame_duration_ns > 0 && total_ns > this->frame_duration_ns)
+	{
+		this->overruns++;
+		this->slowest_overruns[slowest]++;
+		LOG(this->log, LEVEL_NOTICE,
+		    "SF#%u: processing took %lu us, more than the frame duration "
+		    "(%lu us), slowest phase %s with %lu us\n", superframe_sf,
+		    (unsigned long)(total_ns / 1000),
+		    (unsigned long)(this->frame_duration_ns / 1000),
+		    sf_phase_names[slowest],
+		    (unsigned long)(this->durations_ns[slowest] / 1000));
+		if(this->probe_overruns)
+		{
+			this->probe_overruns->put(this->overruns);
+			this->probe_slowest_overruns[slowest]->put(this->slowest_overruns[slowest]);
+		}
+	}
+
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER; phase++)
+	{
+		this->durations_ns[phase] = 0;
+	}
+}
+
+unsigned int SuperframeBudget::getOverruns(void) const
+{
+	return this->overruns;
+}
+
+unsigned int SuperframeBudget::getSlowestOverruns(sf_phase_t phase) const
+{
+	return this->slowest_overruns[phase];
+}
+
+unsigned int SuperframeBudget::getHistogram(unsigned int phase,
+                                            unsigned int bucket) const
+{
+	return this->histograms[phase][bucket];
+}
+
+unsigned int SuperframeBudget::getPercentile(unsigned int phase,
+                                             unsigned int percent) const
+{
+	unsigned int count = 0;
+	unsigned int rank;
+	unsigned int bucket;
+
+	for(bucket = 0; bucket < SF_HISTOGRAM_BUCKETS; bucket++)
+	{
+		count += this->histograms[phase][bucket];
+	}
+	if(count == 0)
+	{
+		return 0;
+	}
+
+	// the rank of the percentile, rounded up
+	rank = ((uint64_t)count * percent + 99) / 100;
+	count = 0;
+	for(bucket = 0; bucket < SF_HISTOGRAM_BUCKETS - 1; bucket++)
+	{
+		count += this->histograms[phase][bucket];
+		if(count >= rank)
+		{
+			break;
+		}
+	}
+	if(bucket == SF_HISTOGRAM_BUCKETS - 1)
+	{
+		return SF_HISTOGRAM_FIRST_BOUND << (SF_HISTOGRAM_BUCKETS - 2);
+	}
+	return SF_HISTOGRAM_FIRST_BOUND << bucket;
+}
+
+unsigned int SuperframeBudget::getBucket(uint64_t duration_ns)
+{
+	uint64_t bound_ns = SF_HISTOGRAM_FIRST_BOUND * 1000;
+	unsigned int bucket = 0;
+
+	while(bucket < SF_HISTOGRAM_BUCKETS - 1 && duration_ns >= bound_ns)
+	{
+		bound_ns *= 2;
+		bucket++;
+	}
+	return bucket;
+}
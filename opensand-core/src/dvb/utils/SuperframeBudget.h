@@ -0,0 +1,201 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file    SuperframeBudget.h
+ * @brief   The processing time of the superframes on the NCC
+ */
+
+#ifndef _SUPERFRAME_BUDGET_H_
+#define _SUPERFRAME_BUDGET_H_
+
+#include "OpenSandCore.h"
+
+#include <opensand_output/Output.h>
+
+#include <stdint.h>
+#include <time.h>
+
+
+/// The phases of the superframe processing
+typedef enum
+{
+	sf_phase_sac,            ///< The SAC processing
+	sf_phase_dama,           ///< The DAMA computation
+	sf_phase_fwd_scheduling, ///< The forward scheduling
+	sf_phase_ttp_build,      ///< The TTP build
+	sf_phase_send            ///< The SOF, TTP and forward frames emission
+} sf_phase_t;
+
+/// The number of phases
+#define SF_PHASES_NUMBER 5
+
+/// The number of buckets of the phases histograms, the first one is
+/// below 32 us then each bucket doubles the bound, the last one has no bound
+#define SF_HISTOGRAM_BUCKETS 12
+
+/// The number of percentiles exported as probes for each phase
+#define SF_PERCENTILES_NUMBER 2
+
+
+/**
+ * @class SuperframeBudget
+ * @brief The processing time of each phase of the superframes on the NCC
+ *
+ * The channel adds the duration of each phase as it goes, then closes the
+ * superframe on the next frame timer. The durations of the superframe are
+ * counted in fixed-size histograms, one per phase and one for the total,
+ * and the superframes whose processing took longer than the frame duration
+ * are counted as overruns, with the slowest phase.
+ *
+ * The histograms and counters are cumulated since the start. The median
+ * and the 99th percentile of each histogram are exported as probes rather
+ * than the buckets, to keep the number of probes low. The timing is always
+ * on, it only costs a monotonic clock read around each phase.
+ */
+class SuperframeBudget
+{
+ public:
+
+	SuperframeBudget();
+	~SuperframeBudget();
+
+	/**
+	 * @brief Register the probes
+	 *
+	 * @param frame_duration_ms  The superframe duration
+	 * @param log                The log for the overruns
+	 */
+	void init(time_ms_t frame_duration_ms, OutputLog *log);
+
+	/**
+	 * @brief Get the current time to measure a phase
+	 *
+	 * @return the monotonic time (ns)
+	 */
+	static uint64_t getTime(void)
+	{
+		struct timespec now;
+
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+	};
+
+	/**
+	 * @brief Add the duration of a phase to the current superframe
+	 *
+	 * @param phase     The phase
+	 * @param start_ns  The time at the beginning of the phase
+	 * @return the current time, to measure the next phase
+	 */
+	uint64_t addDuration(sf_phase_t phase, uint64_t start_ns)
+	{
+		uint64_t now_ns = getTime();
+
+		this->durations_ns[phase] += now_ns - start_ns;
+		return now_ns;
+	};
+
+	/**
+	 * @brief Close the current superframe: update the histograms, check
+	 *        the overrun and output the probes
+	 *
+	 * @param superframe_sf  The closed superframe
+	 */
+	void closeSuperframe(time_sf_t superframe_sf);
+
+	/**
+	 * @brief Get the number of superframes that overran the frame duration
+	 *
+	 * @return the number of overruns
+	 */
+	unsigned int getOverruns(void) const;
+
+	/**
+	 * @brief Get the number of overruns in which a phase was the slowest one
+	 *
+	 * @param phase  The phase
+	 * @return the number of overruns
+	 */
+	unsigned int getSlowestOverruns(sf_phase_t phase) const;
+
+	/**
+	 * @brief Get the number of superframes in a histogram bucket
+	 *
+	 * @param phase   The phase, SF_PHASES_NUMBER for the total
+	 * @param bucket  The bucket
+	 * @return the number of superframes
+	 */
+	unsigned int getHistogram(unsigned int phase, unsigned int bucket) const;
+
+	/**
+	 * @brief Get a percentile of a histogram
+	 *
+	 * @param phase    The phase, SF_PHASES_NUMBER for the total
+	 * @param percent  The percentile
+	 * @return the upper bound of the bucket holding the percentile, the lower
+	 *         bound for the last bucket, 0 if the histogram is empty (us)
+	 */
+	unsigned int getPercentile(unsigned int phase, unsigned int percent) const;
+
+	/**
+	 * @brief Get the histogram bucket of a duration
+	 *
+	 * @param duration_ns  The duration
+	 * @return the bucket
+	 */
+	static unsigned int getBucket(uint64_t duration_ns);
+
+ private:
+
+	/// The superframe duration (ns)
+	uint64_t frame_duration_ns;
+
+	/// The durations of the phases in the current superframe (ns)
+	uint64_t durations_ns[SF_PHASES_NUMBER];
+
+	/// The histograms of the phases durations, then of the total
+	unsigned int histograms[SF_PHASES_NUMBER + 1][SF_HISTOGRAM_BUCKETS];
+
+	/// The number of superframes that overran the frame duration
+	unsigned int overruns;
+
+	/// The number of overruns per slowest phase
+	unsigned int slowest_overruns[SF_PHASES_NUMBER];
+
+	/// The log for the overruns
+	OutputLog *log;
+
+	/// Output probes and stats
+	Probe<int> *probe_percentiles[SF_PHASES_NUMBER + 1][SF_PERCENTILES_NUMBER];
+	Probe<int> *probe_total;
+	Probe<int> *probe_overruns;
+	Probe<int> *probe_slowest_overruns[SF_PHASES_NUMBER];
+};
+
+#endif
@@ -71,6 +71,18 @@ class TerminalCategoryDama: public TerminalCategory<CarriersGroupDama>
 	vector<T *> getTerminalsInCarriersGroup(
 	                             unsigned int carrier_id) const;
 
+	/**
+	 * @brief  Get the terminal list in a specific carriers group
+	 *         without allocating a new list
+	 *
+	 * @tparam T            a terminal context
+	 * @param  carrier_id   the carrier ID
+	 * @param  entries      OUT: the terminal list in the carriers group
+	 */
+	template<class T>
+	void getTerminalsInCarriersGroup(unsigned int carrier_id,
+	                                 vector<T *> &entries) const;
+
 };
 
 template<class T>
@@ -78,17 +90,26 @@ vector<T *> TerminalCategoryDama::getTerminalsInCarriersGroup(
                                           unsigned int carrier_id) const
 {
 	vector<T *> entries;
+	this->getTerminalsInCarriersGroup<T>(carrier_id, entries);
+	return entries;
+}
+
+template<class T>
+void TerminalCategoryDama::getTerminalsInCarriersGroup(
+                                          unsigned int carrier_id,
+                                          vector<T *> &entries) const
+{
 	vector<TerminalContext *>::const_iterator it;
+	entries.clear();
 	for(it = this->terminals.begin();
 	    it != this->terminals.end(); ++it)
 	{
 		T *terminal = dynamic_cast<T *>(*it);
-		if(terminal->getCarrierId() == carrier_id)
+		if(terminal != NULL && terminal->getCarrierId() == carrier_id)
 		{
 			entries.push_back(terminal);
 		}
 	}
-	return entries;
 }
 
 #endif
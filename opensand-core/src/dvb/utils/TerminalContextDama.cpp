@@ -39,221 +39,224 @@
 #include <opensand_output/Output.h>
 
 
-TerminalContextDama::TerminalContextDama(tal_id_t tal_id,
+TerminalContextDama::TerminalContextDama(TerminalStoreDama *store,
+                                         tal_id_t tal_id,
                                          rate_kbps_t cra_kbps,
                                          rate_kbps_t max_rbdc_kbps,
                                          time_sf_t rbdc_timeout_sf,
                                          vol_kb_t max_vbdc_kb):
 	TerminalContext(tal_id),
-	cra_request_kbps(cra_kbps),
-	max_rbdc_kbps(max_rbdc_kbps),
-	rbdc_timeout_sf(rbdc_timeout_sf),
-	max_vbdc_kb(max_vbdc_kb),
-	rbdc_credit(0.0),
-	timer_sf(0),
-	rbdc_request_kbps(0),
-	rbdc_alloc_kbps(0),
-	vbdc_request_kb(0),
-	vbdc_alloc_kb(0),
-	fca_alloc_kbps(0)
+	store(store),
+	slot(store->add(this))
 {
+	this->store->cra_request_kbps[this->slot] = cra_kbps;
+	this->store->max_rbdc_kbps[this->slot] = max_rbdc_kbps;
+	this->store->rbdc_timeout_sf[this->slot] = rbdc_timeout_sf;
+	this->store->max_vbdc_kb[this->slot] = max_vbdc_kb;
 }
 
 TerminalContextDama::~TerminalContextDama()
 {
+	this->store->remove(this->slot);
 }
 
 void TerminalContextDama::updateRbdcTimeout(time_sf_t timeout_sf)
 {
-	this->rbdc_timeout_sf = timeout_sf;
+	this->store->rbdc_timeout_sf[this->slot] = timeout_sf;
 }
 
 void TerminalContextDama::setRequiredCra(rate_kbps_t val_kbps)
 {
-	this->cra_request_kbps = val_kbps;
+	if(this->store->cra_request_kbps[this->slot] != val_kbps)
+	{
+		this->store->setChanged(this->slot);
+	}
+	this->store->cra_request_kbps[this->slot] = val_kbps;
 	LOG(this->log_band, LEVEL_INFO,
 	    "Required CRA is %u kbits/s (for "
 	    "ST%u)\n",
-	    this->cra_request_kbps, this->tal_id);
+	    this->store->cra_request_kbps[this->slot], this->tal_id);
 }
 
 rate_kbps_t TerminalContextDama::getRequiredCra() const
 {
-	return this->cra_request_kbps;
+	return this->store->cra_request_kbps[this->slot];
 }
 
 void TerminalContextDama::setCraAllocation(rate_kbps_t val_kbps)
 {
-	this->cra_alloc_kbps = val_kbps;
+	this->store->cra_alloc_kbps[this->slot] = val_kbps;
 	LOG(this->log_band, LEVEL_INFO,
 	    "Allocated CRA is %u kbits/s (for "
 	    "ST%u)\n",
-	    this->cra_alloc_kbps, this->tal_id);
+	    this->store->cra_alloc_kbps[this->slot], this->tal_id);
 }
 
 rate_kbps_t TerminalContextDama::getCraAllocation() const
 {
-	return this->cra_alloc_kbps;
+	return this->store->cra_alloc_kbps[this->slot];
 }
 
 void TerminalContextDama::setMaxRbdc(rate_kbps_t val_kbps)
 {
-	this->max_rbdc_kbps = val_kbps;
+	this->store->max_rbdc_kbps[this->slot] = val_kbps;
 	LOG(this->log_band, LEVEL_INFO,
 	    "max RBDC is %u kbits/s (for "
-	    "ST%u)\n", this->max_rbdc_kbps,
-	    this->max_rbdc_kbps, this->tal_id);
+	    "ST%u)\n", this->store->max_rbdc_kbps[this->slot],
+	    this->store->max_rbdc_kbps[this->slot], this->tal_id);
 }
 
 rate_kbps_t TerminalContextDama::getMaxRbdc() const
 {
-	return this->max_rbdc_kbps;
+	return this->store->max_rbdc_kbps[this->slot];
 }
 
 vol_kb_t TerminalContextDama::getMaxVbdc() const
 {
-	return this->max_vbdc_kb;
+	return this->store->max_vbdc_kb[this->slot];
 }
 
 void TerminalContextDama::setRequiredRbdc(rate_kbps_t val_kbps)
 {
 	// limit the requets to Max RBDC
-	this->rbdc_request_kbps = std::min(val_kbps, this->max_rbdc_kbps);
+	this->store->rbdc_request_kbps[this->slot] = std::min(val_kbps, this->store->max_rbdc_kbps[this->slot]);
 
 	// save the request
-	this->rbdc_credit = 0.0;
-	this->timer_sf = this->rbdc_timeout_sf;
+	this->store->rbdc_credit[this->slot] = 0.0;
+	this->store->timer_sf[this->slot] = this->store->rbdc_timeout_sf[this->slot];
 	LOG(this->log_band, LEVEL_DEBUG,
 	    "new RBDC request %d (kb/s) credit %.2f timer %d for ST%u.\n",
-	    this->rbdc_request_kbps, this->rbdc_credit,
-	    this->timer_sf, this->tal_id);
+	    this->store->rbdc_request_kbps[this->slot], this->store->rbdc_credit[this->slot],
+	    this->store->timer_sf[this->slot], this->tal_id);
 }
 
 rate_kbps_t TerminalContextDama::getRequiredRbdc() const
 {
-	return this->rbdc_request_kbps;
+	return this->store->rbdc_request_kbps[this->slot];
 }
 
 void TerminalContextDama::setRbdcAllocation(rate_kbps_t val_kbps)
 {
-	this->rbdc_alloc_kbps = val_kbps;
+	this->store->rbdc_alloc_kbps[this->slot] = val_kbps;
 	LOG(this->log_band, LEVEL_DEBUG,
 	    "RBDC allocation %u (kb/s) request %d (kb/s) credit %.2f timer %d for ST%u.\n",
-	    this->rbdc_alloc_kbps, this->rbdc_request_kbps, this->rbdc_credit,
-	    this->timer_sf, this->tal_id);
+	    this->store->rbdc_alloc_kbps[this->slot], this->store->rbdc_request_kbps[this->slot], this->store->rbdc_credit[this->slot],
+	    this->store->timer_sf[this->slot], this->tal_id);
 }
 
 rate_kbps_t TerminalContextDama::getRbdcAllocation() const
 {
-	return this->rbdc_alloc_kbps;
+	return this->store->rbdc_alloc_kbps[this->slot];
 }
 
 void TerminalContextDama::addRbdcCredit(double credit)
 {
-	this->rbdc_credit += credit;
+	this->store->rbdc_credit[this->slot] += credit;
 }
 
 double TerminalContextDama::getRbdcCredit() const
 {
-	return this->rbdc_credit;
+	return this->store->rbdc_credit[this->slot];
 }
 
 void TerminalContextDama::setRbdcCredit(double credit)
 {
-	this->rbdc_credit = credit;
+	this->store->rbdc_credit[this->slot] = credit;
 }
 
 time_sf_t TerminalContextDama::getTimer() const
 {
-	return this->timer_sf;
+	return this->store->timer_sf[this->slot];
 }
 
 void TerminalContextDama::decrementTimer()
 {
-	if(0 < this->timer_sf)
+	if(0 < this->store->timer_sf[this->slot])
 	{
-		--(this->timer_sf);
+		--(this->store->timer_sf[this->slot]);
 	}
 	else
 	{
-		this->timer_sf = 0;	
+		this->store->timer_sf[this->slot] = 0;	
 	}
 
 }
 
 void TerminalContextDama::setRequiredVbdc(vol_kb_t val_kb)
 {
-	this->vbdc_request_kb += val_kb;
-	this->vbdc_request_kb = std::min(this->vbdc_request_kb, this->max_vbdc_kb);
+	this->store->vbdc_request_kb[this->slot] += val_kb;
+	this->store->vbdc_request_kb[this->slot] =
+		std::min(this->store->vbdc_request_kb[this->slot],
+		         this->store->max_vbdc_kb[this->slot]);
 	LOG(this->log_band, LEVEL_DEBUG,
 	    "new VBDC request %u (kb) for ST%u\n",
-	    vbdc_request_kb, this->tal_id);
+	    this->store->vbdc_request_kb[this->slot], this->tal_id);
 }
 
 void TerminalContextDama::setVbdcAllocation(vol_kb_t val_kb)
 {
-	this->vbdc_alloc_kb = val_kb;
-	if(this->vbdc_request_kb >= this->vbdc_alloc_kb)
+	this->store->vbdc_alloc_kb[this->slot] = val_kb;
+	if(this->store->vbdc_request_kb[this->slot] >= this->store->vbdc_alloc_kb[this->slot])
 	{
 		// The allocation on Agent is processed per frame so for one TTP we
 		// will allocate as many time the allocated value as we have frames
 		// in superframes
-		this->vbdc_request_kb -= this->vbdc_alloc_kb;
+		this->store->vbdc_request_kb[this->slot] -= this->store->vbdc_alloc_kb[this->slot];
 	}
 	else
 	{
-		this->vbdc_request_kb = 0;
+		this->store->vbdc_request_kb[this->slot] = 0;
 	}
 	LOG(this->log_band, LEVEL_DEBUG,
 	    "VBDC allocation %u (kb) request %d (kb) for ST%u.\n",
-	    this->vbdc_alloc_kb, this->vbdc_request_kb, this->tal_id);
+	    this->store->vbdc_alloc_kb[this->slot], this->store->vbdc_request_kb[this->slot], this->tal_id);
 }
 
 vol_kb_t TerminalContextDama::getVbdcAllocation() const
 {
-	return this->vbdc_alloc_kb;
+	return this->store->vbdc_alloc_kb[this->slot];
 }
 
 vol_kb_t TerminalContextDama::getRequiredVbdc() const
 {
 	// the allocation is used for each frame per supertrame so it should
 	// be divided by the number of frames per superframes
-	return ceil(this->vbdc_request_kb);
+	return ceil(this->store->vbdc_request_kb[this->slot]);
 }
 
 void TerminalContextDama::setFcaAllocation(rate_kbps_t val_kbps)
 {
-	this->fca_alloc_kbps = val_kbps;
+	this->store->fca_alloc_kbps[this->slot] = val_kbps;
 }
 
 rate_kbps_t TerminalContextDama::getFcaAllocation() const
 {
-	return this->fca_alloc_kbps;
+	return this->store->fca_alloc_kbps[this->slot];
 }
 
 rate_kbps_t TerminalContextDama::getTotalRateAllocation() const
 {
 	LOG(this->log_band, LEVEL_DEBUG,
 	    "Rate allocation: RBDC %u kb/s, FCA %u kb/s, "
-	    "CRA %u kb/s for ST%u\n", this->rbdc_alloc_kbps,
-	    this->fca_alloc_kbps, this->cra_alloc_kbps, this->tal_id);
-	return this->rbdc_alloc_kbps + this->fca_alloc_kbps + this->cra_alloc_kbps;
+	    "CRA %u kb/s for ST%u\n", this->store->rbdc_alloc_kbps[this->slot],
+	    this->store->fca_alloc_kbps[this->slot], this->store->cra_alloc_kbps[this->slot], this->tal_id);
+	return this->store->rbdc_alloc_kbps[this->slot] + this->store->fca_alloc_kbps[this->slot] + this->store->cra_alloc_kbps[this->slot];
 }
 
 vol_kb_t TerminalContextDama::getTotalVolumeAllocation() const
 {
-	return this->vbdc_alloc_kb;
+	return this->store->vbdc_alloc_kb[this->slot];
 }
 
 bool TerminalContextDama::sortByRemainingCredit(const TerminalContextDama *e1,
                                                const TerminalContextDama *e2)
 {
-	return e1->rbdc_credit > e2->rbdc_credit;
+	return e1->store->rbdc_credit[e1->slot] > e2->store->rbdc_credit[e2->slot];
 }
 
 bool TerminalContextDama::sortByVbdcReq(const TerminalContextDama *e1,
                                        const TerminalContextDama *e2)
 {
-	return e1->vbdc_request_kb > e2->vbdc_request_kb;
+	return e1->store->vbdc_request_kb[e1->slot] > e2->store->vbdc_request_kb[e2->slot];
 }
 
@@ -41,28 +41,35 @@
 #include "TerminalContext.h"
 #include "UnitConverter.h"
 #include "FmtDefinition.h"
+#include "TerminalStoreDama.h"
 
 /**
  * @class TerminalContextDama
  * @brief Interface for a terminal context to be used in a DAMA controller.
  *        The requests values and handling MUST be treated in this context but
  *        they SHOULD be implemented in derived classes as these highly depends
- *        on access type
+ *        on access type.
+ *        The values are kept in the slot of the context in a terminal
+ *        store, the context MUST be destroyed before the store
  */
 class TerminalContextDama: public TerminalContext
 {
+	friend class TerminalStoreDama;
+
  public:
 
 	/**
 	 * @brief  Create a terminal context for DAMA
 	 *
+	 * @param  store            the store for the terminal values
 	 * @param  tal_id           terminal id.
 	 * @param  cra_kbps         terminal CRA (kb/s).
 	 * @param  max_rbdc_kbps    maximum RBDC value (kb/s).
 	 * @param  rbdc_timeout_sf  RBDC timeout (in superframe number).
 	 * @param  max_vbdc_kb      maximum VBDC value (kb).
 	 */
-	TerminalContextDama(tal_id_t tal_id,
+	TerminalContextDama(TerminalStoreDama *store,
+	                    tal_id_t tal_id,
 	                    rate_kbps_t cra_kbps,
 	                    rate_kbps_t max_rbdc_kbps,
 	                    time_sf_t rbdc_timeout_sf,
@@ -267,43 +274,11 @@ class TerminalContextDama: public TerminalContext
 
   protected:
 
-	/** Required CRA for the terminal (kb/s) */
-	rate_kbps_t cra_request_kbps;
-
-	/** Allocated CRA for the terminal (kb/s) */
-	rate_kbps_t cra_alloc_kbps;
-
-	/** Maximual RBDC value (kb/s) */
-	rate_kbps_t max_rbdc_kbps;
-
-	/** RBDC request timeout */
-	time_sf_t rbdc_timeout_sf;
-
-	/** The maximum VBDC value */
-	vol_kb_t max_vbdc_kb;
-
-	/** the RBDC credit: the decimal part of RBDC that may remain
-	 *  after DAMA computation */
-	double rbdc_credit;
-
-	/** The timer for RBDC requests: initialized to rbdc_timeout_sf each request
-	 *  and decreased on each SOF */
-	time_sf_t timer_sf;
-
-	/** the RBDC request */
-	rate_kbps_t rbdc_request_kbps;
-
-	/** The RBDC allocation */
-	rate_kbps_t rbdc_alloc_kbps;
-
-	/** the VBDC request */
-	vol_kb_t vbdc_request_kb;
-
-	/** The VBDC allocation */
-	vol_kb_t vbdc_alloc_kb;
+	/** The store of the terminal values */
+	TerminalStoreDama *store;
 
-	/** The FCA allocation */
-	rate_kbps_t fca_alloc_kbps;
+	/** The slot of the terminal in the store */
+	unsigned int slot;
 };
 
 #endif
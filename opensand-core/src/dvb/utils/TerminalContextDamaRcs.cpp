@@ -45,13 +45,14 @@
 #include <cstdlib>
 
 
-TerminalContextDamaRcs::TerminalContextDamaRcs(tal_id_t tal_id,
+TerminalContextDamaRcs::TerminalContextDamaRcs(TerminalStoreDama *store,
+                                               tal_id_t tal_id,
                                                rate_kbps_t cra_kbps,
                                                rate_kbps_t max_rbdc_kbps,
                                                time_sf_t rbdc_timeout_sf,
                                                vol_kb_t max_vbdc_kb):
-	TerminalContextDama(tal_id, cra_kbps, max_rbdc_kbps, rbdc_timeout_sf, max_vbdc_kb),
-	carrier_id()
+	TerminalContextDama(store, tal_id, cra_kbps, max_rbdc_kbps, rbdc_timeout_sf, max_vbdc_kb),
+	req_fmt_def(NULL)
 {
 	this->setRequiredCra(cra_kbps);
 	this->setMaxRbdc(max_rbdc_kbps);
@@ -65,7 +66,9 @@ TerminalContextDamaRcs::~TerminalContextDamaRcs()
 
 unsigned int TerminalContextDamaRcs::getFmtId() const
 {
-	return this->fmt_def != NULL ? this->fmt_def->getId() : 0;
+	FmtDefinition *fmt_def = this->store->fmt_def[this->slot];
+
+	return fmt_def != NULL ? fmt_def->getId() : 0;
 }
 
 FmtDefinition *TerminalContextDamaRcs::getRequiredFmt() const
@@ -80,20 +83,24 @@ void TerminalContextDamaRcs::setRequiredFmt(FmtDefinition *fmt)
 
 FmtDefinition *TerminalContextDamaRcs::getFmt() const
 {
-	return this->fmt_def;
+	return this->store->fmt_def[this->slot];
 }
 
 void TerminalContextDamaRcs::setFmt(FmtDefinition *fmt)
 {
-	this->fmt_def = fmt;
+	if(this->store->fmt_def[this->slot] != fmt)
+	{
+		this->store->setChanged(this->slot);
+	}
+	this->store->fmt_def[this->slot] = fmt;
 }
 
 unsigned int TerminalContextDamaRcs::getCarrierId() const
 {
-	return this->carrier_id;
+	return this->store->carrier_id[this->slot];
 }
 
 void TerminalContextDamaRcs::setCarrierId(unsigned int carrier_id)
 {
-	this->carrier_id = carrier_id;
+	this->store->setCarrierId(this->slot, carrier_id);
 }
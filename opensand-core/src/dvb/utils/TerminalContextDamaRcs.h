@@ -48,7 +48,8 @@ class TerminalContextDamaRcs : public TerminalContextDama
 {
  public:
 
-	TerminalContextDamaRcs(tal_id_t tal_id,
+	TerminalContextDamaRcs(TerminalStoreDama *store,
+	                       tal_id_t tal_id,
 	                       rate_kbps_t cra_kbps,
 	                       rate_kbps_t max_rbdc_kbps,
 	                       time_sf_t rbdc_timeout_sf,
@@ -109,12 +110,6 @@ class TerminalContextDamaRcs : public TerminalContextDama
 
 	/** The required FMT */
 	FmtDefinition *req_fmt_def;
-
-	/** The FMT */
-	FmtDefinition *fmt_def;
-
-	/** The carrier ID */
-	unsigned int carrier_id;
 };
 
 #endif
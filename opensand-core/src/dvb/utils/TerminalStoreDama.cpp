@@ -0,0 +1,182 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file    TerminalStoreDama.cpp
+ * @brief   The storage of the DAMA terminal contexts
+ */
+
+#include "TerminalStoreDama.h"
+#include "TerminalContextDama.h"
+
+#include <algorithm>
+
+
+TerminalStoreDama::TerminalStoreDama():
+	terminals(),
+	tal_id(),
+	cra_request_kbps(),
+	cra_alloc_kbps(),
+	max_rbdc_kbps(),
+	rbdc_timeout_sf(),
+	max_vbdc_kb(),
+	rbdc_credit(),
+	timer_sf(),
+	rbdc_request_kbps(),
+	rbdc_alloc_kbps(),
+	vbdc_request_kb(),
+	vbdc_alloc_kb(),
+	fca_alloc_kbps(),
+	fmt_def(),
+	carrier_id(),
+	moved(false),
+	changed_carriers()
+{
+}
+
+TerminalStoreDama::~TerminalStoreDama()
+{
+}
+
+void TerminalStoreDama::resetAllocations()
+{
+	std::fill(this->cra_alloc_kbps.begin(), this->cra_alloc_kbps.end(), 0);
+	std::fill(this->rbdc_alloc_kbps.begin(), this->rbdc_alloc_kbps.end(), 0);
+	std::fill(this->vbdc_alloc_kb.begin(), this->vbdc_alloc_kb.end(), 0);
+	std::fill(this->fca_alloc_kbps.begin(), this->fca_alloc_kbps.end(), 0);
+}
+
+void TerminalStoreDama::decrementTimers()
+{
+	unsigned int size = this->timer_sf.size();
+
+	for(unsigned int slot = 0; slot < size; ++slot)
+	{
+		if(0 < this->timer_sf[slot])
+		{
+			--(this->timer_sf[slot]);
+		}
+	}
+}
+
+void TerminalStoreDama::clearChanges()
+{
+	this->moved = false;
+	this->changed_carriers.clear();
+}
+
+unsigned int TerminalStoreDama::add(TerminalContextDama *terminal)
+{
+	unsigned int slot = this->terminals.size();
+
+	this->terminals.push_back(terminal);
+	this->tal_id.push_back(terminal->getTerminalId());
+	this->cra_request_kbps.push_back(0);
+	this->cra_alloc_kbps.push_back(0);
+	this->max_rbdc_kbps.push_back(0);
+	this->rbdc_timeout_sf.push_back(0);
+	this->max_vbdc_kb.push_back(0);
+	this->rbdc_credit.push_back(0.0);
+	this->timer_sf.push_back(0);
+	this->rbdc_request_kbps.push_back(0);
+	this->rbdc_alloc_kbps.push_back(0);
+	this->vbdc_request_kb.push_back(0);
+	this->vbdc_alloc_kb.push_back(0);
+	this->fca_alloc_kbps.push_back(0);
+	this->fmt_def.push_back(NULL);
+	this->carrier_id.push_back(0);
+	this->moved = true;
+
+	return slot;
+}
+
+void TerminalStoreDama::remove(unsigned int slot)
+{
+	unsigned int last = this->terminals.size() - 1;
+
+	// the terminal leaves its carriers group, and the last terminal
+	// changes of slot in its own one
+	this->setChanged(slot);
+	this->setChanged(last);
+	this->moved = true;
+
+	if(slot != last)
+	{
+		// move the last terminal in the freed slot
+		this->terminals[slot] = this->terminals[last];
+		this->tal_id[slot] = this->tal_id[last];
+		this->cra_request_kbps[slot] = this->cra_request_kbps[last];
+		this->cra_alloc_kbps[slot] = this->cra_alloc_kbps[last];
+		this->max_rbdc_kbps[slot] = this->max_rbdc_kbps[last];
+		this->rbdc_timeout_sf[slot] = this->rbdc_timeout_sf[last];
+		this->max_vbdc_kb[slot] = this->max_vbdc_kb[last];
+		this->rbdc_credit[slot] = this->rbdc_credit[last];
+		this->timer_sf[slot] = this->timer_sf[last];
+		this->rbdc_request_kbps[slot] = this->rbdc_request_kbps[last];
+		this->rbdc_alloc_kbps[slot] = this->rbdc_alloc_kbps[last];
+		this->vbdc_request_kb[slot] = this->vbdc_request_kb[last];
+		this->vbdc_alloc_kb[slot] = this->vbdc_alloc_kb[last];
+		this->fca_alloc_kbps[slot] = this->fca_alloc_kbps[last];
+		this->fmt_def[slot] = this->fmt_def[last];
+		this->carrier_id[slot] = this->carrier_id[last];
+		this->terminals[slot]->slot = slot;
+	}
+
+	this->terminals.pop_back();
+	this->tal_id.pop_back();
+	this->cra_request_kbps.pop_back();
+	this->cra_alloc_kbps.pop_back();
+	this->max_rbdc_kbps.pop_back();
+	this->rbdc_timeout_sf.pop_back();
+	this->max_vbdc_kb.pop_back();
+	this->rbdc_credit.pop_back();
+	this->timer_sf.pop_back();
+	this->rbdc_request_kbps.pop_back();
+	this->rbdc_alloc_kbps.pop_back();
+	this->vbdc_request_kb.pop_back();
+	this->vbdc_alloc_kb.pop_back();
+	this->fca_alloc_kbps.pop_back();
+	this->fmt_def.pop_back();
+	this->carrier_id.pop_back();
+}
+
+void TerminalStoreDama::setCarrierId(unsigned int slot, unsigned int carrier_id)
+{
+	if(this->carrier_id[slot] == carrier_id)
+	{
+		return;
+	}
+
+	// the terminal leaves its carriers group, its CRA is allocated
+	// again in the new one
+	this->setChanged(slot);
+	this->carrier_id[slot] = carrier_id;
+	this->cra_alloc_kbps[slot] = 0;
+	this->setChanged(slot);
+	this->moved = true;
+}
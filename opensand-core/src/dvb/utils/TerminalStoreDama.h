@@ -0,0 +1,300 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file    TerminalStoreDama.h
+ * @brief   The storage of the DAMA terminal contexts
+ */
+
+#ifndef _TERMINAL_STORE_DAMA_H_
+#define _TERMINAL_STORE_DAMA_H_
+
+#include "OpenSandCore.h"
+#include "FmtDefinition.h"
+
+#include <set>
+#include <vector>
+
+using std::set;
+using std::vector;
+
+class TerminalContextDama;
+
+/**
+ * @class TerminalStoreDama
+ * @brief The values of the DAMA terminal contexts stored per field.
+ *
+ * Each terminal context owns a slot in the store, the values of the
+ * terminals are kept in contiguous arrays indexed by the slots, so the
+ * DAMA controllers can go through all the terminals linearly on each
+ * superframe. The slots are dense: when a terminal is removed the last
+ * one takes its slot.
+ */
+class TerminalStoreDama
+{
+	friend class TerminalContextDama;
+	friend class TerminalContextDamaRcs;
+
+ public:
+
+	TerminalStoreDama();
+	~TerminalStoreDama();
+
+	/**
+	 * @brief Get the number of terminals in the store
+	 *
+	 * @return the number of terminals, that is the number of slots
+	 */
+	unsigned int getSize() const
+	{
+		return this->terminals.size();
+	};
+
+	/**
+	 * @brief Get the terminal context owning a slot
+	 *
+	 * @param slot  The slot
+	 * @return the terminal context
+	 */
+	TerminalContextDama *getTerminal(unsigned int slot) const
+	{
+		return this->terminals[slot];
+	};
+
+	/**
+	 * @brief Get the ID of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the terminal ID
+	 */
+	tal_id_t getTerminalId(unsigned int slot) const
+	{
+		return this->tal_id[slot];
+	};
+
+	/**
+	 * @brief Get the required CRA of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the required CRA (kb/s)
+	 */
+	rate_kbps_t getRequiredCra(unsigned int slot) const
+	{
+		return this->cra_request_kbps[slot];
+	};
+
+	/**
+	 * @brief Set the CRA allocation of the terminal in a slot
+	 *
+	 * @param slot      The slot
+	 * @param val_kbps  The CRA allocation (kb/s)
+	 */
+	void setCraAllocation(unsigned int slot, rate_kbps_t val_kbps)
+	{
+		this->cra_alloc_kbps[slot] = val_kbps;
+	};
+
+	/**
+	 * @brief Get the RBDC credit of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the RBDC credit
+	 */
+	double getRbdcCredit(unsigned int slot) const
+	{
+		return this->rbdc_credit[slot];
+	};
+
+	/**
+	 * @brief Get the RBDC timer of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the timer
+	 */
+	time_sf_t getTimer(unsigned int slot) const
+	{
+		return this->timer_sf[slot];
+	};
+
+	/**
+	 * @brief Get the current FMT of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the FMT, NULL if unknown
+	 */
+	FmtDefinition *getFmt(unsigned int slot) const
+	{
+		return this->fmt_def[slot];
+	};
+
+	/**
+	 * @brief Get the carriers group of the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 * @return the ID of the carriers group
+	 */
+	unsigned int getCarrierId(unsigned int slot) const
+	{
+		return this->carrier_id[slot];
+	};
+
+	/**
+	 * @brief Reset the CRA, RBDC, VBDC and FCA allocations of all
+	 *        the terminals
+	 */
+	void resetAllocations();
+
+	/**
+	 * @brief Decrement the RBDC timers of all the terminals
+	 */
+	void decrementTimers();
+
+	/**
+	 * @brief Whether terminals joined, left or moved in the carriers groups
+	 *        since the last call to @ref clearChanges
+	 *
+	 * @return true if the terminals of the carriers groups changed
+	 */
+	bool isMoved() const
+	{
+		return this->moved;
+	};
+
+	/**
+	 * @brief Whether the CRA allocation of a carriers group may have
+	 *        changed since the last call to @ref clearChanges, because
+	 *        one of its terminals changed its CRA, its MODCOD or its
+	 *        carriers group
+	 *
+	 * @param carrier_id  The carriers group ID
+	 * @return true if the CRA of the carriers group should be computed again
+	 */
+	bool isCarrierChanged(unsigned int carrier_id) const
+	{
+		return this->changed_carriers.find(carrier_id) != this->changed_carriers.end();
+	};
+
+	/**
+	 * @brief Forget the changes of the carriers groups
+	 */
+	void clearChanges();
+
+ protected:
+
+	/**
+	 * @brief Add a terminal context in the store
+	 *
+	 * @param terminal  The terminal context
+	 * @return the slot of the terminal
+	 */
+	unsigned int add(TerminalContextDama *terminal);
+
+	/**
+	 * @brief Remove a terminal context from the store,
+	 *        the last terminal is moved to its slot
+	 *
+	 * @param slot  The slot of the terminal
+	 */
+	void remove(unsigned int slot);
+
+	/**
+	 * @brief Set the carriers group of the terminal in a slot,
+	 *        its CRA allocation is reset when it changes
+	 *
+	 * @param slot        The slot
+	 * @param carrier_id  The ID of the carriers group
+	 */
+	void setCarrierId(unsigned int slot, unsigned int carrier_id);
+
+	/**
+	 * @brief Record that a value used by the CRA allocation changed
+	 *        for the terminal in a slot
+	 *
+	 * @param slot  The slot
+	 */
+	void setChanged(unsigned int slot)
+	{
+		this->changed_carriers.insert(this->carrier_id[slot]);
+	};
+
+	/** The terminal contexts */
+	vector<TerminalContextDama *> terminals;
+
+	/** The terminal IDs */
+	vector<tal_id_t> tal_id;
+
+	/** Required CRA (kb/s) */
+	vector<rate_kbps_t> cra_request_kbps;
+
+	/** Allocated CRA (kb/s) */
+	vector<rate_kbps_t> cra_alloc_kbps;
+
+	/** Maximal RBDC value (kb/s) */
+	vector<rate_kbps_t> max_rbdc_kbps;
+
+	/** RBDC request timeout */
+	vector<time_sf_t> rbdc_timeout_sf;
+
+	/** The maximum VBDC value */
+	vector<vol_kb_t> max_vbdc_kb;
+
+	/** The RBDC credit */
+	vector<double> rbdc_credit;
+
+	/** The timer for RBDC requests */
+	vector<time_sf_t> timer_sf;
+
+	/** The RBDC request */
+	vector<rate_kbps_t> rbdc_request_kbps;
+
+	/** The RBDC allocation */
+	vector<rate_kbps_t> rbdc_alloc_kbps;
+
+	/** The VBDC request */
+	vector<vol_kb_t> vbdc_request_kb;
+
+	/** The VBDC allocation */
+	vector<vol_kb_t> vbdc_alloc_kb;
+
+	/** The FCA allocation */
+	vector<rate_kbps_t> fca_alloc_kbps;
+
+	/** The current FMT */
+	vector<FmtDefinition *> fmt_def;
+
+	/** The carriers group ID */
+	vector<unsigned int> carrier_id;
+
+	/** Whether terminals joined, left or moved in the carriers groups */
+	bool moved;
+
+	/** The carriers groups whose CRA allocation may have changed */
+	set<unsigned int> changed_carriers;
+};
+
+#endif
@@ -72,7 +72,7 @@ Ttp::Ttp(group_id_t group_id, time_sf_t sf_id):
 bool Ttp::addTimePlan(time_frame_t frame_id,
                       tal_id_t tal_id,
                       int32_t offset,
-                      uint16_t assignment_count,
+                      uint32_t assignment_count,
                       fmt_id_t fmt_id,
                       uint8_t priority)
 {
@@ -80,7 +80,7 @@ bool Ttp::addTimePlan(time_frame_t frame_id,
 
 	tp.tal_id = htons(tal_id);
 	tp.offset = htonl(offset);
-	tp.assignment_count = htons(assignment_count);
+	tp.assignment_count = htonl(assignment_count);
 	tp.fmt_id = fmt_id;
 	tp.priority = priority;
 
@@ -211,7 +211,7 @@ bool Ttp::getTp(tal_id_t tal_id, std::map<uint8_t, emu_tp_t> &tps)
 				continue;
 			}
 			tp->offset = ntohl(tp->offset);
-			tp->assignment_count = ntohs(tp->assignment_count);
+			tp->assignment_count = ntohl(tp->assignment_count);
 			tps[emu_frame->frame_info.frame_number] = *tp;
 			LOG(ttp_log, LEVEL_DEBUG,
 			    "SF#%u: frame#%u tbtp#%u: tal_id:%u, "
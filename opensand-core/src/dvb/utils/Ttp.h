@@ -76,7 +76,7 @@ typedef struct
 	int32_t offset;    ///> The offset in the superframe (start_slot for RCS)
 	// TODO we don't do one less
 	// TODO uint8_t in standard and we should build more than one TTP per ST
-	uint16_t assignment_count; ///> one less than the number of timeslots assigned
+	uint32_t assignment_count; ///> one less than the number of timeslots assigned
 	                           //   in the block (for RCS)
 	uint8_t fmt_id;    ///> The ID for FMT (MODCOD ID)
 	uint8_t priority;  ///> The traffic priority (no used in RCS)
@@ -142,7 +142,7 @@ class Ttp: public DvbFrameTpl<T_DVB_TTP>
 	bool addTimePlan(time_frame_t frame_id,
 	                 tal_id_t tal_id,
 	                 int32_t offset,
-	                 uint16_t assignment_count,
+	                 uint32_t assignment_count,
 	                 fmt_id_t fmt_id,
 	                 uint8_t priority);
 
@@ -106,7 +106,7 @@ vol_b_t UnitConverter::symToBits(vol_sym_t vol_sym) const
 
 vol_sym_t UnitConverter::kbitsToSym(vol_kb_t vol_kb) const
 {
-	return ceil(vol_kb * 1000 * this->modulation_efficiency_inv);
+	return ceil(vol_kb * 1000.0 * this->modulation_efficiency_inv);
 }
 
 vol_kb_t UnitConverter::symToKbits(vol_sym_t vol_sym) const
@@ -121,7 +121,7 @@ vol_kb_t UnitConverter::bitsToKbits(vol_b_t vol_b) const
 
 vol_b_t UnitConverter::kbitsToBits(vol_kb_t vol_kb) const
 {
-	return vol_kb * 1000;
+	return (vol_b_t)vol_kb * 1000;
 }
 
 rate_symps_t UnitConverter::bpsToSymps(rate_bps_t rate_bps) const
@@ -136,7 +136,7 @@ rate_bps_t UnitConverter::sympsToBps(rate_symps_t rate_symps) const
 
 rate_symps_t UnitConverter::kbpsToSymps(rate_kbps_t rate_kbps) const
 {
-	return ceil(rate_kbps * 1000 * this->modulation_efficiency_inv);
+	return ceil(rate_kbps * 1000.0 * this->modulation_efficiency_inv);
 }
 
 rate_kbps_t UnitConverter::sympsToKbps(rate_symps_t rate_symps) const
@@ -151,7 +151,7 @@ rate_kbps_t UnitConverter::bpsToKbps(rate_bps_t rate_bps) const
 
 rate_bps_t UnitConverter::kbpsToBps(rate_kbps_t rate_kbps) const
 {
-	return rate_kbps * 1000;
+	return (rate_bps_t)rate_kbps * 1000;
 }
 
 unsigned int UnitConverter::pfToPs(unsigned int rate_pf) const
@@ -161,5 +161,5 @@ unsigned int UnitConverter::pfToPs(unsigned int rate_pf) const
 
 unsigned int UnitConverter::psToPf(unsigned int rate_ps) const
 {
-	return ceil(rate_ps * this->frame_duration_ms / 1000.0);
+	return ceil(rate_ps * (double)this->frame_duration_ms / 1000.0);
 }
@@ -46,10 +46,10 @@ class UnitConverter
  protected:
 
 	time_ms_t frame_duration_ms;          ///< Frame duration (in ms)
-	float frame_duration_ms_inv;          ///< Inverse of frame duration (in ms-1)
+	double frame_duration_ms_inv;         ///< Inverse of frame duration (in ms-1)
 
 	unsigned int modulation_efficiency;   ///< Modulation efficiency
-	float modulation_efficiency_inv;      ///< Invers of modulation efficiency
+	double modulation_efficiency_inv;     ///< Invers of modulation efficiency
 
 	/**
 	 * @brief Create the unit converter
@@ -47,7 +47,7 @@ class UnitConverterFixedBitLength: public UnitConverter
  protected:
 
 	vol_b_t packet_length_b;        ///< Fixed packet length (in bits)
-	float packet_length_b_inv;      ///< Inverse of fixed packet length (in bits-1)
+	double packet_length_b_inv;     ///< Inverse of fixed packet length (in bits-1)
 
  public:
 
@@ -94,7 +94,7 @@ vol_pkt_t UnitConverterFixedSymbolLength::bitsToPkt(vol_b_t vol_b) const
 
 vol_b_t UnitConverterFixedSymbolLength::pktToBits(vol_pkt_t vol_pkt) const
 {
-	return vol_pkt * this->packet_length_sym * this->modulation_efficiency;
+	return (vol_b_t)vol_pkt * this->packet_length_sym * this->modulation_efficiency;
 }
 	
 vol_pkt_t UnitConverterFixedSymbolLength::kbitsToPkt(vol_kb_t vol_kb) const
@@ -104,7 +104,7 @@ vol_pkt_t UnitConverterFixedSymbolLength::kbitsToPkt(vol_kb_t vol_kb) const
 
 vol_kb_t UnitConverterFixedSymbolLength::pktToKbits(vol_pkt_t vol_pkt) const
 {
-	return ceil(vol_pkt * this->packet_length_sym * this->modulation_efficiency / 1000.0);
+	return ceil(vol_pkt * (double)this->packet_length_sym * this->modulation_efficiency / 1000.0);
 }
 
 rate_pktpf_t UnitConverterFixedSymbolLength::sympsToPktpf(rate_symps_t rate_symps) const
@@ -114,7 +114,7 @@ rate_pktpf_t UnitConverterFixedSymbolLength::sympsToPktpf(rate_symps_t rate_symp
 
 rate_symps_t UnitConverterFixedSymbolLength::pktpfToSymps(rate_pktpf_t rate_pktpf) const
 {
-	return ceil(rate_pktpf * this->packet_length_sym * this->frame_duration_ms_inv / 1000.0);
+	return ceil(rate_pktpf * (double)this->packet_length_sym * this->frame_duration_ms_inv / 1000.0);
 }
 
 rate_pktpf_t UnitConverterFixedSymbolLength::bpsToPktpf(rate_bps_t rate_bps) const
@@ -125,7 +125,7 @@ rate_pktpf_t UnitConverterFixedSymbolLength::bpsToPktpf(rate_bps_t rate_bps) con
 
 rate_bps_t UnitConverterFixedSymbolLength::pktpfToBps(rate_pktpf_t rate_pktpf) const
 {
-	return ceil(rate_pktpf * this->packet_length_sym * this->modulation_efficiency
+	return ceil(rate_pktpf * (double)this->packet_length_sym * this->modulation_efficiency
 		* this->frame_duration_ms_inv * 1000);
 }
 	
@@ -139,6 +139,6 @@ rate_pktpf_t UnitConverterFixedSymbolLength::kbpsToPktpf(rate_kbps_t rate_kbps)
 rate_kbps_t UnitConverterFixedSymbolLength::pktpfToKbps(rate_pktpf_t rate_pktpf) const
 {
 	// bit/ms <=> kbits/s
-	return ceil(rate_pktpf * this->packet_length_sym * this->modulation_efficiency
+	return ceil(rate_pktpf * (double)this->packet_length_sym * this->modulation_efficiency
 		* this->frame_duration_ms_inv);
 }
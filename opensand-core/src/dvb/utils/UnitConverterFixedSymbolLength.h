@@ -47,7 +47,7 @@ class UnitConverterFixedSymbolLength: public UnitConverter
  protected:
 
 	vol_sym_t packet_length_sym;    ///< Fixed packet length (in symbols)
-	float packet_length_sym_inv;    ///< Inverse of fixed packet length (in symbols-1)
+	double packet_length_sym_inv;   ///< Inverse of fixed packet length (in symbols-1)
 
  public:
 
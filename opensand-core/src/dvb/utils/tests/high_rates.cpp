@@ -0,0 +1,159 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file high_rates.cpp
+ * @brief Check that the rates and volumes of a 1 Gb/s carrier do not
+ *        overflow in the unit conversions and in the DVB messages
+ */
+
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <opensand_output/Output.h>
+
+#include <UnitConverterFixedBitLength.h>
+#include <UnitConverterFixedSymbolLength.h>
+#include <FmtDefinition.h>
+#include <Sac.h>
+#include <Ttp.h>
+#include <Logon.h>
+
+/// 1 Gb/s in kb/s
+#define GBPS_KBPS 1000000
+
+/**
+ * @brief Get the value of a capacity request after its encoding in a SAC
+ *
+ * @param type   the request type
+ * @param value  the request value
+ * @return the decoded request value
+ */
+static uint32_t getSacRequest(uint8_t type, uint32_t value)
+{
+	Sac sac(1, 0);
+	std::vector<cr_info_t> requests;
+
+	if(!sac.addRequest(0, type, value))
+	{
+		return 0;
+	}
+	requests = sac.getRequests();
+	if(requests.size() != 1)
+	{
+		return 0;
+	}
+	return requests[0].value;
+}
+
+int main()
+{
+	bool failure;
+
+	failure = false;
+	Output::init(false);
+	Sac::sac_log = Output::registerLog(LEVEL_WARNING, "Dvb.SAC");
+	Ttp::ttp_log = Output::registerLog(LEVEL_WARNING, "Dvb.TTP");
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	// 100 ms frames of 1000 bits packets: 100000 packets per frame
+	UnitConverterFixedBitLength bit_converter(100, 1, 1000);
+	check(bit_converter.kbpsToPktpf(GBPS_KBPS) == 100000,
+	      "1 Gb/s in packets per frame");
+	check(bit_converter.pktpfToKbps(100000) == GBPS_KBPS,
+	      "packets per frame in kb/s");
+	check(bit_converter.kbitsToPkt(100000) == 100000, "kbits in packets");
+	check(bit_converter.pktToKbits(100000) == 100000, "packets in kbits");
+	check(bit_converter.kbpsToBps(GBPS_KBPS) == 1000000000ULL,
+	      "1 Gb/s in b/s");
+	check(bit_converter.bpsToKbps(1000000000ULL) == GBPS_KBPS,
+	      "b/s in kb/s");
+	check(bit_converter.psToPf(GBPS_KBPS) == 100000, "kb/s in kbits per frame");
+	check(bit_converter.pfToPs(100000) == GBPS_KBPS, "kbits per frame in kb/s");
+
+	// 500 Msym/s carrier with 536 symbols packets and 2 bits per symbol
+	UnitConverterFixedSymbolLength sym_converter(100, 2, 536);
+	rate_pktpf_t carrier_pktpf = sym_converter.kbpsToPktpf(GBPS_KBPS);
+	rate_kbps_t carrier_kbps = sym_converter.pktpfToKbps(carrier_pktpf);
+	check(carrier_pktpf == 93284, "1 Gb/s in symbol packets per frame");
+	check(carrier_kbps >= GBPS_KBPS &&
+	      carrier_kbps - GBPS_KBPS <= sym_converter.pktpfToKbps(1),
+	      "symbol packets per frame in kb/s");
+	check(sym_converter.getSlotsNumber(500e6) == 93283,
+	      "slots of a 500 Msym/s carrier");
+	check(sym_converter.pktToKbits(carrier_pktpf) ==
+	      sym_converter.psToPf(carrier_kbps),
+	      "symbol packets in kbits");
+
+	// FEC on 1 Gb/s
+	FmtDefinition fmt(1, "QPSK", "3/4", 1.5, 3.0);
+	check(fmt.addFec(750000) == GBPS_KBPS, "add FEC to 750 Mb/s");
+	check(fmt.removeFec(GBPS_KBPS) == 750000, "remove FEC from 1 Gb/s");
+
+	// capacity requests, the granularity increases with the request
+	check(getSacRequest(access_dama_rbdc, 500) == 500, "small RBDC request");
+	check(getSacRequest(access_dama_vbdc, 200) == 200, "small VBDC request");
+	check(getSacRequest(access_dama_rbdc, 16320) == 16320,
+	      "16 Mb/s RBDC request");
+	check(getSacRequest(access_dama_rbdc, GBPS_KBPS) >= GBPS_KBPS - 2048 &&
+	      getSacRequest(access_dama_rbdc, GBPS_KBPS) <= GBPS_KBPS + 2048,
+	      "1 Gb/s RBDC request");
+	check(getSacRequest(access_dama_vbdc, 100000) >= 100000 - 2048 &&
+	      getSacRequest(access_dama_vbdc, 100000) <= 100000 + 2048,
+	      "100 Mbits VBDC request");
+	check(getSacRequest(access_dama_rbdc, 2 * GBPS_KBPS) == 1044480,
+	      "RBDC request above the maximum");
+	check(getSacRequest(access_dama_vbdc, 2 * GBPS_KBPS) == 1044480,
+	      "VBDC request above the maximum");
+
+	// time plans of 100000 kbits
+	Ttp ttp(0, 1);
+	std::map<uint8_t, emu_tp_t> tps;
+	check(ttp.addTimePlan(0, 2, 0, 100000, 3, 0) && ttp.build() &&
+	      ttp.getTp(2, tps) && tps.size() == 1 &&
+	      tps[0].assignment_count == 100000, "100000 kbits time plan");
+
+	// logon of a 1 Gb/s terminal
+	LogonRequest logon(2, GBPS_KBPS, 2 * GBPS_KBPS, 100000);
+	check(logon.getRtBandwidth() == GBPS_KBPS &&
+	      logon.getMaxRbdc() == 2 * GBPS_KBPS &&
+	      logon.getMaxVbdc() == 100000, "1 Gb/s logon request");
+
+	return (failure ? 1 : 0);
+}
@@ -0,0 +1,127 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file superframe_budget.cpp
+ * @brief Check the histograms and overruns of the superframes processing
+ *        time on the NCC
+ */
+
+
+#include <iostream>
+
+#include <opensand_output/Output.h>
+
+#include <SuperframeBudget.h>
+
+/// 1 ms in ns
+#define MS_NS 1000000
+
+/**
+ * @brief Add a duration to a phase as if it had just ended
+ *
+ * @param budget       the superframe budget
+ * @param phase        the phase
+ * @param duration_ns  the duration of the phase
+ */
+static void addPhase(SuperframeBudget &budget, sf_phase_t phase,
+                     uint64_t duration_ns)
+{
+	budget.addDuration(phase, SuperframeBudget::getTime() - duration_ns);
+}
+
+int main()
+{
+	bool failure;
+
+	failure = false;
+	Output::init(false);
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	// buckets below 32 us, then doubling, the last one has no bound
+	check(SuperframeBudget::getBucket(0) == 0 &&
+	      SuperframeBudget::getBucket(31999) == 0, "first bucket");
+	check(SuperframeBudget::getBucket(32000) == 1 &&
+	      SuperframeBudget::getBucket(100000) == 2, "doubling buckets");
+	check(SuperframeBudget::getBucket(65536000) == SF_HISTOGRAM_BUCKETS - 1 &&
+	      SuperframeBudget::getBucket(3600000 * (uint64_t)MS_NS) ==
+	      SF_HISTOGRAM_BUCKETS - 1, "last bucket");
+
+	SuperframeBudget budget;
+	budget.init(1, Output::registerLog(LEVEL_WARNING, "Dvb.Ncc.Budget"));
+	check(budget.getPercentile(SF_PHASES_NUMBER, 50) == 0, "empty histogram");
+
+	// 40 us per phase, 200 us in total, within the 1 ms frame
+	for(unsigned int phase = 0; phase < SF_PHASES_NUMBER; phase++)
+	{
+		addPhase(budget, (sf_phase_t)phase, 40000);
+	}
+	budget.closeSuperframe(1);
+	check(budget.getHistogram(sf_phase_sac, 1) == 1 &&
+	      budget.getHistogram(sf_phase_send, 1) == 1 &&
+	      budget.getHistogram(SF_PHASES_NUMBER, 3) == 1, "histograms");
+	check(budget.getOverruns() == 0, "no overrun");
+
+	// a 3 ms DAMA computation overruns the frame
+	addPhase(budget, sf_phase_dama, 3 * MS_NS);
+	budget.closeSuperframe(2);
+	check(budget.getHistogram(sf_phase_sac, 0) == 1 &&
+	      budget.getHistogram(sf_phase_dama, 7) == 1 &&
+	      budget.getHistogram(SF_PHASES_NUMBER, 7) == 1, "slow phase histogram");
+	check(budget.getOverruns() == 1 &&
+	      budget.getSlowestOverruns(sf_phase_dama) == 1 &&
+	      budget.getSlowestOverruns(sf_phase_sac) == 0, "overrun");
+
+	// a 100 ms emission ends in the last bucket
+	addPhase(budget, sf_phase_send, 100 * MS_NS);
+	budget.closeSuperframe(3);
+	check(budget.getHistogram(sf_phase_send, SF_HISTOGRAM_BUCKETS - 1) == 1 &&
+	      budget.getOverruns() == 2 &&
+	      budget.getSlowestOverruns(sf_phase_send) == 1, "last bucket overrun");
+
+	// the percentiles are the bounds of the buckets
+	check(budget.getPercentile(SF_PHASES_NUMBER, 50) == 4096 &&
+	      budget.getPercentile(SF_PHASES_NUMBER, 99) == 32768 &&
+	      budget.getPercentile(sf_phase_sac, 50) == 32 &&
+	      budget.getPercentile(sf_phase_sac, 99) == 64, "percentiles");
+
+	// nothing is counted twice when a superframe is empty
+	budget.closeSuperframe(4);
+	check(budget.getHistogram(SF_PHASES_NUMBER, 0) == 1 &&
+	      budget.getOverruns() == 2, "empty superframe");
+
+	return (failure ? 1 : 0);
+}
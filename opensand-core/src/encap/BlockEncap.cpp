@@ -128,9 +128,35 @@ bool BlockEncap::Downward::onEvent(const RtEvent *const event)
 	return true;
 }
 
-void BlockEncap::Downward::setContext(const std::vector<EncapPlugin::EncapContext *> &encap_ctx)
+BlockEncap::Downward::~Downward()
 {
-	this->ctx = encap_ctx;
+	encap_contexts_t::iterator it;
+
+	// stop the workers before releasing their contexts
+	delete this->workers;
+	for(it = this->workers_ctx.begin(); it != this->workers_ctx.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+bool BlockEncap::Downward::setContext(const std::vector<encap_contexts_t> &encap_ctx)
+{
+	for(unsigned int i = 1; i < encap_ctx.size(); i++)
+	{
+		this->workers_ctx.insert(this->workers_ctx.end(),
+		                         encap_ctx[i].begin(), encap_ctx[i].end());
+	}
+	this->workers = new EncapWorkerPool();
+	if(!this->workers->start(encap_ctx, this->log_receive))
+	{
+		LOG(this->log_init, LEVEL_ERROR,
+		    "cannot start the encapsulation workers\n");
+		return false;
+	}
+	LOG(this->log_init, LEVEL_NOTICE,
+	    "%zu encapsulation worker(s)\n", encap_ctx.size());
+	return true;
 }
 
 bool BlockEncap::Upward::onEvent(const RtEvent *const event)
@@ -251,6 +277,8 @@ bool BlockEncap::onInit()
 	vector <EncapPlugin::EncapContext *> up_return_ctx;
 	vector <EncapPlugin::EncapContext *> up_return_ctx_scpc;
 	vector <EncapPlugin::EncapContext *> down_forward_ctx;
+	vector <encap_contexts_t> workers_ctx;
+	unsigned int workers_number;
 	int lan_nbr;
 	int i = 0;
 	LanAdaptationPlugin *lan_plugin = NULL;
@@ -400,13 +428,28 @@ bool BlockEncap::onInit()
 	    compo_name.c_str());
 	host = getComponentType(compo_name);
 
+	// get the number of encapsulation workers
+	if(!Conf::getValue(Conf::section_map[ADV_SECTION],
+	                   ENCAP_WORKERS, workers_number) ||
+	   workers_number == 0)
+	{
+		LOG(this->log_init, LEVEL_ERROR,
+		    "section '%s': missing or invalid parameter '%s'\n",
+		    ADV_SECTION, ENCAP_WORKERS);
+		goto error;
+	}
+
 	if(host == terminal || this->satellite_type == REGENERATIVE)
 	{
 		// reorder reception context to get the deencapsulation contexts in the
 		// right order
 		reverse(down_forward_ctx.begin(), down_forward_ctx.end());
 		
-		((Downward *)this->downward)->setContext(up_return_ctx);
+		if(!this->getWorkersEncapContext(lan_plugin, up_return_ctx,
+		                                 workers_number, workers_ctx))
+		{
+			goto error;
+		}
 		((Upward *)this->upward)->setContext(down_forward_ctx);
 	}
 	else
@@ -416,10 +459,18 @@ bool BlockEncap::onInit()
 		reverse(up_return_ctx.begin(), up_return_ctx.end());
 		reverse(up_return_ctx_scpc.begin(), up_return_ctx_scpc.end());
 		
-		((Downward *)this->downward)->setContext(down_forward_ctx);
+		if(!this->getWorkersEncapContext(lan_plugin, down_forward_ctx,
+		                                 workers_number, workers_ctx))
+		{
+			goto error;
+		}
 		((Upward *)this->upward)->setContext(up_return_ctx);
 		((Upward *)this->upward)->setSCPCContext(up_return_ctx_scpc);
 	}
+	if(!((Downward *)this->downward)->setContext(workers_ctx))
+	{
+		goto error;
+	}
 
 	return true;
 error:
@@ -428,7 +479,8 @@ error:
 
 bool BlockEncap::Downward::onTimer(event_id_t timer_id)
 {
-	std::map<event_id_t, int>::iterator it;
+	std::map<event_id_t, std::pair<unsigned int, int> >::iterator it;
+	unsigned int worker;
 	int id;
 	NetBurst *burst;
 	bool status = false;
@@ -447,17 +499,18 @@ bool BlockEncap::Downward::onTimer(event_id_t timer_id)
 	}
 
 	// context found
-	id = (*it).second;
+	worker = (*it).second.first;
+	id = (*it).second.second;
 	LOG(this->log_receive, LEVEL_INFO,
-	    "corresponding emission context found (ID = %d)\n",
-	    id);
+	    "corresponding emission context found (ID = %d, worker = %u)\n",
+	    id, worker);
 
 	// remove emission timer from the list
 	this->removeEvent((*it).first);
 	this->timers.erase(it);
 
-	// flush the last encapsulation contexts
-	burst = (this->ctx.back())->flush(id);
+	// flush the last encapsulation contexts of the worker
+	burst = this->workers->flush(worker, id);
 	if(burst == NULL)
 	{
 		LOG(this->log_receive, LEVEL_ERROR,
@@ -496,8 +549,7 @@ error:
 
 bool BlockEncap::Downward::onRcvBurst(NetBurst *burst)
 {
-	map<long, int> time_contexts;
-	vector<EncapPlugin::EncapContext *>::iterator iter;
+	vector<map<long, int> > time_contexts;
 	string name;
 	size_t size;
 	bool status = false;
@@ -516,54 +568,52 @@ bool BlockEncap::Downward::onRcvBurst(NetBurst *burst)
 	    "encapsulate %zu %s packet(s)\n",
 	    size, name.c_str());
 
-	// encapsulate packet
-	for(iter = this->ctx.begin(); iter != this->ctx.end();
-	    iter++)
+	// encapsulate packet, the failing context is logged by the workers
+	burst = this->workers->encapsulate(burst, time_contexts);
+	if(burst == NULL)
 	{
-		burst = (*iter)->encapsulate(burst, time_contexts);
-		if(burst == NULL)
-		{
-			LOG(this->log_receive, LEVEL_ERROR,
-			    "encapsulation failed in %s context\n",
-			    (*iter)->getName().c_str());
-			goto error;
-		}
+		goto error;
 	}
 
 	// set encapsulate timers if needed
-	for(map<long, int>::iterator time_iter = time_contexts.begin();
-	    time_iter != time_contexts.end(); time_iter++)
+	for(unsigned int worker = 0; worker < time_contexts.size(); worker++)
 	{
-		std::map<event_id_t, int>::iterator it;
-		bool found = false;
-
-		// check if there is already a timer armed for the context
-		for(it = this->timers.begin(); !found && it != this->timers.end(); it++)
+		for(map<long, int>::iterator time_iter = time_contexts[worker].begin();
+		    time_iter != time_contexts[worker].end(); time_iter++)
 		{
-		    found = ((*it).second == (*time_iter).second);
-		}
+			std::map<event_id_t, std::pair<unsigned int, int> >::iterator it;
+			std::pair<unsigned int, int> context(worker, (*time_iter).second);
+			bool found = false;
 
-		// set a new timer if no timer was found and timer is not null
-		if(!found && (*time_iter).first != 0)
-		{
-			event_id_t timer;
-			ostringstream name;
+			// check if there is already a timer armed for the context
+			for(it = this->timers.begin(); !found && it != this->timers.end(); it++)
+			{
+			    found = ((*it).second == context);
+			}
 
-			name << "context_" << (*time_iter).second;
-			timer = this->addTimerEvent(name.str(),
-			                            (*time_iter).first,
-			                            false);
+			// set a new timer if no timer was found and timer is not null
+			if(!found && (*time_iter).first != 0)
+			{
+				event_id_t timer;
+				ostringstream name;
 
-			this->timers.insert(std::make_pair(timer, (*time_iter).second));
-			LOG(this->log_receive, LEVEL_INFO,
-			    "timer for context ID %d armed with %ld ms\n",
-			    (*time_iter).second, (*time_iter).first);
-		}
-		else
-		{
-			LOG(this->log_receive, LEVEL_INFO,
-			    "timer already set for context ID %d\n",
-			    (*time_iter).second);
+				name << "context_" << worker << "_" << (*time_iter).second;
+				timer = this->addTimerEvent(name.str(),
+				                            (*time_iter).first,
+				                            false);
+
+				this->timers.insert(std::make_pair(timer, context));
+				LOG(this->log_receive, LEVEL_INFO,
+				    "timer for context ID %d of worker %u armed with "
+				    "%ld ms\n", (*time_iter).second, worker,
+				    (*time_iter).first);
+			}
+			else
+			{
+				LOG(this->log_receive, LEVEL_INFO,
+				    "timer already set for context ID %d of worker %u\n",
+				    (*time_iter).second, worker);
+			}
 		}
 	}
 
@@ -888,6 +938,74 @@ bool BlockEncap::getSCPCEncapContext(LanAdaptationPlugin *l_plugin,
 		return false;
 }
 
+bool BlockEncap::getWorkersEncapContext(LanAdaptationPlugin *l_plugin,
+                                        const vector <EncapPlugin::EncapContext *> &ctx,
+                                        unsigned int workers_number,
+                                        vector <encap_contexts_t> &workers_ctx)
+{
+	vector <EncapPlugin::EncapContext *>::const_iterator it;
+
+	// the first worker uses the plugins contexts
+	workers_ctx.push_back(ctx);
+
+	// the other ones need their own contexts
+	for(unsigned int i = 1; i < workers_number; i++)
+	{
+		StackPlugin *upper_encap = l_plugin;
+
+		workers_ctx.push_back(encap_contexts_t());
+		for(it = ctx.begin(); it != ctx.end(); ++it)
+		{
+			EncapPlugin *plugin;
+			EncapPlugin::EncapContext *context;
+
+			if(!Plugin::getEncapsulationPlugin((*it)->getName(), &plugin))
+			{
+				LOG(this->log_init, LEVEL_ERROR,
+				    "cannot get plugin for %s encapsulation\n",
+				    (*it)->getName().c_str());
+				goto error;
+			}
+
+			context = plugin->createContext();
+			if(context == NULL)
+			{
+				LOG(this->log_init, LEVEL_ERROR,
+				    "cannot create %s encapsulation context for "
+				    "worker %u\n", plugin->getName().c_str(), i);
+				goto error;
+			}
+			workers_ctx.back().push_back(context);
+			if(!context->setUpperPacketHandler(
+						upper_encap->getPacketHandler(),
+						this->satellite_type))
+			{
+				LOG(this->log_init, LEVEL_ERROR,
+				    "upper encapsulation type %s is not supported "
+				    "for %s encapsulation",
+				    upper_encap->getName().c_str(),
+				    context->getName().c_str());
+				goto error;
+			}
+			upper_encap = plugin;
+		}
+	}
+
+	return true;
+
+error:
+	// release the contexts created for the workers
+	for(unsigned int i = 1; i < workers_ctx.size(); i++)
+	{
+		for(it = workers_ctx[i].begin(); it != workers_ctx[i].end(); ++it)
+		{
+			delete *it;
+		}
+	}
+	workers_ctx.clear();
+	return false;
+}
+
 // TODO try to factorize or remove
 /*bool BlockEncap::initModcodFiles(const char *def,
                                  const char *simu,
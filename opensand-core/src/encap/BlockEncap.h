@@ -45,6 +45,7 @@
 #include "OpenSandCore.h"
 #include "LanAdaptationPlugin.h"
 #include "OpenSandFrames.h"
+#include "EncapWorkerPool.h"
 
 
 
@@ -143,18 +144,33 @@ class BlockEncap: public Block
 	 public:
 		Downward(const string &name, tal_id_t UNUSED(mac_id)) :
 			RtDownward(name),
-			EncapChannel()
+			EncapChannel(),
+			workers(NULL),
+			workers_ctx()
 		{};
+		~Downward();
 		bool onEvent(const RtEvent *const event);
 		
-		void setContext(const std::vector<EncapPlugin::EncapContext *> &encap_ctx);
+		/**
+		 * Set the emission contexts and start the encapsulation workers
+		 *
+		 * @param encap_ctx  The emission contexts list from upper to lower
+		 *                   context of each worker, the contexts of the
+		 *                   workers after the first one are released with
+		 *                   the channel
+		 * @return true on success, false otherwise
+		 */
+		bool setContext(const std::vector<encap_contexts_t> &encap_ctx);
 		
 	 private:
-		/// the emission contexts list from lower to upper context
-		std::vector<EncapPlugin::EncapContext *> ctx;
+		/// the workers encapsulating the bursts with their emission contexts
+		EncapWorkerPool *workers;
+
+		/// the emission contexts created for the workers
+		encap_contexts_t workers_ctx;
 		
-		/// Expiration timers for encapsulation contexts
-		std::map<event_id_t, int> timers;
+		/// Expiration timers for encapsulation contexts with their worker
+		std::map<event_id_t, std::pair<unsigned int, int> > timers;
 
 		/**
 		 * Handle a burst received from the upper-layer block
@@ -221,6 +237,21 @@ class BlockEncap: public Block
 	                         string return_link_std,
 	                         const char *link_type);
 
+	/**
+	 *
+	 * Create new contexts for the encapsulation workers
+	 *
+	 * @param l_plugin        The LAN adaptation plugin
+	 * @param ctx             The emission contexts of the first worker
+	 * @param workers_number  The number of workers
+	 * @param workers_ctx     OUT: The emission contexts of each worker
+	 * @return                Whether the contexts have been created or not
+	 */
+	bool getWorkersEncapContext(LanAdaptationPlugin *l_plugin,
+	                            const vector <EncapPlugin::EncapContext *> &ctx,
+	                            unsigned int workers_number,
+	                            vector <encap_contexts_t> &workers_ctx);
+
 	/// initialization method
 	bool onInit();
 };
@@ -0,0 +1,192 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file EncapWorkerPool.cpp
+ * @brief The threads sharing the encapsulation of the bursts by flow
+ */
+
+
+#include "EncapWorkerPool.h"
+
+
+EncapWorkerPool::EncapWorkerPool():
+	workers(),
+	threads(),
+	log(NULL)
+{
+}
+
+EncapWorkerPool::~EncapWorkerPool()
+{
+	vector<encap_worker_t *>::iterator it;
+
+	// the threads are stopped by the pool destructor, they are idle
+	// between two bursts
+	for(it = this->workers.begin(); it != this->workers.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+bool EncapWorkerPool::start(const vector<encap_contexts_t> &contexts,
+                            OutputLog *log)
+{
+	this->log = log;
+	for(unsigned int i = 0; i < contexts.size(); i++)
+	{
+		encap_worker_t *worker = new encap_worker_t;
+
+		worker->pool = this;
+		worker->contexts = contexts[i];
+		worker->burst = NULL;
+		this->workers.push_back(worker);
+	}
+	// one thread per worker, including the calling thread
+	return this->threads.start(contexts.size(), log);
+}
+
+unsigned int EncapWorkerPool::getWorkersNumber() const
+{
+	return this->workers.size();
+}
+
+unsigned int EncapWorkerPool::getWorker(const NetPacket *packet) const
+{
+	// the workers have the same contexts, the flows are the ones of the
+	// lower context that builds the link packets
+	const encap_contexts_t &contexts = this->workers.front()->contexts;
+
+	return contexts.back()->getFlow(packet) % this->workers.size();
+}
+
+NetBurst *EncapWorkerPool::encapsulate(NetBurst *burst,
+                                       vector<map<long, int> > &time_contexts)
+{
+	unsigned int workers_number = this->workers.size();
+	vector<void *> args;
+	NetBurst::iterator packet;
+	NetBurst *encap_burst;
+	bool status = true;
+
+	time_contexts.resize(workers_number);
+	if(workers_number == 1)
+	{
+		encap_worker_t *worker = this->workers.front();
+
+		worker->burst = burst;
+		this->encapsulate(worker);
+		time_contexts[0].swap(worker->time_contexts);
+		worker->time_contexts.clear();
+		encap_burst = worker->burst;
+		worker->burst = NULL;
+		return encap_burst;
+	}
+
+	// dispatch the packets, they now belong to the workers bursts
+	for(unsigned int i = 0; i < workers_number; i++)
+	{
+		this->workers[i]->burst = new NetBurst();
+	}
+	for(packet = burst->begin(); packet != burst->end(); ++packet)
+	{
+		unsigned int i = this->getWorker(*packet);
+		this->workers[i]->burst->push_back(*packet);
+	}
+	burst->clear();
+	delete burst;
+
+	for(unsigned int i = 0; i < workers_number; i++)
+	{
+		if(!this->workers[i]->burst->empty())
+		{
+			args.push_back(this->workers[i]);
+		}
+	}
+	this->threads.run(EncapWorkerPool::runWorker, args);
+
+	// merge the encapsulated packets in the workers order
+	encap_burst = new NetBurst();
+	for(unsigned int i = 0; i < workers_number; i++)
+	{
+		encap_worker_t *worker = this->workers[i];
+
+		time_contexts[i].swap(worker->time_contexts);
+		worker->time_contexts.clear();
+		if(worker->burst == NULL)
+		{
+			status = false;
+			continue;
+		}
+		encap_burst->splice(encap_burst->end(), *worker->burst);
+		delete worker->burst;
+		worker->burst = NULL;
+	}
+	if(!status)
+	{
+		delete encap_burst;
+		return NULL;
+	}
+	return encap_burst;
+}
+
+NetBurst *EncapWorkerPool::flush(unsigned int worker, int context_id)
+{
+	if(worker >= this->workers.size())
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "unknown encapsulation worker %u\n", worker);
+		return NULL;
+	}
+	return this->workers[worker]->contexts.back()->flush(context_id);
+}
+
+void EncapWorkerPool::encapsulate(encap_worker_t *worker)
+{
+	encap_contexts_t::iterator iter;
+
+	for(iter = worker->contexts.begin();
+	    iter != worker->contexts.end() && worker->burst != NULL; ++iter)
+	{
+		worker->burst = (*iter)->encapsulate(worker->burst,
+		                                     worker->time_contexts);
+		if(worker->burst == NULL)
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "encapsulation failed in %s context\n",
+			    (*iter)->getName().c_str());
+		}
+	}
+}
+
+void EncapWorkerPool::runWorker(void *arg)
+{
+	encap_worker_t *worker = (encap_worker_t *)arg;
+
+	worker->pool->encapsulate(worker);
+}
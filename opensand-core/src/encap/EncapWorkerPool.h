@@ -0,0 +1,164 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file EncapWorkerPool.h
+ * @brief The threads sharing the encapsulation of the bursts by flow
+ */
+
+#ifndef ENCAP_WORKER_POOL_H
+#define ENCAP_WORKER_POOL_H
+
+
+#include "NetPacket.h"
+#include "NetBurst.h"
+#include "EncapPlugin.h"
+#include "WorkerPool.h"
+
+#include <opensand_output/Output.h>
+
+#include <map>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+
+/**
+ * @class EncapWorkerPool
+ * @brief The threads sharing the encapsulation of the bursts by flow
+ *
+ * Each worker has its own stack of encapsulation contexts. The packets
+ * of a burst are dispatched to the workers by flow, as defined by the
+ * lower context that builds the link packets (a fragment ID for GSE), so
+ * the packets of a flow are always encapsulated in order by the same
+ * contexts and a fragment ID is never used by two workers. The workers
+ * bursts are the tasks of a WorkerPool, the calling thread encapsulates
+ * some of them and the call returns once every worker is done, with the
+ * encapsulated packets merged in the workers order.
+ *
+ * The packet handlers of the plugins are shared by the workers, the
+ * contexts only call their const methods, which keep no state.
+ */
+class EncapWorkerPool
+{
+ public:
+
+	/**
+	 * @brief Build a pool without worker
+	 */
+	EncapWorkerPool();
+
+	/**
+	 * @brief Stop the worker threads, the contexts are not released
+	 */
+	~EncapWorkerPool();
+
+	/**
+	 * @brief Start the workers
+	 *
+	 * @param contexts  The encapsulation contexts of each worker, from
+	 *                  upper to lower context
+	 * @param log       The log for encapsulation errors
+	 * @return true on success, false otherwise
+	 */
+	bool start(const vector<encap_contexts_t> &contexts, OutputLog *log);
+
+	/**
+	 * @brief Get the number of workers
+	 *
+	 * @return the number of workers
+	 */
+	unsigned int getWorkersNumber() const;
+
+	/**
+	 * @brief Get the worker encapsulating a packet
+	 *
+	 * @param packet  The packet
+	 * @return the worker index
+	 */
+	unsigned int getWorker(const NetPacket *packet) const;
+
+	/**
+	 * @brief Encapsulate a burst
+	 *
+	 * @param burst          The burst, released
+	 * @param time_contexts  OUT: The contexts to flush with their timer
+	 *                       for each worker
+	 * @return the encapsulated packets, NULL on error
+	 */
+	NetBurst *encapsulate(NetBurst *burst,
+	                      vector<map<long, int> > &time_contexts);
+
+	/**
+	 * @brief Flush a context of the lower encapsulation of a worker
+	 *
+	 * @param worker      The worker index
+	 * @param context_id  The context ID
+	 * @return the encapsulated packets, NULL on error
+	 */
+	NetBurst *flush(unsigned int worker, int context_id);
+
+ private:
+
+	/// A worker
+	typedef struct
+	{
+		EncapWorkerPool *pool;       ///< The pool of the worker
+		encap_contexts_t contexts;   ///< The worker contexts
+		NetBurst *burst;             ///< The burst to encapsulate,
+		                             ///< then the encapsulated one
+		map<long, int> time_contexts; ///< The contexts to flush
+	} encap_worker_t;
+
+	/**
+	 * @brief Encapsulate the burst of a worker
+	 *
+	 * @param worker  The worker
+	 */
+	void encapsulate(encap_worker_t *worker);
+
+	/**
+	 * @brief The task encapsulating the burst of a worker
+	 *
+	 * @param arg  The worker
+	 */
+	static void runWorker(void *arg);
+
+	/// The workers
+	vector<encap_worker_t *> workers;
+
+	/// The threads running the workers
+	WorkerPool threads;
+
+	/// The log for encapsulation errors
+	OutputLog *log;
+};
+
+
+#endif
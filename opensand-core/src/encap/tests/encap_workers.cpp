@@ -0,0 +1,474 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file encap_workers.cpp
+ * @brief Check that the encapsulation workers keep the flows order and
+ *        the fragment IDs, and measure the encapsulation rate with the
+ *        number of workers
+ */
+
+
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <opensand_output/Output.h>
+
+#include <EncapWorkerPool.h>
+#include <TestTimer.h>
+
+/// The number of packets in a burst
+#define BURST_PACKETS 256
+/// The number of flows in the bursts
+#define BURST_FLOWS 64
+/// The number of bursts measured for each number of workers
+#define BURSTS 400
+/// The length of the packets
+#define PACKET_LENGTH 1000
+/// The length of the fragmented packets
+#define PDU_LENGTH 9000
+/// The maximum length of a fragment, as a GSE packet
+#define FRAGMENT_LENGTH 4096
+
+
+
+/**
+ * @class TestPlugin
+ * @brief A plugin only used to build the test contexts
+ */
+class TestPlugin: public EncapPlugin
+{
+ public:
+
+	TestPlugin(): EncapPlugin(0xffff)
+	{
+		this->name = "TEST";
+		this->context = NULL;
+		this->packet_handler = NULL;
+	};
+
+	/**
+	 * @class Context
+	 * @brief A context checking that it gets all the packets of its flows
+	 *        in order, with some work on the packets data
+	 */
+	class Context: public EncapContext
+	{
+	 public:
+
+		Context(EncapPlugin &plugin):
+			EncapContext(plugin),
+			sequences(),
+			failure(false)
+		{};
+
+		NetBurst *encapsulate(NetBurst *burst,
+		                      std::map<long, int> &time_contexts)
+		{
+			NetBurst *encap_burst = new NetBurst();
+			NetBurst::iterator packet;
+
+			for(packet = burst->begin(); packet != burst->end(); ++packet)
+			{
+				const Data &data = (*packet)->getData();
+				int flow = ((*packet)->getDstTalId() << 3) | (*packet)->getQos();
+				unsigned int sequence = data.at(0) | (data.at(1) << 8);
+				uint32_t sum = 0;
+				Data encap_data;
+
+				// the flows of a context are only sent to this context
+				std::map<int, unsigned int>::iterator it = this->sequences.find(flow);
+				if(it != this->sequences.end() && sequence != (*it).second + 1)
+				{
+					this->failure = true;
+				}
+				this->sequences[flow] = sequence;
+
+				// some work on the data, as a header compression would do
+				for(unsigned int j = 0; j < 8; j++)
+				{
+					for(unsigned int i = 0; i < data.length(); i++)
+					{
+						sum = (sum << 1 | sum >> 31) ^ data[i];
+					}
+				}
+				encap_data.append(1, (unsigned char)(sum & 0xff));
+				encap_data.append(data);
+				encap_burst->add(new NetPacket(encap_data, encap_data.length(),
+				                               "TEST", 0xffff,
+				                               (*packet)->getQos(),
+				                               (*packet)->getSrcTalId(),
+				                               (*packet)->getDstTalId(), 1));
+				time_contexts.insert(std::make_pair(10L, flow));
+			}
+			delete burst;
+			return encap_burst;
+		};
+
+		NetBurst *deencapsulate(NetBurst *burst)
+		{
+			return burst;
+		};
+
+		NetBurst *flush(int UNUSED(context_id))
+		{
+			return new NetBurst();
+		};
+
+		NetBurst *flushAll()
+		{
+			return new NetBurst();
+		};
+
+		/// The last sequence number of each flow
+		std::map<int, unsigned int> sequences;
+
+		/// Whether a flow was not received in order
+		bool failure;
+	};
+};
+
+
+/**
+ * @class FragPlugin
+ * @brief A plugin fragmenting the packets as GSE does, with a fragment ID
+ *        per source and QoS
+ */
+class FragPlugin: public EncapPlugin
+{
+ public:
+
+	FragPlugin(): EncapPlugin(0xfffe)
+	{
+		this->name = "FRAG";
+		this->context = NULL;
+		this->packet_handler = NULL;
+	};
+
+	/**
+	 * @class Context
+	 * @brief A context fragmenting the packets, the fragments start with
+	 *        the fragment ID and whether they are the last one
+	 */
+	class Context: public EncapContext
+	{
+	 public:
+
+		Context(EncapPlugin &plugin):
+			EncapContext(plugin),
+			frag_ids()
+		{};
+
+		unsigned int getFlow(const NetPacket *packet) const
+		{
+			return ((packet->getSrcTalId() & 0x1f) << 3) |
+			       (packet->getQos() & 0x07);
+		};
+
+		NetBurst *encapsulate(NetBurst *burst,
+		                      std::map<long, int> &UNUSED(time_contexts))
+		{
+			NetBurst *encap_burst = new NetBurst();
+			NetBurst::iterator packet;
+
+			for(packet = burst->begin(); packet != burst->end(); ++packet)
+			{
+				const Data &data = (*packet)->getData();
+				uint8_t frag_id = this->getFlow(*packet);
+
+				this->frag_ids.insert(frag_id);
+				for(size_t pos = 0; pos < data.length(); pos += FRAGMENT_LENGTH)
+				{
+					size_t length = std::min(data.length() - pos,
+					                         (size_t)FRAGMENT_LENGTH);
+					Data fragment;
+
+					fragment.append(1, frag_id);
+					fragment.append(1, pos + length == data.length());
+					fragment.append(data.substr(pos, length));
+					encap_burst->add(new NetPacket(fragment, fragment.length(),
+					                               "FRAG", 0xfffe,
+					                               (*packet)->getQos(),
+					                               (*packet)->getSrcTalId(),
+					                               (*packet)->getDstTalId(), 2));
+				}
+			}
+			delete burst;
+			return encap_burst;
+		};
+
+		NetBurst *deencapsulate(NetBurst *burst)
+		{
+			return burst;
+		};
+
+		NetBurst *flush(int UNUSED(context_id))
+		{
+			return new NetBurst();
+		};
+
+		NetBurst *flushAll()
+		{
+			return new NetBurst();
+		};
+
+		/// The fragment IDs used by the context
+		std::set<uint8_t> frag_ids;
+	};
+};
+
+
+/**
+ * @brief Build a burst with the packets of several flows
+ *
+ * @param sequences  the next sequence number of each flow
+ * @param seed       the random seed
+ * @return the burst
+ */
+static NetBurst *getBurst(std::vector<unsigned int> &sequences,
+                          unsigned int &seed)
+{
+	NetBurst *burst = new NetBurst();
+
+	for(unsigned int i = 0; i < BURST_PACKETS; i++)
+	{
+		unsigned int flow = rand_r(&seed) % BURST_FLOWS;
+		unsigned int sequence = sequences[flow]++;
+		Data data;
+
+		data.append(1, (unsigned char)(sequence & 0xff));
+		data.append(1, (unsigned char)((sequence >> 8) & 0xff));
+		data.append(PACKET_LENGTH - 2, (unsigned char)flow);
+		burst->add(new NetPacket(data, data.length(), "DATA", 0x0800,
+		                         flow & 0x07, 0, flow >> 3, 0));
+	}
+	return burst;
+}
+
+int main()
+{
+	unsigned int workers[] = {1, 2, 4, 8};
+	std::vector<double> rates;
+	bool failure;
+
+	failure = false;
+	Output::init(false);
+	NetBurst::log_net_burst = Output::registerLog(LEVEL_WARNING, "NetBurst");
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	OutputLog *log = Output::registerLog(LEVEL_WARNING, "Encap");
+	NetPacket flow_packet(Data(), 0, "DATA", 0x0800, 3, 0, 5, 0);
+	{
+		TestPlugin plugin;
+		TestPlugin::Context context(plugin);
+		std::vector<encap_contexts_t> contexts(3, encap_contexts_t(1, &context));
+		EncapWorkerPool pool;
+
+		pool.start(contexts, log);
+		check(pool.getWorker(&flow_packet) == ((5 << 3) | 3) % 3,
+		      "worker of a flow");
+	}
+
+	// the PDUs of a source and QoS to several terminals share a fragment
+	// ID, their fragments are built by a single worker
+	{
+		FragPlugin plugin;
+		FragPlugin::Context context0(plugin);
+		FragPlugin::Context context1(plugin);
+		std::vector<encap_contexts_t> contexts;
+		std::vector<std::map<long, int> > time_contexts;
+		std::map<uint8_t, Data> partial;
+		std::vector<unsigned int> pdus(8, 0);
+		EncapWorkerPool pool;
+		NetBurst *burst = new NetBurst();
+		bool reassembled = true;
+		unsigned int count = 0;
+
+		contexts.push_back(encap_contexts_t(1, &context0));
+		contexts.push_back(encap_contexts_t(1, &context1));
+		pool.start(contexts, log);
+		for(unsigned int i = 0; i < 32; i++)
+		{
+			// the first byte is the QoS, then the destination
+			Data data;
+
+			data.append(1, (unsigned char)(i % 3));
+			data.append(PDU_LENGTH - 1, (unsigned char)(i % 7));
+			burst->add(new NetPacket(data, data.length(), "DATA", 0x0800,
+			                         i % 3, 1, i % 7, 0));
+		}
+		burst = pool.encapsulate(burst, time_contexts);
+		for(NetBurst::iterator packet = burst->begin();
+		    packet != burst->end(); ++packet)
+		{
+			const Data &fragment = (*packet)->getData();
+			Data &pdu = partial[fragment.at(0)];
+
+			count++;
+			pdu.append(fragment.substr(2));
+			if(!fragment.at(1))
+			{
+				continue;
+			}
+			// a whole PDU of the fragment ID, without another one mixed in
+			reassembled &= (pdu.length() == PDU_LENGTH &&
+			                ((1 << 3) | pdu.at(0)) == fragment.at(0) &&
+			                pdu.find_first_not_of(pdu.at(1), 1) == Data::npos);
+			pdus[pdu.at(0)]++;
+			pdu.clear();
+		}
+		delete burst;
+		for(unsigned int qos = 0; qos < 3; qos++)
+		{
+			uint8_t frag_id = (1 << 3) | qos;
+
+			reassembled &= (partial[frag_id].empty() &&
+			                context0.frag_ids.count(frag_id) +
+			                context1.frag_ids.count(frag_id) == 1);
+		}
+		check(reassembled && count == 32 * 3 &&
+		      pdus[0] + pdus[1] + pdus[2] == 32, "fragment IDs on one worker");
+	}
+
+	printf("%10s %15s\n", "workers", "packets/s");
+	for(unsigned int i = 0; i < sizeof(workers) / sizeof(workers[0]); i++)
+	{
+		TestPlugin plugin;
+		std::vector<encap_contexts_t> contexts;
+		std::vector<TestPlugin::Context *> test_contexts;
+		std::vector<unsigned int> sequences(BURST_FLOWS, 0);
+		std::vector<unsigned int> received(BURST_FLOWS, 0);
+		std::vector<std::map<long, int> > time_contexts;
+		std::set<int> flows;
+		EncapWorkerPool *pool = new EncapWorkerPool();
+		unsigned int seed = 42;
+		unsigned int packets = 0;
+		bool in_order = true;
+		bool flushed = true;
+		uint64_t start;
+		double duration = 0;
+
+		for(unsigned int j = 0; j < workers[i]; j++)
+		{
+			TestPlugin::Context *context = new TestPlugin::Context(plugin);
+
+			test_contexts.push_back(context);
+			contexts.push_back(encap_contexts_t(1, context));
+		}
+		if(!pool->start(contexts, log))
+		{
+			check(false, "start workers");
+			return 1;
+		}
+
+		for(unsigned int j = 0; j < BURSTS; j++)
+		{
+			NetBurst *burst = getBurst(sequences, seed);
+			NetBurst::iterator packet;
+
+			start = getNanoseconds();
+			burst = pool->encapsulate(burst, time_contexts);
+			duration += getNanoseconds() - start;
+			if(burst == NULL)
+			{
+				in_order = false;
+				continue;
+			}
+
+			// the flows are in order in the merged burst
+			for(packet = burst->begin(); packet != burst->end(); ++packet)
+			{
+				const Data &data = (*packet)->getData();
+				unsigned int flow = ((*packet)->getDstTalId() << 3) |
+				                    (*packet)->getQos();
+				unsigned int sequence = data.at(1) | (data.at(2) << 8);
+
+				if(sequence != received[flow])
+				{
+					in_order = false;
+				}
+				received[flow] = sequence + 1;
+				packets++;
+			}
+			delete burst;
+
+			// each flow has a timer on the worker encapsulating it
+			for(unsigned int k = 0; k < time_contexts.size(); k++)
+			{
+				std::map<long, int>::iterator it;
+
+				for(it = time_contexts[k].begin();
+				    it != time_contexts[k].end(); ++it)
+				{
+					NetPacket flow_packet(Data(), 0, "DATA", 0x0800,
+					                      (*it).second & 0x07, 0,
+					                      (*it).second >> 3, 0);
+
+					flushed &= (pool->getWorker(&flow_packet) == k);
+					burst = pool->flush(k, (*it).second);
+					flushed &= (burst != NULL);
+					delete burst;
+				}
+			}
+		}
+		delete pool;
+
+		for(unsigned int j = 0; j < test_contexts.size(); j++)
+		{
+			std::map<int, unsigned int>::iterator it;
+
+			in_order &= !test_contexts[j]->failure;
+			for(it = test_contexts[j]->sequences.begin();
+			    it != test_contexts[j]->sequences.end(); ++it)
+			{
+				// a flow is only encapsulated by one worker
+				in_order &= flows.insert((*it).first).second;
+			}
+			delete test_contexts[j];
+		}
+		check(in_order && packets == BURSTS * BURST_PACKETS,
+		      "flows in order");
+		check(flushed, "timers on the flows worker");
+		printf("%10u %15.0f\n", workers[i], packets / duration * 1e9);
+	}
+
+	return (failure ? 1 : 0);
+}
@@ -135,7 +135,7 @@ void InterconnectChannelSender::serialize(DvbFrame *dvb_frame,
 	pos += sizeof(spot);
 	memcpy(buf + pos, &carrier_id, sizeof(carrier_id));
 	pos += sizeof(carrier_id);
-	memcpy(buf + pos, dvb_frame->getData().c_str(),
+	memcpy(buf + pos, dvb_frame->getBuffer().data(),
 	       dvb_frame->getTotalLength());
 	length = total_len;
 }
@@ -194,10 +194,12 @@ void InterconnectChannelReceiver::initUdpChannels(unsigned int data_port, unsign
 }
 
 int InterconnectChannelReceiver::receiveToBuffer(NetSocketEvent *const event,
+                                                 unsigned char **datagram,
                                                  interconnect_msg_buffer_t **buf)
 {
 	int ret = -1;
 	size_t length = 0;
+	*datagram = NULL;
 	*buf = NULL;
 
 	LOG(this->log_interconnect, LEVEL_DEBUG,
@@ -207,11 +209,11 @@ int InterconnectChannelReceiver::receiveToBuffer(NetSocketEvent *const event,
 	// Try to receive data from the channel
 	if(*event == this->sig_channel->getChannelFd())
 	{
-		ret = this->sig_channel->receive(event, (unsigned char **) buf, length);
+		ret = this->sig_channel->receive(event, datagram, length);
 	}
 	else
 	{
-		ret = this->data_channel->receive(event, (unsigned char **) buf, length);
+		ret = this->data_channel->receive(event, datagram, length);
 	}
 
 	LOG(this->log_interconnect, LEVEL_DEBUG,
@@ -220,11 +222,16 @@ int InterconnectChannelReceiver::receiveToBuffer(NetSocketEvent *const event,
 	// Check that the total_length is correct, and fix data length
 	if(ret >= 0 && length > 0)
 	{
+		// the message is read in place, after the UDP sequencing field
+		*buf = (interconnect_msg_buffer_t *)(*datagram + UDP_SEQ_LEN);
 		if((*buf)->data_len != length)
 		{
 			LOG(this->log_interconnect, LEVEL_ERROR,
 			    "Data length received (%zu) mismatches with message length (%zu)\n",
 			    length, (*buf)->data_len);
+			event->releaseData(*datagram);
+			*datagram = NULL;
+			*buf = NULL;
 			return -1;
 		}
 		(*buf)->data_len -= (sizeof((*buf)->data_len) + sizeof((*buf)->msg_type));
@@ -232,6 +239,7 @@ int InterconnectChannelReceiver::receiveToBuffer(NetSocketEvent *const event,
 	// If empty packet, return null pointer
 	else if(ret >= 0 && length == 0)
 	{
+		*datagram = NULL;
 		*buf = NULL;
 	}
 
@@ -256,9 +264,10 @@ bool InterconnectChannelReceiver::receive(NetSocketEvent *const event,
 	// Start receiving messages
 	do
 	{
+		unsigned char *datagram = NULL;
 		interconnect_msg_buffer_t *buf = NULL;
 
-		ret = this->receiveToBuffer(event, &buf);
+		ret = this->receiveToBuffer(event, &datagram, &buf);
 		if(ret < 0)
 		{
 			// Problem on reception
@@ -296,11 +305,11 @@ bool InterconnectChannelReceiver::receive(NetSocketEvent *const event,
 					LOG(this->log_interconnect, LEVEL_ERROR,
 					    "Unknown type of message received\n");
 					status = false;
-					free(buf);
+					event->releaseData(datagram);
 					continue;
 			}
-			// Free buf
-			free(buf);
+			// Give the buffer back to the event
+			event->releaseData(datagram);
 
 			// Insert the message in the list
 			messages.push_back(message);
@@ -190,9 +190,14 @@ class InterconnectChannelReceiver: public InterconnectChannel
 
 	/**
 	 * @brief Receive a message from the socket
+	 *
+	 * @param event     The event on the socket
+	 * @param datagram  OUT: the datagram buffer, to be released on event
+	 * @param buf       OUT: the message inside the datagram
 	 * @return -1 on error, 1 if more packets can be read, 0 if last packet.
 	 */
 	int receiveToBuffer(NetSocketEvent *const event,
+	                    unsigned char **datagram,
 	                    interconnect_msg_buffer_t **buf);
 
 	/**
@@ -40,6 +40,7 @@
 
 #include <cstdio>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <linux/if_tun.h>
 #include <net/if.h>
@@ -277,8 +278,9 @@ bool BlockLanAdaptation::Upward::onMsgFromDown(NetBurst *burst)
 			    "%s packet received from lower layer & should "
 			    "be read\n", (*burst_it)->getName().c_str());
 			
-			Data packet = (*burst_it)->getData();
+			const PacketBuffer &packet = (*burst_it)->getBuffer();
 			unsigned char head[TUNTAP_FLAGS_LEN];
+			struct iovec iov[2];
 			for(unsigned int i = 0; i < TUNTAP_FLAGS_LEN; i++)
 			{
 				// add the protocol flag in the header
@@ -288,8 +290,12 @@ bool BlockLanAdaptation::Upward::onMsgFromDown(NetBurst *burst)
 				    head[i], i);
 			}
 
-			packet.insert(0, head, TUNTAP_FLAGS_LEN);
-			if(write(this->fd, packet.data(), packet.length()) < 0)
+			// write the header and the packet without copying them together
+			iov[0].iov_base = head;
+			iov[0].iov_len = TUNTAP_FLAGS_LEN;
+			iov[1].iov_base = (void *)packet.data();
+			iov[1].iov_len = packet.length();
+			if(writev(this->fd, iov, 2) < 0)
 			{
 				LOG(this->log_receive, LEVEL_ERROR,
 				    "Unable to write data on tun or tap "
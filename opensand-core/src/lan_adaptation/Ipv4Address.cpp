@@ -133,3 +133,12 @@ int Ipv4Address::version() const
 {
 	return 4;
 }
+
+unsigned char Ipv4Address::at(unsigned int i) const
+{
+	if(i < Ipv4Address::length())
+	{
+		return this->_ip[i];
+	}
+	return 0;
+}
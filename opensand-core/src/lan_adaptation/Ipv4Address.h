@@ -90,6 +90,7 @@ class Ipv4Address: public IpAddress
 	std::string str();
 	bool matchAddressWithMask(const IpAddress *addr, unsigned int mask) const;
 	int version() const;
+	unsigned char at(unsigned int i) const;
 };
 
 #endif
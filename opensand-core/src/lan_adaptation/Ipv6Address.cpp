@@ -199,3 +199,12 @@ int Ipv6Address::version() const
 {
 	return 6;
 }
+
+unsigned char Ipv6Address::at(unsigned int i) const
+{
+	if(i < Ipv6Address::length())
+	{
+		return this->_ip.s6_addr[i];
+	}
+	return 0;
+}
@@ -109,6 +109,7 @@ class Ipv6Address: public IpAddress
 	std::string str();
 	bool matchAddressWithMask(const IpAddress *addr, unsigned int mask) const;
 	int version() const;
+	unsigned char at(unsigned int i) const;
 };
 
 #endif
@@ -0,0 +1,271 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file evc_classifier.cpp
+ * @brief Check the EVC classifier against a linear search on the EVC
+ *        and measure the lookup cost with the number of EVC
+ */
+
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include <EvcClassifier.h>
+#include <TestTimer.h>
+
+/// The number of lookups measured for each number of EVC
+#define EVC_LOOKUPS 100000
+
+/// A frame to classify
+typedef struct
+{
+	MacAddress *src;
+	MacAddress *dst;
+	uint16_t q_tci;
+	uint16_t ad_tci;
+	uint16_t ether_type;
+	evc_match_t match;
+} frame_t;
+
+
+/**
+ * @brief Search the EVC of a frame linearly, as the Ethernet plugin used to
+ *
+ * @param evcs    the EVC by ID
+ * @param frame   the frame
+ * @param evc_id  the ID of the EVC found
+ * @return the EVC if found, NULL otherwise
+ */
+static Evc *linearSearch(const std::map<uint8_t, Evc *> &evcs,
+                         const frame_t &frame, uint8_t &evc_id)
+{
+	for(std::map<uint8_t, Evc *>::const_iterator it = evcs.begin();
+	    it != evcs.end(); ++it)
+	{
+		bool matches = false;
+
+		switch(frame.match)
+		{
+			case EVC_MATCH_ETH:
+				matches = (*it).second->matches(frame.src, frame.dst,
+				                                frame.ether_type);
+				break;
+			case EVC_MATCH_Q:
+				matches = (*it).second->matches(frame.src, frame.dst,
+				                                frame.q_tci,
+				                                frame.ether_type);
+				break;
+			case EVC_MATCH_AD:
+				matches = (*it).second->matches(frame.src, frame.dst,
+				                                frame.q_tci, frame.ad_tci,
+				                                frame.ether_type);
+				break;
+		}
+		if(matches)
+		{
+			evc_id = (*it).first;
+			return (*it).second;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Get the string of a random MAC address
+ *
+ * @param seed     the random seed
+ * @param generic  whether the last byte is generic
+ * @return the MAC address string
+ */
+static std::string getMac(unsigned int &seed, bool generic)
+{
+	char mac[18];
+
+	// few addresses, so that frames match several EVC
+	snprintf(mac, sizeof(mac), "00:00:00:00:%02x:%02x",
+	         rand_r(&seed) % 4, rand_r(&seed) % 16);
+	if(generic)
+	{
+		mac[15] = '*';
+		mac[16] = '*';
+	}
+	return std::string(mac);
+}
+
+int main()
+{
+	unsigned int sizes[] = {4, 64, 256};
+	bool failure;
+
+	failure = false;
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	EvcClassifier classifier;
+	evc_cache_t cache;
+	uint8_t evc_id = 0;
+	Evc evc1(new MacAddress("00:00:00:00:00:01"),
+	         new MacAddress("00:00:00:00:00:02"), 10, 20, 0x0800);
+	Evc evc2(new MacAddress("00:00:00:00:00:**"),
+	         new MacAddress("00:00:00:00:00:02"), 10, 30, 0x0800);
+	Evc evc3(new MacAddress("00:00:00:00:00:01"),
+	         new MacAddress("00:00:00:00:00:02"), 10, 20, 0x0800);
+	MacAddress mac1(0, 0, 0, 0, 0, 1);
+	MacAddress mac2(0, 0, 0, 0, 0, 2);
+	MacAddress mac3(0, 0, 0, 0, 0, 3);
+	EvcClassifier::clearCache(cache);
+	check(classifier.add(3, &evc3) && classifier.add(5, &evc1) &&
+	      classifier.add(4, &evc2), "add EVC");
+	check(classifier.find(mac1, mac2, 10, 20, 0x0800, EVC_MATCH_AD,
+	                      cache, evc_id) == &evc3 && evc_id == 3,
+	      "lowest EVC ID");
+	check(classifier.find(mac1, mac2, 10, 20, 0x0800, EVC_MATCH_AD,
+	                      cache, evc_id) == &evc3 && evc_id == 3,
+	      "cached EVC");
+	check(classifier.find(mac3, mac2, 10, 30, 0x0800, EVC_MATCH_AD,
+	                      cache, evc_id) == &evc2 && evc_id == 4,
+	      "generic MAC address");
+	check(classifier.find(mac3, mac2, 10, 99, 0x0800, EVC_MATCH_Q,
+	                      cache, evc_id) == &evc2 && evc_id == 4,
+	      "ad TCI ignored");
+	check(classifier.find(mac1, mac2, 11, 20, 0x0800, EVC_MATCH_ETH,
+	                      cache, evc_id) == &evc3 && evc_id == 3,
+	      "TCI ignored");
+	check(classifier.find(mac1, mac2, 10, 20, 0x86dd, EVC_MATCH_ETH,
+	                      cache, evc_id) == NULL,
+	      "unknown EtherType");
+	check(classifier.find(mac1, mac2, 10, 20, 0x86dd, EVC_MATCH_ETH,
+	                      cache, evc_id) == NULL,
+	      "cached unknown EtherType");
+
+	// compare with a linear search on random EVC and frames,
+	// then measure the lookup cost
+	printf("%10s %15s %15s\n", "EVC", "classifier (ns)", "linear (ns)");
+	for(unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		EvcClassifier evc_classifier;
+		std::map<uint8_t, Evc *> evcs;
+		std::vector<frame_t> frames;
+		unsigned int seed = 42;
+		unsigned int lookups;
+		uint8_t id1 = 0;
+		uint8_t id2 = 0;
+		bool match = true;
+		uint64_t start;
+		double classifier_duration;
+		double linear_duration;
+
+		EvcClassifier::clearCache(cache);
+		for(unsigned int j = 0; j < sizes[i]; j++)
+		{
+			Evc *evc;
+			uint8_t id = sizes[i] - 1 - j;
+
+			evc = new Evc(new MacAddress(getMac(seed, j % 8 == 0)),
+			              new MacAddress(getMac(seed, j % 16 == 1)),
+			              rand_r(&seed) % 4, rand_r(&seed) % 4,
+			              j % 2 ? 0x0800 : 0x86dd);
+			evcs[id] = evc;
+			evc_classifier.add(id, evc);
+		}
+		for(unsigned int j = 0; j < 1000; j++)
+		{
+			frame_t frame;
+			std::string src = getMac(seed, false);
+			std::string dst = getMac(seed, false);
+
+			frame.src = new MacAddress(src);
+			frame.dst = new MacAddress(dst);
+			frame.q_tci = rand_r(&seed) % 4;
+			frame.ad_tci = rand_r(&seed) % 4;
+			frame.ether_type = rand_r(&seed) % 2 ? 0x0800 : 0x86dd;
+			frame.match = (evc_match_t)(rand_r(&seed) % 3);
+			frames.push_back(frame);
+		}
+
+		// twice to check the cached lookups
+		for(unsigned int j = 0; j < 2 * frames.size(); j++)
+		{
+			const frame_t &frame = frames[j % frames.size()];
+			Evc *evc1 = evc_classifier.find(*frame.src, *frame.dst,
+			                                frame.q_tci, frame.ad_tci,
+			                                frame.ether_type, frame.match,
+			                                cache, id1);
+			Evc *evc2 = linearSearch(evcs, frame, id2);
+			if(evc1 != evc2 || (evc1 && id1 != id2))
+			{
+				match = false;
+			}
+		}
+		check(match, "same EVC as linear search");
+
+		lookups = EVC_LOOKUPS;
+		start = getNanoseconds();
+		for(unsigned int j = 0; j < lookups; j++)
+		{
+			const frame_t &frame = frames[j % frames.size()];
+			evc_classifier.find(*frame.src, *frame.dst,
+			                    frame.q_tci, frame.ad_tci,
+			                    frame.ether_type, frame.match, cache, id1);
+		}
+		classifier_duration = (double)(getNanoseconds() - start) / lookups;
+
+		start = getNanoseconds();
+		for(unsigned int j = 0; j < lookups; j++)
+		{
+			linearSearch(evcs, frames[j % frames.size()], id2);
+		}
+		linear_duration = (double)(getNanoseconds() - start) / lookups;
+		printf("%10u %15.1f %15.1f\n", sizes[i],
+		       classifier_duration, linear_duration);
+
+		for(std::map<uint8_t, Evc *>::iterator it = evcs.begin();
+		    it != evcs.end(); ++it)
+		{
+			delete (*it).second;
+		}
+		for(unsigned int j = 0; j < frames.size(); j++)
+		{
+			delete frames[j].src;
+			delete frames[j].dst;
+		}
+	}
+
+	return (failure ? 1 : 0);
+}
@@ -0,0 +1,273 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file ip_classifier.cpp
+ * @brief Check the IP classifier against the IP packets accessors and
+ *        measure the classification cost of a burst
+ */
+
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <opensand_output/Output.h>
+
+#include <IpClassifier.h>
+#include <Ipv4Packet.h>
+#include <Ipv6Packet.h>
+#include <Ipv4Address.h>
+#include <NetBurst.h>
+#include <SarpTable.h>
+#include <TestTimer.h>
+
+/// The number of packets in a burst
+#define IP_BURST_PACKETS 64
+/// The number of bursts measured
+#define IP_BURSTS 10000
+
+
+/**
+ * @brief Build a random IP packet
+ *
+ * @param seed  the random seed
+ * @return the packet
+ */
+static NetPacket *getPacket(unsigned int &seed)
+{
+	unsigned char data[60];
+	unsigned int length = 40 + rand_r(&seed) % 20;
+	uint32_t sum = 0;
+
+	for(unsigned int i = 0; i < sizeof(data); i++)
+	{
+		data[i] = rand_r(&seed);
+	}
+	switch(rand_r(&seed) % 8)
+	{
+		case 0:
+			// too short or unknown version
+			return new NetPacket(data, rand_r(&seed) % 2 ? 12 : length);
+		case 1:
+		case 2:
+		case 3:
+			data[0] = 0x60 | (data[0] & 0x0f);
+			// few addresses, so that some are in the SARP table
+			data[24] = 0x20;
+			data[25] = 0x01;
+			data[26] = rand_r(&seed) % 2;
+			break;
+		default:
+			data[0] = 0x45;
+			data[2] = 0;
+			data[3] = length;
+			data[16] = 192;
+			data[17] = 168;
+			data[18] = rand_r(&seed) % 4;
+			data[10] = 0;
+			data[11] = 0;
+			for(unsigned int i = 0; i < 20; i += 2)
+			{
+				sum += (data[i] << 8) | data[i + 1];
+			}
+			sum = (sum >> 16) + (sum & 0xffff);
+			sum = (sum >> 16) + (sum & 0xffff);
+			data[10] = (~sum >> 8) & 0xff;
+			data[11] = ~sum & 0xff;
+	}
+	return new NetPacket(data, length);
+}
+
+/**
+ * @brief Classify a packet with the IP packets accessors and the
+ *        traffic categories map, as the IP plugin used to
+ *
+ * @param packet      the packet
+ * @param categories  the traffic categories by DSCP
+ * @param sarp_table  the SARP table
+ * @param ip_class    OUT: the packet classification
+ */
+static void classifyPacket(const NetPacket *packet,
+                           const std::map<qos_t, TrafficCategory *> &categories,
+                           const SarpTable *sarp_table,
+                           ip_class_t &ip_class)
+{
+	std::map<qos_t, TrafficCategory *>::const_iterator found;
+	IpPacket *ip_packet;
+
+	memset(&ip_class, 0, sizeof(ip_class));
+	ip_class.version = IpPacket::version(packet->getData());
+	switch(ip_class.version)
+	{
+		case 4:
+			ip_packet = new Ipv4Packet(packet->getData());
+			break;
+		case 6:
+			ip_packet = new Ipv6Packet(packet->getData());
+			break;
+		default:
+			return;
+	}
+	if(ip_packet->isValid())
+	{
+		ip_class.valid = true;
+		ip_class.dscp = ip_packet->diffServCodePoint();
+		found = categories.find(ip_class.dscp);
+		if(found != categories.end())
+		{
+			ip_class.category = (*found).second;
+		}
+		ip_class.dst_found = sarp_table->getTalByIp(ip_packet->dstAddr(),
+		                                            ip_class.dst_tal_id);
+	}
+	delete ip_packet;
+}
+
+int main()
+{
+	std::map<qos_t, TrafficCategory *> categories;
+	IpClassifier classifier;
+	TrafficCategory expedited;
+	TrafficCategory assured;
+	TrafficCategory best_effort;
+	std::vector<ip_class_t> classes;
+	std::vector<NetBurst *> bursts;
+	unsigned int seed = 42;
+	unsigned int mismatches;
+	ip_class_t ip_class;
+	uint64_t start;
+	double classifier_duration;
+	double packets_duration;
+	bool failure;
+
+	failure = false;
+	Output::init(false);
+
+#define check(test, name) \
+	do { \
+		bool result = (test); \
+		std::cout << (name) << " => " << (result ? "ok" : "failed") \
+		          << std::endl; \
+		if(!result) \
+			failure = true; \
+	} while(0)
+
+	SarpTable sarp_table;
+	expedited.setId(0);
+	assured.setId(1);
+	best_effort.setId(2);
+	categories[184] = &expedited;
+	categories[72] = &assured;
+	categories[0] = &best_effort;
+	check(classifier.setCategory(184, &expedited) &&
+	      classifier.setCategory(72, &assured) &&
+	      classifier.setCategory(0, &best_effort),
+	      "DSCP categories");
+	check(!classifier.setCategory(185, &expedited) &&
+	      !classifier.setCategory(256, &expedited) &&
+	      classifier.getCategory(184) == &expedited,
+	      "not DSCP values");
+	sarp_table.add(new Ipv4Address(192, 168, 1, 0), 24, 1);
+	sarp_table.add(new Ipv4Address(192, 168, 2, 0), 23, 2);
+	sarp_table.add(new Ipv6Address(0x20, 0x01, 0, 0, 0, 0, 0, 0,
+	                               0, 0, 0, 0, 0, 0, 0, 0), 24, 3);
+	sarp_table.setDefaultTal(0);
+	// the IP packets accessors log the invalid packets
+	IpPacket::ip_log = Output::registerLog(LEVEL_CRITICAL, "IP");
+	NetBurst::log_net_burst = Output::registerLog(LEVEL_WARNING, "NetBurst");
+
+	// compare with the IP packets accessors on random bursts
+	mismatches = 0;
+	for(unsigned int i = 0; i < 100; i++)
+	{
+		NetBurst *burst = new NetBurst();
+		NetBurst::const_iterator packet;
+		unsigned int j = 0;
+
+		for(unsigned int k = 0; k < IP_BURST_PACKETS; k++)
+		{
+			burst->add(getPacket(seed));
+		}
+		classifier.classify(burst, &sarp_table, classes);
+		for(packet = burst->begin(); packet != burst->end(); ++packet, ++j)
+		{
+			classifyPacket(*packet, categories, &sarp_table, ip_class);
+			// the IPv4 checksum is only checked by the IP packets
+			if(classes[j].version != ip_class.version ||
+			   (classes[j].valid != ip_class.valid &&
+			    (ip_class.valid || ip_class.version != 4)) ||
+			   (ip_class.valid &&
+			    (classes[j].dscp != ip_class.dscp ||
+			     classes[j].category != ip_class.category ||
+			     classes[j].dst_found != ip_class.dst_found ||
+			     classes[j].dst_tal_id != ip_class.dst_tal_id)))
+			{
+				mismatches++;
+			}
+		}
+		bursts.push_back(burst);
+	}
+	check(mismatches == 0, "same classification as IP packets");
+
+	// measure the classification cost of a burst
+	start = getNanoseconds();
+	for(unsigned int i = 0; i < IP_BURSTS; i++)
+	{
+		classifier.classify(bursts[i % bursts.size()], &sarp_table, classes);
+	}
+	classifier_duration = (double)(getNanoseconds() - start) / IP_BURSTS;
+
+	start = getNanoseconds();
+	for(unsigned int i = 0; i < IP_BURSTS; i++)
+	{
+		NetBurst *burst = bursts[i % bursts.size()];
+		NetBurst::const_iterator packet;
+		unsigned int j = 0;
+
+		classes.resize(burst->size());
+		for(packet = burst->begin(); packet != burst->end(); ++packet, ++j)
+		{
+			classifyPacket(*packet, categories, &sarp_table, classes[j]);
+		}
+	}
+	packets_duration = (double)(getNanoseconds() - start) / IP_BURSTS;
+	printf("%10s %15s %15s\n", "packets", "classifier (ns)", "packets (ns)");
+	printf("%10u %15.1f %15.1f\n", IP_BURST_PACKETS,
+	       classifier_duration, packets_duration);
+
+	for(unsigned int i = 0; i < bursts.size(); i++)
+	{
+		delete bursts[i];
+	}
+
+	return (failure ? 1 : 0);
+}
@@ -114,7 +114,6 @@ Aal5Packet::Aal5Packet(const unsigned char *data, size_t length):
 {
 	this->name = "AAL5";
 	this->type = NET_PROTO_AAL5;
-	this->data.reserve(1500);
 
 	this->validityChecked = false;
 	this->validityResult = false;
@@ -124,7 +123,6 @@ Aal5Packet::Aal5Packet(const Data &data): NetPacket(data)
 {
 	this->name = "AAL5";
 	this->type = NET_PROTO_AAL5;
-	this->data.reserve(1500);
 
 	this->validityChecked = false;
 	this->validityResult = false;
@@ -135,7 +133,6 @@ Aal5Packet::Aal5Packet(const Data &data, size_t length):
 {
 	this->name = "AAL5";
 	this->type = NET_PROTO_AAL5;
-	this->data.reserve(1500);
 
 	this->validityChecked = false;
 	this->validityResult = false;
@@ -194,7 +191,8 @@ bool Aal5Packet::isValid() const
 	}
 
 	// calculate the CRC
-	crc = Aal5Packet::calcCrc(this->data.substr(0, this->data.length() - 4));
+	crc = Aal5Packet::calcCrc(
+		this->data.slice(0, this->data.length() - 4).toData());
 	cur_crc = this->crc();
 
 
@@ -250,11 +248,11 @@ Data Aal5Packet::getPayload() const
 		return Data();
 	}
 
-	return this->data.substr(0, payload_len);
+	return this->data.slice(0, payload_len).toData();
 }
 
 // static
-Aal5Packet *Aal5Packet::createFromPayload(Data payload)
+Aal5Packet *Aal5Packet::createFromPayload(const Data &payload)
 {
 	unsigned int last_atm_cell_len, padding_len;
 	Data data;
@@ -288,7 +286,7 @@ Aal5Packet *Aal5Packet::createFromPayload(Data payload)
 	return new Aal5Packet(data);
 }
 
-uint32_t Aal5Packet::calcCrc(Data data)
+uint32_t Aal5Packet::calcCrc(const Data &data)
 {
 	uint32_t crc;
 	unsigned int cpt;
@@ -328,6 +326,6 @@ unsigned int Aal5Packet::nbAtmCells() const
 
 Data Aal5Packet::atmCell(unsigned int index) const
 {
-	return this->data.substr(index * 48, 48);
+	return this->data.slice(index * 48, 48).toData();
 }
 
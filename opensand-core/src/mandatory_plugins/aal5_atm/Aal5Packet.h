@@ -92,7 +92,7 @@ class Aal5Packet: public NetPacket
 	 * @param payload the payload of the AAL5 packet to be created
 	 * @return a newly created AAL5 packet
 	 */
-	static Aal5Packet *createFromPayload(Data payload);
+	static Aal5Packet *createFromPayload(const Data &payload);
 
 	/**
 	 * Get the number of ATM cells needed to encapsulate payload data into an
@@ -119,7 +119,7 @@ class Aal5Packet: public NetPacket
 	 * @param data data to calculate the CRC from
 	 * @return the checksum
 	 */
-	static uint32_t calcCrc(Data data);
+	static uint32_t calcCrc(const Data &data);
 
 	/**
 	 * Retrieve the CRC from the AAL5 trailer
@@ -44,7 +44,6 @@ AtmCell::AtmCell(const unsigned char *data, size_t length):
 {
 	this->name = "ATM";
 	this->type = NET_PROTO_ATM;
-	this->data.reserve(53);
 	this->header_length = 5;
 }
 
@@ -52,7 +51,6 @@ AtmCell::AtmCell(const Data &data): NetPacket(data)
 {
 	this->name = "ATM";
 	this->type = NET_PROTO_ATM;
-	this->data.reserve(53);
 	this->header_length = 5;
 }
 
@@ -61,7 +59,6 @@ AtmCell::AtmCell(const Data &data, size_t length):
 {
 	this->name = "ATM";
 	this->type = NET_PROTO_ATM;
-	this->data.reserve(53);
 	this->header_length = 5;
 }
 
@@ -116,7 +113,7 @@ Data AtmCell::getPayload()
 		return Data();
 	}
 
-	return Data(this->data, 5, this->getPayloadLength());
+	return this->data.slice(5, this->getPayloadLength()).toData();
 }
 
 // UNI VPI field (8 bits)
@@ -169,37 +166,37 @@ bool AtmCell::isLastCell()
 
 void AtmCell::setGfc(uint8_t gfc)
 {
-	this->data.replace(0, 1, 1,
-		((gfc << 4) & 0xf0) + (this->data.at(0) & 0x0f));
+	this->data.writableData()[0] =
+		((gfc << 4) & 0xf0) + (this->data.at(0) & 0x0f);
 }
 
 void AtmCell::setVpi(uint8_t vpi)
 {
-	this->data.replace(0, 1, 1,
-		(this->data.at(0) & 0xf0) + ((vpi >> 4) & 0x0f));
-	this->data.replace(1, 1, 1,
-		((vpi << 4) & 0xf0) + (this->data.at(1) & 0x0f));
+	this->data.writableData()[0] =
+		(this->data.at(0) & 0xf0) + ((vpi >> 4) & 0x0f);
+	this->data.writableData()[1] =
+		((vpi << 4) & 0xf0) + (this->data.at(1) & 0x0f);
 }
 
 void AtmCell::setVci(uint16_t vci)
 {
-	this->data.replace(1, 1, 1,
-		(this->data.at(1) & 0xf0) + ((vci >> 12) & 0x0f));
-	this->data.replace(2, 1, 1, (vci >> 4) & 0xff);
-	this->data.replace(3, 1, 1,
-		((vci << 4) & 0xf0) + (this->data.at(3) & 0x0f));
+	this->data.writableData()[1] =
+		(this->data.at(1) & 0xf0) + ((vci >> 12) & 0x0f);
+	this->data.writableData()[2] = (vci >> 4) & 0xff;
+	this->data.writableData()[3] =
+		((vci << 4) & 0xf0) + (this->data.at(3) & 0x0f);
 }
 
 void AtmCell::setPt(uint8_t pt)
 {
-	this->data.replace(3, 1, 1,
-		(this->data.at(3) & 0xf1) + ((pt << 1) & 0x0e));
+	this->data.writableData()[3] =
+		(this->data.at(3) & 0xf1) + ((pt << 1) & 0x0e);
 }
 
 void AtmCell::setClp(uint8_t clp)
 {
-	this->data.replace(3, 1, 1,
-		(this->data.at(3) & 0xfe) + (clp & 0x01));
+	this->data.writableData()[3] =
+		(this->data.at(3) & 0xfe) + (clp & 0x01);
 }
 
 void AtmCell::setIsLastCell(bool is_last_cell)
@@ -40,6 +40,7 @@
 
 #include <opensand_output/Output.h>
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <arpa/inet.h>
@@ -133,8 +134,11 @@ bool Ethernet::init()
 }
 
 Ethernet::Context::Context(LanAdaptationPlugin &plugin):
-	LanAdaptationContext(plugin)
+	LanAdaptationContext(plugin),
+	evc_classifier()
 {
+	EvcClassifier::clearCache(this->encap_evc_cache);
+	EvcClassifier::clearCache(this->deencap_evc_cache);
 }
 
 bool Ethernet::Context::init()
@@ -371,6 +375,12 @@ bool Ethernet::Context::initEvc(ConfigurationFile &config)
 			return false;
 		}
 		this->evc_map[id] = evc;
+		if(!this->evc_classifier.add(id, evc))
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "unknown tag protocol in EVC %u\n", id);
+			return false;
+		}
 	}
 	// initialize the statistics on EVC
 	this->initStats();
@@ -528,14 +538,14 @@ NetBurst *Ethernet::Context::encapsulate(NetBurst *burst,
 		else
 		{
 			size_t header_length;
-			uint16_t ether_type = Ethernet::getPayloadEtherType((*packet)->getData());
-			uint16_t frame_type = Ethernet::getFrameType((*packet)->getData());
-			MacAddress src_mac = Ethernet::getSrcMac((*packet)->getData());
-			MacAddress dst_mac = Ethernet::getDstMac((*packet)->getData());
+			uint16_t ether_type = Ethernet::getPayloadEtherType((*packet)->getBuffer());
+			uint16_t frame_type = Ethernet::getFrameType((*packet)->getBuffer());
+			MacAddress src_mac = Ethernet::getSrcMac((*packet)->getBuffer());
+			MacAddress dst_mac = Ethernet::getDstMac((*packet)->getBuffer());
 			tal_id_t src = 255 ;
 			tal_id_t dst = 0;
-			uint16_t q_tci = Ethernet::getQTci((*packet)->getData());
-			uint16_t ad_tci = Ethernet::getAdTci((*packet)->getData());
+			uint16_t q_tci = Ethernet::getQTci((*packet)->getBuffer());
+			uint16_t ad_tci = Ethernet::getAdTci((*packet)->getBuffer());
 			qos_t pcp = (q_tci & 0xe000) >> 13;
 			qos_t qos = 0;
 			Evc *evc;
@@ -594,18 +604,21 @@ NetBurst *Ethernet::Context::encapsulate(NetBurst *burst,
 			{
 				case NET_PROTO_ETH:
 					header_length = ETHERNET_2_HEADSIZE;
-					evc = this->getEvc(src_mac, dst_mac, ether_type, evc_id);
+					evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+					                   EVC_MATCH_ETH, this->encap_evc_cache, evc_id);
 					qos = default_category->second->getId();
 					break;
 				case NET_PROTO_802_1Q:
 					header_length = ETHERNET_802_1Q_HEADSIZE;
-					evc = this->getEvc(src_mac, dst_mac, q_tci, ether_type, evc_id);
+					evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+					                   EVC_MATCH_Q, this->encap_evc_cache, evc_id);
 					LOG(this->log, LEVEL_INFO,
 					    "TCI = %u\n", q_tci);
 					break;
 				case NET_PROTO_802_1AD:
 					header_length = ETHERNET_802_1AD_HEADSIZE;
-					evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type, evc_id);
+					evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+					                   EVC_MATCH_AD, this->encap_evc_cache, evc_id);
 					LOG(this->log, LEVEL_INFO,
 					    "Outer TCI = %u, Inner TCI = %u\n", ad_tci, q_tci);
 					break;
@@ -658,7 +671,7 @@ NetBurst *Ethernet::Context::encapsulate(NetBurst *burst,
 					    pcp, qos);
 				}
 				// TODO we should cast to an EthernetPacket and use getPayload instead
-				eth_frame = this->createEthFrameData((*packet)->getData().substr(header_length),
+				eth_frame = this->createEthFrameData((*packet)->getData(header_length),
 				                                     src_mac, dst_mac,
 				                                     ether_type,
 				                                     q_tci, ad_tci,
@@ -735,12 +748,12 @@ NetBurst *Ethernet::Context::deencapsulate(NetBurst *burst)
 	{
 		NetPacket *deenc_packet = NULL;
 		size_t data_length = (*packet)->getTotalLength();
-		MacAddress dst_mac = Ethernet::getDstMac((*packet)->getData());
-		MacAddress src_mac = Ethernet::getSrcMac((*packet)->getData());
-		uint16_t q_tci = Ethernet::getQTci((*packet)->getData());
-		uint16_t ad_tci = Ethernet::getAdTci((*packet)->getData());
-		uint16_t ether_type = Ethernet::getPayloadEtherType((*packet)->getData());
-		uint16_t frame_type = Ethernet::getFrameType((*packet)->getData());
+		MacAddress dst_mac = Ethernet::getDstMac((*packet)->getBuffer());
+		MacAddress src_mac = Ethernet::getSrcMac((*packet)->getBuffer());
+		uint16_t q_tci = Ethernet::getQTci((*packet)->getBuffer());
+		uint16_t ad_tci = Ethernet::getAdTci((*packet)->getBuffer());
+		uint16_t ether_type = Ethernet::getPayloadEtherType((*packet)->getBuffer());
+		uint16_t frame_type = Ethernet::getFrameType((*packet)->getBuffer());
 		Evc *evc;
 		size_t header_length;
 		uint8_t evc_id = 0;
@@ -749,15 +762,18 @@ NetBurst *Ethernet::Context::deencapsulate(NetBurst *burst)
 		{
 			case NET_PROTO_ETH:
 				header_length = ETHERNET_2_HEADSIZE;
-				evc = this->getEvc(src_mac, dst_mac, ether_type, evc_id);
+				evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+				                   EVC_MATCH_ETH, this->deencap_evc_cache, evc_id);
 				break;
 			case NET_PROTO_802_1Q:
 				header_length = ETHERNET_802_1Q_HEADSIZE;
-				evc = this->getEvc(src_mac, dst_mac, q_tci, ether_type, evc_id);
+				evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+				                   EVC_MATCH_Q, this->deencap_evc_cache, evc_id);
 				break;
 			case NET_PROTO_802_1AD:
 				header_length = ETHERNET_802_1AD_HEADSIZE;
-				evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type, evc_id);
+				evc = this->getEvc(src_mac, dst_mac, q_tci, ad_tci, ether_type,
+				                   EVC_MATCH_AD, this->deencap_evc_cache, evc_id);
 				break;
 			default:
 				LOG(this->log, LEVEL_ERROR,
@@ -828,7 +844,7 @@ NetBurst *Ethernet::Context::deencapsulate(NetBurst *burst)
 					ad_tci = (evc->getAdTci() & 0xffff);
 				}
 				// TODO we should cast to an EthernetPacket and use getPayload instead
-				deenc_packet = this->createEthFrameData((*packet)->getData().substr(header_length),
+				deenc_packet = this->createEthFrameData((*packet)->getData(header_length),
 				                                        src_mac, dst_mac,
 				                                        ether_type,
 				                                        q_tci, ad_tci,
@@ -914,7 +930,8 @@ NetPacket *Ethernet::Context::createEthFrameData(NetPacket *packet, uint8_t &evc
 		    it2 != dst_macs.end(); ++it2)
 		{
 			// TODO remove tags from here and search with IP addresses
-			evc = this->getEvc(*it1, *it2, q_tci, ad_tci, ether_type, evc_id);
+			evc = this->getEvc(*it1, *it2, q_tci, ad_tci, ether_type,
+			                   EVC_MATCH_AD, this->encap_evc_cache, evc_id);
 			if(evc)
 			{
 				break;
@@ -1108,7 +1125,10 @@ NetPacket *Ethernet::PacketHandler::build(const Data &data,
 {
 	NetPacket *frame = NULL;
 	size_t head_length = 0;
-	uint16_t frame_type = Ethernet::getFrameType(data);
+	// the packet shares the buffer
+	PacketBuffer buffer(data.c_str(),
+	                    std::min(data_length, (size_t)data.length()));
+	uint16_t frame_type = Ethernet::getFrameType(buffer);
 	switch(frame_type)
 	{
 		case NET_PROTO_802_1Q:
@@ -1123,7 +1143,7 @@ NetPacket *Ethernet::PacketHandler::build(const Data &data,
 			break;
 	}
 
-	frame = new NetPacket(data, data_length,
+	frame = new NetPacket(buffer,
 	                      this->getName(),
 	                      frame_type,
 	                      qos,
@@ -1133,65 +1153,22 @@ NetPacket *Ethernet::PacketHandler::build(const Data &data,
 	return frame;
 }
 
-Evc *Ethernet::Context::getEvc(const MacAddress src_mac,
-                               const MacAddress dst_mac,
-                               uint16_t ether_type,
-                               uint8_t &evc_id) const
-{
-	for(map<uint8_t, Evc *>::const_iterator it = this->evc_map.begin();
-	    it != this->evc_map.end(); ++it)
-	{
-		if((*it).second->matches(&src_mac, &dst_mac, ether_type))
-		{
-			evc_id = (*it).first;
-			return (*it).second;
-		}
-	}
-	return NULL;
-}
-
-
-Evc *Ethernet::Context::getEvc(const MacAddress src_mac,
-                               const MacAddress dst_mac,
-                               uint16_t q_tci,
-                               uint16_t ether_type,
-                               uint8_t &evc_id) const
-{
-	for(map<uint8_t, Evc *>::const_iterator it = this->evc_map.begin();
-	    it != this->evc_map.end(); ++it)
-	{
-		if((*it).second->matches(&src_mac, &dst_mac, q_tci, ether_type))
-		{
-			evc_id = (*it).first;
-			return (*it).second;
-		}
-	}
-	return NULL;
-}
-
-
-Evc *Ethernet::Context::getEvc(const MacAddress src_mac,
-                               const MacAddress dst_mac,
+Evc *Ethernet::Context::getEvc(const MacAddress &src_mac,
+                               const MacAddress &dst_mac,
                                uint16_t q_tci,
                                uint16_t ad_tci,
                                uint16_t ether_type,
+                               evc_match_t match,
+                               evc_cache_t &cache,
                                uint8_t &evc_id) const
 {
-	for(map<uint8_t, Evc *>::const_iterator it = this->evc_map.begin();
-	    it != this->evc_map.end(); ++it)
-	{
-		if((*it).second->matches(&src_mac, &dst_mac, q_tci, ad_tci, ether_type))
-		{
-			evc_id = (*it).first;
-			return (*it).second;
-		}
-	}
-	return NULL;
+	return this->evc_classifier.find(src_mac, dst_mac, q_tci, ad_tci,
+	                                 ether_type, match, cache, evc_id);
 }
 
 
 // TODO ENDIANESS !
-uint16_t Ethernet::getFrameType(const Data &data)
+uint16_t Ethernet::getFrameType(const PacketBuffer &data)
 {
 	uint16_t ether_type = NET_PROTO_ERROR;
 	uint16_t ether_type2 = NET_PROTO_ERROR;
@@ -1216,7 +1193,7 @@ uint16_t Ethernet::getFrameType(const Data &data)
 	return ether_type;
 }
 
-uint16_t Ethernet::getPayloadEtherType(const Data &data)
+uint16_t Ethernet::getPayloadEtherType(const PacketBuffer &data)
 {
 	uint16_t ether_type = NET_PROTO_ERROR;
 	if(data.length() < 13)
@@ -1258,7 +1235,7 @@ uint16_t Ethernet::getPayloadEtherType(const Data &data)
 	return ether_type;
 }
 
-uint16_t Ethernet::getQTci(const Data &data)
+uint16_t Ethernet::getQTci(const PacketBuffer &data)
 {
 	uint16_t tci = 0;
 	uint16_t ether_type;
@@ -1288,7 +1265,7 @@ uint16_t Ethernet::getQTci(const Data &data)
 	return tci;
 }
 
-uint16_t Ethernet::getAdTci(const Data &data)
+uint16_t Ethernet::getAdTci(const PacketBuffer &data)
 {
 	uint16_t tci = 0;
 	uint16_t ether_type;
@@ -1317,7 +1294,7 @@ uint16_t Ethernet::getAdTci(const Data &data)
 	return tci;
 }
 
-MacAddress Ethernet::getDstMac(const Data &data)
+MacAddress Ethernet::getDstMac(const PacketBuffer &data)
 {
 	if(data.length() < 6)
 	{
@@ -1330,7 +1307,7 @@ MacAddress Ethernet::getDstMac(const Data &data)
 	                  data.at(3), data.at(4), data.at(5));
 }
 
-MacAddress Ethernet::getSrcMac(const Data &data)
+MacAddress Ethernet::getSrcMac(const PacketBuffer &data)
 {
 	if(data.length() < 12)
 	{
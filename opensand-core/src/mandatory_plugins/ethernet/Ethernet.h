@@ -47,6 +47,7 @@
 
 #include "EthernetHeader.h"
 #include "Evc.h"
+#include "EvcClassifier.h"
 
 #include <NetBurst.h>
 #include <MacAddress.h>
@@ -134,36 +135,6 @@ class Ethernet: public LanAdaptationPlugin
 		                              tal_id_t src_tal_id, tal_id_t dst_tal_id,
 		                              uint16_t desired_frame_type);
 
-		/**
-		 * @brief Get the EVC corresponding to Ethernet flow
-		 *
-		 * @param src_mac    The source MAC address
-		 * @param dst_mac    The destination MAC address
-		 * @param ether_type The EtherType
-		 * @param evc_id     The id of the EVC if found
-		 * @return the EVC if found, NULL otherwise
-		 */
-		Evc *getEvc(const MacAddress src_mac,
-		            const MacAddress dst_mac,
-		            uint16_t ether_type,
-		            uint8_t &evc_id) const;
-
-		/**
-		 * @brief Get the EVC corresponding to Ethernet flow
-		 *
-		 * @param src_mac    The source MAC address
-		 * @param dst_mac    The destination MAC address
-		 * @param q_tci      The Q TCI
-		 * @param ether_type The EtherType
-		 * @param evc_id     The id of the EVC if found
-		 * @return the EVC if found, NULL otherwise
-		 */
-		Evc *getEvc(const MacAddress src_mac,
-		            const MacAddress dst_mac,
-		            uint16_t q_tci,
-		            uint16_t ether_type,
-		            uint8_t &evc_id) const;
-
 		/**
 		 * @brief Get the EVC corresponding to Ethernet flow
 		 *
@@ -172,14 +143,18 @@ class Ethernet: public LanAdaptationPlugin
 		 * @param q_tci      The Q TCI
 		 * @param ad_tci     The ad TCI
 		 * @param ether_type The EtherType
+		 * @param match      The fields of the flow to compare
+		 * @param cache      The lookups cache of the channel
 		 * @param evc_id     The id of the EVC if found
 		 * @return the EVC if found, NULL otherwise
 		 */
-		Evc *getEvc(const MacAddress src_mac,
-		            const MacAddress dst_mac,
+		Evc *getEvc(const MacAddress &src_mac,
+		            const MacAddress &dst_mac,
 		            uint16_t q_tci,
 		            uint16_t ad_tci,
 		            uint16_t ether_type,
+		            evc_match_t match,
+		            evc_cache_t &cache,
 		            uint8_t &evc_id) const;
 
 		/**
@@ -210,6 +185,12 @@ class Ethernet: public LanAdaptationPlugin
 
 		/// The Ethernet Virtual Connections
 		map<uint8_t, Evc *> evc_map;
+		/// The classifier finding the EVC of the frames
+		EvcClassifier evc_classifier;
+		/// The EVC lookups cache of the encapsulation
+		evc_cache_t encap_evc_cache;
+		/// The EVC lookups cache of the deencapsulation
+		evc_cache_t deencap_evc_cache;
 		/// The amount of data sent per EVC between two updates
 		map<uint8_t, size_t> evc_data_size;
 		/// The throughput per EVC
@@ -272,7 +253,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the type of frame
 	 */
-	static uint16_t getFrameType(const Data &data);
+	static uint16_t getFrameType(const PacketBuffer &data);
 
 	/**
 	 * @brief Retrieve the EtherType of a payload carried by an Ethernet frame
@@ -280,7 +261,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the EtherType
 	 */
-	static uint16_t getPayloadEtherType(const Data &data);
+	static uint16_t getPayloadEtherType(const PacketBuffer &data);
 
 	/**
 	 * @brief Retrieve the Q TCI from an Ethernet frame
@@ -288,7 +269,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the Q TCI
 	 */
-	static uint16_t getQTci(const Data &data);
+	static uint16_t getQTci(const PacketBuffer &data);
 
 	/**
 	 * @brief Retrieve the ad TCI from an Ethernet frame
@@ -296,7 +277,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the ad TCI
 	 */
-	static uint16_t getAdTci(const Data &data);
+	static uint16_t getAdTci(const PacketBuffer &data);
 
 	/**
 	 * @brief Retrieve the source MAC address from an Ethernet frame
@@ -304,7 +285,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the source MAC address on success, an empty sring otherwise
 	 */
-	static MacAddress getSrcMac(const Data &data);
+	static MacAddress getSrcMac(const PacketBuffer &data);
 
 	/**
 	 * @brief Retrieve the destination MAC address from an Ethernet frame
@@ -312,7 +293,7 @@ class Ethernet: public LanAdaptationPlugin
 	 * @param data   the Ethernet frame data
 	 * @return the destination MAC address on success, an empty sring otherwise
 	 */
-	static MacAddress getDstMac(const Data &data);
+	static MacAddress getDstMac(const PacketBuffer &data);
 
 };
 
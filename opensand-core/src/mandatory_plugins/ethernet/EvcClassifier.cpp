@@ -0,0 +1,234 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file EvcClassifier.cpp
+ * @brief The classifier finding the EVC of Ethernet frames
+ */
+
+#include "EvcClassifier.h"
+
+#include <NetPacket.h>
+
+#include <cstring>
+
+
+/**
+ * @brief Get the bytes of a MAC address and the mask of its bytes
+ *        that are not generic
+ *
+ * @param mac   The MAC address
+ * @param mask  OUT: The mask
+ * @return the MAC address bytes
+ */
+static inline uint64_t getMacKey(const MacAddress &mac, uint64_t &mask)
+{
+	uint64_t key = 0;
+
+	mask = 0;
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		key = (key << 8) | mac.at(i);
+		mask = (mask << 8) | (mac.isGeneric(i) ? 0 : 0xff);
+	}
+	return key;
+}
+
+
+size_t EvcClassifier::KeyHash::operator()(const evc_key_t &key) const
+{
+	uint64_t hash;
+
+	hash = key.mac_src * 0x9e3779b97f4a7c15ULL;
+	hash ^= key.mac_dst * 0xc2b2ae3d27d4eb4fULL;
+	hash ^= key.fields * 0x165667b19e3779f9ULL;
+	hash ^= hash >> 29;
+	return (size_t)hash;
+}
+
+bool EvcClassifier::KeyEqual::operator()(const evc_key_t &key1,
+                                         const evc_key_t &key2) const
+{
+	return (key1.mac_src == key2.mac_src &&
+	        key1.mac_dst == key2.mac_dst &&
+	        key1.fields == key2.fields);
+}
+
+
+EvcClassifier::EvcClassifier():
+	groups()
+{
+}
+
+EvcClassifier::~EvcClassifier()
+{
+}
+
+bool EvcClassifier::getTci(uint32_t tag, uint16_t &tci)
+{
+	// the tag protocol then the TCI, the frames are classified on the TCI
+	if((tag >> 16) != NET_PROTO_802_1Q && (tag >> 16) != NET_PROTO_802_1AD)
+	{
+		return false;
+	}
+	tci = tag & 0xffff;
+	return true;
+}
+
+bool EvcClassifier::add(uint8_t id, Evc *evc)
+{
+	evc_match_t matches[] = {EVC_MATCH_ETH, EVC_MATCH_Q, EVC_MATCH_AD};
+	uint64_t src_mask;
+	uint64_t dst_mask;
+	uint64_t mac_src = getMacKey(*evc->getMacSrc(), src_mask);
+	uint64_t mac_dst = getMacKey(*evc->getMacDst(), dst_mask);
+	uint16_t q_tci;
+	uint16_t ad_tci;
+	evc_group_t *group = NULL;
+	evc_entry_t entry;
+
+	if(!getTci(evc->getQTci(), q_tci) || !getTci(evc->getAdTci(), ad_tci))
+	{
+		return false;
+	}
+
+	for(vector<evc_group_t>::iterator it = this->groups.begin();
+	    it != this->groups.end(); ++it)
+	{
+		if((*it).src_mask == src_mask && (*it).dst_mask == dst_mask)
+		{
+			group = &(*it);
+			break;
+		}
+	}
+	if(!group)
+	{
+		this->groups.push_back(evc_group_t());
+		group = &this->groups.back();
+		group->src_mask = src_mask;
+		group->dst_mask = dst_mask;
+	}
+
+	// the frame fields ignored by a match are not in its key
+	entry.id = id;
+	entry.evc = evc;
+	for(unsigned int i = 0; i < sizeof(matches) / sizeof(matches[0]); i++)
+	{
+		evc_key_t key = getKey(mac_src & src_mask, mac_dst & dst_mask,
+		                       q_tci, ad_tci,
+		                       evc->getEtherType(), matches[i]);
+		unordered_map<evc_key_t, evc_entry_t, KeyHash, KeyEqual>::iterator found;
+
+		found = group->index.find(key);
+		if(found == group->index.end())
+		{
+			group->index[key] = entry;
+		}
+		else if(id < (*found).second.id)
+		{
+			(*found).second = entry;
+		}
+	}
+	return true;
+}
+
+Evc *EvcClassifier::find(const MacAddress &mac_src,
+                         const MacAddress &mac_dst,
+                         uint16_t q_tci,
+                         uint16_t ad_tci,
+                         uint16_t ether_type,
+                         evc_match_t match,
+                         evc_cache_t &cache,
+                         uint8_t &evc_id) const
+{
+	uint64_t mask;
+	uint64_t src = getMacKey(mac_src, mask);
+	uint64_t dst = getMacKey(mac_dst, mask);
+	evc_key_t key = getKey(src, dst, q_tci, ad_tci, ether_type, match);
+	evc_cache_entry_t &cached = cache.entries[KeyHash()(key) % EVC_CACHE_SIZE];
+	const evc_entry_t *best = NULL;
+
+	if(cached.valid && KeyEqual()(cached.key, key))
+	{
+		if(cached.evc)
+		{
+			evc_id = cached.id;
+		}
+		return cached.evc;
+	}
+
+	for(vector<evc_group_t>::const_iterator it = this->groups.begin();
+	    it != this->groups.end(); ++it)
+	{
+		unordered_map<evc_key_t, evc_entry_t, KeyHash, KeyEqual>::const_iterator found;
+
+		found = (*it).index.find(getKey(src & (*it).src_mask,
+		                                dst & (*it).dst_mask,
+		                                q_tci, ad_tci, ether_type, match));
+		if(found != (*it).index.end() &&
+		   (!best || (*found).second.id < best->id))
+		{
+			best = &(*found).second;
+		}
+	}
+
+	cached.key = key;
+	cached.valid = true;
+	cached.evc = best ? best->evc : NULL;
+	cached.id = best ? best->id : 0;
+	if(best)
+	{
+		evc_id = best->id;
+	}
+	return cached.evc;
+}
+
+void EvcClassifier::clearCache(evc_cache_t &cache)
+{
+	memset(&cache, 0, sizeof(cache));
+}
+
+evc_key_t EvcClassifier::getKey(uint64_t mac_src, uint64_t mac_dst,
+                                uint16_t q_tci, uint16_t ad_tci,
+                                uint16_t ether_type, evc_match_t match)
+{
+	evc_key_t key;
+
+	key.mac_src = mac_src;
+	key.mac_dst = mac_dst;
+	key.fields = ((uint64_t)match << 48) | ether_type;
+	if(match != EVC_MATCH_ETH)
+	{
+		key.fields |= (uint64_t)q_tci << 16;
+	}
+	if(match == EVC_MATCH_AD)
+	{
+		key.fields |= (uint64_t)ad_tci << 32;
+	}
+	return key;
+}
@@ -0,0 +1,208 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file EvcClassifier.h
+ * @brief The classifier finding the EVC of Ethernet frames
+ */
+
+#ifndef EVC_CLASSIFIER_H
+#define EVC_CLASSIFIER_H
+
+#include "Evc.h"
+
+#include <MacAddress.h>
+
+#include <stdint.h>
+#include <vector>
+#include <tr1/unordered_map>
+
+using std::vector;
+using std::tr1::unordered_map;
+
+
+/// The number of entries in a cache of EVC lookups
+#define EVC_CACHE_SIZE 256
+
+
+/// The fields of a frame compared to the EVC ones
+typedef enum
+{
+	EVC_MATCH_ETH, ///< MAC addresses and EtherType
+	EVC_MATCH_Q,   ///< MAC addresses, Q TCI and EtherType
+	EVC_MATCH_AD,  ///< MAC addresses, Q and ad TCI and EtherType
+} evc_match_t;
+
+/// The key of an EVC lookup
+typedef struct
+{
+	uint64_t mac_src; ///< The source MAC address
+	uint64_t mac_dst; ///< The destination MAC address
+	uint64_t fields;  ///< The match type, TCIs and EtherType
+} evc_key_t;
+
+/// A cached EVC lookup
+typedef struct
+{
+	evc_key_t key; ///< The lookup key, with the frame MAC addresses
+	bool valid;    ///< Whether the entry holds a lookup
+	Evc *evc;      ///< The EVC found, NULL if there is none
+	uint8_t id;    ///< The ID of the EVC found
+} evc_cache_entry_t;
+
+/// A cache of EVC lookups, a thread looking for EVC needs its own cache
+typedef struct
+{
+	evc_cache_entry_t entries[EVC_CACHE_SIZE]; ///< The entries by key hash
+} evc_cache_t;
+
+
+/**
+ * @class EvcClassifier
+ * @brief The classifier finding the EVC of Ethernet frames
+ *
+ * The EVC are grouped by the generic bytes of their MAC addresses.
+ * In each group, the EVC are indexed in a hash table with their MAC
+ * addresses without the generic bytes, for each type of match.
+ * A lookup costs one hash lookup per group and the last lookups are
+ * cached, whatever the number of EVC.
+ */
+class EvcClassifier
+{
+ public:
+
+	/**
+	 * @brief Build an empty classifier
+	 */
+	EvcClassifier();
+
+	/**
+	 * @brief Destroy the classifier, the EVC are not released
+	 */
+	~EvcClassifier();
+
+	/**
+	 * @brief Add an EVC, the EVC with the lowest ID is found when
+	 *        several EVC match a frame
+	 *
+	 * @param id   The EVC ID
+	 * @param evc  The EVC
+	 * @return true on success, false if a tag protocol is unknown
+	 */
+	bool add(uint8_t id, Evc *evc);
+
+	/**
+	 * @brief Find the EVC of a frame
+	 *
+	 * @param mac_src     The source MAC address
+	 * @param mac_dst     The destination MAC address
+	 * @param q_tci       The Q TCI, ignored for EVC_MATCH_ETH
+	 * @param ad_tci      The ad TCI, only used for EVC_MATCH_AD
+	 * @param ether_type  The EtherType of the packet carried by
+	 *                    the Ethernet payload
+	 * @param match       The fields of the frame to compare
+	 * @param cache       The lookups cache of the calling thread
+	 * @param evc_id      OUT: The ID of the EVC if found
+	 * @return the EVC if found, NULL otherwise
+	 */
+	Evc *find(const MacAddress &mac_src,
+	          const MacAddress &mac_dst,
+	          uint16_t q_tci,
+	          uint16_t ad_tci,
+	          uint16_t ether_type,
+	          evc_match_t match,
+	          evc_cache_t &cache,
+	          uint8_t &evc_id) const;
+
+	/**
+	 * @brief Empty a lookups cache
+	 *
+	 * @param cache  The cache
+	 */
+	static void clearCache(evc_cache_t &cache);
+
+ private:
+
+	/// The hash of a lookup key
+	struct KeyHash
+	{
+		size_t operator()(const evc_key_t &key) const;
+	};
+
+	/// The equality of lookup keys
+	struct KeyEqual
+	{
+		bool operator()(const evc_key_t &key1, const evc_key_t &key2) const;
+	};
+
+	/// An indexed EVC
+	typedef struct
+	{
+		uint8_t id; ///< The EVC ID
+		Evc *evc;   ///< The EVC
+	} evc_entry_t;
+
+	/// The EVC with the same generic bytes in their MAC addresses
+	typedef struct
+	{
+		uint64_t src_mask; ///< The mask of the source MAC address bytes
+		uint64_t dst_mask; ///< The mask of the destination MAC address bytes
+		unordered_map<evc_key_t, evc_entry_t, KeyHash, KeyEqual> index;
+		                   ///< The EVC indexed by masked key
+	} evc_group_t;
+
+	/**
+	 * @brief Get the TCI of an EVC tag
+	 *
+	 * @param tag  The tag, as returned by the EVC: the tag protocol
+	 *             then the TCI
+	 * @param tci  OUT: The TCI
+	 * @return true on success, false if the tag protocol is unknown
+	 */
+	static bool getTci(uint32_t tag, uint16_t &tci);
+
+	/**
+	 * @brief Build a lookup key
+	 *
+	 * @param mac_src     The source MAC address
+	 * @param mac_dst     The destination MAC address
+	 * @param q_tci       The Q TCI
+	 * @param ad_tci      The ad TCI
+	 * @param ether_type  The EtherType
+	 * @param match       The fields to compare
+	 * @return the key
+	 */
+	static evc_key_t getKey(uint64_t mac_src, uint64_t mac_dst,
+	                        uint16_t q_tci, uint16_t ad_tci,
+	                        uint16_t ether_type, evc_match_t match);
+
+	/// The EVC groups
+	vector<evc_group_t> groups;
+};
+
+#endif
@@ -110,6 +110,7 @@ NetBurst *Ip::Context::encapsulate(NetBurst *burst,
 {
 	NetBurst *ip_packets = NULL;
 	NetBurst::iterator packet;
+	unsigned int i;
 
 	// create an empty burst of IP packets
 	ip_packets = new NetBurst();
@@ -121,21 +122,30 @@ NetBurst *Ip::Context::encapsulate(NetBurst *burst,
 		return NULL;
 	}
 
+	// classify the whole burst from the packets data, the destination
+	// is not needed on ST in transparent mode as it is always the GW
+	this->classifier.classify(burst,
+	                          (this->tal_id != this->gw_id &&
+	                           this->satellite_type == TRANSPARENT) ?
+	                          NULL : this->sarp_table,
+	                          this->encap_classes);
+
 	// TODO for here and deencap functions try to dynamic cast packets
 	//      instead of allocating (do not forget to erase from source burst
 	//      because when releasing burst content is also released
-	for(packet = burst->begin(); packet != burst->end(); ++packet)
+	for(packet = burst->begin(), i = 0; packet != burst->end(); ++packet, ++i)
 	{
+		const ip_class_t &ip_class = this->encap_classes[i];
 		IpPacket *ip_packet;
 
 		// create IP packet from data
-		switch(IpPacket::version((*packet)->getData()))
+		switch(ip_class.version)
 		{
 			case 4:
-				ip_packet = new Ipv4Packet((*packet)->getData());
+				ip_packet = new Ipv4Packet((*packet)->getBuffer());
 				break;
 			case 6:
-				ip_packet = new Ipv6Packet((*packet)->getData());
+				ip_packet = new Ipv6Packet((*packet)->getBuffer());
 				break;
 			default:
 				LOG(this->log, LEVEL_ERROR,
@@ -143,10 +153,9 @@ NetBurst *Ip::Context::encapsulate(NetBurst *burst,
 				continue;
 		}
 		LOG(this->log, LEVEL_INFO,
-		    "encap:got an IPv%u packet\n",
-		    IpPacket::version((*packet)->getData()));
+		    "encap:got an IPv%u packet\n", ip_class.version);
 		// check IP packet validity
-		if(!ip_packet->isValid())
+		if(!ip_class.valid || !ip_packet->isValid())
 		{
 			LOG(this->log, LEVEL_ERROR,
 			    "IP packet is not valid\n");
@@ -155,10 +164,11 @@ NetBurst *Ip::Context::encapsulate(NetBurst *burst,
 		}
 
 		ip_packet->setSrcTalId(this->tal_id);
-		if(!this->onMsgIp(ip_packet))
+		if(!this->onMsgIp(ip_packet, ip_class))
 		{
 			LOG(this->log, LEVEL_ERROR,
 			    "IP handling failed, drop packet\n");
+			delete ip_packet;
 			continue;
 		}
 		ip_packets->add(ip_packet);
@@ -174,6 +184,7 @@ NetBurst *Ip::Context::deencapsulate(NetBurst *burst)
 {
 	NetBurst *net_packets;
 	NetBurst::iterator packet;
+	unsigned int i;
 
 	// create an empty burst of network packets
 	net_packets = new NetBurst();
@@ -186,21 +197,25 @@ NetBurst *Ip::Context::deencapsulate(NetBurst *burst)
 		return NULL;
 	}
 
-	for(packet = burst->begin(); packet != burst->end(); ++packet)
+	// classify the whole burst from the packets data
+	this->classifier.classify(burst, this->sarp_table,
+	                          this->deencap_classes);
+
+	for(packet = burst->begin(), i = 0; packet != burst->end(); ++packet, ++i)
 	{
+		const ip_class_t &ip_class = this->deencap_classes[i];
 		IpPacket *ip_packet;
-		IpAddress *ip_addr;
-		tal_id_t dst_tal_id;
+		tal_id_t dst_tal_id = ip_class.dst_tal_id;
 		tal_id_t src_tal_id = (*packet)->getSrcTalId();
 
 		// create IP packet from data
-		switch(IpPacket::version((*packet)->getData()))
+		switch(ip_class.version)
 		{
 			case 4:
-				ip_packet = new Ipv4Packet((*packet)->getData());
+				ip_packet = new Ipv4Packet((*packet)->getBuffer());
 				break;
 			case 6:
-				ip_packet = new Ipv6Packet((*packet)->getData());
+				ip_packet = new Ipv6Packet((*packet)->getBuffer());
 				break;
 			default:
 				LOG(this->log, LEVEL_ERROR,
@@ -208,11 +223,10 @@ NetBurst *Ip::Context::deencapsulate(NetBurst *burst)
 				continue;
 		}
 		LOG(this->log, LEVEL_INFO,
-		    "deencap:got an IPv%u packet\n",
-		    IpPacket::version((*packet)->getData()));
+		    "deencap:got an IPv%u packet\n", ip_class.version);
 
 		// check IP packet validity
-		if(!ip_packet->isValid())
+		if(!ip_class.valid || !ip_packet->isValid())
 		{
 			LOG(this->log, LEVEL_ERROR,
 			    "IP packet is not valid\n");
@@ -223,8 +237,7 @@ NetBurst *Ip::Context::deencapsulate(NetBurst *burst)
 		// get destination Tal ID from IP information as on GW
 		// in transparent mode, the destination is always the GW
 		// itself
-		ip_addr = ip_packet->dstAddr();
-		if(!this->sarp_table->getTalByIp(ip_addr, dst_tal_id))
+		if(!ip_class.dst_found)
 		{
 			// check default tal_id
 			if(dst_tal_id > BROADCAST_TAL_ID)
@@ -253,22 +266,22 @@ NetBurst *Ip::Context::deencapsulate(NetBurst *burst)
 }
 
 
-bool Ip::Context::onMsgIp(IpPacket *ip_packet)
+bool Ip::Context::onMsgIp(IpPacket *ip_packet, const ip_class_t &ip_class)
 {
 	int traffic_category;
+	TrafficCategory *category;
 	map<qos_t, TrafficCategory *>::const_iterator found_category;
 
-	IpAddress *ip_addr;
 	tal_id_t pkt_tal_id; // tal is found in the SARP table
 
 	// set QoS:
 	//  - retrieve the QoS set by TC using DSCP
 	//  - if unknown category/priority, put packet in the default category/priority
 	//  - assign QoS/priority to the IP packet
-	traffic_category = (int) ip_packet->diffServCodePoint();
+	traffic_category = (int) ip_class.dscp;
 
-	found_category = this->category_map.find(traffic_category);
-	if(found_category == this->category_map.end())
+	category = ip_class.category;
+	if(!category)
 	{
 		LOG(this->log, LEVEL_INFO,
 		    "DSCP %d unknown		    ; IP packet goes to default "
@@ -282,16 +295,17 @@ bool Ip::Context::onMsgIp(IpPacket *ip_packet)
 			    "default MAC category not defined\n");
 			return false;
 		}
+		category = found_category->second;
 	}
 	else
 	{
 		LOG(this->log, LEVEL_INFO,
 		    "IP packet with DSCP %d goes to MAC category %s with "
 		    "id %u\n", traffic_category, 
-		    found_category->second->getName().c_str(),
-		    found_category->second->getId());
+		    category->getName().c_str(),
+		    category->getId());
 	}
-	ip_packet->setQos(found_category->second->getId());
+	ip_packet->setQos(category->getId());
 
 	if(this->tal_id != this->gw_id && 
 	   this->satellite_type ==  TRANSPARENT)
@@ -303,18 +317,8 @@ bool Ip::Context::onMsgIp(IpPacket *ip_packet)
 		// Other modes
 		// DST Tal Id = Tal Id(ip_dst)
 		// SRC Tal Id = Host Tal Id
-		ip_addr = ip_packet->dstAddr();
-		if(!ip_addr)
-		{
-			LOG(this->log, LEVEL_ERROR,
-			    "cannot get IP packet address\n");
-			return false;
-		}
-		LOG(this->log, LEVEL_DEBUG,
-		    "IPv%d destination address = %s\n",
-		    ip_packet->version(), ip_addr->str().c_str());
-
-		if(!this->sarp_table->getTalByIp(ip_addr, pkt_tal_id))
+		pkt_tal_id = ip_class.dst_tal_id;
+		if(!ip_class.dst_found)
 		{
 			// check default tal_id
 			if(pkt_tal_id > BROADCAST_TAL_ID)
@@ -350,7 +354,7 @@ char Ip::Context::getLanHeader(unsigned int pos, NetPacket *packet)
 {
 	unsigned char ether_type[4] = {0, 0, 0, 0};
 	// create IP packet from data
-	switch(IpPacket::version(packet->getData()))
+	switch(IpPacket::version(packet->getBuffer()))
 	{
 		case 4:
 			LOG(this->log, LEVEL_INFO,
@@ -408,6 +412,34 @@ NetPacket *Ip::PacketHandler::build(const Data &data,
 	}
 }
 
+NetPacket *Ip::PacketHandler::build(const PacketBuffer &buffer,
+                                    uint8_t qos,
+                                    uint8_t src_tal_id,
+                                    uint8_t dst_tal_id) const
+{
+	IpPacket *packet;
+
+	// the packet shares the buffer of the frame it was received in
+	if(IpPacket::version(buffer) == 4)
+	{
+		packet = new Ipv4Packet(buffer);
+	}
+	else if(IpPacket::version(buffer) == 6)
+	{
+		packet = new Ipv6Packet(buffer);
+	}
+	else
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "cannot get IP version\n");
+		return NULL;
+	}
+	packet->setQos(qos);
+	packet->setSrcTalId(src_tal_id);
+	packet->setDstTalId(dst_tal_id);
+	return packet;
+}
+
 bool Ip::Context::initTrafficCategories(ConfigurationFile &config)
 {
 	int i = 0;
@@ -481,6 +513,13 @@ bool Ip::Context::initTrafficCategories(ConfigurationFile &config)
 		category->setId(mac_queue_prio);
 		category->setName(mac_queue_name);
 		this->category_map[dscp_value] = category;
+		if(!this->classifier.setCategory(dscp_value, category))
+		{
+			LOG(this->log, LEVEL_WARNING,
+			    "Traffic category %ld - [%s]: not a DSCP value, no IP "
+			    "packet will match it\n", dscp_value,
+			    mac_queue_name.c_str());
+		}
 	}
 	// Get default category
 	if(!config.getValue(config_section_map[SECTION_MAPPING], 
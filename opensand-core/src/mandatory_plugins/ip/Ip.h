@@ -41,6 +41,7 @@
 #include "IpPacket.h"
 #include "Ipv4Packet.h"
 #include "Ipv6Packet.h"
+#include "IpClassifier.h"
 #include "TrafficCategory.h"
 
 #include <opensand_conf/conf.h>
@@ -85,9 +86,10 @@ class Ip: public LanAdaptationPlugin
 		 * @brief handle an IP message
 		 *
 		 * @param ip_packet  The IP packet
+		 * @param ip_class   The classification of the IP packet
 		 * @return true on success, false otherwise
 		 */
-		bool onMsgIp(IpPacket *ip_packet);
+		bool onMsgIp(IpPacket *ip_packet, const ip_class_t &ip_class);
 
 	  private:
 
@@ -104,6 +106,15 @@ class Ip: public LanAdaptationPlugin
 
 		/// The default traffic category
 		qos_t default_category;
+
+		/// The traffic categories by DSCP
+		IpClassifier classifier;
+
+		/// The classification of the bursts to encapsulate
+		vector<ip_class_t> encap_classes;
+
+		/// The classification of the bursts to deencapsulate
+		vector<ip_class_t> deencap_classes;
 	};
 
 	/**
@@ -134,6 +145,11 @@ class Ip: public LanAdaptationPlugin
 		                 uint8_t qos,
 		                 uint8_t src_tal_id,
 		                 uint8_t dst_tal_id) const;
+
+		NetPacket *build(const PacketBuffer &buffer,
+		                 uint8_t qos,
+		                 uint8_t src_tal_id,
+		                 uint8_t dst_tal_id) const;
 	};
 	
 	/// Constructor
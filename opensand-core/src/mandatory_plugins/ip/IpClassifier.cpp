@@ -0,0 +1,126 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file IpClassifier.cpp
+ * @brief The classifier of the IP packets of a burst
+ */
+
+#include "IpClassifier.h"
+
+#include <cstring>
+
+
+/// The minimal length of an IPv4 header
+#define IPV4_HEADER_MIN_LEN 20
+/// The offset of the destination address in the IPv4 header
+#define IPV4_DST_OFFSET 16
+/// The length of an IPv6 header
+#define IPV6_HEADER_LEN 40
+/// The offset of the destination address in the IPv6 header
+#define IPV6_DST_OFFSET 24
+
+
+IpClassifier::IpClassifier()
+{
+	memset(this->categories, 0, sizeof(this->categories));
+}
+
+bool IpClassifier::setCategory(long int dscp, TrafficCategory *category)
+{
+	if(dscp < 0 || dscp > 0xfc || (dscp & 0x03) != 0)
+	{
+		return false;
+	}
+	this->categories[dscp >> 2] = category;
+	return true;
+}
+
+void IpClassifier::classify(const NetBurst *burst,
+                            const SarpTable *sarp_table,
+                            vector<ip_class_t> &classes) const
+{
+	NetBurst::const_iterator packet;
+	unsigned int i = 0;
+
+	// keep the capacity between bursts
+	classes.resize(burst->size());
+	for(packet = burst->begin(); packet != burst->end(); ++packet, ++i)
+	{
+		const PacketBuffer &data = (*packet)->getBuffer();
+		const unsigned char *header = data.data();
+		size_t length = data.length();
+		ip_class_t &ip_class = classes[i];
+		const unsigned char *dst;
+
+		ip_class.version = 0;
+		ip_class.valid = false;
+		ip_class.dscp = 0;
+		ip_class.category = NULL;
+		ip_class.dst_found = false;
+		ip_class.dst_tal_id = 0;
+
+		// same minimal length as IpPacket::version
+		if(length < IPV4_HEADER_MIN_LEN)
+		{
+			continue;
+		}
+		ip_class.version = header[0] >> 4;
+		switch(ip_class.version)
+		{
+			case 4:
+				if((size_t)(header[0] & 0x0f) * 4 < IPV4_HEADER_MIN_LEN ||
+				   (size_t)(header[0] & 0x0f) * 4 > length)
+				{
+					continue;
+				}
+				ip_class.dscp = header[1] & 0xfc;
+				dst = header + IPV4_DST_OFFSET;
+				break;
+			case 6:
+				if(length < IPV6_HEADER_LEN)
+				{
+					continue;
+				}
+				ip_class.dscp = ((header[0] & 0x0f) << 4) |
+				                ((header[1] & 0xc0) >> 4);
+				dst = header + IPV6_DST_OFFSET;
+				break;
+			default:
+				continue;
+		}
+		ip_class.valid = true;
+		ip_class.category = this->categories[ip_class.dscp >> 2];
+		if(sarp_table)
+		{
+			ip_class.dst_found = sarp_table->getTalByIp(ip_class.version,
+			                                            dst,
+			                                            ip_class.dst_tal_id);
+		}
+	}
+}
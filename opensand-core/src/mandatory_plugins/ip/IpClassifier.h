@@ -0,0 +1,124 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file IpClassifier.h
+ * @brief The classifier of the IP packets of a burst
+ */
+
+#ifndef IP_CLASSIFIER_H
+#define IP_CLASSIFIER_H
+
+#include "NetBurst.h"
+#include "SarpTable.h"
+#include "TrafficCategory.h"
+#include "OpenSandCore.h"
+
+#include <stdint.h>
+#include <vector>
+
+using std::vector;
+
+
+/// The number of DSCP values
+#define IP_DSCP_COUNT 64
+
+
+/// The classification of an IP packet
+typedef struct
+{
+	uint8_t version;           ///< The IP version, 0 if it cannot be read
+	bool valid;                ///< Whether the header can be classified
+	uint8_t dscp;              ///< The DSCP, as in the TOS/traffic class byte
+	TrafficCategory *category; ///< The DSCP category, NULL if unknown
+	bool dst_found;            ///< Whether the destination is in SARP table
+	tal_id_t dst_tal_id;       ///< The destination tal ID, the default one
+	                           ///< if not found
+} ip_class_t;
+
+
+/**
+ * @class IpClassifier
+ * @brief The classifier of the IP packets of a burst
+ *
+ * The traffic categories are stored in a table indexed by DSCP and
+ * the headers are read in the packets data, so a packet is classified
+ * with one table access and one SARP lookup, without building any
+ * IP packet or address.
+ * The checksum of the IPv4 headers is not checked.
+ */
+class IpClassifier
+{
+ public:
+
+	/**
+	 * @brief Build a classifier without traffic category
+	 */
+	IpClassifier();
+
+	/**
+	 * @brief Set the traffic category of a DSCP
+	 *
+	 * @param dscp      The DSCP, as in the TOS/traffic class byte
+	 * @param category  The traffic category
+	 * @return false if the value is not a DSCP one (the 2 ECN bits are
+	 *         set or it does not fit in the byte), true otherwise
+	 */
+	bool setCategory(long int dscp, TrafficCategory *category);
+
+	/**
+	 * @brief Get the traffic category of a DSCP
+	 *
+	 * @param dscp  The DSCP, as in the TOS/traffic class byte
+	 * @return the traffic category, NULL if there is none
+	 */
+	TrafficCategory *getCategory(uint8_t dscp) const
+	{
+		return this->categories[dscp >> 2];
+	};
+
+	/**
+	 * @brief Classify the IP packets of a burst
+	 *
+	 * @param burst       The burst
+	 * @param sarp_table  The SARP table to find the destinations in,
+	 *                    NULL to skip the lookups
+	 * @param classes     OUT: The classification of each packet, in the
+	 *                    burst order
+	 */
+	void classify(const NetBurst *burst,
+	              const SarpTable *sarp_table,
+	              vector<ip_class_t> &classes) const;
+
+ private:
+
+	/// The traffic categories by DSCP, without the ECN bits
+	TrafficCategory *categories[IP_DSCP_COUNT];
+};
+
+#endif
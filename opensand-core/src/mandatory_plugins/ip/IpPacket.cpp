@@ -41,7 +41,6 @@ OutputLog *IpPacket::ip_log = NULL;
 IpPacket::IpPacket(const unsigned char *data, size_t length):
 	NetPacket(data, length)
 {
-	this->data.reserve(1500);
 
 	this->src_addr = NULL;
 	this->dst_addr = NULL;
@@ -50,7 +49,6 @@ IpPacket::IpPacket(const unsigned char *data, size_t length):
 
 IpPacket::IpPacket(const Data &data): NetPacket(data)
 {
-	this->data.reserve(1500);
 
 	this->src_addr = NULL;
 	this->dst_addr = NULL;
@@ -59,7 +57,13 @@ IpPacket::IpPacket(const Data &data): NetPacket(data)
 IpPacket::IpPacket(const Data &data, size_t length):
 	NetPacket(data, length)
 {
-	this->data.reserve(1500);
+
+	this->src_addr = NULL;
+	this->dst_addr = NULL;
+}
+
+IpPacket::IpPacket(const PacketBuffer &buffer): NetPacket(buffer)
+{
 
 	this->src_addr = NULL;
 	this->dst_addr = NULL;
@@ -102,11 +106,24 @@ Data IpPacket::getPayload() const
 		return Data();
 	}
 
-	return this->data.substr(header_len, payload_len);
+	return this->data.slice(header_len, payload_len).toData();
+}
+
+// static
+int IpPacket::version(const Data &data)
+{
+	if(data.length() < 4 * 5)
+	{
+		LOG(ip_log, LEVEL_ERROR,
+		    "invalid IP packet\n");
+		return 0;
+	}
+
+	return ((data.at(0) & 0xf0) >> 4);
 }
 
 // static
-int IpPacket::version(Data data)
+int IpPacket::version(const PacketBuffer &data)
 {
 	if(data.length() < 4 * 5)
 	{
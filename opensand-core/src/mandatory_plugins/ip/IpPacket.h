@@ -77,6 +77,12 @@ class IpPacket: public NetPacket
 	 */
 	IpPacket(const Data &data, size_t length);
 
+	/**
+	 * Build an IP packet sharing the content of a buffer
+	 * @param buffer buffer from which an IP packet can be created
+	 */
+	IpPacket(const PacketBuffer &buffer);
+
 	/**
 	 * Build an empty IP packet
 	 */
@@ -95,7 +101,14 @@ class IpPacket: public NetPacket
 	 * @param data IP data
 	 * @return the IP version
 	 */
-	static int version(Data data);
+	static int version(const Data &data);
+
+	/**
+	 * Retrieve the version from an IP packet
+	 * @param data IP data
+	 * @return the IP version
+	 */
+	static int version(const PacketBuffer &data);
 
 	/**
 	 * Retrieve the version of the IP packet
@@ -71,6 +71,16 @@ Ipv4Packet::Ipv4Packet(const Data &data,
 	this->header_length = 20;
 }
 
+Ipv4Packet::Ipv4Packet(const PacketBuffer &buffer): IpPacket(buffer)
+{
+	this->name = "IPv4";
+	this->type = NET_PROTO_IPV4;
+
+	this->validity_checked = false;
+	this->validity_result = false;
+	this->header_length = 20;
+}
+
 Ipv4Packet::Ipv4Packet(): IpPacket()
 {
 	this->name = "IPv4";
@@ -102,6 +112,14 @@ bool Ipv4Packet::isValid() const
 		goto invalid;
 	}
 
+	// the header must be in the packet, the buffer is not readable after it
+	if(this->data.length() < this->ihl() * 4U)
+	{
+		LOG(ip_log, LEVEL_ERROR,
+		    "IP packet is shorter than its header\n");
+		goto invalid;
+	}
+
 	// calculate the CRC
 	crc = this->calcCrc();
 	cur_crc = this->crc();
@@ -131,7 +149,7 @@ uint16_t Ipv4Packet::calcCrc() const
 	uint16_t *data;
 	uint32_t sum;
 
-	data = (uint16_t *) this->data.c_str();
+	data = (uint16_t *) this->data.data();
 	nbytes = this->ihl() * 4;
 	sum = 0;
 
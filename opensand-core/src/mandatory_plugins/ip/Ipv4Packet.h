@@ -81,6 +81,12 @@ class Ipv4Packet: public IpPacket
 	 */
 	Ipv4Packet(const Data &data, size_t length);
 
+	/**
+	 * Build an IPv4 packet sharing the content of a buffer
+	 * @param buffer buffer from which an IPv4 packet can be created
+	 */
+	Ipv4Packet(const PacketBuffer &buffer);
+
 	/**
 	 * Build an empty IPv4 packet
 	 */
@@ -61,6 +61,13 @@ Ipv6Packet::Ipv6Packet(const Data &data, size_t length):
 	this->header_length = 40;
 }
 
+Ipv6Packet::Ipv6Packet(const PacketBuffer &buffer): IpPacket(buffer)
+{
+	this->name = "IPv6";
+	this->type = NET_PROTO_IPV6;
+	this->header_length = 40;
+}
+
 Ipv6Packet::Ipv6Packet(): IpPacket()
 {
 	this->name = "IPv6";
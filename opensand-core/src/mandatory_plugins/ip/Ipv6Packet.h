@@ -68,6 +68,12 @@ class Ipv6Packet: public IpPacket
 	 */
 	Ipv6Packet(const Data &data, size_t length);
 
+	/**
+	 * Build an IPv6 packet sharing the content of a buffer
+	 * @param buffer buffer from which an IPv6 packet can be created
+	 */
+	Ipv6Packet(const PacketBuffer &buffer);
+
 	/**
 	 * Build an empty IPv6 packet
 	 */
@@ -44,7 +44,6 @@ MpegPacket::MpegPacket(const unsigned char *data, size_t length):
 {
 	this->name = "MPEG2-TS";
 	this->type = NET_PROTO_MPEG;
-	this->data.reserve(TS_PACKETSIZE);
 	this->header_length = TS_HEADERSIZE;
 	this->src_tal_id = this->getSrcTalId();
 	this->dst_tal_id = this->getDstTalId();
@@ -55,7 +54,6 @@ MpegPacket::MpegPacket(const Data &data): NetPacket(data)
 {
 	this->name = "MPEG2-TS";
 	this->type = NET_PROTO_MPEG;
-	this->data.reserve(TS_PACKETSIZE);
 	this->header_length = TS_HEADERSIZE;
 	this->src_tal_id = this->getSrcTalId();
 	this->dst_tal_id = this->getDstTalId();
@@ -67,7 +65,6 @@ MpegPacket::MpegPacket(const Data &data, size_t length):
 {
 	this->name = "MPEG2-TS";
 	this->type = NET_PROTO_MPEG;
-	this->data.reserve(TS_PACKETSIZE);
 	this->header_length = TS_HEADERSIZE;
 	this->src_tal_id = this->getSrcTalId();
 	this->dst_tal_id = this->getDstTalId();
@@ -36,6 +36,8 @@
 
 #include <opensand_output/Output.h>
 
+#include <algorithm>
+
 static uint32_t crc_table[2560] =
 {
 	0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
@@ -91,7 +93,6 @@ UlePacket::UlePacket(const unsigned char *data, size_t length):
 {
 	this->name = "ULE";
 	this->type = NET_PROTO_ULE;
-	this->data.reserve(1500);
 	this->header_length = ULE_HEADER_LEN;
 }
 
@@ -99,7 +100,6 @@ UlePacket::UlePacket(const Data &data): NetPacket(data)
 {
 	this->name = "ULE";
 	this->type = NET_PROTO_ULE;
-	this->data.reserve(1500);
 	this->header_length = ULE_HEADER_LEN;
 }
 
@@ -108,7 +108,6 @@ UlePacket::UlePacket(const Data &data, size_t length):
 {
 	this->name = "ULE";
 	this->type = NET_PROTO_ULE;
-	this->data.reserve(1500);
 	this->header_length = ULE_HEADER_LEN;
 }
 
@@ -125,6 +124,7 @@ UlePacket::UlePacket(uint16_t type, Data *address, Data payload, bool crc_enable
 	unsigned char dbit;
 	unsigned char length_hi, length_lo;
 	unsigned char type_hi, type_lo;
+	unsigned char field[4];
 	uint32_t crc;
 
 	this->name = "ULE";
@@ -139,28 +139,32 @@ UlePacket::UlePacket(uint16_t type, Data *address, Data payload, bool crc_enable
 	// Length field
 	length_hi = ((payload.length() + ULE_CRC_LEN) >> 8) & 0x7f;
 	length_lo = (payload.length() + ULE_CRC_LEN) & 0xff;
-	this->data.append(1, dbit | length_hi);
-	this->data.append(1, length_lo);
+	field[0] = dbit | length_hi;
+	field[1] = length_lo;
 
 	// Type field
 	type_hi = (type >> 8) & 0xff;
 	type_lo = type & 0xff;
-	this->data.append(1, type_hi);
-	this->data.append(1, type_lo);
+	field[2] = type_hi;
+	field[3] = type_lo;
+	this->data.append(field, 4);
 
 	// Destination Address field if present
 	if(address != NULL)
-		this->data.append(*address, 0, ULE_ADDR_LEN);
+		this->data.append(address->c_str(),
+		                  std::min((size_t)ULE_ADDR_LEN,
+		                           (size_t)address->length()));
 
 	// Payload
-	this->data.append(payload);
+	this->data.append(payload.c_str(), payload.length());
 
 	// CRC field
 	crc = this->calcCrc(crc_enabled);
-	this->data.append(1, (crc >> 24) & 0xff);
-	this->data.append(1, (crc >> 16) & 0xff);
-	this->data.append(1, (crc >> 8) & 0xff);
-	this->data.append(1, crc & 0xff);
+	field[0] = (crc >> 24) & 0xff;
+	field[1] = (crc >> 16) & 0xff;
+	field[2] = (crc >> 8) & 0xff;
+	field[3] = crc & 0xff;
+	this->data.append(field, 4);
 }
 
 UlePacket::~UlePacket()
@@ -225,9 +229,9 @@ size_t UlePacket::getPayloadLength() const
 
 Data UlePacket::getPayload() const
 {
-	return Data(this->data,
-	            this->getTotalLength() - this->getPayloadLength() - ULE_CRC_LEN,
-	            this->getPayloadLength());
+	return this->data.slice(this->getTotalLength() -
+	                        this->getPayloadLength() - ULE_CRC_LEN,
+	                        this->getPayloadLength()).toData();
 }
 
 bool UlePacket::isDstAddrPresent() const
@@ -243,7 +247,7 @@ uint16_t UlePacket::getPayloadType() const
 
 Data UlePacket::destAddr() const
 {
-	return this->data.substr(4, ULE_ADDR_LEN);
+	return this->data.slice(4, ULE_ADDR_LEN).toData();
 }
 
 uint32_t UlePacket::crc() const
@@ -262,11 +266,11 @@ uint32_t UlePacket::calcCrc(bool enabled) const
 
 	if(enabled)
 	{
-		Data::const_iterator it;
+		const unsigned char *it = this->data.data();
 		unsigned int index;
 
-		for(it = this->data.begin(), index = 0;
-			it != this->data.end() && index < (unsigned int) this->getTotalLength() - ULE_ADDR_LEN;
+		for(index = 0;
+			index < this->data.length() && index < (unsigned int) this->getTotalLength() - ULE_ADDR_LEN;
 			it++, index++)
 		{
 			crc = (crc << 8) ^ crc_table[((crc >> 24) ^ (*it)) & 0xff];
@@ -40,11 +40,21 @@
 #include <cstring>
 
 
-DelayFifo::DelayFifo(vol_pkt_t max_size_pkt):
-	queue(),
+/// The wheel slot of a tick
+#define WHEEL_SLOT(tick) \
+	(&this->wheel[((unsigned long)(tick)) % DELAY_WHEEL_SIZE])
+
+
+DelayFifo::DelayFifo(unsigned int max_size_pkt):
+	overflow(),
+	current(0),
+	last(0),
+	wheel_size(0),
+	size(0),
 	max_size_pkt(max_size_pkt),
 	fifo_mutex("delay_fifo_mutex")
 {
+	memset(this->wheel, 0, sizeof(this->wheel));
 }
 
 /**
@@ -55,23 +65,23 @@ DelayFifo::~DelayFifo()
 	this->flush();
 }
 
-vol_pkt_t DelayFifo::getCurrentSize() const
+unsigned int DelayFifo::getCurrentSize() const
 {
 	RtLock lock(this->fifo_mutex);
-	return this->queue.size();
+	return this->size;
 }
 
-bool DelayFifo::setMaxSize(vol_pkt_t max_size_pkt)
+bool DelayFifo::setMaxSize(unsigned int max_size_pkt)
 {
 	RtLock lock(this->fifo_mutex);
 	// check if current size is bigger than the new max value
-	if(this->queue.size() > max_size_pkt)
+	if(this->size > max_size_pkt)
 		return false;
 	this->max_size_pkt = max_size_pkt;
 	return true;
 }
 
-vol_pkt_t DelayFifo::getMaxSize() const
+unsigned int DelayFifo::getMaxSize() const
 {
 	RtLock lock(this->fifo_mutex);
 	return this->max_size_pkt;
@@ -80,35 +90,91 @@ vol_pkt_t DelayFifo::getMaxSize() const
 clock_t DelayFifo::getTickOut() const
 {
 	RtLock lock(this->fifo_mutex);
-	if(queue.size() > 0)
+	if(this->size > 0)
 	{
-		return this->queue.front()->getTickOut();
+		return WHEEL_SLOT(this->current)->head->getTickOut();
 	}
 	return 0;
 }
 
 vector<DelayFifoElement *> DelayFifo::getQueue(void)
 {
-	return this->queue;
+	RtLock lock(this->fifo_mutex);
+	vector<DelayFifoElement *> queue;
+	map<time_t, delay_slot_t>::iterator it;
+	DelayFifoElement *elem;
+
+	queue.reserve(this->size);
+	for(time_t tick = this->current;
+	    this->size > 0 && tick < this->current + DELAY_WHEEL_SIZE; tick++)
+	{
+		for(elem = WHEEL_SLOT(tick)->head; elem != NULL; elem = elem->next)
+		{
+			queue.push_back(elem);
+		}
+	}
+	for(it = this->overflow.begin(); it != this->overflow.end(); ++it)
+	{
+		for(elem = (*it).second.head; elem != NULL; elem = elem->next)
+		{
+			queue.push_back(elem);
+		}
+	}
+	return queue;
 }
 
 bool DelayFifo::push(DelayFifoElement *elem)
 {
-	int pos;
 	RtLock lock(this->fifo_mutex);
+	time_t tick = elem->getTickOut();
 
-	if(this->queue.size() >= this->max_size_pkt)
+	if(this->size >= this->max_size_pkt)
 	{
 		return false;
 	}
 
-	pos = this->getTickOutPosition(elem->getTickOut());
+	if(this->size == 0)
+	{
+		this->restart(tick);
+		this->last = tick;
+	}
+	else if(tick > this->last)
+	{
+		this->last = tick;
+	}
 
-	// insert in correct position
-	if(pos >= 0)
+	if(tick < this->current)
+	{
+		// the wheel is already after this tick, keep the first slot
+		// sorted, this should only happen with a shorter delay
+		delay_slot_t *slot = WHEEL_SLOT(this->current);
+		DelayFifoElement *prev = slot->head;
+
+		if(prev->getTickOut() > tick)
+		{
+			elem->next = slot->head;
+			slot->head = elem;
+		}
+		else
+		{
+			while(prev->next != NULL && prev->next->getTickOut() <= tick)
+			{
+				prev = prev->next;
+			}
+			elem->next = prev->next;
+			prev->next = elem;
+			if(elem->next == NULL)
+			{
+				slot->tail = elem;
+			}
+		}
+		this->wheel_size++;
+	}
+	else
 	{
-		this->queue.insert(this->queue.begin()+pos, elem);
+		this->append(elem, tick);
 	}
+	this->size++;
 
 	return true;
 }
@@ -116,46 +182,85 @@ bool DelayFifo::push(DelayFifoElement *elem)
 bool DelayFifo::pushFront(DelayFifoElement *elem)
 {
 	RtLock lock(this->fifo_mutex);
+	delay_slot_t *slot;
 
-	// insert in head of fifo
-	if(this->queue.size() < this->max_size_pkt)
+	if(this->size >= this->max_size_pkt)
 	{
-		this->queue.insert(this->queue.begin(), elem);
-		return true;
+		return false;
 	}
 
-	return false;
+	// insert in head of fifo
+	if(this->size == 0)
+	{
+		this->restart(elem->getTickOut());
+		this->last = elem->getTickOut();
+	}
+	slot = WHEEL_SLOT(this->current);
+	elem->next = slot->head;
+	slot->head = elem;
+	if(slot->tail == NULL)
+	{
+		slot->tail = elem;
+	}
+	this->wheel_size++;
+	this->size++;
 
+	return true;
 }
 
 bool DelayFifo::pushBack(DelayFifoElement *elem)
 {
 	RtLock lock(this->fifo_mutex);
 
-	// insert in head of fifo
-	if(this->queue.size() < this->max_size_pkt)
+	if(this->size >= this->max_size_pkt)
 	{
-		this->queue.insert(this->queue.end(), elem);
-		return true;
+		return false;
 	}
 
-	return false;
+	// insert in tail of fifo
+	if(this->size == 0)
+	{
+		this->restart(elem->getTickOut());
+		this->last = elem->getTickOut();
+	}
+	else if(elem->getTickOut() > this->last)
+	{
+		this->last = elem->getTickOut();
+	}
+	this->append(elem, this->last);
+	this->size++;
 
+	return true;
 }
+
 DelayFifoElement *DelayFifo::pop()
 {
 	RtLock lock(this->fifo_mutex);
 	DelayFifoElement *elem;
+	delay_slot_t *slot;
 
-	if(this->queue.size() <= 0)
+	if(this->size <= 0)
 	{
 		return NULL;
 	}
 
-	elem = this->queue.front();
+	slot = WHEEL_SLOT(this->current);
+	elem = slot->head;
 
 	// remove the packet
-	this->queue.erase(this->queue.begin());
+	slot->head = elem->next;
+	if(slot->head == NULL)
+	{
+		slot->tail = NULL;
+	}
+	elem->next = NULL;
+	this->wheel_size--;
+	this->size--;
+
+	if(this->size > 0 && slot->head == NULL)
+	{
+		this->advance();
+	}
 
 	return elem;
 }
@@ -163,47 +268,101 @@ DelayFifoElement *DelayFifo::pop()
 void DelayFifo::flush()
 {
 	RtLock lock(this->fifo_mutex);
-	vector<DelayFifoElement *>::iterator it;
-	for(it = this->queue.begin(); it != this->queue.end(); ++it)
+	map<time_t, delay_slot_t>::iterator it;
+	DelayFifoElement *elem;
+
+	for(unsigned int i = 0; i < DELAY_WHEEL_SIZE; i++)
+	{
+		while(this->wheel[i].head != NULL)
+		{
+			elem = this->wheel[i].head;
+			this->wheel[i].head = elem->next;
+			delete elem;
+		}
+		this->wheel[i].tail = NULL;
+	}
+	for(it = this->overflow.begin(); it != this->overflow.end(); ++it)
 	{
-		delete *it;
+		while((*it).second.head != NULL)
+		{
+			elem = (*it).second.head;
+			(*it).second.head = elem->next;
+			delete elem;
+		}
 	}
 
-	this->queue.clear();
+	this->overflow.clear();
+	this->wheel_size = 0;
+	this->size = 0;
 }
 
-int DelayFifo::getTickOutPosition(time_t time_out)
+void DelayFifo::append(DelayFifoElement *elem, time_t tick)
 {
-	time_t time_elem;
-	int pos = -1;
-	int start = 0;
-	int test = 0;
-	int end = this->queue.size() - 1;
+	delay_slot_t *slot;
 
-	// Implement a divide and conquer approach
-	// TODO: if this proves too consuming, implement one FIFO for
-	// each SPOT/GW, and always push_back (all elements will
-	// have the same delay, except for those with 0 delay)
-	while(end > start)
+	if(tick >= this->current + DELAY_WHEEL_SIZE)
 	{
-		test = (end + start)/2;
-		time_elem = this->queue.at(test)->getTickOut();
-		if(time_elem > time_out)
-			end = test;
-		else
-			start = test + 1;
+		slot = &this->overflow[tick];
 	}
-	if(end == start)
+	else
 	{
-		time_elem = this->queue.at(start)->getTickOut();
-		if(time_elem > time_out)
-			pos = start;
-		else
-			pos = start + 1;
+		slot = WHEEL_SLOT(tick);
+		this->wheel_size++;
+	}
+
+	elem->next = NULL;
+	if(slot->tail == NULL)
+	{
+		slot->head = elem;
+	}
+	else
+	{
+		slot->tail->next = elem;
 	}
-	else if(end < 0)
+	slot->tail = elem;
+}
+
+void DelayFifo::advance(void)
+{
+	if(this->wheel_size == 0)
+	{
+		// only elements after the horizon, jump to the first one
+		this->restart((*this->overflow.begin()).first);
+		return;
+	}
+
+	do
+	{
+		// the slot we leave becomes the last one of the wheel
+		this->current++;
+		this->migrate();
+	}
+	while(WHEEL_SLOT(this->current)->head == NULL);
+}
+
+void DelayFifo::restart(time_t tick)
+{
+	this->current = tick;
+	this->migrate();
+}
+
+void DelayFifo::migrate(void)
+{
+	map<time_t, delay_slot_t>::iterator it;
+	DelayFifoElement *elem;
+
+	while(!this->overflow.empty())
 	{
-		pos = 0;
+		it = this->overflow.begin();
+		if((*it).first >= this->current + DELAY_WHEEL_SIZE)
+		{
+			break;
+		}
+		*WHEEL_SLOT((*it).first) = (*it).second;
+		for(elem = (*it).second.head; elem != NULL; elem = elem->next)
+		{
+			this->wheel_size++;
+		}
+		this->overflow.erase(it);
 	}
-	return pos;
 }
@@ -47,11 +47,20 @@ using std::vector;
 using std::map;
 
 
+/// The number of slots in the delay wheel, one per ms
+#define DELAY_WHEEL_SIZE 4096
+
+
 /**
  * @class DelayFifo
  * @brief Defines a Delay fifo
  *
  * Manages a Sat Carrier fifo, for queuing, statistics, ...
+ *
+ * The elements are sorted on their tick out in a timing wheel with one
+ * slot per ms, so push and pop do not depend on the number of elements.
+ * The elements that should leave the FIFO after the wheel horizon
+ * wait in an overflow map until the wheel reaches them.
  */
 class DelayFifo
 {
@@ -62,7 +71,7 @@ class DelayFifo
 	 *
 	 * @param max_size_pkt  the fifo maximum size
 	 */
-	DelayFifo(vol_pkt_t max_size_pkt = 10000);
+	DelayFifo(unsigned int max_size_pkt = 10000);
 
 	~DelayFifo();
 
@@ -71,7 +80,7 @@ class DelayFifo
 	 *
 	 * @return the queue current size
 	 */
-	vol_pkt_t getCurrentSize() const;
+	unsigned int getCurrentSize() const;
 
 	/**
 	 * @brief Set the fifo maximum size
@@ -79,14 +88,14 @@ class DelayFifo
 	 * @param max_size_pkt, the max number of packets
 	 * @return true on success, false otherwise
 	 */
-	bool setMaxSize(vol_pkt_t max_size_pkt);
+	bool setMaxSize(unsigned int max_size_pkt);
 	
 	/**
 	 * @brief Get the fifo maximum size
 	 *
 	 * @return the queue maximum size
 	 */
-	vol_pkt_t getMaxSize() const;
+	unsigned int getMaxSize() const;
 	
 	/**
 	 * @brief Get the head element tick out
@@ -139,16 +148,60 @@ class DelayFifo
 
  protected:
 
+	/// The elements with the same tick out, in arrival order
+	typedef struct
+	{
+		DelayFifoElement *head;  ///< The first element
+		DelayFifoElement *tail;  ///< The last element
+	} delay_slot_t;
+
+	/**
+	 * @brief Add an element at the end of its slot
+	 *
+	 * @param elem  The element
+	 * @param tick  The tick of the slot
+	 */
+	void append(DelayFifoElement *elem, time_t tick);
+
+	/**
+	 * @brief Move the wheel to the next slot containing elements
+	 *        and bring the elements that enter the wheel horizon
+	 *        from the overflow map
+	 */
+	void advance(void);
+
+	/**
+	 * @brief Restart the empty wheel at a given tick
+	 *
+	 * @param tick  The tick of the first slot
+	 */
+	void restart(time_t tick);
+
 	/**
-	 * @brief Get the index where time_out should be placed
-	 * @param time_out the tick out 
-	 * @return -1 on error, the index on success
+	 * @brief Bring the elements that enter the wheel horizon
+	 *        from the overflow map
 	 */
-	int getTickOutPosition(time_t time_out);
+	void migrate(void);
+
+	/// The wheel slots, indexed by tick out modulo the wheel size
+	delay_slot_t wheel[DELAY_WHEEL_SIZE];
+
+	/// The elements after the wheel horizon, sorted on tick out
+	map<time_t, delay_slot_t> overflow;
+
+	/// The tick of the first slot of the wheel, that contains the head
+	time_t current;
+
+	/// The biggest tick out in the FIFO
+	time_t last;
+
+	/// The number of elements in the wheel
+	unsigned int wheel_size;
 
-	vector<DelayFifoElement *> queue; ///< the FIFO itself
+	/// The number of elements in the FIFO
+	unsigned int size;
 
-	vol_pkt_t max_size_pkt;         ///< the maximum size for that FIFO
+	unsigned int max_size_pkt;      ///< the maximum size for that FIFO
 
 	mutable RtMutex fifo_mutex; ///< The mutex to protect FIFO from concurrent access
 };
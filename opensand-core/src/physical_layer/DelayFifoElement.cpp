@@ -33,12 +33,40 @@
 
 
 #include "DelayFifoElement.h"
+#include "ObjectPool.h"
+
+
+/// The maximum size of the elements allocated in pool
+#define DELAY_FIFO_ELEMENT_POOL_SIZE (sizeof(DelayFifoElement))
+
+
+/**
+ * @brief Get the elements pool, created on first use
+ *
+ * @return the elements pool
+ */
+static ObjectPool &getPool(void)
+{
+	static ObjectPool pool("DelayFifoElement", DELAY_FIFO_ELEMENT_POOL_SIZE);
+	return pool;
+}
+
+void *DelayFifoElement::operator new(size_t size)
+{
+	return getPool().allocate(size);
+}
+
+void DelayFifoElement::operator delete(void *p)
+{
+	ObjectPool::release(p);
+}
 
 DelayFifoElement::DelayFifoElement(NetContainer *elem,
                                              time_t tick_in, time_t tick_out):
 	elem(elem),
 	tick_in(tick_in),
-	tick_out(tick_out)
+	tick_out(tick_out),
+	next(NULL)
 {
 }
 
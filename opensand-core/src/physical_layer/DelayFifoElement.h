@@ -42,6 +42,8 @@
  */
 class DelayFifoElement
 {
+	friend class DelayFifo;
+
  protected:
 
 	/// The element stored in the FIFO
@@ -52,6 +54,9 @@ class DelayFifoElement
 	/// The minimal time the packet will output the FIFO (in ms)
 	time_t tick_out;
 
+	/// The next element with the same tick out in the FIFO
+	DelayFifoElement *next;
+
 
  public:
 
@@ -69,6 +74,21 @@ class DelayFifoElement
 	 */
 	~DelayFifoElement();
 
+	/**
+	 * Allocate an element in the elements pool
+	 *
+	 * @param size  The element size
+	 * @return the element memory
+	 */
+	void *operator new(size_t size);
+
+	/**
+	 * Release an element in the elements pool
+	 *
+	 * @param p  The element memory
+	 */
+	void operator delete(void *p);
+
 	/**
 	 * Get the FIFO elelement
 	 * @return The FIFO element
@@ -49,6 +49,9 @@ GroundPhysicalChannel::GroundPhysicalChannel(tal_id_t mac_id):
 	attenuation_model(NULL),
 	clear_sky_condition(0),
 	delay_fifo(),
+	channel(NULL),
+	deadline_timer(false),
+	fifo_deadline(0),
 	probe_attenuation(NULL),
 	probe_clear_sky_condition(NULL),
 	mac_id(mac_id),
@@ -75,7 +78,7 @@ bool GroundPhysicalChannel::initGround(const string &channel_name, RtChannel *ch
 {
 	ostringstream name;
 	char probe_name[128];
-	vol_pkt_t max_size;
+	unsigned int max_size;
 	time_ms_t refresh_period_ms;
 	string attenuation_type;
 	string phy_layer_section;
@@ -113,7 +116,7 @@ bool GroundPhysicalChannel::initGround(const string &channel_name, RtChannel *ch
 	}
 	this->delay_fifo.setMaxSize(max_size);
 	LOG(log_init, LEVEL_NOTICE,
-	    "delay_fifo_max_size = %d pkt", max_size);
+	    "delay_fifo_max_size = %u pkt", max_size);
 
 	// Get the delay refresh period
 	if(!Conf::getValue(Conf::section_map[ADV_SECTION],
@@ -123,11 +126,24 @@ bool GroundPhysicalChannel::initGround(const string &channel_name, RtChannel *ch
 		    "cannot get '%s' value", DELAY_TIMER);
 		return false;;
 	}
-	LOG(log_init, LEVEL_NOTICE,
-	    "delay_refresh_period = %d ms", refresh_period_ms);
-
 	// Initialize the FIFO event
-	this->fifo_timer = channel->addTimerEvent("fifo_timer", refresh_period_ms);
+	this->channel = channel;
+	if(refresh_period_ms == 0)
+	{
+		// armed on the packets deadlines, without idle wake up
+		LOG(log_init, LEVEL_NOTICE,
+		    "delay FIFO timer armed on the earliest deadline");
+		this->deadline_timer = true;
+		this->fifo_timer = channel->addTimerEvent("fifo_timer", 0,
+		                                          false, false);
+	}
+	else
+	{
+		LOG(log_init, LEVEL_NOTICE,
+		    "delay_refresh_period = %d ms", refresh_period_ms);
+		this->fifo_timer = channel->addTimerEvent("fifo_timer",
+		                                          refresh_period_ms);
+	}
 
 	// Initialize log
 	snprintf(probe_name, sizeof(probe_name),
@@ -282,6 +298,13 @@ bool GroundPhysicalChannel::pushPacket(NetContainer *pkt)
 	    elem->getTickIn(),
 	    elem->getTickOut(),
 	    delay);
+
+	// the new packet may be the first one to leave the FIFO
+	if(this->deadline_timer &&
+	   (this->fifo_deadline == 0 || elem->getTickOut() < this->fifo_deadline))
+	{
+		this->armFifoTimer();
+	}
 	return true;
 
 release_elem:
@@ -312,5 +335,35 @@ bool GroundPhysicalChannel::forwardReadyPackets()
 		delete elem;
 		this->forwardPacket((DvbFrame *)pkt);
 	}
+
+	if(this->deadline_timer)
+	{
+		// the timer is disabled once expired
+		this->fifo_deadline = 0;
+		if(this->delay_fifo.getCurrentSize() > 0)
+		{
+			this->armFifoTimer();
+		}
+	}
 	return true;
 }
+
+void GroundPhysicalChannel::armFifoTimer()
+{
+	timeval current;
+	double remaining_ms;
+
+	this->fifo_deadline = this->delay_fifo.getTickOut();
+
+	// the ticks are in ms but the timer is precise to the us
+	gettimeofday(&current, NULL);
+	remaining_ms = this->fifo_deadline -
+	               (current.tv_sec * 1000.0 + current.tv_usec / 1000.0);
+	if(remaining_ms <= 0)
+	{
+		this->channel->raiseTimer(this->fifo_timer);
+		return;
+	}
+	this->channel->setDuration(this->fifo_timer, remaining_ms);
+	this->channel->startTimer(this->fifo_timer);
+}
@@ -64,6 +64,16 @@ class GroundPhysicalChannel
 	/// The FIFO that implements the delay
 	DelayFifo delay_fifo;
 
+	/// The channel owning the FIFO timer
+	RtChannel *channel;
+
+	/// Whether the FIFO timer is armed on the earliest deadline
+	/// instead of being periodic
+	bool deadline_timer;
+
+	/// The tick out the FIFO timer is armed for, 0 if it is not armed
+	clock_t fifo_deadline;
+
 	/// Probes
 	Probe<float> *probe_attenuation;
 	Probe<float> *probe_clear_sky_condition;
@@ -130,6 +140,12 @@ class GroundPhysicalChannel
 	 */
 	bool forwardReadyPackets();
 
+	/**
+	 * @brief Arm the FIFO timer on the head packet deadline,
+	 *        in deadline timer mode
+	 */
+	void armFifoTimer();
+
 	/**
 	 * @brief Forward the frame to the next channel
 	 *
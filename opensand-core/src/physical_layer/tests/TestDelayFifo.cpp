@@ -42,7 +42,7 @@
 #include <cstring>
 
 
-TestDelayFifo::TestDelayFifo(vol_pkt_t max_size_pkt):
+TestDelayFifo::TestDelayFifo(unsigned int max_size_pkt):
 	queue(),
 	max_size_pkt(max_size_pkt),
 	fifo_mutex("delay_fifo_mutex")
@@ -57,13 +57,13 @@ TestDelayFifo::~TestDelayFifo()
 	this->flush();
 }
 
-vol_pkt_t TestDelayFifo::getCurrentSize() const
+unsigned int TestDelayFifo::getCurrentSize() const
 {
 	RtLock lock(this->fifo_mutex);
 	return this->queue.size();
 }
 
-vol_pkt_t TestDelayFifo::getMaxSize() const
+unsigned int TestDelayFifo::getMaxSize() const
 {
 	RtLock lock(this->fifo_mutex);
 	return this->max_size_pkt;
@@ -99,7 +99,6 @@ bool TestDelayFifo::push(TestDelayFifoElement *elem)
 	// insert in correct position
 	if(pos >= 0)
 	{
-		printf("fifo pos %d", pos);
 		this->queue.insert(this->queue.begin()+pos, elem);
 	}
 
@@ -195,6 +194,5 @@ int TestDelayFifo::getTickOutPosition(time_t time_out)
 	{
 		pos = 0;
 	}
-	printf("Position: %d\n", pos);
 	return pos;
 }
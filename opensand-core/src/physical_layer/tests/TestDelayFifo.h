@@ -62,7 +62,7 @@ class TestDelayFifo
 	 *
 	 * @param max_size_pkt  the fifo maximum size
 	 */
-	TestDelayFifo(vol_pkt_t max_size_pkt);
+	TestDelayFifo(unsigned int max_size_pkt);
 
 	~TestDelayFifo();
 
@@ -71,14 +71,14 @@ class TestDelayFifo
 	 *
 	 * @return the queue current size
 	 */
-	vol_pkt_t getCurrentSize() const;
+	unsigned int getCurrentSize() const;
 
 	/**
 	 * @brief Get the fifo maximum size
 	 *
 	 * @return the queue maximum size
 	 */
-	vol_pkt_t getMaxSize() const;
+	unsigned int getMaxSize() const;
 	
 	/**
 	 * @brief Get the head element tick out
@@ -140,7 +140,7 @@ class TestDelayFifo
 
 	vector<TestDelayFifoElement *> queue; ///< the FIFO itself
 
-	vol_pkt_t max_size_pkt;         ///< the maximum size for that FIFO
+	unsigned int max_size_pkt;      ///< the maximum size for that FIFO
 
 	mutable RtMutex fifo_mutex; ///< The mutex to protect FIFO from concurrent access
 };
@@ -0,0 +1,133 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ * Copyright © 2019 CNES
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file bench_delay_fifo.cpp
+ * @brief Compare the delay FIFO timing wheel with the sorted vector
+ *        of TestDelayFifo
+ *
+ * The FIFOs are filled with elements, then each operation pushes an
+ * element with a random delay and pops the head one, as the physical layer
+ * does. The order of the popped elements is checked against the vector.
+ */
+
+
+#include "DelayFifo.h"
+#include "TestDelayFifo.h"
+#include "TestTimer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+
+/// The number of push and pop measured for each FIFO size
+#define BENCH_OPERATIONS 10000
+
+/// The delay of each element, in ms: GEO delay with jitter
+#define BENCH_DELAY(seed) (250 + rand_r(seed) % 20)
+
+
+/**
+ * @brief Fill a FIFO then measure push and pop on it
+ *
+ * @param fifo      The FIFO
+ * @param number    The number of elements in FIFO
+ * @param duration  OUT: The duration of an operation (ns)
+ * @return the sum of the popped tick out, to compare the FIFOs
+ */
+template<class Fifo, class Element>
+static uint64_t bench(Fifo *fifo, unsigned int number, double &duration)
+{
+	unsigned int seed = 42;
+	uint64_t checksum = 0;
+	uint64_t start;
+	time_t tick = 0;
+	Element *elem;
+
+	// a few elements arrive each ms
+	for(unsigned int i = 0; i < number; i++)
+	{
+		tick = i / 8;
+		fifo->push(new Element(NULL, tick, tick + BENCH_DELAY(&seed)));
+	}
+
+	start = getNanoseconds();
+	for(unsigned int i = 0; i < BENCH_OPERATIONS; i++)
+	{
+		tick = (number + i) / 8;
+		fifo->push(new Element(NULL, tick, tick + BENCH_DELAY(&seed)));
+		elem = fifo->pop();
+		checksum = checksum * 31 + elem->getTickOut();
+		delete elem;
+	}
+	duration = (double)(getNanoseconds() - start) / BENCH_OPERATIONS;
+
+	while(fifo->getCurrentSize() > 0)
+	{
+		elem = fifo->pop();
+		checksum = checksum * 31 + elem->getTickOut();
+		delete elem;
+	}
+	return checksum;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int sizes[] = {10000, 100000, 1000000};
+	int is_failure = 0;
+
+	printf("%10s %15s %15s\n", "elements", "wheel (ns/op)", "vector (ns/op)");
+	for(unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		DelayFifo *wheel = new DelayFifo(sizes[i] + 1);
+		TestDelayFifo *vector = new TestDelayFifo(sizes[i] + 1);
+		double wheel_duration;
+		double vector_duration;
+		uint64_t wheel_checksum;
+		uint64_t vector_checksum;
+
+		wheel_checksum = bench<DelayFifo, DelayFifoElement>(
+			wheel, sizes[i], wheel_duration);
+		vector_checksum = bench<TestDelayFifo, TestDelayFifoElement>(
+			vector, sizes[i], vector_duration);
+		printf("%10u %15.1f %15.1f\n", sizes[i],
+		       wheel_duration, vector_duration);
+		if(wheel_checksum != vector_checksum)
+		{
+			fprintf(stderr, "elements not popped in the same order "
+			        "with %u elements\n", sizes[i]);
+			is_failure = 1;
+		}
+
+		delete wheel;
+		delete vector;
+	}
+
+	return is_failure;
+}
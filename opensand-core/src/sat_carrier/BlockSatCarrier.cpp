@@ -41,6 +41,15 @@
 #include "DvbFrame.h"
 #include "OpenSandFrames.h"
 #include "OpenSandCore.h"
+#include "PacketBuffer.h"
+
+
+/// The reception buffers are storages adopted by the received frames
+static const net_buffer_allocator_t datagram_allocator =
+{
+	PacketBuffer::allocateStorage,
+	PacketBuffer::releaseStorage,
+};
 
 /**
  * Constructor
@@ -70,7 +79,7 @@ bool BlockSatCarrier::Downward::onEvent(const RtEvent *const event)
 			    event->getName().c_str());
 
 			if(!this->out_channel_set.send(dvb_frame->getCarrierId(),
-			                               dvb_frame->getData().c_str(),
+			                               dvb_frame->getBuffer().data(),
 			                               dvb_frame->getTotalLength()))
 			{
 				LOG(this->log_receive, LEVEL_ERROR,
@@ -89,6 +98,12 @@ bool BlockSatCarrier::Downward::onEvent(const RtEvent *const event)
 	return true;
 }
 
+bool BlockSatCarrier::Downward::onEventsProcessed(void)
+{
+	// send the frames queued while handling the events
+	return this->out_channel_set.flush();
+}
+
 bool BlockSatCarrier::Upward::onEvent(const RtEvent *const event)
 {
 	bool status = true;
@@ -131,7 +146,7 @@ bool BlockSatCarrier::Upward::onEvent(const RtEvent *const event)
 
 					if(length > 0)
 					{
-						this->onReceivePktFromCarrier(carrier_id, spot_id,  
+						this->onReceivePktFromCarrier(carrier_id, spot_id,
 						                              buf, length);
 					}
 				}
@@ -182,9 +197,12 @@ bool BlockSatCarrier::Upward::onInit(void)
 			    "Listen on fd %d for channel %d\n",
 			    channel->getChannelFd(), channel->getChannelID());
 			name << "Channel_" << channel->getChannelID();
+			// receive the datagrams in storages the frames can adopt
 			this->addNetSocketEvent(name.str(),
 			                        channel->getChannelFd(),
-			                        MSG_BBFRAME_SIZE_MAX + 1); // consider byte used for sequencing
+			                        MSG_BBFRAME_SIZE_MAX + 1, // consider byte used for sequencing
+			                        3,
+			                        &datagram_allocator);
 		}
 	}
 	return true;
@@ -205,11 +223,14 @@ bool BlockSatCarrier::Downward::onInit()
 
 void BlockSatCarrier::Upward::onReceivePktFromCarrier(uint8_t carrier_id,
                                                       spot_id_t spot_id,
-                                                      unsigned char *data,
+                                                      unsigned char *datagram,
                                                       size_t length)
 {
-	DvbFrame *dvb_frame = new DvbFrame(data, length);
-	free(data);
+	// the frame uses the datagram storage, the payload is after
+	// the sequencing field
+	DvbFrame *dvb_frame = new DvbFrame(PacketBuffer::adopt(datagram,
+	                                                       UDP_SEQ_LEN,
+	                                                       length));
 
 	dvb_frame->setCarrierId(carrier_id);
 	dvb_frame->setSpot(spot_id);
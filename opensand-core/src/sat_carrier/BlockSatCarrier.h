@@ -92,12 +92,13 @@ class BlockSatCarrier: public Block
 		 * @brief Handle a packt received from carrier
 		 *
 		 * @param carrier_id  The carrier of the packet
-		 * @param data        The data read on socket
-		 * @param length      The data length
+		 * @param datagram    The datagram read on socket, the frame built
+		 *                    from it takes its ownership
+		 * @param length      The data length, after the sequencing field
 		 */
 		void onReceivePktFromCarrier(uint8_t carrier_id,
 		                             spot_id_t spot_id,
-		                             unsigned char *data,
+		                             unsigned char *datagram,
 		                             size_t length);
 	};
 
@@ -113,6 +114,7 @@ class BlockSatCarrier: public Block
 
 		bool onInit(void);
 		bool onEvent(const RtEvent *const event);
+		bool onEventsProcessed(void);
 
 	 private:
 		/// the IP address for emulation newtork
@@ -398,7 +398,7 @@ bool sat_carrier_channel_set::send(uint8_t carrier_id,
 	{
 		if(carrier_id == (*it)->getChannelID() && (*it)->isOutputOk())
 		{
-			if((*it)->send(data, length))
+			if((*it)->enqueue(data, length))
 			{
 				status = true;
 			}
@@ -417,6 +417,26 @@ bool sat_carrier_channel_set::send(uint8_t carrier_id,
 }
 
 
+bool sat_carrier_channel_set::flush(void)
+{
+	std::vector <UdpChannel *>::const_iterator it;
+	bool status = true;
+
+	for(it = this->begin(); it != this->end(); ++it)
+	{
+		if((*it)->isOutputOk() && !(*it)->flush())
+		{
+			LOG(this->log_sat_carrier, LEVEL_ERROR,
+			    "failed to flush data on channel %u\n",
+			    (*it)->getChannelID());
+			status = false;
+		}
+	}
+
+	return status;
+}
+
+
 int sat_carrier_channel_set::receive(NetSocketEvent *const event,
                                      unsigned int &op_carrier,
                                      spot_id_t &op_spot,
@@ -75,6 +75,7 @@ class sat_carrier_channel_set: public std::vector < UdpChannel * >
 
 	/**
 	 * @brief Send data on a satellite carrier
+	 *        The data are queued in the channel until the next flush
 	 *
 	 * @param carrier_id  The satellite carrier ID
 	 * @param data        The data to send
@@ -83,16 +84,26 @@ class sat_carrier_channel_set: public std::vector < UdpChannel * >
 	 */
 	bool send(uint8_t carrier_id, const unsigned char *data, size_t length);
 
+	/**
+	 * @brief Send the data queued on all satellite carriers
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool flush(void);
+
 	/**
 	* @brief Receive data on a channel set
 	*
 	* The function works in blocking mode, so call it only when you are sure
 	* some data is ready to be received.
 	*
+	* The datagram is not copied, the payload starts UDP_SEQ_LEN bytes
+	* after op_buf which should be given back with event->releaseData.
+	*
 	* @param event         The event on channel fd
 	* @param op_carrier    Satellite Carrier id
-	* @param op_buf        pointer to a char buffer
-	* @param op_len        the received data length
+	* @param op_buf        OUT: the datagram buffer
+	* @param op_len        the received payload length
 	* @return  0 on success, 1 if the function should be
 	 *         called another time, -1 on error
 	*/
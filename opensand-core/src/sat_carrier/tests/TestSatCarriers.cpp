@@ -164,6 +164,12 @@ bool TestSatCarriers::Downward::onEvent(const RtEvent *const event)
 	return true;
 }
 
+bool TestSatCarriers::Downward::onEventsProcessed(void)
+{
+	// send the packets queued while handling the events
+	return this->out_channel_set.flush();
+}
+
 bool TestSatCarriers::Upward::onEvent(const RtEvent *const event)
 {
 	bool status = true;
@@ -198,8 +204,8 @@ bool TestSatCarriers::Upward::onEvent(const RtEvent *const event)
 				{
 					if(length > 0)
 					{
-						Data *packet = new Data(buf, length);
-						free(buf);
+						Data *packet = new Data(buf + UDP_SEQ_LEN, length);
+						((NetSocketEvent *)event)->releaseData(buf);
 
 						if(!this->shareMessage((void **)(&packet), length, from_udp))
 						{
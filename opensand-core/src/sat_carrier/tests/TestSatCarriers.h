@@ -102,6 +102,7 @@ class TestSatCarriers: public Block
 
 		bool onInit(void);
 		bool onEvent(const RtEvent *const event);
+		bool onEventsProcessed(void);
 
 		/**
 		 * @brief Set the network socket file descriptor
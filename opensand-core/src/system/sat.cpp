@@ -60,6 +60,7 @@
 #include "BlockSatCarrier.h"
 #include "BlockPhysicalLayerSat.h"
 #include "Plugin.h"
+#include "ObjectPool.h"
 #include "OpenSandConf.h"
 
 #include <opensand_conf/conf.h>
@@ -82,11 +83,12 @@ bool init_process(int argc, char **argv, string &ip_addr, string &conf_path)
 	int opt;
 	bool output_enabled = true;
 	bool output_stdout = false;
+	bool output_deferred = false;
 	bool stop = false;
 	string lib_external_output_path = "";
 	char entity[10];
 	/* setting environment agent parameters */
-	while(!stop && (opt = getopt(argc, argv, "-hqda:c:e:")) != EOF)
+	while(!stop && (opt = getopt(argc, argv, "-hqdba:c:e:")) != EOF)
 	{
 		switch(opt)
 		{
@@ -98,6 +100,10 @@ bool init_process(int argc, char **argv, string &ip_addr, string &conf_path)
 				// enable output debug
 				output_stdout = true;
 				break;
+			case 'b':
+				// format the logs in the output thread
+				output_deferred = true;
+				break;
 			case 'a':
 				/// get local IP address
 				ip_addr = optarg;
@@ -112,11 +118,12 @@ bool init_process(int argc, char **argv, string &ip_addr, string &conf_path)
 				break;
 			case 'h':
 			case '?':
-				fprintf(stderr, "usage: %s [-h] [[-q] [-d] -a ip_address -c conf_path] -e lib_ext_output_path\n",
+				fprintf(stderr, "usage: %s [-h] [[-q] [-d] [-b] -a ip_address -c conf_path] -e lib_ext_output_path\n",
 					argv[0]);
 				fprintf(stderr, "\t-h                       print this message\n");
 				fprintf(stderr, "\t-q                       disable output\n");
 				fprintf(stderr, "\t-d                       enable output debug events\n");
+				fprintf(stderr, "\t-b                       format the logs in the output thread\n");
 				fprintf(stderr, "\t-a <ip_address>          set the IP address\n");
 				fprintf(stderr, "\t-c <conf_path>           specify the configuration path\n");
 				fprintf(stderr, "\t-e <lib_ext_output_path> specify the external output library path\n");
@@ -148,6 +155,10 @@ bool init_process(int argc, char **argv, string &ip_addr, string &conf_path)
 	{
 		Output::enableStdlog();
 	}
+	if(output_deferred)
+	{
+		Output::enableDeferredLogs();
+	}
 	if(stop)
 	{
 		return false;
@@ -345,6 +356,8 @@ int main(int argc, char **argv)
 	{
 		goto release_plugins;
 	}
+	// the pools created before the output have no probe yet
+	ObjectPool::registerProbes();
 	if(!Output::finishInit())
 	{
 		DFLTLOG(LEVEL_NOTICE,
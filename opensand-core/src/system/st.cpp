@@ -63,6 +63,7 @@
 #include "BlockSatCarrier.h"
 #include "BlockPhysicalLayer.h"
 #include "Plugin.h"
+#include "ObjectPool.h"
 #include "OpenSandConf.h"
 
 #include <opensand_rt/Rt.h>
@@ -88,11 +89,12 @@ bool init_process(int argc, char **argv,
 	int opt;
 	bool output_enabled = true;
 	bool output_stdout = false;
+	bool output_deferred = false;
 	bool stop = false;
 	string lib_external_output_path = "";
 	char entity[10];
 	/* setting environment agent parameters */
-	while(!stop && (opt = getopt(argc, argv, "-hqdi:a:t:c:e:")) != EOF)
+	while(!stop && (opt = getopt(argc, argv, "-hqdbi:a:t:c:e:")) != EOF)
 	{
 		switch(opt)
 		{
@@ -104,6 +106,10 @@ bool init_process(int argc, char **argv,
 			// enable output debug
 			output_stdout = true;
 			break;
+		case 'b':
+			// format the logs in the output thread
+			output_deferred = true;
+			break;
 		case 'i':
 			// get instance id
 			instance_id = atoi(optarg);
@@ -126,12 +132,13 @@ bool init_process(int argc, char **argv,
 			break;
 		case 'h':
 		case '?':
-			fprintf(stderr, "usage: %s [-h] [[-q] [-d] -i instance_id -a ip_address "
+			fprintf(stderr, "usage: %s [-h] [[-q] [-d] [-b] -i instance_id -a ip_address "
 				"-t tuntap_iface -c conf_path -e lib_ext_output_path\n",
 			        argv[0]);
 			fprintf(stderr, "\t-h                       print this message\n");
 			fprintf(stderr, "\t-q                       disable output\n");
 			fprintf(stderr, "\t-d                       enable output debug events\n");
+			fprintf(stderr, "\t-b                       format the logs in the output thread\n");
 			fprintf(stderr, "\t-a <ip_address>          set the IP address for emulation\n");
 			fprintf(stderr, "\t-t <tuntap_iface>        set the ST TUN/TAP interface name\n");
 			fprintf(stderr, "\t-i <instance>            set the instance id\n");
@@ -165,6 +172,10 @@ bool init_process(int argc, char **argv,
 	{
 		Output::enableStdlog();
 	}
+	if(output_deferred)
+	{
+		Output::enableDeferredLogs();
+	}
 	if(stop)
 	{
 		return false;
@@ -381,6 +392,8 @@ int main(int argc, char **argv)
 	{
 		goto release_plugins;
 	}
+	// the pools created before the output have no probe yet
+	ObjectPool::registerProbes();
 	if(!Output::finishInit())
 	{
 		DFLTLOG(LEVEL_NOTICE,
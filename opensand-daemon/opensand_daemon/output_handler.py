@@ -61,6 +61,7 @@ MSG_CMD_DISABLE = 8
 MSG_CMD_ENABLE = 9
 
 MSG_CMD_SEND_PROBES = 10
+MSG_CMD_SEND_PROBES_BATCH = 13
 MSG_CMD_SEND_LOG = 20
 
 MSG_CMD_ENABLE_PROBE = 11
@@ -73,7 +74,9 @@ MSG_CMD_ENABLE_SYSLOG = 25
 MSG_CMD_DISABLE_SYSLOG = 26
 
 
-REL_MSGS_PROG_TO_COL = frozenset([MSG_CMD_SEND_PROBES, MSG_CMD_SEND_LOG])
+REL_MSGS_PROG_TO_COL = frozenset([MSG_CMD_SEND_PROBES,
+                                  MSG_CMD_SEND_PROBES_BATCH,
+                                  MSG_CMD_SEND_LOG])
 
 class OutputHandler(threading.Thread):
     """
@@ -228,8 +231,8 @@ class OutputHandler(threading.Thread):
         msg_len = len(msg) if msg is not None else 0
 
         if (cmd in [MSG_CMD_REGISTER_INIT, MSG_CMD_REGISTER_END,
-                    MSG_CMD_REGISTER_LIVE]) and msg_len >= 6:
-            pid, num_probes, num_logs = struct.unpack("!LBB", msg[0:6])
+                    MSG_CMD_REGISTER_LIVE]) and msg_len >= 7:
+            pid, num_probes, num_logs = struct.unpack("!LHB", msg[0:7])
             LOGGER.debug("REGISTER from PID %d (%d probes, %d logs)",
                          pid, num_probes, num_logs)
 
@@ -262,13 +265,13 @@ class OutputHandler(threading.Thread):
                             prog_name, prog_id)
 
             resp = MSG_CMD_ACK
-            header = struct.pack("!LBBBBB", MAGIC_NUMBER,
+            header = struct.pack("!LBBHBB", MAGIC_NUMBER,
                                  cmd, prog_id, num_probes,
                                  num_logs, len(prog_name))
 
             if self._collector_addr:
                 # Send REGISTER to the collector
-                sendtosock(self._ext_socket, header + prog_name + msg[6:],
+                sendtosock(self._ext_socket, header + prog_name + msg[7:],
                            self._collector_addr)
 
                 if cmd != MSG_CMD_REGISTER_LIVE:
@@ -289,17 +292,17 @@ class OutputHandler(threading.Thread):
                             # store the register message to send it back if
                             # collector is restarted or moved
                             self._register_msg[prog_id].append(header + prog_name +
-                                                               msg[6:])
+                                                               msg[7:])
                 else:
                     # store the register message to send it back if
                     # collector is restarted or moved
                     self._register_msg[prog_id].append(header + prog_name +
-                                                       msg[6:])
+                                                       msg[7:])
             else:
                 # store the register message to send it if
                 # collector is started
                 self._register_msg[prog_id].append(header + prog_name +
-                                                   msg[6:])
+                                                   msg[7:])
                 resp = MSG_CMD_NACK
                 LOGGER.error("Collector not known, not relaying REGISTER")
 
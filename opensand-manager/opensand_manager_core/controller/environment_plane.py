@@ -365,24 +365,24 @@ class EnvironmentPlaneController(object):
         Handles a registration message.
         """
         host_id, prog_id, num_probes, num_logs, name_length = \
-            struct.unpack("!BBBBB", data[0:5])
-        prog_name = data[5:5 + name_length]
+            struct.unpack("!BBHBB", data[0:6])
+        prog_name = data[6:6 + name_length]
         full_prog_id = (host_id << 8) | prog_id
 
         if len(prog_name) != name_length:
             self._log.error("Program name length mismatch")
             return False
 
-        pos = 5 + name_length
+        pos = 6 + name_length
 
         probe_list = []
         for _ in xrange(num_probes):
             probe_id, storage_type, name_length, unit_length = \
-                    struct.unpack("!BBBB", data[pos:pos + 4])
+                    struct.unpack("!HBBB", data[pos:pos + 5])
             enabled = bool(storage_type & (1 << 7))
             displayed = bool(storage_type & (1 << 6))
             storage_type = storage_type & ~(3 << 6)
-            pos += 4
+            pos += 5
 
             name = data[pos:pos + name_length]
             if len(name) != name_length:
@@ -495,8 +495,8 @@ class EnvironmentPlaneController(object):
         total_length = len(data)
 
         while pos < total_length:
-            probe_id = struct.unpack("!B", data[pos])[0]
-            pos += 1
+            probe_id = struct.unpack("!H", data[pos:pos + 2])[0]
+            pos += 2
 
             try:
                 probe = program.get_probe(probe_id)
@@ -558,7 +558,7 @@ class EnvironmentPlaneController(object):
 
         state = 2 if probe.displayed else (1 if probe.enabled else 0)
 
-        message = struct.pack("!LBBBBB", MAGIC_NUMBER, MSG_MGR_SET_PROBE_STATUS,
+        message = struct.pack("!LBBBHB", MAGIC_NUMBER, MSG_MGR_SET_PROBE_STATUS,
                               host_id, program_id, probe_id, state)
 
         self._sock.sendto(message, self._collector_addr[0])
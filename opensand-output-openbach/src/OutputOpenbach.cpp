@@ -169,6 +169,7 @@ void OutputOpenbach::sendProbes(void)
 	for(size_t i = 0 ; i < this->probes.size() ; i++)
 	{
 		BaseProbe *probe = this->probes[i];
+		probe->collect();
 		if(this->getValueCount(probe) == 0)
 		{
 			continue;
@@ -37,7 +37,11 @@
 #include <stdlib.h>
 #include <string.h>
 
-BaseProbe::BaseProbe(uint8_t id, const string &name,
+unsigned int BaseProbe::threads_count = 0;
+
+__thread unsigned int BaseProbe::thread_shard = 0;
+
+BaseProbe::BaseProbe(uint16_t id, const string &name,
                      const string &unit,
                      bool enabled, sample_type_t type):
 	id(id),
@@ -57,3 +61,15 @@ void BaseProbe::reset()
 {
 	this->values_count = 0;	
 }
+
+unsigned int BaseProbe::getThreadShard()
+{
+	if(!BaseProbe::thread_shard)
+	{
+		// give the next shard to each new thread
+		BaseProbe::thread_shard =
+			__atomic_fetch_add(&BaseProbe::threads_count, 1,
+			                   __ATOMIC_RELAXED) % PROBE_SHARDS + 1;
+	}
+	return BaseProbe::thread_shard - 1;
+}
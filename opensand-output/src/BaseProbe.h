@@ -43,6 +43,12 @@ using std::string;
 
 class OutputInternal;
 
+/// The number of shards the probe values are accumulated in
+#define PROBE_SHARDS 16
+
+/// The size of a probe shard, a cache line
+#define PROBE_SHARD_SIZE 64
+
 /**
  * @brief Probe sample type
  **/
@@ -114,19 +120,25 @@ public:
 	 */
 	virtual datatype_t getDataType() const = 0;
 
+	/**
+	 * @brief Merge the values put by all threads since last call
+	 *        in the probe value
+	 **/
+	virtual void collect() = 0;
+
 	/**
 	 * @brief reset values count
 	 *
 	 **/
-	void reset();
+	virtual void reset();
 
 protected:
-	BaseProbe(uint8_t id, const string &name,
+	BaseProbe(uint16_t id, const string &name,
 	          const string &unit,
 	          bool enabled, sample_type_t type);
 
 	/// the probe ID
-	uint8_t id;
+	uint16_t id;
 	/// the probe name
 	string name;
 	/// the probe unit
@@ -137,7 +149,21 @@ protected:
 	sample_type_t s_type;
 
 	/// the number of values in probe
-	uint16_t values_count;
+	uint32_t values_count;
+
+	/**
+	 * @brief Get the shard used by the current thread
+	 *
+	 * @return the shard index
+	 */
+	static unsigned int getThreadShard();
+
+private:
+	/// the number of threads that got a shard
+	static unsigned int threads_count;
+
+	/// the shard used by the current thread, plus one
+	static __thread unsigned int thread_shard;
 };
 
 #endif
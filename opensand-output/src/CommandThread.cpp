@@ -91,7 +91,7 @@ void CommandThread::run()
 			case MSG_CMD_ENABLE_PROBE:
 			case MSG_CMD_DISABLE_PROBE:
 			{
-				uint8_t probe_id = buffer[5];
+				uint16_t probe_id = msgReadProbeId(buffer + 5);
 				bool enabling = (command_id == MSG_CMD_ENABLE_PROBE);
 
 				Output::setProbeState(probe_id, enabling);
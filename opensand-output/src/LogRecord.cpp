@@ -0,0 +1,391 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file LogRecord.cpp
+ * @brief Record of a log format and its arguments, to format the log later
+ */
+
+
+#include "LogRecord.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/// The type of argument of a format conversion
+typedef enum
+{
+	arg_none,      ///< no argument (%%)
+	arg_int,       ///< int or smaller integer
+	arg_long,      ///< long integer (l)
+	arg_llong,     ///< long long integer (ll, q)
+	arg_size,      ///< size_t (z)
+	arg_intmax,    ///< intmax_t (j)
+	arg_ptrdiff,   ///< ptrdiff_t (t)
+	arg_double,    ///< floating point value
+	arg_string,    ///< C string
+	arg_pointer,   ///< pointer
+	arg_invalid,   ///< conversion that cannot be recorded
+} arg_type_t;
+
+
+/**
+ * @brief Parse a format conversion
+ *
+ * @param conversion  The conversion, just after the '%'
+ * @param type        OUT: The type of argument of the conversion
+ * @return the end of the conversion
+ */
+static const char *parseConversion(const char *conversion, arg_type_t &type)
+{
+	const char *pos = conversion;
+	arg_type_t length = arg_int;
+
+	// flags, width and precision given in the format only
+	pos += strspn(pos, "-+ #0'");
+	pos += strspn(pos, "0123456789");
+	if(*pos == '.')
+	{
+		pos++;
+		pos += strspn(pos, "0123456789");
+	}
+
+	switch(*pos)
+	{
+		case 'h':
+			pos += (pos[1] == 'h') ? 2 : 1;
+			break;
+		case 'l':
+			length = (pos[1] == 'l') ? arg_llong : arg_long;
+			pos += (pos[1] == 'l') ? 2 : 1;
+			break;
+		case 'q':
+			length = arg_llong;
+			pos++;
+			break;
+		case 'z':
+			length = arg_size;
+			pos++;
+			break;
+		case 'j':
+			length = arg_intmax;
+			pos++;
+			break;
+		case 't':
+			length = arg_ptrdiff;
+			pos++;
+			break;
+		case 'L':
+			length = arg_invalid;
+			pos++;
+			break;
+	}
+
+	switch(*pos)
+	{
+		case '%':
+			type = (pos == conversion) ? arg_none : arg_invalid;
+			break;
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			type = length;
+			break;
+		case 'c':
+			type = (length == arg_int) ? arg_int : arg_invalid;
+			break;
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			type = (length == arg_int || length == arg_long) ?
+			       arg_double : arg_invalid;
+			break;
+		case 's':
+			type = (length == arg_int) ? arg_string : arg_invalid;
+			break;
+		case 'p':
+			type = arg_pointer;
+			break;
+		default:
+			// %n, %*, %m, wide characters, ...
+			type = arg_invalid;
+			return pos;
+	}
+
+	return pos + 1;
+}
+
+/**
+ * @brief Get the size of the raw value of an argument
+ *
+ * @param type  The argument type
+ * @return the size
+ */
+static size_t getArgSize(arg_type_t type)
+{
+	switch(type)
+	{
+		case arg_none:
+			return 0;
+		case arg_int:
+			return sizeof(int);
+		case arg_double:
+			return sizeof(double);
+		case arg_string:
+			// the string length, the string follows
+			return sizeof(uint16_t);
+		default:
+			return sizeof(uint64_t);
+	}
+}
+
+
+size_t LogRecord::encode(unsigned char *record, size_t size,
+                         const char *format, va_list args)
+{
+	size_t length = sizeof(format);
+	const char *pos = format;
+
+	if(size < length)
+	{
+		return 0;
+	}
+	memcpy(record, &format, sizeof(format));
+
+	while((pos = strchr(pos, '%')) != NULL)
+	{
+		arg_type_t type;
+		uint64_t value = 0;
+		int int_value;
+		double double_value;
+		const char *string_value;
+		uint16_t string_length;
+
+		pos = parseConversion(pos + 1, type);
+		if(type == arg_none)
+		{
+			continue;
+		}
+		if(type == arg_invalid || size - length < getArgSize(type))
+		{
+			return 0;
+		}
+
+		switch(type)
+		{
+			case arg_int:
+				int_value = va_arg(args, int);
+				memcpy(record + length, &int_value, sizeof(int_value));
+				length += sizeof(int_value);
+				continue;
+
+			case arg_double:
+				double_value = va_arg(args, double);
+				memcpy(record + length, &double_value, sizeof(double_value));
+				length += sizeof(double_value);
+				continue;
+
+			case arg_string:
+				string_value = va_arg(args, const char *);
+				if(!string_value)
+				{
+					string_value = "(null)";
+				}
+				// the string is copied after its length
+				string_length = strnlen(string_value, size - length);
+				if(size - length < sizeof(string_length) + string_length)
+				{
+					return 0;
+				}
+				memcpy(record + length, &string_length, sizeof(string_length));
+				length += sizeof(string_length);
+				memcpy(record + length, string_value, string_length);
+				length += string_length;
+				continue;
+
+			case arg_long:
+				value = va_arg(args, long);
+				break;
+			case arg_llong:
+				value = va_arg(args, long long);
+				break;
+			case arg_size:
+				value = va_arg(args, size_t);
+				break;
+			case arg_intmax:
+				value = va_arg(args, intmax_t);
+				break;
+			case arg_ptrdiff:
+				value = va_arg(args, ptrdiff_t);
+				break;
+			case arg_pointer:
+				value = (uintptr_t)va_arg(args, void *);
+				break;
+			default:
+				return 0;
+		}
+		memcpy(record + length, &value, sizeof(value));
+		length += sizeof(value);
+	}
+
+	return length;
+}
+
+bool LogRecord::decode(const unsigned char *record, size_t length,
+                       string &text)
+{
+	const char *format;
+	const char *pos;
+	size_t offset = sizeof(format);
+	char buffer[LOG_RECORD_SIZE];
+
+	if(length < offset)
+	{
+		return false;
+	}
+	memcpy(&format, record, sizeof(format));
+
+	text.clear();
+	pos = format;
+	while(*pos)
+	{
+		const char *start = strchr(pos, '%');
+		const char *end;
+		arg_type_t type;
+		string conversion;
+		uint64_t value;
+		int int_value;
+		double double_value;
+		uint16_t string_length;
+
+		if(!start)
+		{
+			text.append(pos);
+			break;
+		}
+		text.append(pos, start - pos);
+		end = parseConversion(start + 1, type);
+		pos = end;
+		if(type == arg_none)
+		{
+			text.append(1, '%');
+			continue;
+		}
+		if(type == arg_invalid || length - offset < getArgSize(type))
+		{
+			return false;
+		}
+
+		// format each conversion with its own recorded argument
+		conversion.assign(start, end - start);
+		switch(type)
+		{
+			case arg_int:
+				memcpy(&int_value, record + offset, sizeof(int_value));
+				offset += sizeof(int_value);
+				snprintf(buffer, sizeof(buffer), conversion.c_str(), int_value);
+				text.append(buffer);
+				continue;
+
+			case arg_double:
+				memcpy(&double_value, record + offset, sizeof(double_value));
+				offset += sizeof(double_value);
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         double_value);
+				text.append(buffer);
+				continue;
+
+			case arg_string:
+				memcpy(&string_length, record + offset, sizeof(string_length));
+				offset += sizeof(string_length);
+				if(length - offset < string_length)
+				{
+					return false;
+				}
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         string((const char *)record + offset,
+				                string_length).c_str());
+				offset += string_length;
+				text.append(buffer);
+				continue;
+
+			default:
+				break;
+		}
+
+		memcpy(&value, record + offset, sizeof(value));
+		offset += sizeof(value);
+		switch(type)
+		{
+			case arg_long:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (long)value);
+				break;
+			case arg_llong:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (long long)value);
+				break;
+			case arg_size:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (size_t)value);
+				break;
+			case arg_intmax:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (intmax_t)value);
+				break;
+			case arg_ptrdiff:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (ptrdiff_t)value);
+				break;
+			case arg_pointer:
+				snprintf(buffer, sizeof(buffer), conversion.c_str(),
+				         (void *)(uintptr_t)value);
+				break;
+			default:
+				return false;
+		}
+		text.append(buffer);
+	}
+
+	// same limit as the logs formatted immediately
+	if(text.size() >= LOG_RECORD_SIZE)
+	{
+		text.resize(LOG_RECORD_SIZE - 1);
+	}
+	return true;
+}
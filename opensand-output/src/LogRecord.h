@@ -0,0 +1,83 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file LogRecord.h
+ * @brief Record of a log format and its arguments, to format the log later
+ */
+
+#ifndef _LOG_RECORD_H
+#define _LOG_RECORD_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <string>
+
+using std::string;
+
+
+/// The maximum size of a log record, as a formatted log
+#define LOG_RECORD_SIZE 1024
+
+
+/**
+ * @class Log record encoding and decoding
+ *
+ * A record holds the format address, used as format identifier, then
+ * the raw value of each argument as given by the format conversions.
+ * Strings are copied, the format itself is not: it must be a string
+ * literal.
+ */
+class LogRecord
+{
+ public:
+	/**
+	 * @brief Record a log format and its arguments without formatting them
+	 *
+	 * @param record  The buffer to record the log into
+	 * @param size    The buffer size
+	 * @param format  The log format, a string literal
+	 * @param args    The log arguments
+	 * @return the record length, 0 if the log cannot be recorded
+	 */
+	static size_t encode(unsigned char *record, size_t size,
+	                     const char *format, va_list args);
+
+	/**
+	 * @brief Format a recorded log
+	 *
+	 * @param record  The record
+	 * @param length  The record length
+	 * @param text    OUT: The formatted log
+	 * @return true on success, false otherwise
+	 */
+	static bool decode(const unsigned char *record, size_t length,
+	                   string &text);
+};
+
+#endif
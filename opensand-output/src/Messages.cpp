@@ -61,7 +61,7 @@ struct msg_register_t
 	uint32_t magic;      ///< magic number
 	uint8_t cmd_type;    ///< command type
 	uint32_t pid;        ///< process ID
-	uint8_t num_probes;  ///< number of probes
+	uint16_t num_probes; ///< number of probes
 	uint8_t num_logs;    ///< number of logs
 } PACKED;
 
@@ -73,6 +73,18 @@ struct msg_send_probes_t
 	uint32_t timestamp;  ///< the time elapsed since startup
 } PACKED;
 
+/// probe batch header
+struct msg_send_probes_batch_t
+{
+	uint32_t magic;      ///< magic number
+	uint8_t cmd_type;    ///< command type
+	uint8_t version;     ///< the batch format version
+	uint8_t flags;       ///< the batch flags
+	uint8_t stream;      ///< the batch stream
+	uint16_t sequence;   ///< the batch sequence number
+	uint32_t timestamp;  ///< the time elapsed since startup
+} PACKED;
+
 /// log header
 struct msg_send_log_t
 {
@@ -84,40 +96,55 @@ struct msg_send_log_t
 
 
 void msgHeaderRegisterEnd(string &message, pid_t pid,
-                          uint8_t num_probes, uint8_t num_logs)
+                          uint16_t num_probes, uint8_t num_logs)
 {
 	return msgHeaderRegisterAll(message, pid, num_probes, num_logs,
 	                            MSG_CMD_REGISTER_END);
 }
 
 void msgHeaderRegister(string &message, pid_t pid,
-                       uint8_t num_probes, uint8_t num_logs)
+                       uint16_t num_probes, uint8_t num_logs)
 {
 	return msgHeaderRegisterAll(message, pid, num_probes, num_logs,
 	                            MSG_CMD_REGISTER_INIT);
 }
 
 void msgHeaderRegisterLive(string &message, pid_t pid,
-                           uint8_t num_probes, uint8_t num_logs)
+                           uint16_t num_probes, uint8_t num_logs)
 {
 	return msgHeaderRegisterAll(message, pid, num_probes, num_logs,
 	                            MSG_CMD_REGISTER_LIVE);
 }
 
 void msgHeaderRegisterAll(string &message, pid_t pid,
-                          uint8_t num_probes, uint8_t num_logs,
+                          uint16_t num_probes, uint8_t num_logs,
                           uint8_t command)
 {
 	msg_register_t header;
 	header.magic = htonl(MAGIC_NUMBER);
 	header.cmd_type = command;
 	header.pid = htonl(pid);
-	header.num_probes = num_probes;
+	header.num_probes = htons(num_probes);
 	header.num_logs = num_logs;
 
 	message.append((const char *)&header, sizeof(header));
 }
 
+void msgAppendProbeId(string &message, uint16_t probe_id)
+{
+	uint16_t id = htons(probe_id);
+
+	message.append((const char *)&id, sizeof(id));
+}
+
+uint16_t msgReadProbeId(const char *data)
+{
+	uint16_t id;
+
+	memcpy(&id, data, sizeof(id));
+	return ntohs(id);
+}
+
 void msgHeaderSendProbes(string &message, uint32_t timestamp)
 {
 	msg_send_probes_t header;
@@ -128,6 +155,22 @@ void msgHeaderSendProbes(string &message, uint32_t timestamp)
 	message.append((const char *)&header, sizeof(header));
 }
 
+void msgHeaderSendProbesBatch(string &message, uint8_t version,
+                              uint8_t flags, uint8_t stream,
+                              uint16_t sequence, uint32_t timestamp)
+{
+	msg_send_probes_batch_t header;
+	header.magic = htonl(MAGIC_NUMBER);
+	header.cmd_type = MSG_CMD_SEND_PROBES_BATCH;
+	header.version = version;
+	header.flags = flags;
+	header.stream = stream;
+	header.sequence = htons(sequence);
+	header.timestamp = htonl(timestamp);
+
+	message.append((const char *)&header, sizeof(header));
+}
+
 void msgHeaderSendLog(string &message, uint8_t log_id, log_level_t level)
 {
 	msg_send_log_t header;
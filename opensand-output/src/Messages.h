@@ -52,6 +52,7 @@ using std::string;
 #define MSG_CMD_ENABLE 9
 
 #define MSG_CMD_SEND_PROBES 10
+#define MSG_CMD_SEND_PROBES_BATCH 13
 #define MSG_CMD_SEND_LOG 20
 
 #define MSG_CMD_ENABLE_PROBE 11
@@ -74,7 +75,7 @@ using std::string;
  * @param num_probes The number of probes
  * @param num_logs	 The number of logs
  */
-void msgHeaderRegister(string &message, pid_t pid, uint8_t num_probes,
+void msgHeaderRegister(string &message, pid_t pid, uint16_t num_probes,
                        uint8_t num_logs);
 
 /**
@@ -85,7 +86,7 @@ void msgHeaderRegister(string &message, pid_t pid, uint8_t num_probes,
  * @param num_probes The number of probes
  * @param num_logs	 The number of logs
  */
-void msgHeaderRegisterLive(string &message, pid_t pid, uint8_t num_probes,
+void msgHeaderRegisterLive(string &message, pid_t pid, uint16_t num_probes,
                            uint8_t num_logs);
 
 /**
@@ -96,7 +97,7 @@ void msgHeaderRegisterLive(string &message, pid_t pid, uint8_t num_probes,
  * @param num_probes The number of probes
  * @param num_logs	 The number of logs
  */
-void msgHeaderRegisterEnd(string &message, pid_t pid, uint8_t num_probes,
+void msgHeaderRegisterEnd(string &message, pid_t pid, uint16_t num_probes,
                           uint8_t num_logs);
 
 /**
@@ -108,9 +109,25 @@ void msgHeaderRegisterEnd(string &message, pid_t pid, uint8_t num_probes,
  * @param num_logs	 The number of logs
  * @param command    The register command
  */
-void msgHeaderRegisterAll(string &message, pid_t pid, uint8_t num_probes,
+void msgHeaderRegisterAll(string &message, pid_t pid, uint16_t num_probes,
                           uint8_t num_logs, uint8_t command);
 
+/**
+ * @brief add a probe ID to a message
+ *
+ * @param message   The message
+ * @param probe_id  The probe ID
+ */
+void msgAppendProbeId(string &message, uint16_t probe_id);
+
+/**
+ * @brief read a probe ID in a message
+ *
+ * @param data  The probe ID position in message
+ * @return the probe ID
+ */
+uint16_t msgReadProbeId(const char *data);
+
 /**
  * @brief send probes
  *
@@ -119,6 +136,20 @@ void msgHeaderRegisterAll(string &message, pid_t pid, uint8_t num_probes,
  */
 void msgHeaderSendProbes(string &message, uint32_t timestamp);
 
+/**
+ * @brief send a batch of probes
+ *
+ * @param message    The message
+ * @param version    The batch format version
+ * @param flags      The batch flags
+ * @param stream     The batch stream
+ * @param sequence   The batch sequence number
+ * @param timestamp  The time ellapsed since startup (ms)
+ */
+void msgHeaderSendProbesBatch(string &message, uint8_t version,
+                              uint8_t flags, uint8_t stream,
+                              uint16_t sequence, uint32_t timestamp);
+
 /**
  * @brief send log
  *
@@ -204,6 +204,15 @@ void Output::sendProbes(void)
 	instance->sendProbes();
 }
 
+void Output::flush(void)
+{
+	if(!instance)
+	{
+		return;
+	}
+	instance->flush();
+}
+
 void Output::sendEvent(OutputEvent* event,
                        const char* msg_format, ...)
 {
@@ -236,6 +245,30 @@ void Output::sendLog(const OutputLog *log,
 	instance->sendLog(log, log_level, buf);
 }
 
+void Output::deferLog(const OutputLog *log,
+                      log_level_t log_level,
+                      const char *msg_format, ...)
+{
+	char buf[1024];
+	va_list args;
+	bool deferred;
+	assert(log != NULL);
+
+	va_start(args, msg_format);
+	deferred = instance->deferLog(log, log_level, msg_format, args);
+	va_end(args);
+	if(deferred)
+	{
+		return;
+	}
+
+	va_start(args, msg_format);
+	vsnprintf(buf, sizeof(buf), msg_format, args);
+	va_end(args);
+
+	instance->sendLog(log, log_level, buf);
+}
+
 void Output::sendLog(log_level_t log_level,
                      const char *msg_format, ...)
 {
@@ -258,7 +291,7 @@ Output::~Output()
 {
 }
 
-void Output::setProbeState(uint8_t probe_id, bool enabled)
+void Output::setProbeState(uint16_t probe_id, bool enabled)
 {
 	instance->setProbeState(probe_id, enabled);
 }
@@ -303,6 +336,11 @@ void Output::enableStdlog(void)
 	instance->enableStdlog();
 }
 
+void Output::enableDeferredLogs(void)
+{
+	instance->enableDeferredLogs();
+}
+
 void Output::setLevels(const map<string, log_level_t> &levels,
                        const map<string, log_level_t> &specific)
 {
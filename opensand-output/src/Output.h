@@ -68,9 +68,9 @@
 	{ \
 		if(level <= log->getDisplayLevel()) \
 		{ \
-			Output::sendLog(log, level, \
-			                " [%s:%s():%d] " fmt, \
-			                __FILE__, __FUNCTION__, __LINE__, ##args); \
+			Output::deferLog(log, level, \
+			                 " [%s:%s():%d] " fmt, \
+			                 __FILE__, __FUNCTION__, __LINE__, ##args); \
 		} \
 	} \
 	while(0)
@@ -249,6 +249,12 @@ public:
 	 **/
 	static void sendProbes(void);
 
+	/**
+	 * @brief Wait until the queued messages and deferred logs are sent,
+	 *        to be called before unloading the code of the log formats
+	 **/
+	static void flush(void);
+
 	/**
 	 * @brief Send the specified event with the specified message format.
 	 *
@@ -282,11 +288,30 @@ public:
 	                    const char *msg_format, ...)
 		PRINTFLIKE(2, 3);
 
+	/**
+	 * @brief Sent the specified log with the specified message format,
+	 *        the formatting may be done later by the output thread
+	 *
+	 * @param log         The log
+	 * @param log_level   The log level to send
+	 * @param msg_format  The message format, a string literal
+	 **/
+	static void deferLog(const OutputLog *log,
+	                     log_level_t log_level,
+	                     const char *msg_format, ...)
+		PRINTFLIKE(3, 4);
+
 	/**
 	 * @brief Enable output on stdout/stderr
 	 */
 	static void enableStdlog(void);
 
+	/**
+	 * @brief Format the logs in the output thread instead of the
+	 *        logging threads, needs to be called before finishInit
+	 */
+	static void enableDeferredLogs(void);
+
 	/**
 	 * @brief Adjust the output log display level
 	 *
@@ -313,7 +338,7 @@ private:
 	 * @param probe_id  The probe ID
 	 * @param enabled   Whether the probe is enabled or not
 	 */
-	static void setProbeState(uint8_t probe_id, bool enabled);
+	static void setProbeState(uint16_t probe_id, bool enabled);
 
 	/**
 	 * @brief Set the log level
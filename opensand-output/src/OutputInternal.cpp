@@ -67,6 +67,7 @@ OutputInternal::OutputInternal():
 	enable_logs(true),
 	enable_syslog(true),
 	enable_stdlog(false),
+	enable_deferred_logs(false),
 	probes(),
 	logs(),
 	default_log(NULL),
@@ -150,7 +151,7 @@ OutputLog *OutputInternal::registerLog(log_level_t display_level,
 	return log;
 }
 
-uint8_t OutputInternal::getBaseProbeId(BaseProbe *probe) const
+uint16_t OutputInternal::getBaseProbeId(BaseProbe *probe) const
 {
 	return probe->id;	
 }
@@ -170,7 +171,7 @@ uint8_t OutputInternal::getLogId(const OutputLog *log) const
 	return log->id;	
 }
 
-uint16_t OutputInternal::getValueCount(BaseProbe *probe) const
+uint32_t OutputInternal::getValueCount(BaseProbe *probe) const
 {
 	return probe->values_count;	
 }
@@ -222,8 +223,28 @@ void OutputInternal::sendLog(const OutputLog *log,
 }
 
 
-void OutputInternal::setProbeState(uint8_t probe_id, bool enabled)
+bool OutputInternal::deferLog(const OutputLog *, log_level_t,
+                              const char *, va_list)
 {
+	// formatted immediately by default
+	return false;
+}
+
+void OutputInternal::flush(void)
+{
+	// nothing is queued by default
+}
+
+
+void OutputInternal::setProbeState(uint16_t probe_id, bool enabled)
+{
+	if(probe_id >= this->probes.size())
+	{
+		this->sendLog(this->log, LEVEL_ERROR,
+		              "Cannot set the state of unknown probe %u\n",
+		              probe_id);
+		return;
+	}
 	this->sendLog(this->log, LEVEL_INFO,
 	              "%s probe %s\n",
 	              enabled ? "Enabling" : "Disabling",
@@ -285,6 +306,12 @@ void OutputInternal::enableStdlog(void)
 	this->enable_stdlog = true;
 }
 
+void OutputInternal::enableDeferredLogs(void)
+{
+	OutputLock lock(this->mutex); // take lock
+	this->enable_deferred_logs = true;
+}
+
 bool OutputInternal::collectorEnabled(void) const
 {
 	OutputLock lock(this->mutex);
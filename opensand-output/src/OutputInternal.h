@@ -43,9 +43,12 @@
 #include "OutputMutex.h"
 
 #include <assert.h>
+#include <stdarg.h>
 #include <sys/un.h>
 #include <vector>
 #include <map>
+#include <limits>
+#include <cstdlib>
 
 using std::vector;
 using std::map;
@@ -68,7 +71,7 @@ class OutputInternal
 	 * @param probe object
 	 * @return base probe id
 	 */
-    uint8_t getBaseProbeId(BaseProbe *probe) const;
+    uint16_t getBaseProbeId(BaseProbe *probe) const;
 	
 	/**
 	 * @brief Get storage type id
@@ -100,7 +103,7 @@ class OutputInternal
 	 * @param probe object
 	 * @return count values
 	 */
-	uint16_t getValueCount(BaseProbe *probe) const;
+	uint32_t getValueCount(BaseProbe *probe) const;
 	
 	/**
 	 * @brief Get color for logs levels 
@@ -179,6 +182,11 @@ class OutputInternal
 	 **/
 	virtual void sendProbes(void) = 0;
 
+	/**
+	 * @brief Wait until the queued messages and deferred logs are sent
+	 **/
+	virtual void flush(void);
+
 	/**
 	 * @brief Send the specified log with the specified message
 	 *
@@ -208,13 +216,27 @@ class OutputInternal
 	void sendLog(const OutputLog *log, log_level_t log_level,
 	             const char *msg_format, ...);
 
+	/**
+	 * @brief Record a log to format it later, if deferred logs are
+	 *        enabled and supported
+	 *
+	 * @param log		The log
+	 * @param log_level	The log level
+	 * @param msg_format	The message format, a string literal
+	 * @param args		The message arguments
+	 * @return true if the log is recorded, false if it should be
+	 *         formatted now
+	 **/
+	virtual bool deferLog(const OutputLog *log, log_level_t log_level,
+	                      const char *msg_format, va_list args);
+
 	/**
 	 * @brief Set the probe state
 	 *
 	 * @param probe_id  The probe ID
 	 * @param enabled   Whether the probe is enabled or not
 	 */
-	void setProbeState(uint8_t probe_id, bool enabled);
+	void setProbeState(uint16_t probe_id, bool enabled);
 
 	/**
 	 * @brief Set the log level
@@ -259,6 +281,11 @@ class OutputInternal
 	 */
 	void enableStdlog(void);
 
+	/**
+	 * @brief Enable logs formatting in the output thread
+	 */
+	void enableDeferredLogs(void);
+
 	/**
 	 * @brief  Send registration for a probe outside initialization
 	 *
@@ -335,6 +362,10 @@ class OutputInternal
 	/// whether the logs are printed on stdout/stderr
 	bool enable_stdlog;
 
+	/// whether the logs are formatted in the output thread,
+	/// set before starting the threads so it is read without lock
+	bool enable_deferred_logs;
+
 	/// the probes
 	vector<BaseProbe *> probes;
 
@@ -371,7 +402,17 @@ Probe<T> *OutputInternal::registerProbe(const string &name,
                                         bool enabled, sample_type_t type)
 {
 	this->mutex.acquireLock();
-	uint8_t new_id = this->probes.size();
+	// the probe identifier is on two bytes in the messages, a probe
+	// cannot be registered with an identifier used by another one
+	if(this->probes.size() > std::numeric_limits<uint16_t>::max())
+	{
+		this->mutex.releaseLock();
+		this->sendLog(this->log, LEVEL_CRITICAL,
+		              "Cannot register probe %s: too many probes\n",
+		              name.c_str());
+		abort();
+	}
+	uint16_t new_id = this->probes.size();
 	Probe<T> *probe = new Probe<T>(new_id, name, unit, enabled, type);
 	this->probes.push_back(probe);
 	this->mutex.releaseLock();
@@ -38,6 +38,8 @@
 #include "Output.h"
 #include "OutputInternal.h"
 #include "CommandThread.h"
+#include "OutputThread.h"
+#include "ProbeBatch.h"
 
 #include <vector>
 #include <errno.h>
@@ -63,7 +65,10 @@ static uint32_t getMilis()
 
 OutputOpensand::OutputOpensand(const char* sock_pre):
 	sock(-1),
-	sock_prefix(sock_pre)
+	sock_prefix(sock_pre),
+	output_thread(NULL),
+	probe_drops(NULL),
+	probe_batches()
 {
 	memset(&this->daemon_sock_addr, 0, sizeof(this->daemon_sock_addr));
 	memset(&this->self_sock_addr, 0, sizeof(this->self_sock_addr));
@@ -72,6 +77,15 @@ OutputOpensand::OutputOpensand(const char* sock_pre):
 
 OutputOpensand::~OutputOpensand()
 {
+	// send the queued messages before closing the socket
+	delete this->output_thread;
+	this->output_thread = NULL;
+	for(map<pthread_t, ProbeBatch *>::iterator it = this->probe_batches.begin();
+	    it != this->probe_batches.end(); ++it)
+	{
+		delete it->second;
+	}
+	this->probe_batches.clear();
 	if(this->sock != 0)
 	{
 		// Close the command socket
@@ -149,6 +163,14 @@ bool OutputOpensand::init(bool enable_collector)
 	
 	this->default_log = this->registerLog(LEVEL_WARNING, "default");
 
+	if(enable_collector)
+	{
+		// the messages dropped when the output buffers are full
+		this->probe_drops = this->registerProbe<int>("Output.drops",
+		                                             "message number",
+		                                             true, SAMPLE_LAST);
+	}
+
 	this->OutputInternal::sendLog(this->log, LEVEL_INFO,
 	                              "Output initialization done (%s)\n",
 	                              enable_collector ? "enabled" : "disabled");
@@ -177,6 +199,11 @@ bool OutputOpensand::finishInit(void)
 	if(!this->collectorEnabled())
 	{
 		this->setInitializing(false);
+		// the output thread only formats the logs
+		if(this->enable_deferred_logs)
+		{
+			return this->startOutputThread();
+		}
 		return true;
 	}
 
@@ -210,7 +237,7 @@ bool OutputOpensand::finishInit(void)
 		const string name = this->probes[i]->getName();
 		const string unit = this->probes[i]->getUnit();
 
-		message.append(1, this->getBaseProbeId(probes[i]));
+		msgAppendProbeId(message, this->getBaseProbeId(this->probes[i]));
 		message.append(1, (((int)this->probes[i]->isEnabled()) << 7) |
 		                   this->getStorageTypeId(this->probes[i]));
 		message.append(1, name.size());
@@ -277,11 +304,39 @@ bool OutputOpensand::finishInit(void)
 		return false;
 	}
 
+	// Start the thread sending logs and probes, registrations and
+	// commands answers are still sent synchronously
+	if(!this->startOutputThread())
+	{
+		return false;
+	}
+
 	this->sendLog(this->log, LEVEL_INFO, "output initialized\n");
 
 	return true;
 }
 
+bool OutputOpensand::startOutputThread(void)
+{
+	OutputThread *output_thread;
+
+	if(this->output_thread)
+	{
+		return true;
+	}
+
+	output_thread = new OutputThread(this, this->sock, this->daemon_sock_addr);
+	if(!output_thread->start())
+	{
+		this->sendLog(this->log, LEVEL_ERROR, "Cannot start output thread\n");
+		delete output_thread;
+		return false;
+	}
+	this->output_thread = output_thread;
+
+	return true;
+}
+
 bool OutputOpensand::sendRegister(BaseProbe *probe)
 {
 	string message;
@@ -298,7 +353,7 @@ bool OutputOpensand::sendRegister(BaseProbe *probe)
 
 	msgHeaderRegisterLive(message, getpid(), 1, 0);
 	  	    	                        
-	message.append(1, this->getBaseProbeId(probe));
+	msgAppendProbeId(message, this->getBaseProbeId(probe));
 	message.append(1, (((int)probe->isEnabled()) << 7) |
 	                   this->getStorageTypeId(probe));
 	message.append(1, name.size());
@@ -385,28 +440,6 @@ bool OutputOpensand::sendRegister(OutputLog *log)
 	return true;
 }
 
-void OutputOpensand::appendValueAndReset(BaseProbe *probe, string &msg)
-{
-	size_t data_size;
-	unsigned char* data;
-	
-	// get size of probe data
-	data_size = probe->getDataSize();
-	
-	// allocate memory
-	data = new unsigned char[data_size];
-
-	// get probe data
-	probe->getData(data, data_size);
-	
-	// Append data to message
-	msg.append((const char*)data, data_size);
-
-	// release memory
-	delete[] data;
-}
-
-
 void OutputOpensand::sendProbes(void)
 {
 	if(!this->collectorEnabled())
@@ -414,30 +447,48 @@ void OutputOpensand::sendProbes(void)
 		return;
 	}
 
-	bool needs_sending = false;
-
 	uint32_t timestamp = getMilis() - this->started_time;
+	ProbeBatch *batch;
 	string message;
-	msgHeaderSendProbes(message, timestamp);
+
+	if(this->output_thread)
+	{
+		this->probe_drops->put(this->output_thread->getDropped());
+	}
 
 	this->mutex.acquireLock();
+	// the messages of different threads may be reordered,
+	// each thread has its own stream of batches
+	map<pthread_t, ProbeBatch *>::iterator it;
+	it = this->probe_batches.find(pthread_self());
+	if(it == this->probe_batches.end())
+	{
+		batch = new ProbeBatch(this->probe_batches.size());
+		this->probe_batches[pthread_self()] = batch;
+	}
+	else
+	{
+		batch = it->second;
+	}
+
+	batch->start();
 	for(size_t i = 0 ; i < this->probes.size() ; i++)
 	{
 		BaseProbe *probe = this->probes[i];
+		probe->collect();
 		if(this->getValueCount(probe) != 0)
 		{
 			if(probe->isEnabled())
 			{
-				needs_sending = true;
-				message.append(1, (uint8_t)i);
-				this->appendValueAndReset(probe, message);
+				batch->add((uint16_t)i, probe);
 			}
 			probe->reset();
 		}
 	}
+	message = batch->finish(timestamp);
 	this->mutex.releaseLock();
 
-	if(needs_sending && !this->sendMessage(message))
+	if(!message.empty() && !this->queueMessage(message))
 	{
 		this->OutputInternal::sendLog(this->log, LEVEL_ERROR,
 		                              "Sending probe values failed: %s\n",
@@ -451,9 +502,7 @@ void OutputOpensand::sendProbes(void)
 // level, so it would be great, in this case to load a level per
 // block + a default one in the configuration file as it was
 // done before.
-// TODO create a circular buffer running in a thread, to avoid sending
-//      too much logs and also to avoid sending sames logs many times
-//      and also to avoid waiting on output when logging...
+// TODO avoid sending sames logs many times
 void OutputOpensand::sendLog(const OutputLog *log,
                              log_level_t log_level, 
                              const string &message_text)
@@ -479,7 +528,7 @@ void OutputOpensand::sendLog(const OutputLog *log,
 		msgHeaderSendLog(message, this->getLogId(log), log_level);
 		message.append(message_text);
 
-		if(!this->sendMessage(message, false))
+		if(!this->queueMessage(message, false))
 		{
 			// do not call sendLog again, we may loop...
 			syslog(LEVEL_ERROR,
@@ -519,6 +568,27 @@ outputs:
 }
 
 
+void OutputOpensand::flush(void)
+{
+	if(!this->output_thread)
+	{
+		return;
+	}
+	this->output_thread->drain();
+}
+
+bool OutputOpensand::deferLog(const OutputLog *log,
+                              log_level_t log_level,
+                              const char *msg_format, va_list args)
+{
+	if(!this->enable_deferred_logs || !this->output_thread)
+	{
+		return false;
+	}
+	return this->output_thread->sendLog(log, log_level, msg_format, args);
+}
+
+
 bool OutputOpensand::sendMessage(const string &message, bool block) const
 {
 	OutputLock lock(this->mutex);
@@ -546,3 +616,14 @@ bool OutputOpensand::sendMessage(const string &message, bool block) const
 	return true;
 }
 
+bool OutputOpensand::queueMessage(const string &message, bool block) const
+{
+	if(!this->output_thread)
+	{
+		return this->sendMessage(message, block);
+	}
+	// dropped messages are reported by the output thread
+	this->output_thread->send(message);
+	return true;
+}
+
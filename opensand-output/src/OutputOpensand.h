@@ -47,10 +47,14 @@
 #include <stdint.h>
 #include <cstdio>
 #include <arpa/inet.h>
+#include <pthread.h>
 
 using std::vector;
 using std::map;
 
+class OutputThread;
+class ProbeBatch;
+
 
 /**
  * @class hold opensand output library variables and methods
@@ -83,6 +87,12 @@ class OutputOpensand : public OutputInternal
 	 **/
 	void sendProbes(void);
 
+	/**
+	 * @brief Wait until the output thread sent the queued messages
+	 *        and deferred logs
+	 **/
+	void flush(void);
+
 	/**
 	 * @brief Send the specified log with the specified message
 	 *
@@ -93,6 +103,19 @@ class OutputOpensand : public OutputInternal
 	void sendLog(const OutputLog *log, log_level_t log_level,
 	             const string &message_text);
 
+	/**
+	 * @brief Record a log to be formatted by the output thread
+	 *
+	 * @param log		The log
+	 * @param log_level	The log level
+	 * @param msg_format	The message format, a string literal
+	 * @param args		The message arguments
+	 * @return true if the log is recorded, false if it should be
+	 *         formatted now
+	 **/
+	bool deferLog(const OutputLog *log, log_level_t log_level,
+	              const char *msg_format, va_list args);
+
 	/**
 	 * @brief  Send registration for a probe outside initialization
 	 *
@@ -131,6 +154,15 @@ class OutputOpensand : public OutputInternal
 
 	const char* sock_prefix;
 
+	/// the thread sending logs and probes to the daemon
+	OutputThread *output_thread;
+
+	/// the number of messages dropped by the output thread
+	Probe<int> *probe_drops;
+
+	/// the probe batches encoders, one per thread sending probes
+	map<pthread_t, ProbeBatch *> probe_batches;
+
 	/**
 	 * @brief  Send a message to the daemon
 	 *
@@ -141,17 +173,29 @@ class OutputOpensand : public OutputInternal
 	bool sendMessage(const string &message, bool block=true) const;
 
 	/**
-	 * @brief receive a message from the daemon
+	 * @brief  Queue a message for the output thread or send it if the
+	 *         thread is not started yet
 	 *
-	 * @return the command type on success, 0 on failure
+	 * @param message  The message
+	 * @param block    Whether we should block until message can be sent
+	 *                 when the output thread is not started
+	 * @return true on success, queued or dropped message,
+	 *         false otherwise
 	 */
-	uint8_t rcvMessage(void) const;
+	bool queueMessage(const string &message, bool block=true) const;
 
 	/**
-	 * @brief Add a value in probe
+	 * @brief  Start the output thread if it is not started yet
 	 *
-	 * @para str the value
+	 * @return true on success, false otherwise
 	 */
-	void appendValueAndReset(BaseProbe *probe, string& str);
+	bool startOutputThread(void);
+
+	/**
+	 * @brief receive a message from the daemon
+	 *
+	 * @return the command type on success, 0 on failure
+	 */
+	uint8_t rcvMessage(void) const;
 };
 #endif
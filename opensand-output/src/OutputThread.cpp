@@ -0,0 +1,451 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file OutputThread.cpp
+ * @brief Background thread class sending the messages queued by the
+ *        other threads to the daemon.
+ */
+
+
+#include "OutputThread.h"
+#include "OutputInternal.h"
+#include "LogRecord.h"
+
+#include <errno.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+/// The length of a message that continues at the buffer beginning
+#define OUTPUT_RING_WRAP 0xffffffff
+
+/// The flag set in the length of log records
+#define OUTPUT_RING_LOG 0x80000000
+
+/// The room used by a message in a buffer, aligned for the next length
+#define OUTPUT_RING_RECORD(len) ((sizeof(uint32_t) + (len) + 3) & ~3U)
+
+/// The delay between two checks of the buffers while draining them (in us)
+#define OUTPUT_DRAIN_DELAY 1000
+
+
+uint32_t OutputThread::instances = 0;
+
+__thread OutputThread::output_ring_t *OutputThread::ring = NULL;
+
+__thread uint32_t OutputThread::ring_owner = 0;
+
+__thread bool OutputThread::is_output_thread = false;
+
+
+OutputThread::OutputThread(OutputInternal *output, int sock_fd,
+                           sockaddr_un daemon_sock_addr):
+	output(output),
+	sock_fd(sock_fd),
+	daemon_sock_addr(daemon_sock_addr),
+	started(false),
+	stop(false),
+	event_fd(-1),
+	sleeping(0),
+	rings_count(0),
+	dropped(0),
+	logged_dropped(0)
+{
+	this->id = __atomic_add_fetch(&OutputThread::instances, 1,
+	                              __ATOMIC_RELAXED);
+	memset(this->rings, 0, sizeof(this->rings));
+	pthread_mutex_init(&this->rings_mutex, NULL);
+	pthread_key_create(&this->ring_key, OutputThread::releaseRing);
+}
+
+OutputThread::~OutputThread()
+{
+	uint64_t event = 1;
+
+	if(this->started)
+	{
+		// send the remaining messages then stop
+		__atomic_store_n(&this->stop, true, __ATOMIC_SEQ_CST);
+		if(write(this->event_fd, &event, sizeof(event)) < 0)
+		{
+			syslog(LOG_ERR, "Unable to wake up output thread: %s\n",
+			       strerror(errno));
+		}
+		pthread_join(this->thread, NULL);
+	}
+	if(this->event_fd >= 0)
+	{
+		close(this->event_fd);
+	}
+	// the threads still running do not release their buffers anymore
+	pthread_key_delete(this->ring_key);
+	for(uint32_t i = 0; i < this->rings_count; i++)
+	{
+		delete[] this->rings[i]->buffer;
+		delete this->rings[i];
+	}
+	pthread_mutex_destroy(&this->rings_mutex);
+}
+
+bool OutputThread::start()
+{
+	this->event_fd = eventfd(0, 0);
+	if(this->event_fd < 0)
+	{
+		syslog(LOG_ERR, "Unable to create output thread event: %s\n",
+		       strerror(errno));
+		return false;
+	}
+	if(pthread_create(&this->thread, NULL, OutputThread::_run, this) != 0)
+	{
+		syslog(LOG_ERR, "Unable to start the output thread\n");
+		return false;
+	}
+	this->started = true;
+
+	return true;
+}
+
+bool OutputThread::send(const string &message)
+{
+	int flags = MSG_DONTWAIT;
+
+	if(OutputThread::is_output_thread)
+	{
+		// formatted log records, send them as other messages
+		flags = 0;
+	}
+	else if(this->getRing())
+	{
+		return this->push((const unsigned char *)message.data(),
+		                  message.size(), false);
+	}
+
+	// too many threads, send without blocking
+	if(sendto(this->sock_fd, message.data(), message.size(), flags,
+	          (const sockaddr *)&this->daemon_sock_addr,
+	          sizeof(this->daemon_sock_addr)) < (signed)message.size())
+	{
+		__atomic_add_fetch(&this->dropped, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+	return true;
+}
+
+bool OutputThread::sendLog(const OutputLog *log, log_level_t log_level,
+                           const char *format, va_list args)
+{
+	unsigned char record[sizeof(log) + 1 + LOG_RECORD_SIZE];
+	size_t length;
+
+	if(!this->getRing())
+	{
+		return false;
+	}
+
+	memcpy(record, &log, sizeof(log));
+	record[sizeof(log)] = log_level;
+	length = LogRecord::encode(record + sizeof(log) + 1, LOG_RECORD_SIZE,
+	                           format, args);
+	if(!length)
+	{
+		return false;
+	}
+	// a dropped log is counted as a dropped message
+	this->push(record, sizeof(log) + 1 + length, true);
+	return true;
+}
+
+void OutputThread::drain()
+{
+	uint64_t event = 1;
+
+	if(!this->started || OutputThread::is_output_thread)
+	{
+		return;
+	}
+	// a record is removed from its buffer once it is sent
+	while(!this->isEmpty())
+	{
+		if(__atomic_exchange_n(&this->sleeping, 0, __ATOMIC_SEQ_CST) &&
+		   write(this->event_fd, &event, sizeof(event)) < 0)
+		{
+			syslog(LOG_ERR, "Unable to wake up output thread: %s\n",
+			       strerror(errno));
+		}
+		usleep(OUTPUT_DRAIN_DELAY);
+	}
+}
+
+uint32_t OutputThread::getDropped() const
+{
+	return __atomic_load_n(&this->dropped, __ATOMIC_RELAXED);
+}
+
+bool OutputThread::push(const unsigned char *data, uint32_t length,
+                        bool is_log)
+{
+	output_ring_t *ring = OutputThread::ring;
+	uint32_t record = OUTPUT_RING_RECORD(length);
+	uint32_t head;
+	uint32_t tail;
+	uint32_t pos;
+	uint32_t contiguous;
+	uint32_t needed;
+
+	tail = ring->tail;
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	pos = tail & (OUTPUT_RING_SIZE - 1);
+	contiguous = OUTPUT_RING_SIZE - pos;
+	needed = record + (contiguous < record ? contiguous : 0);
+	if(record > OUTPUT_RING_SIZE / 2 ||
+	   OUTPUT_RING_SIZE - (tail - head) < needed)
+	{
+		__atomic_add_fetch(&this->dropped, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	if(contiguous < record)
+	{
+		// no room at the end of buffer, continue at the beginning
+		*((uint32_t *)(ring->buffer + pos)) = OUTPUT_RING_WRAP;
+		tail += contiguous;
+		pos = 0;
+	}
+	if(is_log)
+	{
+		length |= OUTPUT_RING_LOG;
+	}
+	*((uint32_t *)(ring->buffer + pos)) = length;
+	memcpy(ring->buffer + pos + sizeof(uint32_t), data,
+	       length & ~OUTPUT_RING_LOG);
+	__atomic_store_n(&ring->tail, tail + record, __ATOMIC_SEQ_CST);
+
+	// wake up the output thread only if it is waiting
+	if(__atomic_load_n(&this->sleeping, __ATOMIC_SEQ_CST) &&
+	   __atomic_exchange_n(&this->sleeping, 0, __ATOMIC_SEQ_CST))
+	{
+		uint64_t event = 1;
+		if(write(this->event_fd, &event, sizeof(event)) < 0)
+		{
+			syslog(LOG_ERR, "Unable to wake up output thread: %s\n",
+			       strerror(errno));
+		}
+	}
+
+	return true;
+}
+
+void *OutputThread::_run(void *arg)
+{
+	OutputThread *self = (OutputThread*) arg;
+	OutputThread::is_output_thread = true;
+	self->run();
+
+	return NULL;
+}
+
+void OutputThread::run()
+{
+	uint64_t event;
+
+	for(;;)
+	{
+		if(this->flush() > 0)
+		{
+			continue;
+		}
+		if(__atomic_load_n(&this->stop, __ATOMIC_SEQ_CST))
+		{
+			return;
+		}
+
+		// check the buffers again once the producers can see we sleep
+		__atomic_store_n(&this->sleeping, 1, __ATOMIC_SEQ_CST);
+		if(this->isEmpty() && !__atomic_load_n(&this->stop, __ATOMIC_SEQ_CST))
+		{
+			if(read(this->event_fd, &event, sizeof(event)) < 0 &&
+			   errno != EINTR)
+			{
+				syslog(LOG_ERR, "Unable to wait output thread event: %s\n",
+				       strerror(errno));
+			}
+		}
+		__atomic_store_n(&this->sleeping, 0, __ATOMIC_SEQ_CST);
+	}
+}
+
+OutputThread::output_ring_t *OutputThread::getRing()
+{
+	if(OutputThread::ring_owner == this->id)
+	{
+		return OutputThread::ring;
+	}
+
+	// the thread may have used another output thread in between
+	OutputThread::ring = (output_ring_t *)pthread_getspecific(this->ring_key);
+	if(OutputThread::ring == NULL)
+	{
+		OutputThread::ring = this->acquireRing();
+		if(OutputThread::ring != NULL)
+		{
+			pthread_setspecific(this->ring_key, OutputThread::ring);
+		}
+	}
+	OutputThread::ring_owner = this->id;
+
+	return OutputThread::ring;
+}
+
+OutputThread::output_ring_t *OutputThread::acquireRing()
+{
+	output_ring_t *ring = NULL;
+
+	pthread_mutex_lock(&this->rings_mutex);
+	// the records left by the previous owner are still sent,
+	// the new owner continues after them
+	for(uint32_t i = 0; i < this->rings_count; i++)
+	{
+		if(!__atomic_load_n(&this->rings[i]->used, __ATOMIC_ACQUIRE))
+		{
+			ring = this->rings[i];
+			ring->used = 1;
+			goto unlock;
+		}
+	}
+	if(this->rings_count < OUTPUT_RINGS_MAX)
+	{
+		ring = new output_ring_t;
+		ring->buffer = new unsigned char[OUTPUT_RING_SIZE];
+		ring->head = 0;
+		ring->tail = 0;
+		ring->used = 1;
+		this->rings[this->rings_count] = ring;
+		__atomic_store_n(&this->rings_count, this->rings_count + 1,
+		                 __ATOMIC_RELEASE);
+	}
+
+unlock:
+	pthread_mutex_unlock(&this->rings_mutex);
+	return ring;
+}
+
+void OutputThread::releaseRing(void *ring)
+{
+	__atomic_store_n(&((output_ring_t *)ring)->used, 0, __ATOMIC_RELEASE);
+}
+
+unsigned int OutputThread::flush()
+{
+	uint32_t count = __atomic_load_n(&this->rings_count, __ATOMIC_ACQUIRE);
+	unsigned int sent = 0;
+	uint32_t dropped;
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		output_ring_t *ring = this->rings[i];
+		uint32_t head = ring->head;
+		uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+		while(head != tail)
+		{
+			uint32_t pos = head & (OUTPUT_RING_SIZE - 1);
+			uint32_t length = *((uint32_t *)(ring->buffer + pos));
+
+			if(length == OUTPUT_RING_WRAP)
+			{
+				head += OUTPUT_RING_SIZE - pos;
+				continue;
+			}
+			if(length & OUTPUT_RING_LOG)
+			{
+				length &= ~OUTPUT_RING_LOG;
+				this->sendLogRecord(ring->buffer + pos + sizeof(uint32_t),
+				                    length);
+			}
+			else if(sendto(this->sock_fd, ring->buffer + pos + sizeof(uint32_t),
+			               length, 0, (const sockaddr *)&this->daemon_sock_addr,
+			               sizeof(this->daemon_sock_addr)) < (signed)length)
+			{
+				syslog(LOG_ERR, "Sending message failed: %s\n",
+				       strerror(errno));
+			}
+			head += OUTPUT_RING_RECORD(length);
+			__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+			sent++;
+		}
+		__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+	}
+
+	dropped = __atomic_load_n(&this->dropped, __ATOMIC_RELAXED);
+	if(dropped != this->logged_dropped)
+	{
+		syslog(LOG_WARNING,
+		       "%u messages were dropped because the output buffers were "
+		       "full\n", dropped - this->logged_dropped);
+		this->logged_dropped = dropped;
+	}
+
+	return sent;
+}
+
+void OutputThread::sendLogRecord(const unsigned char *record,
+                                 uint32_t length)
+{
+	const OutputLog *log;
+	log_level_t log_level;
+	string text;
+
+	memcpy(&log, record, sizeof(log));
+	log_level = (log_level_t)record[sizeof(log)];
+	if(!LogRecord::decode(record + sizeof(log) + 1,
+	                      length - sizeof(log) - 1, text))
+	{
+		syslog(LOG_ERR, "Unable to format a log record\n");
+		return;
+	}
+	this->output->sendLog(log, log_level, text);
+}
+
+bool OutputThread::isEmpty()
+{
+	uint32_t count = __atomic_load_n(&this->rings_count, __ATOMIC_ACQUIRE);
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(this->rings[i]->head !=
+		   __atomic_load_n(&this->rings[i]->tail, __ATOMIC_SEQ_CST))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,256 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file OutputThread.h
+ * @brief Background thread class sending the messages queued by the
+ *        other threads to the daemon.
+ */
+
+#ifndef _OUTPUT_THREAD_H
+#define _OUTPUT_THREAD_H
+
+#include "OutputLog.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string>
+#include <sys/un.h>
+
+using std::string;
+
+class OutputInternal;
+
+
+/// The size of the messages buffer of each thread (in bytes)
+#define OUTPUT_RING_SIZE (256 * 1024)
+
+/// The maximum number of threads with a messages buffer
+#define OUTPUT_RINGS_MAX 32
+
+
+/**
+ * @class thread that sends the messages queued by the other threads
+ *
+ * Each thread queues its messages in its own buffer without lock nor
+ * system call, the messages that do not fit in the buffer are dropped.
+ * The memory used is limited to OUTPUT_RING_SIZE for at most
+ * OUTPUT_RINGS_MAX threads at a time, the buffer of a thread is given to
+ * another one once it exits. The threads without buffer send their
+ * messages without blocking.
+ * The logs can also be queued as records, formatted by the output thread.
+ */
+class OutputThread
+{
+ public:
+	OutputThread(OutputInternal *output, int sock_fd,
+	             sockaddr_un daemon_sock_addr);
+
+	/**
+	 * @brief Stop the thread once all the queued messages are sent
+	 */
+	~OutputThread();
+
+	/**
+	 * @brief start the output thread
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool start();
+
+	/**
+	 * @brief Queue a message for the daemon, never blocks
+	 *
+	 * @param message  The message
+	 * @return true on success, false if the message is dropped
+	 */
+	bool send(const string &message);
+
+	/**
+	 * @brief Queue a log to be formatted then sent by the output thread,
+	 *        never blocks
+	 *
+	 * @param log        The log
+	 * @param log_level  The log level
+	 * @param format     The log format, a string literal
+	 * @param args       The log arguments
+	 * @return true on success, false if the log cannot be recorded
+	 */
+	bool sendLog(const OutputLog *log, log_level_t log_level,
+	             const char *format, va_list args);
+
+	/**
+	 * @brief Wait until the messages and logs queued before the call
+	 *        are sent, the logs records refer to their format
+	 */
+	void drain();
+
+	/**
+	 * @brief Get the number of messages dropped since the thread creation
+	 *
+	 * @return the number of dropped messages
+	 */
+	uint32_t getDropped() const;
+
+ private:
+
+	/// The messages buffer of a thread
+	typedef struct
+	{
+		unsigned char *buffer; ///< The messages, with their length before
+		uint32_t head;         ///< The read position, set by output thread
+		uint32_t tail;         ///< The write position, set by the owner
+		uint32_t used;         ///< Whether a thread owns the buffer
+	} output_ring_t;
+
+	/**
+	 * @brief run the output thread
+	 *
+	 * @param arg  The output thread to run.
+	 */
+	static void *_run(void *arg);
+
+	/**
+	 * @brief run the thread loop
+	 */
+	void run();
+
+	/**
+	 * @brief Queue a record in the current thread buffer
+	 *
+	 * @param data    The record
+	 * @param length  The record length
+	 * @param is_log  Whether the record is a log record or a message
+	 * @return true on success, false if the record is dropped
+	 */
+	bool push(const unsigned char *data, uint32_t length, bool is_log);
+
+	/**
+	 * @brief Format a log record and send the log
+	 *
+	 * @param record  The log record
+	 * @param length  The record length
+	 */
+	void sendLogRecord(const unsigned char *record, uint32_t length);
+
+	/**
+	 * @brief Get the messages buffer of the current thread
+	 *
+	 * @return the buffer, NULL if there is no more buffer available
+	 */
+	output_ring_t *getRing();
+
+	/**
+	 * @brief Give a buffer to the current thread, a buffer released by
+	 *        an exited thread or a new one
+	 *
+	 * @return the buffer, NULL if there is no more buffer available
+	 */
+	output_ring_t *acquireRing();
+
+	/**
+	 * @brief Release the buffer of an exiting thread
+	 *
+	 * @param ring  The buffer
+	 */
+	static void releaseRing(void *ring);
+
+	/**
+	 * @brief Send the messages queued in all buffers
+	 *
+	 * @return the number of messages sent
+	 */
+	unsigned int flush();
+
+	/**
+	 * @brief Check whether all the buffers are empty
+	 *
+	 * @return true if they are empty, false otherwise
+	 */
+	bool isEmpty();
+
+	/// The output the logs records are sent to
+	OutputInternal *output;
+
+	/// The socket for output thread
+	int sock_fd;
+
+	/// The daemon socket addr
+	sockaddr_un daemon_sock_addr;
+
+	/// The thread
+	pthread_t thread;
+
+	/// Whether the thread is started
+	bool started;
+
+	/// Whether the thread should stop
+	bool stop;
+
+	/// The event to wake up the thread
+	int event_fd;
+
+	/// Whether the thread waits for an event
+	uint32_t sleeping;
+
+	/// The buffers of the threads
+	output_ring_t *rings[OUTPUT_RINGS_MAX];
+
+	/// The number of buffers
+	uint32_t rings_count;
+
+	/// The lock for buffers creation
+	pthread_mutex_t rings_mutex;
+
+	/// The key of the thread buffers, released when the threads exit
+	pthread_key_t ring_key;
+
+	/// The number of messages dropped
+	uint32_t dropped;
+
+	/// The number of dropped messages already reported in syslog
+	uint32_t logged_dropped;
+
+	/// The output thread identifier, to find the thread buffers
+	uint32_t id;
+
+	/// The number of output threads created
+	static uint32_t instances;
+
+	/// The current thread buffer
+	static __thread output_ring_t *ring;
+
+	/// The identifier of the output thread owning the current thread buffer
+	static __thread uint32_t ring_owner;
+
+	/// Whether the current thread is an output thread
+	static __thread bool is_output_thread;
+};
+
+#endif
@@ -36,10 +36,11 @@
 #define _PROBE_H
 
 #include "BaseProbe.h"
-#include "OutputMutex.h"
 
 #include <algorithm>
+#include <limits>
 #include <string.h>
+#include <stdlib.h>
 #include <iostream>
 #include <cassert>
 #include <sstream>
@@ -50,6 +51,9 @@ using std::string;
 
 /**
  * @class the probe respresentation
+ *
+ * The values are accumulated without lock in one of PROBE_SHARDS
+ * shards chosen per thread, they are merged when collected.
  */
 template<typename T>
 class Probe : public BaseProbe
@@ -74,66 +78,203 @@ public:
 
 	datatype_t getDataType() const;
 
+	void collect();
+
+	/**
+	 * @brief reset values count and the probe value
+	 **/
+	void reset();
+
 private:
-	Probe(uint8_t id, const string &name,
+	Probe(uint16_t id, const string &name,
 	      const string &unit,
 	      bool enabled, sample_type_t type);
 
-	/// the concatenation of all values
+	/// The values put by the threads using a shard
+	typedef struct
+	{
+		T accumulator;   ///< the concatenation of the shard values
+		uint32_t count;  ///< the number of values in shard
+	} probe_shard_t;
+
+	/**
+	 * @brief Get the accumulator value when there is no value
+	 *
+	 * @return the neutral value for the probe sample type
+	 */
+	T getNeutral() const;
+
+	/**
+	 * @brief Add a value to an accumulator shared between threads
+	 *
+	 * @param accumulator  The accumulator
+	 * @param value        The value to add
+	 */
+	static void add(T &accumulator, T value);
+
+	/**
+	 * @brief Get a shard
+	 *
+	 * @param index  The shard index
+	 * @return the shard
+	 */
+	inline probe_shard_t *getShard(unsigned int index) const
+	{
+		return (probe_shard_t *)((unsigned char *)this->shards +
+		                         index * PROBE_SHARD_SIZE);
+	};
+
+	/// the concatenation of all collected values
 	T accumulator;
 
-	/// mutex on probe (is it necessary ?)
-	OutputMutex mutex;
+	/// the last value put, for SAMPLE_LAST probes
+	T last;
+
+	/// the shards, one cache line each
+	probe_shard_t *shards;
 };
 
 template<typename T>
-Probe<T>::Probe(uint8_t id, const string &name,
+Probe<T>::Probe(uint16_t id, const string &name,
                 const string &unit,
                 bool enabled, sample_type_t type):
 	BaseProbe(id, name, unit, enabled, type),
-	mutex("probe")
+	accumulator(),
+	last(),
+	shards(NULL)
 {
+	void *shards;
+
+	assert(sizeof(probe_shard_t) <= PROBE_SHARD_SIZE);
+	if(posix_memalign(&shards, PROBE_SHARD_SIZE,
+	                  PROBE_SHARDS * PROBE_SHARD_SIZE) != 0)
+	{
+		throw std::bad_alloc();
+	}
+	memset(shards, 0, PROBE_SHARDS * PROBE_SHARD_SIZE);
+	this->shards = (probe_shard_t *)shards;
+	for(unsigned int i = 0; i < PROBE_SHARDS; i++)
+	{
+		this->getShard(i)->accumulator = this->getNeutral();
+	}
+	this->accumulator = this->getNeutral();
 }
 
 template<typename T>
 Probe<T>::~Probe()
 {
+	free(this->shards);
 }
 
 template<typename T>
 void Probe<T>::put(T value)
 {
-	OutputLock lock(this->mutex);
+	probe_shard_t *shard = this->getShard(BaseProbe::getThreadShard());
+	T current;
 
-	if(this->values_count == 0)
+	switch (this->s_type)
 	{
-		this->accumulator = value;
-	
+		case SAMPLE_LAST:
+			__atomic_store(&this->last, &value, __ATOMIC_RELAXED);
+		break;
+
+		case SAMPLE_MIN:
+			__atomic_load(&shard->accumulator, &current, __ATOMIC_RELAXED);
+			while(value < current &&
+			      !__atomic_compare_exchange(&shard->accumulator, &current,
+			                                 &value, true, __ATOMIC_RELAXED,
+			                                 __ATOMIC_RELAXED));
+		break;
+
+		case SAMPLE_MAX:
+			__atomic_load(&shard->accumulator, &current, __ATOMIC_RELAXED);
+			while(current < value &&
+			      !__atomic_compare_exchange(&shard->accumulator, &current,
+			                                 &value, true, __ATOMIC_RELAXED,
+			                                 __ATOMIC_RELAXED));
+		break;
+
+		case SAMPLE_AVG:
+		case SAMPLE_SUM:
+			Probe<T>::add(shard->accumulator, value);
+		break;
 	}
-	else
+
+	__atomic_add_fetch(&shard->count, 1, __ATOMIC_RELEASE);
+}
+
+template<typename T>
+void Probe<T>::collect()
+{
+	T neutral = this->getNeutral();
+	T value = neutral;
+	uint32_t count = 0;
+
+	for(unsigned int i = 0; i < PROBE_SHARDS; i++)
 	{
+		probe_shard_t *shard = this->getShard(i);
+		T shard_value;
+
+		// the count is taken before the accumulator, so a value being
+		// put may be merged now and counted in the next collect, but
+		// a counted value is always merged
+		count += __atomic_exchange_n(&shard->count, 0, __ATOMIC_ACQUIRE);
+		__atomic_exchange(&shard->accumulator, &neutral, &shard_value,
+		                  __ATOMIC_ACQ_REL);
 		switch (this->s_type)
 		{
 			case SAMPLE_LAST:
-				this->accumulator = value;
 			break;
-			
+
 			case SAMPLE_MIN:
-				this->accumulator = std::min(this->accumulator, value);
+				value = std::min(value, shard_value);
 			break;
-			
+
 			case SAMPLE_MAX:
-				this->accumulator = std::max(this->accumulator, value);
+				value = std::max(value, shard_value);
 			break;
-			
+
 			case SAMPLE_AVG:
 			case SAMPLE_SUM:
-				this->accumulator += value;
+				value += shard_value;
 			break;
 		}
 	}
-	
-	this->values_count++;
+
+	if(this->s_type == SAMPLE_LAST)
+	{
+		__atomic_load(&this->last, &value, __ATOMIC_RELAXED);
+	}
+
+	// the values merged without being counted yet are kept until the
+	// probe is reset, once sent
+	switch (this->s_type)
+	{
+		case SAMPLE_LAST:
+			this->accumulator = value;
+		break;
+
+		case SAMPLE_MIN:
+			this->accumulator = std::min(this->accumulator, value);
+		break;
+
+		case SAMPLE_MAX:
+			this->accumulator = std::max(this->accumulator, value);
+		break;
+
+		case SAMPLE_AVG:
+		case SAMPLE_SUM:
+			this->accumulator += value;
+		break;
+	}
+	this->values_count += count;
+}
+
+template<typename T>
+void Probe<T>::reset()
+{
+	BaseProbe::reset();
+	this->accumulator = this->getNeutral();
 }
 
 template<typename T>
@@ -156,6 +297,45 @@ size_t Probe<T>::getDataSize() const
 	return sizeof(this->accumulator);
 }
 
+template<typename T>
+T Probe<T>::getNeutral() const
+{
+	switch (this->s_type)
+	{
+		case SAMPLE_MIN:
+			return std::numeric_limits<T>::max();
+
+		case SAMPLE_MAX:
+			return std::numeric_limits<T>::is_integer ?
+			       std::numeric_limits<T>::min() :
+			       -std::numeric_limits<T>::max();
+
+		default:
+			return T();
+	}
+}
+
+template<typename T>
+void Probe<T>::add(T &accumulator, T value)
+{
+	T current;
+	T sum;
+
+	__atomic_load(&accumulator, &current, __ATOMIC_RELAXED);
+	do
+	{
+		sum = current + value;
+	}
+	while(!__atomic_compare_exchange(&accumulator, &current, &sum, true,
+	                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+template<>
+inline void Probe<int32_t>::add(int32_t &accumulator, int32_t value)
+{
+	__atomic_fetch_add(&accumulator, value, __ATOMIC_RELAXED);
+}
+
 template<>
 datatype_t Probe<int32_t>::getDataType() const;
 
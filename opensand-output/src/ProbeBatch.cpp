@@ -0,0 +1,346 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file ProbeBatch.cpp
+ * @brief Compact encoding of the probe values sent at each probes tick
+ */
+
+
+#include "ProbeBatch.h"
+#include "Messages.h"
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <arpa/inet.h>
+#include <byteswap.h>
+#include <endian.h>
+#include <string.h>
+
+#if ENABLE_LZ4
+#include <lz4.h>
+#endif
+
+
+/// The size of the batch header after the base header
+#define PROBE_BATCH_HEADER_SIZE 9
+
+
+/**
+ * @brief Append a varint (LEB128) to a string
+ *
+ * @param str    The string
+ * @param value  The value
+ */
+static void appendVarint(string &str, uint64_t value)
+{
+	while(value >= 0x80)
+	{
+		str.append(1, (char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	str.append(1, (char)value);
+}
+
+/**
+ * @brief Read a varint (LEB128)
+ *
+ * @param data    The data
+ * @param length  The data length
+ * @param pos     IN/OUT: The varint position
+ * @param value   OUT: The value
+ * @return true on success, false if the data is truncated
+ */
+static bool readVarint(const unsigned char *data, size_t length,
+                       size_t &pos, uint64_t &value)
+{
+	unsigned int shift = 0;
+
+	value = 0;
+	while(pos < length && shift < 64)
+	{
+		uint8_t byte = data[pos++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if(!(byte & 0x80))
+		{
+			return true;
+		}
+		shift += 7;
+	}
+	return false;
+}
+
+
+ProbeBatch::ProbeBatch(uint8_t stream):
+	message(),
+	entries(),
+	last_id(0),
+	stream_id(stream),
+	streams()
+{
+}
+
+void ProbeBatch::start(void)
+{
+	probe_batch_stream_t &stream = this->streams[this->stream_id];
+
+	this->entries.clear();
+	this->last_id = 0;
+	if(stream.sequence % PROBE_BATCH_KEY_PERIOD == 0)
+	{
+		stream.previous.assign(stream.previous.size(), 0);
+	}
+}
+
+void ProbeBatch::add(uint16_t probe_id, const BaseProbe *probe)
+{
+	uint64_t &previous = getPrevious(this->streams[this->stream_id],
+	                                 probe_id);
+	unsigned char data[sizeof(uint64_t)];
+	uint32_t bits32;
+	uint64_t bits;
+	int32_t delta;
+
+	// the value in network order, as in the former message
+	probe->getData(data, probe->getDataSize());
+	appendVarint(this->entries, probe_id - this->last_id);
+	this->last_id = probe_id;
+
+	switch(probe->getDataType())
+	{
+		case INT32_TYPE:
+			memcpy(&bits32, data, sizeof(bits32));
+			bits = ntohl(bits32);
+			delta = (int32_t)((uint32_t)bits - (uint32_t)previous);
+			appendVarint(this->entries,
+			             ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+			break;
+
+		case FLOAT_TYPE:
+			memcpy(&bits32, data, sizeof(bits32));
+			bits = ntohl(bits32);
+			appendVarint(this->entries, bswap_32((uint32_t)(bits ^ previous)));
+			break;
+
+		case DOUBLE_TYPE:
+			memcpy(&bits, data, sizeof(bits));
+			bits = be64toh(bits);
+			appendVarint(this->entries, bswap_64(bits ^ previous));
+			break;
+
+		default:
+			return;
+	}
+	previous = bits;
+}
+
+const string &ProbeBatch::finish(uint32_t timestamp)
+{
+	probe_batch_stream_t &stream = this->streams[this->stream_id];
+	uint8_t flags = 0;
+
+	this->message.clear();
+	if(this->entries.empty())
+	{
+		return this->message;
+	}
+
+	if(stream.sequence % PROBE_BATCH_KEY_PERIOD == 0)
+	{
+		flags |= PROBE_BATCH_KEY;
+	}
+#if ENABLE_LZ4
+	if(this->entries.size() >= PROBE_BATCH_LZ4_MIN &&
+	   this->entries.size() <= 0xffff)
+	{
+		char compressed[LZ4_COMPRESSBOUND(0xffff)];
+		int length;
+
+		length = LZ4_compress_default(this->entries.data(), compressed,
+		                              this->entries.size(),
+		                              sizeof(compressed));
+		if(length > 0 &&
+		   (size_t)length + sizeof(uint16_t) < this->entries.size())
+		{
+			uint16_t size = htons(this->entries.size());
+
+			msgHeaderSendProbesBatch(this->message, PROBE_BATCH_VERSION,
+			                         flags | PROBE_BATCH_LZ4, this->stream_id,
+			                         stream.sequence, timestamp);
+			this->message.append((const char *)&size, sizeof(size));
+			this->message.append(compressed, length);
+			stream.sequence++;
+			return this->message;
+		}
+	}
+#endif
+	msgHeaderSendProbesBatch(this->message, PROBE_BATCH_VERSION, flags,
+	                         this->stream_id, stream.sequence, timestamp);
+	this->message.append(this->entries);
+	stream.sequence++;
+
+	return this->message;
+}
+
+bool ProbeBatch::decode(const unsigned char *message, size_t length,
+                        const vector<datatype_t> &types,
+                        uint32_t &timestamp,
+                        vector<pair<uint16_t, double> > &values)
+{
+	const unsigned char *data = message + PROBE_BATCH_HEADER_SIZE;
+	size_t data_length = length - PROBE_BATCH_HEADER_SIZE;
+	uint16_t sequence;
+	uint32_t timestamp_n;
+	uint8_t flags;
+	size_t pos = 0;
+	uint64_t id = 0;
+#if ENABLE_LZ4
+	unsigned char decompressed[0xffff];
+#endif
+
+	values.clear();
+	if(length < PROBE_BATCH_HEADER_SIZE || message[0] != PROBE_BATCH_VERSION)
+	{
+		return false;
+	}
+	flags = message[1];
+	memcpy(&sequence, message + 3, sizeof(sequence));
+	sequence = ntohs(sequence);
+	memcpy(&timestamp_n, message + 5, sizeof(timestamp_n));
+	timestamp = ntohl(timestamp_n);
+
+	// a batch relative to a lost batch cannot be decoded
+	probe_batch_stream_t &stream = this->streams[message[2]];
+	if(flags & PROBE_BATCH_KEY)
+	{
+		stream.previous.assign(stream.previous.size(), 0);
+		stream.synchronized = true;
+	}
+	else if(sequence != stream.sequence)
+	{
+		stream.synchronized = false;
+	}
+	stream.sequence = sequence + 1;
+	if(!stream.synchronized)
+	{
+		return false;
+	}
+
+	if(flags & PROBE_BATCH_LZ4)
+	{
+#if ENABLE_LZ4
+		uint16_t size;
+		int decompressed_length;
+
+		if(data_length < sizeof(size))
+		{
+			return false;
+		}
+		memcpy(&size, data, sizeof(size));
+		size = ntohs(size);
+		decompressed_length =
+			LZ4_decompress_safe((const char *)data + sizeof(size),
+			                    (char *)decompressed,
+			                    data_length - sizeof(size),
+			                    sizeof(decompressed));
+		if(decompressed_length != size)
+		{
+			stream.synchronized = false;
+			return false;
+		}
+		data = decompressed;
+		data_length = size;
+#else
+		stream.synchronized = false;
+		return false;
+#endif
+	}
+
+	while(pos < data_length)
+	{
+		uint64_t gap;
+		uint64_t encoded;
+		uint64_t bits;
+		uint32_t bits32;
+		int32_t integer;
+		float float_value;
+		double double_value;
+
+		if(!readVarint(data, data_length, pos, gap) ||
+		   !readVarint(data, data_length, pos, encoded) ||
+		   id + gap >= types.size())
+		{
+			stream.synchronized = false;
+			return false;
+		}
+		id += gap;
+
+		uint64_t &previous = getPrevious(stream, id);
+		switch(types[id])
+		{
+			case INT32_TYPE:
+				integer = (int32_t)((uint32_t)(encoded >> 1) ^
+				                    -(uint32_t)(encoded & 1));
+				bits = (uint32_t)((uint32_t)previous + (uint32_t)integer);
+				values.push_back(std::make_pair(id, (double)(int32_t)bits));
+				break;
+
+			case FLOAT_TYPE:
+				bits = (bswap_32((uint32_t)encoded) ^ previous) & 0xffffffff;
+				bits32 = bits;
+				memcpy(&float_value, &bits32, sizeof(float_value));
+				values.push_back(std::make_pair(id, (double)float_value));
+				break;
+
+			case DOUBLE_TYPE:
+				bits = bswap_64(encoded) ^ previous;
+				memcpy(&double_value, &bits, sizeof(double_value));
+				values.push_back(std::make_pair(id, double_value));
+				break;
+
+			default:
+				stream.synchronized = false;
+				return false;
+		}
+		previous = bits;
+	}
+
+	return true;
+}
+
+uint64_t &ProbeBatch::getPrevious(probe_batch_stream_t &stream,
+                                  uint16_t probe_id)
+{
+	if(probe_id >= stream.previous.size())
+	{
+		stream.previous.resize(probe_id + 1, 0);
+	}
+	return stream.previous[probe_id];
+}
@@ -0,0 +1,170 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file ProbeBatch.h
+ * @brief Compact encoding of the probe values sent at each probes tick
+ */
+
+#ifndef _PROBE_BATCH_H
+#define _PROBE_BATCH_H
+
+#include "BaseProbe.h"
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+using std::pair;
+
+
+/// The version of the probe batch format
+#define PROBE_BATCH_VERSION 1
+
+/// The number of batches between two key batches
+#define PROBE_BATCH_KEY_PERIOD 16
+
+/// The minimum size of entries compressed with LZ4
+#define PROBE_BATCH_LZ4_MIN 128
+
+/// Flag for batch values that do not depend on the previous batches
+#define PROBE_BATCH_KEY 0x01
+
+/// Flag for batch entries compressed with LZ4
+#define PROBE_BATCH_LZ4 0x02
+
+
+/**
+ * @class Batch of probe values
+ *
+ * A batch holds the header of a MSG_CMD_SEND_PROBES_BATCH message, then
+ * an entry per probe value:
+ *  - the probe ID, as a varint difference with the previous entry ID,
+ *  - the value, as a varint difference with the previous value of the
+ *    probe: zigzag encoded subtraction for integers, byte swapped XOR of
+ *    the bits for floating point values, as the low bits of the mantissa
+ *    are often unchanged.
+ * The probe types are the ones announced in the probes registration.
+ * Each PROBE_BATCH_KEY_PERIOD batches, a key batch compares the values
+ * to zero so that a decoder can synchronize again after a lost batch.
+ *
+ * Each thread sending probes has its own stream of batches, as the
+ * messages of different threads may be reordered.
+ * The same class decodes the batches, keeping the same previous values
+ * for each stream.
+ */
+class ProbeBatch
+{
+ public:
+	/**
+	 * @brief Create a batch encoder or decoder
+	 *
+	 * @param stream  The stream of the encoded batches
+	 */
+	ProbeBatch(uint8_t stream = 0);
+
+	/**
+	 * @brief Start a new batch
+	 */
+	void start(void);
+
+	/**
+	 * @brief Add the value of a probe to the batch, the probes are added
+	 *        by increasing ID
+	 *
+	 * @param probe_id  The probe ID
+	 * @param probe     The probe
+	 */
+	void add(uint16_t probe_id, const BaseProbe *probe);
+
+	/**
+	 * @brief Finish the batch
+	 *
+	 * @param timestamp  The time elapsed since startup (ms)
+	 * @return the batch message, empty if there is no value in batch
+	 */
+	const string &finish(uint32_t timestamp);
+
+	/**
+	 * @brief Decode a batch message
+	 *
+	 * @param message    The message after its magic number and command
+	 * @param length     The message length
+	 * @param types      The data type of the probes, indexed by ID
+	 * @param timestamp  OUT: The time elapsed since startup (ms)
+	 * @param values     OUT: The probe IDs and values
+	 * @return true on success, false if the batch is invalid or
+	 *         depends on a lost batch
+	 */
+	bool decode(const unsigned char *message, size_t length,
+	            const vector<datatype_t> &types,
+	            uint32_t &timestamp,
+	            vector<pair<uint16_t, double> > &values);
+
+ private:
+
+	/// The state of a stream of batches
+	typedef struct
+	{
+		uint16_t sequence;        ///< The sequence number of the next batch
+		bool synchronized;        ///< Whether the decoded batches are
+		                          ///< complete since the last key batch
+		vector<uint64_t> previous; ///< The previous value bits of each probe
+	} probe_batch_stream_t;
+
+	/**
+	 * @brief Get the previous value of a probe
+	 *
+	 * @param stream    The stream
+	 * @param probe_id  The probe ID
+	 * @return the value bits
+	 */
+	static uint64_t &getPrevious(probe_batch_stream_t &stream,
+	                             uint16_t probe_id);
+
+	/// The batch message
+	string message;
+
+	/// The batch entries
+	string entries;
+
+	/// The ID of the last probe in batch
+	uint16_t last_id;
+
+	/// The stream of the encoded batches
+	uint8_t stream_id;
+
+	/// The streams states, only one when encoding
+	map<uint8_t, probe_batch_stream_t> streams;
+};
+
+#endif
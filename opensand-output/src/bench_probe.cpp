@@ -0,0 +1,161 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * @file bench_probe.cpp
+ * @brief Measure the cost of Probe<T>::put with several writer threads
+ *
+ * Each writer thread puts values in the same probes, then the probes are
+ * collected as sendProbes does and checked against the values put.
+ */
+
+
+#include "Output.h"
+
+#include <cstdio>
+#include <pthread.h>
+#include <time.h>
+#include <stdint.h>
+
+/// The number of values put by each writer thread
+#define BENCH_PUTS 1000000
+
+
+/// The probes shared by the writer threads
+static Probe<int32_t> *sum_probe;
+static Probe<int32_t> *max_probe;
+static Probe<float> *float_probe;
+
+
+/**
+ * @brief Get a monotonic time in ns
+ *
+ * @return the time
+ */
+static uint64_t getNanoseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Put values in the probes
+ *
+ * @return NULL
+ */
+static void *putValues(void *)
+{
+	for(int32_t i = 0; i < BENCH_PUTS; i++)
+	{
+		sum_probe->put(1);
+		max_probe->put(i);
+		float_probe->put(0.5);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Collect a probe values as sendProbes does
+ *
+ * @param probe  The probe
+ * @return the value collected
+ */
+template<typename T>
+static T collect(Probe<T> *probe)
+{
+	T value;
+
+	probe->collect();
+	value = probe->get();
+	probe->reset();
+	return value;
+}
+
+/**
+ * @brief Run the writer threads and collect the probes until they are done
+ *
+ * @param threads  The number of writer threads
+ * @return true if the collected values are correct, false otherwise
+ */
+static bool bench(unsigned int threads)
+{
+	pthread_t writers[threads];
+	uint64_t sum = 0;
+	double float_sum = 0;
+	int32_t max = 0;
+	uint64_t start;
+	uint64_t duration;
+	bool ok = true;
+
+	start = getNanoseconds();
+	for(unsigned int i = 0; i < threads; i++)
+	{
+		pthread_create(&writers[i], NULL, putValues, NULL);
+	}
+	for(unsigned int i = 0; i < threads; i++)
+	{
+		pthread_join(writers[i], NULL);
+	}
+	duration = getNanoseconds() - start;
+
+	sum = collect(sum_probe);
+	max = collect(max_probe);
+	float_sum = collect(float_probe);
+	if(sum != (uint64_t)threads * BENCH_PUTS ||
+	   float_sum != threads * BENCH_PUTS * 0.5 ||
+	   max != BENCH_PUTS - 1)
+	{
+		ok = false;
+	}
+
+	// cost of a put for the whole process, as if the threads shared a CPU
+	printf("%2u writer threads: %6.1f ns per put%s\n", threads,
+	       (double)duration / ((uint64_t)threads * BENCH_PUTS * 3),
+	       ok ? "" : " WRONG");
+	return ok;
+}
+
+int main(void)
+{
+	unsigned int threads[] = {1, 4, 16};
+	bool ok = true;
+
+	Output::init(false);
+	sum_probe = Output::registerProbe<int32_t>("sum", true, SAMPLE_SUM);
+	max_probe = Output::registerProbe<int32_t>("max", true, SAMPLE_MAX);
+	float_probe = Output::registerProbe<float>("float", true, SAMPLE_SUM);
+
+	for(unsigned int i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+	{
+		ok &= bench(threads[i]);
+	}
+
+	Output::close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+/*
+ *
+ * OpenSAND is an emulation testbed aiming to represent in a cost effective way a
+ * satellite telecommunication system for research and engineering activities.
+ *
+ *
+ * Copyright © 2019 TAS
+ *
+ *
+ * This file is part of the OpenSAND testbed.
+ *
+ *
+ * OpenSAND is free software : you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY, without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * @file probe_collector.cpp
+ * @brief Stand-in collector measuring the probe batches throughput
+ *
+ * The collector binds the daemon socket in a temporary folder, acknowledges
+ * the registration and decodes the probe batches sent by sendProbes as the
+ * real collector does.
+ */
+
+
+#include "Output.h"
+#include "Messages.h"
+#include "ProbeBatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/// The default number of probes
+#define COLLECTOR_PROBES 200
+
+/// The number of probes ticks
+#define COLLECTOR_TICKS 20000
+
+/// The maximum size of a received message
+#define COLLECTOR_MSG_SIZE 65536
+
+
+/// The stand-in daemon socket
+static int sock;
+
+/// The probes data types, indexed by ID
+static vector<datatype_t> types;
+
+/// Statistics of the stand-in collector
+static uint64_t batches = 0;
+static uint64_t values = 0;
+static uint64_t invalid = 0;
+static uint64_t bytes = 0;
+static uint64_t former_bytes = 0;
+static uint64_t last_batch = 0;
+
+
+/**
+ * @brief Get a monotonic time in ns
+ *
+ * @return the time
+ */
+static uint64_t getNanoseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * @brief Receive the messages until no message is received for 500ms
+ *
+ * @return NULL
+ */
+static void *collect(void *)
+{
+	unsigned char message[COLLECTOR_MSG_SIZE];
+	ProbeBatch batch;
+	timeval timeout = {0, 500000};
+
+	setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	while(true)
+	{
+		vector<pair<uint16_t, double> > batch_values;
+		sockaddr_un from;
+		socklen_t from_len = sizeof(from);
+		uint32_t timestamp;
+		ssize_t len;
+
+		len = recvfrom(sock, message, sizeof(message), 0,
+		               (sockaddr *)&from, &from_len);
+		if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+		   last_batch != 0)
+		{
+			break;
+		}
+		else if(len < 5)
+		{
+			continue;
+		}
+
+		switch(message[4])
+		{
+			case MSG_CMD_REGISTER_INIT:
+			case MSG_CMD_REGISTER_END:
+				// acknowledge with the magic number
+				message[4] = MSG_CMD_ACK;
+				sendto(sock, message, 5, 0, (sockaddr *)&from, from_len);
+				break;
+
+			case MSG_CMD_SEND_PROBES_BATCH:
+				batches++;
+				bytes += len;
+				if(!batch.decode(message + 5, len - 5, types, timestamp,
+				                 batch_values))
+				{
+					invalid++;
+					break;
+				}
+				values += batch_values.size();
+				// header, then probe ID and value for each probe
+				former_bytes += 9;
+				for(size_t i = 0; i < batch_values.size(); i++)
+				{
+					former_bytes += 1 +
+						(types[batch_values[i].first] == DOUBLE_TYPE ? 8 : 4);
+				}
+				last_batch = getNanoseconds();
+				break;
+
+			default:
+				break;
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	vector<BaseProbe *> probes;
+	unsigned int count = COLLECTOR_PROBES;
+	char folder[] = "/tmp/probe_collector.XXXXXX";
+	string path;
+	sockaddr_un address;
+	pthread_t collector;
+	uint64_t start;
+	uint64_t duration;
+
+	if(argc > 1)
+	{
+		count = atoi(argv[1]);
+	}
+	if(count == 0 || count > 256)
+	{
+		fprintf(stderr, "usage: %s [probes count, up to 256]\n", argv[0]);
+		return 1;
+	}
+
+	if(!mkdtemp(folder))
+	{
+		perror("mkdtemp");
+		return 1;
+	}
+	path = string(folder) + "/sand-daemon.socket";
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+	if(sock < 0 || bind(sock, (sockaddr *)&address, sizeof(address)) < 0)
+	{
+		perror("bind");
+		return 1;
+	}
+	pthread_create(&collector, NULL, collect, NULL);
+
+	// a mix of counters, constant values and measures
+	Output::init(true, folder);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		char name[32];
+
+		snprintf(name, sizeof(name), "probe_%u", i);
+		switch(i % 3)
+		{
+			case 0:
+				probes.push_back(Output::registerProbe<int32_t>(name, true,
+				                                                 SAMPLE_LAST));
+				types.push_back(INT32_TYPE);
+				break;
+			case 1:
+				probes.push_back(Output::registerProbe<float>(name, true,
+				                                               SAMPLE_AVG));
+				types.push_back(FLOAT_TYPE);
+				break;
+			default:
+				probes.push_back(Output::registerProbe<double>(name, true,
+				                                                SAMPLE_LAST));
+				types.push_back(DOUBLE_TYPE);
+				break;
+		}
+	}
+	if(!Output::finishInit())
+	{
+		fprintf(stderr, "registration failed\n");
+		return 1;
+	}
+
+	start = getNanoseconds();
+	for(int32_t tick = 0; tick < COLLECTOR_TICKS; tick++)
+	{
+		for(unsigned int i = 0; i < count; i++)
+		{
+			switch(i % 3)
+			{
+				case 0:
+					((Probe<int32_t> *)probes[i])->put(tick * (i % 7));
+					break;
+				case 1:
+					((Probe<float> *)probes[i])->put((tick + i) % 10 / 4.0);
+					break;
+				default:
+					((Probe<double> *)probes[i])->put(i % 2 ? 0 : tick / 3.0);
+					break;
+			}
+		}
+		Output::sendProbes();
+		if(tick % 100 == 0)
+		{
+			// let the collector keep up, as with real ticks
+			usleep(1000);
+		}
+	}
+	duration = getNanoseconds() - start;
+	pthread_join(collector, NULL);
+
+	printf("%u probes, %d ticks: %.1f us per sendProbes\n", count,
+	       COLLECTOR_TICKS, duration / 1000.0 / COLLECTOR_TICKS);
+	printf("%llu batches (%llu invalid), %llu values, %.0f values/s\n",
+	       (unsigned long long)batches, (unsigned long long)invalid,
+	       (unsigned long long)values,
+	       values * 1e9 / (last_batch - start));
+	printf("%.2f bytes per value, %.2f with the former format\n",
+	       (double)bytes / values, (double)former_bytes / values);
+
+	Output::close();
+	unlink(path.c_str());
+	rmdir(folder);
+	return (invalid == 0 && values != 0) ? 0 : 1;
+}
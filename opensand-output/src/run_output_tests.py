@@ -84,16 +84,16 @@ LEVEL_ERROR = 3
 
 class MessageRegister(object):
     def __init__(self, data):
-        self.pid, num_probes, num_logs = struct.unpack("!LBB", data[0:6])
+        self.pid, num_probes, num_logs = struct.unpack("!LHB", data[0:7])
 
         self.probes = []
         self.logs = []
 
-        pos = 6
+        pos = 7
         for _ in xrange(num_probes):
             probe_id, storage_type, name_length, unit_length = \
-                    struct.unpack("!BBBB", data[pos:pos + 4])
-            pos += 4
+                    struct.unpack("!HBBB", data[pos:pos + 5])
+            pos += 5
             enabled = bool(storage_type & (1 << 7))
             storage_type = (storage_type & ~(1 << 7))
             name = data[pos:pos + name_length]
@@ -424,10 +424,10 @@ class EnvironmentPlaneNormalTester(EnvironmentPlaneBaseTester):
         msg = self.get_message()
         assert isinstance(msg, MessageSendProbes)
         assert msg.values == {0: -42}
-        self.socket.sendto(struct.pack("!LBB", MAGIC_NUMBER,
+        self.socket.sendto(struct.pack("!LBH", MAGIC_NUMBER,
                                        MSG_CMD_ENABLE_PROBE, 5),
                            self.program_sock_path)
-        self.socket.sendto(struct.pack("!LBB", MAGIC_NUMBER,
+        self.socket.sendto(struct.pack("!LBH", MAGIC_NUMBER,
                                        MSG_CMD_DISABLE_PROBE, 0),
                            self.program_sock_path)
         time.sleep(.1)
@@ -438,10 +438,10 @@ class EnvironmentPlaneNormalTester(EnvironmentPlaneBaseTester):
         assert isinstance(msg, MessageSendProbes)
         assert msg.values == {5: 42}
 
-        self.socket.sendto(struct.pack("!LBB", MAGIC_NUMBER,
+        self.socket.sendto(struct.pack("!LBH", MAGIC_NUMBER,
                                        MSG_CMD_DISABLE_PROBE, 5),
                            self.program_sock_path)
-        self.socket.sendto(struct.pack("!LBB", MAGIC_NUMBER,
+        self.socket.sendto(struct.pack("!LBH", MAGIC_NUMBER,
                                        MSG_CMD_ENABLE_PROBE, 0),
                            self.program_sock_path)
 
@@ -130,11 +130,15 @@ Gse::Gse():
 
 
 Gse::Context::Context(EncapPlugin &plugin):
-	EncapPlugin::EncapContext(plugin), contexts()
+	EncapPlugin::EncapContext(plugin),
+	gse(static_cast<Gse &>(plugin)),
+	frame(),
+	pdu(),
+	contexts()
 {
 	this->vfrag_pkt = NULL;
 	this->vfrag_gse = NULL;
-	this->buf = NULL;
+	this->vfrag_frame = NULL;
 }
 
 bool Gse::Context::init(void)
@@ -258,11 +262,16 @@ Gse::Context::~Context()
 			    gse_get_status(status));
 		}
 	}
-	if(this->buf != NULL)
+	if(this->vfrag_frame != NULL)
 	{
-		delete[] this->buf;
+		status = gse_free_vfrag_no_alloc(&this->vfrag_frame, 0, 1);
+		if(status != GSE_STATUS_OK)
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "cannot free vfrag in GSE deencapsulation context (%s)\n",
+			    gse_get_status(status));
+		}
 	}
-
 	// release GSE encapsulation and deencapsulation contexts if created
 	if(this->encap != NULL)
 	{
@@ -505,12 +514,11 @@ bool Gse::Context::encapFixedLength(NetPacket *packet, NetBurst *gse_packets,
 bool Gse::Context::encapVariableLength(NetPacket *packet, NetBurst *gse_packets)
 {
 	gse_status_t status;
+	unsigned char *start;
+
 	if(this->vfrag_pkt == NULL)
 	{
 		status = gse_allocate_vfrag(&this->vfrag_pkt, 1);
-		this->buf = new uint8_t[GSE_MAX_PACKET_LENGTH +
-		                        GSE_MAX_HEADER_LENGTH +
-		                        GSE_MAX_TRAILER_LENGTH];
 		if(status != GSE_STATUS_OK)
 		{
 			LOG(this->log, LEVEL_ERROR,
@@ -519,8 +527,12 @@ bool Gse::Context::encapVariableLength(NetPacket *packet, NetBurst *gse_packets)
 		}
 	}
 
-	// Affect buffer to vfrag
-	status = gse_affect_buf_vfrag(this->vfrag_pkt, this->buf,
+	// Affect the packet buffer to vfrag, the GSE library writes the headers
+	// and the CRC in the room around the data instead of copying it.
+	// The packet is consumed by the encapsulation, so the buffer is only
+	// copied if it does not have enough room or if it is still shared
+	start = packet->reserveRoom(GSE_MAX_HEADER_LENGTH, GSE_MAX_TRAILER_LENGTH);
+	status = gse_affect_buf_vfrag(this->vfrag_pkt, start,
 	                              GSE_MAX_HEADER_LENGTH,
 	                              GSE_MAX_TRAILER_LENGTH,
 	                              packet->getTotalLength());
@@ -530,17 +542,10 @@ bool Gse::Context::encapVariableLength(NetPacket *packet, NetBurst *gse_packets)
 		    "cannot affect buf to vfrag\n");
 		return false;
 	}
+	// keep the buffer while the GSE library uses it, the packet may be
+	// released before the last fragment is built
+	this->pdu = packet->getBuffer();
 
-	// Copy data to buffer
-	status = gse_copy_data(this->vfrag_pkt, packet->getData().c_str(),
-	                       packet->getTotalLength());
-	if(status != GSE_STATUS_OK)
-	{
-		LOG(this->log, LEVEL_ERROR,
-		    "Virtual fragment data copy failed (%s), drop packet\n",
-		    gse_get_status(status));
-		return false;
-	}
 	return this->encapPacket(packet, gse_packets);
 }
 
@@ -628,11 +633,7 @@ bool Gse::Context::encapPacket(NetPacket *packet,
 		if(status == GSE_STATUS_OK)
 		{
 			NetPacket *gse;
-			Data gse_packet(gse_get_vfrag_start(this->vfrag_gse),
-			                gse_get_vfrag_length(this->vfrag_gse));
-			gse = this->createPacket(gse_packet,
-			                         gse_get_vfrag_length(this->vfrag_gse),
-			                         qos, src_tal_id, dst_tal_id);
+			gse = this->createGsePacket(qos, src_tal_id, dst_tal_id);
 			// create a GSE packet from fragments computed by the GSE library
 			if(gse == NULL)
 			{
@@ -703,6 +704,21 @@ NetBurst *Gse::Context::deencapsulate(NetBurst *burst)
 		return NULL;
 	}
 
+	// Allocate vfrag_frame if it hasn't been created yet, the received
+	// packets are affected to its virtual buffer
+	if(this->vfrag_frame == NULL)
+	{
+		status = gse_allocate_vfrag(&this->vfrag_frame, 1);
+		if(status != GSE_STATUS_OK)
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "cannot allocate vfrag_frame\n");
+			delete net_packets;
+			delete burst;
+			return NULL;
+		}
+	}
+
 	for(packet = burst->begin(); packet != burst->end(); packet++)
 	{
 		uint8_t dst_tal_id;
@@ -746,14 +762,21 @@ NetBurst *Gse::Context::deencapsulate(NetBurst *burst)
 			continue;
 		}
 
-		// Create a virtual fragment containing the GSE packet
-		// TODO : this function could be optimized (preallocating vfrag_gse), but
-		// gse_deencap_packet call below frees vfrag struct (need to change that
-		// function in order to be no_alloc compatible). 
-		status = gse_create_vfrag_with_data(&vfrag_gse, (*packet)->getTotalLength(),
-		                                    0, 0,
-		                                    (*packet)->getData().c_str(),
-		                                    (*packet)->getTotalLength());
+		// Wrap a virtual fragment around the GSE packet, in the buffer of
+		// the frame it was received in, instead of copying it.
+		// gse_deencap_packet frees the virtual fragment it is given, so it
+		// gets a duplicate: vfrag_frame keeps the virtual buffer from being
+		// released by the GSE library and the frame buffer is referenced
+		// until the next packet. The GSE library does not write in it.
+		this->frame = (*packet)->getBuffer();
+		status = gse_affect_buf_vfrag(this->vfrag_frame,
+		                              (unsigned char *)this->frame.data(),
+		                              0, 0, this->frame.length());
+		if(status == GSE_STATUS_OK)
+		{
+			status = gse_duplicate_vfrag(&vfrag_gse, this->vfrag_frame,
+			                             this->frame.length());
+		}
 		if(status != GSE_STATUS_OK)
 		{
 			LOG(this->log, LEVEL_ERROR,
@@ -770,6 +793,7 @@ NetBurst *Gse::Context::deencapsulate(NetBurst *burst)
 			continue;
 		}
 	}
+	this->frame = PacketBuffer();
 
 	// delete the burst and all packets in it
 	delete burst;
@@ -945,16 +969,28 @@ bool Gse::Context::deencapVariableLength(gse_vfrag_t *vfrag_pdu,
 	uint8_t src_tal_id, dst_tal_id;
 	uint8_t qos;
 	unsigned int pkt_nbr = 0;
-	Data pdu_frag(gse_get_vfrag_start(vfrag_pdu),
-	              gse_get_vfrag_length(vfrag_pdu));
+	unsigned char *start = gse_get_vfrag_start(vfrag_pdu);
+	size_t length = gse_get_vfrag_length(vfrag_pdu);
+	const unsigned char *frame_start = this->frame.data();
 
 	src_tal_id = Gse::getSrcTalIdFromLabel(label);
 	dst_tal_id = Gse::getDstTalIdFromLabel(label);
 	qos = Gse::getQosFromLabel(label);
 
-	packet = this->current_upper->build(pdu_frag,
-	                                    gse_get_vfrag_length(vfrag_pdu),
-	                                    qos, src_tal_id, dst_tal_id);
+	// a complete PDU is still in the frame buffer and the packet can share
+	// it, a PDU built from fragments is in a buffer of the GSE library
+	if(frame_start != NULL && start >= frame_start &&
+	   start + length <= frame_start + this->frame.length())
+	{
+		packet = this->current_upper->build(
+			this->frame.slice(start - frame_start, length),
+			qos, src_tal_id, dst_tal_id);
+	}
+	else
+	{
+		packet = this->current_upper->build(Data(start, length), length,
+		                                    qos, src_tal_id, dst_tal_id);
+	}
 	if(packet == NULL)
 	{
 		LOG(this->log, LEVEL_ERROR, 
@@ -1136,11 +1172,7 @@ NetBurst *Gse::Context::flush(int context_id)
 		if(status == GSE_STATUS_OK)
 		{
 			NetPacket *gse;
-			Data gse_frag(gse_get_vfrag_start(this->vfrag_gse),
-			              gse_get_vfrag_length(this->vfrag_gse));
-			gse = this->createPacket(gse_frag,
-			                         gse_get_vfrag_length(this->vfrag_gse),
-			                         qos, src_tal_id, dst_tal_id);
+			gse = this->createGsePacket(qos, src_tal_id, dst_tal_id);
 			// create a GSE packet from fragments computed by the GSE library
 			if(gse == NULL)
 			{
@@ -1197,11 +1229,86 @@ NetBurst *Gse::Context::flushAll()
 	return NULL;
 }
 
+unsigned int Gse::Context::getFlow(const NetPacket *packet) const
+{
+	return Gse::getFragId(packet);
+}
+
+NetPacket *Gse::Context::createGsePacket(uint8_t qos,
+                                         uint8_t src_tal_id,
+                                         uint8_t dst_tal_id) const
+{
+	const Gse::PacketHandler *handler =
+		static_cast<const Gse::PacketHandler *>(this->gse.getPacketHandler());
+
+	// the GSE packet is read in the buffer where the GSE library wrote
+	// its header, there is no intermediate Data
+	return handler->build(gse_get_vfrag_start(this->vfrag_gse),
+	                      gse_get_vfrag_length(this->vfrag_gse),
+	                      qos, src_tal_id, dst_tal_id);
+}
+
 NetPacket *Gse::PacketHandler::build(const Data &data,
                                      size_t data_length,
+                                     uint8_t qos,
+                                     uint8_t src_tal_id,
+                                     uint8_t dst_tal_id) const
+{
+	// stop at the end of the data, as copying the Data used to
+	return this->build(data.c_str(), MIN(data_length, data.length()),
+	                   qos, src_tal_id, dst_tal_id);
+}
+
+NetPacket *Gse::PacketHandler::build(const unsigned char *data,
+                                     size_t data_length,
+                                     uint8_t UNUSED(_qos),
+                                     uint8_t UNUSED(_src_tal_id),
+                                     uint8_t _dst_tal_id) const
+{
+	uint8_t qos;
+	uint8_t src_tal_id;
+	uint8_t dst_tal_id = _dst_tal_id;
+	uint16_t header_length;
+
+	if(!this->readHeader(data, data_length, qos, src_tal_id, dst_tal_id,
+	                     header_length))
+	{
+		return NULL;
+	}
+
+	return new NetPacket(data, data_length,
+	                     this->getName(), this->getEtherType(),
+	                     qos, src_tal_id, dst_tal_id, header_length);
+}
+
+NetPacket *Gse::PacketHandler::build(const PacketBuffer &buffer,
                                      uint8_t UNUSED(_qos),
                                      uint8_t UNUSED(_src_tal_id),
                                      uint8_t _dst_tal_id) const
+{
+	uint8_t qos;
+	uint8_t src_tal_id;
+	uint8_t dst_tal_id = _dst_tal_id;
+	uint16_t header_length;
+
+	if(buffer.empty() ||
+	   !this->readHeader(buffer.data(), buffer.length(), qos, src_tal_id,
+	                     dst_tal_id, header_length))
+	{
+		return NULL;
+	}
+
+	return new NetPacket(buffer,
+	                     this->getName(), this->getEtherType(),
+	                     qos, src_tal_id, dst_tal_id, header_length);
+}
+
+bool Gse::PacketHandler::readHeader(const unsigned char *data,
+                                    size_t data_length,
+                                    uint8_t &qos,
+                                    uint8_t &src_tal_id,
+                                    uint8_t &dst_tal_id,
+                                    uint16_t &header_length) const
 {
 	gse_status_t status;
 	uint8_t label[6];
@@ -1209,12 +1316,11 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 	uint8_t e;
 	uint8_t label_length = 6;
 
-	uint8_t qos;
-	uint8_t src_tal_id = BROADCAST_TAL_ID;
-	uint8_t dst_tal_id = BROADCAST_TAL_ID;
 	uint8_t frag_id;
-	uint16_t header_length = 0;
-	unsigned char *packet = (unsigned char *)data.c_str();
+	unsigned char *packet = (unsigned char *)data;
+
+	src_tal_id = BROADCAST_TAL_ID;
+	header_length = 0;
 
 	status = gse_get_start_indicator(packet, &s);
 	if(status != GSE_STATUS_OK)
@@ -1222,7 +1328,7 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 		LOG(this->log, LEVEL_ERROR,
 		    "cannot get start indicator (%s)\n",
 		    gse_get_status(status));
-		return NULL;
+		return false;
 	}
 
 	status = gse_get_end_indicator(packet, &e);
@@ -1231,7 +1337,7 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 		LOG(this->log, LEVEL_ERROR,
 		    "cannot get end indicator (%s)\n",
 		    gse_get_status(status));
-		return NULL;
+		return false;
 	}
 
 	// subsequent fragment
@@ -1243,11 +1349,10 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 			LOG(this->log, LEVEL_ERROR,
 			    "cannot get frag ID (%s)\n",
 			    gse_get_status(status));
-			return NULL;
+			return false;
 		}
 		qos = Gse::getQosFromFragId(frag_id);
 		src_tal_id = Gse::getSrcTalIdFromFragId(frag_id);
-		dst_tal_id = _dst_tal_id;
 		LOG(this->log, LEVEL_DEBUG,
 		    "build a subsequent fragment "
 		    "SRC TAL Id = %u, QoS = %u, DST TAL Id=  %u\n",
@@ -1265,7 +1370,7 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 			LOG(this->log, LEVEL_ERROR,
 			    "cannot get label (%s)\n",
 			    gse_get_status(status));
-			return NULL;
+			return false;
 		}
 		qos = Gse::getQosFromLabel(label);
 		src_tal_id = Gse::getSrcTalIdFromLabel(label);
@@ -1295,9 +1400,7 @@ NetPacket *Gse::PacketHandler::build(const Data &data,
 		    qos, src_tal_id, dst_tal_id, header_length);
 	}
 
-	return new NetPacket(data, data_length,
-	                     this->getName(), this->getEtherType(),
-	                     qos, src_tal_id, dst_tal_id, header_length);
+	return true;
 }
 
 size_t Gse::PacketHandler::getLength(const unsigned char *data) const
@@ -1330,6 +1433,18 @@ bool Gse::PacketHandler::getChunk(NetPacket *packet, size_t remaining_length,
 	*data = NULL;
 	*remaining_data = NULL;
 
+	// a packet that fits is encapsulated as is, do not copy it in a
+	// virtual fragment only to be told that it does not need refragmentation
+	// (use case 1)
+	if(packet->getTotalLength() <= MIN(remaining_length, GSE_MAX_PACKET_LENGTH))
+	{
+		LOG(this->log, LEVEL_DEBUG,
+		    "no need to refragment, the whole packet can be "
+		    "encapsulated\n");
+		*data = packet;
+		return true;
+	}
+
 	frag_id = Gse::getFragId(packet);
 
 	LOG(this->log, LEVEL_DEBUG,
@@ -1339,7 +1454,7 @@ bool Gse::PacketHandler::getChunk(NetPacket *packet, size_t remaining_length,
 	status = gse_create_vfrag_with_data(&first_frag,
 	                                    packet->getTotalLength(),
 	                                    GSE_MAX_REFRAG_HEAD_OFFSET, 0,
-	                                    packet->getData().c_str(),
+	                                    packet->getBuffer().data(),
 	                                    packet->getTotalLength());
 	if(status != GSE_STATUS_OK)
 	{
@@ -1380,18 +1495,14 @@ bool Gse::PacketHandler::getChunk(NetPacket *packet, size_t remaining_length,
 	else if(status == GSE_STATUS_OK)
 	{
 		// the packet has been fragmented in order to be encapsulated partially
-		// (use case 2)
-		Data gse_first(gse_get_vfrag_start(first_frag),
-		               gse_get_vfrag_length(first_frag));
-		Data gse_second(gse_get_vfrag_start(second_frag),
-		                gse_get_vfrag_length(second_frag));
-
+		// (use case 2), the fragments are built from the virtual fragments
+		// bytes
 		LOG(this->log, LEVEL_INFO,
 		    "packet has been refragmented, first fragment is "
 		    "%zu bytes long, second fragment is %zu bytes long\n",
 		    gse_get_vfrag_length(first_frag), gse_get_vfrag_length(second_frag));
 		// add the first fragment to the BB frame
-		*data = this->build(gse_first,
+		*data = this->build(gse_get_vfrag_start(first_frag),
 		                    gse_get_vfrag_length(first_frag),
 		                    packet->getQos(),
 		                    packet->getSrcTalId(), packet->getDstTalId());
@@ -1403,7 +1514,7 @@ bool Gse::PacketHandler::getChunk(NetPacket *packet, size_t remaining_length,
 		}
 
 		// create a new NetPacket containing the second fragment
-		*remaining_data = this->build(gse_second,
+		*remaining_data = this->build(gse_get_vfrag_start(second_frag),
 		                              gse_get_vfrag_length(second_frag),
 		                              packet->getQos(),
 		                              packet->getSrcTalId(), packet->getDstTalId());
@@ -1585,7 +1696,7 @@ NetPacket *Gse::PacketHandler::getPacketForHeaderExtensions(const std::vector<Ne
 		unsigned char* packet_data;
 		gse_status_t status;
 
-		packet_data = (unsigned char *)packet->getData().c_str();
+		packet_data = (unsigned char *)packet->getBuffer().data();
 
 		status = gse_get_start_indicator(packet_data,
 		                                  &indicator);
@@ -1661,7 +1772,7 @@ bool Gse::PacketHandler::setHeaderExtensions(const NetPacket* packet,
 	// TODO : this could be optimized using no_alloc
 	status = gse_create_vfrag_with_data(&vfrag, GSE_MAX_PACKET_LENGTH,
 	                                    MAX_CNI_EXT_LEN, 0,
-	                                    (unsigned char *)packet->getData().c_str(),
+	                                    (unsigned char *)packet->getBuffer().data(),
 	                                    packet->getTotalLength());
 
 	if(status != GSE_STATUS_OK)
@@ -1710,9 +1821,7 @@ bool Gse::PacketHandler::setHeaderExtensions(const NetPacket* packet,
 		return false;
 	}
 
-	Data gse_frag(gse_get_vfrag_start(vfrag),
-	              gse_get_vfrag_length(vfrag));
-	(*new_packet) = this->build(gse_frag,
+	(*new_packet) = this->build(gse_get_vfrag_start(vfrag),
 	                            gse_get_vfrag_length(vfrag),
 	                            /* qos and tal_ids are read from label */
 	                            0, 0, packet->getDstTalId());
@@ -1740,7 +1849,7 @@ bool Gse::PacketHandler::getHeaderExtensions(const NetPacket *packet,
 	status = gse_create_vfrag_with_data(&gse_data,
 	                                    packet->getTotalLength(),
 	                                    0, 0,
-	                                    packet->getData().c_str(),
+	                                    packet->getBuffer().data(),
 	                                    packet->getTotalLength());
 	if(status != GSE_STATUS_OK)
 	{
@@ -1750,7 +1859,7 @@ bool Gse::PacketHandler::getHeaderExtensions(const NetPacket *packet,
 	}
 	
 	// Get the in-band extension
-	status = gse_deencap_get_header_ext((unsigned char *)packet->getData().c_str(),
+	status = gse_deencap_get_header_ext((unsigned char *)packet->getBuffer().data(),
 	                                     this->deencap_callback[callback_name],
 	                                     opaque);
 	if(status != GSE_STATUS_OK && status != GSE_STATUS_EXTENSION_UNAVAILABLE)
@@ -1831,7 +1940,7 @@ uint8_t Gse::getQosFromLabel(const uint8_t label[])
 }
 
 // TODO add const here once NetPacket getter will be const
-uint8_t Gse::getFragId(NetPacket *packet)
+uint8_t Gse::getFragId(const NetPacket *packet)
 {
 	uint8_t src_tal_id = packet->getSrcTalId();
 	uint8_t qos = packet->getQos();
@@ -73,6 +73,8 @@ class Gse: public EncapPlugin
 	{
 	  private:
 
+		/// The GSE plugin
+		Gse &gse;
 		/// The GSE encapsulation context
 		gse_encap_t *encap;
 		 /// The GSE deencapsulation context
@@ -83,8 +85,15 @@ class Gse: public EncapPlugin
 		gse_vfrag_t *vfrag_pkt;
 		/// GSE virtual fragment for storing packets after encapsulation
 		gse_vfrag_t *vfrag_gse;
-		/// Buffer used by the vfrags
-		uint8_t *buf;
+		/// GSE virtual fragment wrapping the received GSE packet
+		gse_vfrag_t *vfrag_frame;
+		/// The buffer of the frame the received GSE packet is in, kept while
+		/// the GSE library uses it
+		PacketBuffer frame;
+		/// The buffer of the packet being encapsulated, the variable length
+		/// packets are encapsulated in place and the GSE library uses it
+		/// until the next one
+		PacketBuffer pdu;
 		/// Temporary buffers for encapsulation contexts. Contexts are identified
 		/// by an unique identifier
 		std::map <GseIdentifier *, GseEncapCtx *, ltGseIdentifier> contexts;
@@ -109,6 +118,16 @@ class Gse: public EncapPlugin
 		NetBurst *flush(int context_id);
 		NetBurst *flushAll();
 
+		/**
+		 * @brief Get the flow of a packet, that is its fragment ID: the
+		 *        GSE library fragments the PDUs of a fragment ID one after
+		 *        the other, so they must be encapsulated by the same context
+		 *
+		 * @param packet  The packet
+		 * @return the fragment ID
+		 */
+		unsigned int getFlow(const NetPacket *packet) const;
+
 	  private:
 		bool encapFixedLength(NetPacket *packet, NetBurst *gse_packets,
 		                      long &time);
@@ -121,6 +140,19 @@ class Gse: public EncapPlugin
 		bool deencapVariableLength(gse_vfrag_t *vfrag_pdu, uint16_t dest_spot,
 		                           uint8_t label[6], NetBurst *net_packets);
 
+		/**
+		 * @brief Create a packet from the GSE packet in vfrag_gse,
+		 *        directly from the virtual fragment bytes
+		 *
+		 * @param qos         the QoS of the packet
+		 * @param src_tal_id  the source terminal ID of the packet
+		 * @param dst_tal_id  the destination terminal ID of the packet
+		 * @return the packet, NULL on error
+		 */
+		NetPacket *createGsePacket(uint8_t qos,
+		                           uint8_t src_tal_id,
+		                           uint8_t dst_tal_id) const;
+
 	};
 
 	/**
@@ -134,6 +166,25 @@ class Gse: public EncapPlugin
 		map<string, gse_encap_build_header_ext_cb_t> encap_callback;
 		map<string, gse_deencap_read_header_ext_cb_t> deencap_callback;
 
+		/**
+		 * @brief Read the attributes of a GSE packet in its header
+		 *
+		 * @param data           the GSE packet bytes
+		 * @param data_length    the GSE packet length
+		 * @param qos            OUT: the QoS
+		 * @param src_tal_id     OUT: the source terminal ID
+		 * @param dst_tal_id     IN/OUT: the destination terminal ID, kept
+		 *                       for subsequent fragments that have no label
+		 * @param header_length  OUT: the GSE header length
+		 * @return true on success, false otherwise
+		 */
+		bool readHeader(const unsigned char *data,
+		                size_t data_length,
+		                uint8_t &qos,
+		                uint8_t &src_tal_id,
+		                uint8_t &dst_tal_id,
+		                uint16_t &header_length) const;
+
 	  public:
 
 		PacketHandler(EncapPlugin &plugin);
@@ -143,6 +194,40 @@ class Gse: public EncapPlugin
 		                 uint8_t qos,
 		                 uint8_t src_tal_id,
 		                 uint8_t dst_tal_id) const;
+
+		/**
+		 * @brief Build a GSE packet from raw bytes, such as the content
+		 *        of a virtual fragment, without copying them in a Data first
+		 *
+		 * @param data         the GSE packet bytes
+		 * @param data_length  the GSE packet length
+		 * @param qos          unused, the QoS is read in the GSE header
+		 * @param src_tal_id   unused, the source is read in the GSE header
+		 * @param dst_tal_id   the destination terminal ID of subsequent
+		 *                     fragments, that have no label
+		 * @return the GSE packet, NULL on error
+		 */
+		NetPacket *build(const unsigned char *data,
+		                 size_t data_length,
+		                 uint8_t qos,
+		                 uint8_t src_tal_id,
+		                 uint8_t dst_tal_id) const;
+
+		/**
+		 * @brief Build a GSE packet in a part of a frame buffer, the packet
+		 *        shares the buffer instead of copying it
+		 *
+		 * @param buffer       the GSE packet bytes
+		 * @param qos          unused, the QoS is read in the GSE header
+		 * @param src_tal_id   unused, the source is read in the GSE header
+		 * @param dst_tal_id   the destination terminal ID of subsequent
+		 *                     fragments, that have no label
+		 * @return the GSE packet, NULL on error
+		 */
+		NetPacket *build(const PacketBuffer &buffer,
+		                 uint8_t qos,
+		                 uint8_t src_tal_id,
+		                 uint8_t dst_tal_id) const;
 		size_t getFixedLength() const {return 0;};
 		size_t getMinLength() const {return 3;};
 		size_t getLength(const unsigned char *data) const;
@@ -215,7 +300,7 @@ class Gse: public EncapPlugin
 	 * @param   packet  The packet to create the frag id from..
 	 * @return  the frag id.
 	 */
-	static uint8_t getFragId(NetPacket *packet);
+	static uint8_t getFragId(const NetPacket *packet);
 
 	/**
 	 * @brief   Create a fragment id from a GSE context.
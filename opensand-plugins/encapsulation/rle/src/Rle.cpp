@@ -51,6 +51,7 @@
 #define LABEL_SIZE 3        // bytes
 #define SDU_MAX_SIZE 4096   // bytes
 #define ALPDU_HEADER_SIZE 3 // bytes
+#define PPDU_DROP_SIZE 4096 // bytes, more than a PPDU
 
 void rle_log(const int module_id,
 		const int level,
@@ -294,8 +295,7 @@ NetBurst *Rle::Context::encapsulate(NetBurst *burst,
 		packet = *it;
 
 		// Create a new packet (already encapsulated)
-		encap_packet = new NetPacket(packet->getData(),
-			packet->getTotalLength(),
+		encap_packet = new NetPacket(packet->getBuffer(),
 			this->getName(),
 			this->getEtherType(),
 			packet->getQos(),
@@ -381,33 +381,35 @@ bool Rle::Context::decapNextPacket(NetPacket *packet, NetBurst *burst)
 	uint8_t src_tal_id, dst_tal_id, qos;
 	uint8_t label[LABEL_SIZE];
 	unsigned char label_str[LABEL_SIZE];
-	RleIdentifier *identifier = NULL;
 	map<RleIdentifier *, struct rle_receiver *, ltRleIdentifier>::iterator it;
+	const unsigned char *payload;
+	size_t payload_length;
 
 	struct rle_receiver *receiver;
-	struct rle_sdu *sdus = NULL;
+	struct rle_sdu *sdus;
 	size_t sdus_count = 0;
-	size_t sdus_capacity = 0;
 	size_t sdus_max_count = 0;
 	enum rle_decap_status status;
 
 	LOG(this->log, LEVEL_DEBUG, "New packet to decapsulate using RLE (len=%u bytes)",
 			packet->getTotalLength());
 
-	// Get data which identify the receiver
-	if(packet->getPayloadLength() <= LABEL_SIZE + ALPDU_HEADER_SIZE)
+	// Get data which identify the receiver, the payload is read in place
+	payload = packet->getBuffer().data() + packet->getHeaderLength();
+	payload_length = packet->getPayloadLength();
+	if(payload_length <= LABEL_SIZE + ALPDU_HEADER_SIZE)
 	{
 		LOG(this->log, LEVEL_ERROR,
 			"Not enough payload in %s packet\n",
 			this->getName().c_str());
-		goto error;
+		return false;
 	}
-	if(!Rle::getLabel(packet->getPayload(), label))
+	if(!Rle::getLabel(payload, label))
 	{
 		LOG(this->log, LEVEL_ERROR,
 			"Unable to get label from %s packet\n",
 			this->getName().c_str());
-		goto error;
+		return false;
 	}
 	src_tal_id = label[0];
 	dst_tal_id = label[1];
@@ -418,8 +420,8 @@ bool Rle::Context::decapNextPacket(NetPacket *packet, NetBurst *burst)
 			qos);
 
 	// Get receiver
-	identifier = new RleIdentifier(src_tal_id, dst_tal_id);
-	it = this->receivers.find(identifier);
+	RleIdentifier key(src_tal_id, dst_tal_id);
+	it = this->receivers.find(&key);
 	if(it == this->receivers.end())
 	{
 		LOG(this->log, LEVEL_DEBUG, "Packet requiring a new RLE receiver");
@@ -428,46 +430,35 @@ bool Rle::Context::decapNextPacket(NetPacket *packet, NetBurst *burst)
 		receiver = rle_receiver_new(&this->rle_conf);
 		if(!receiver)
 		{
-			delete identifier;
 			LOG(this->log, LEVEL_ERROR,
 				"cannot create a RLE receiver\n");
-			goto error;
+			return false;
 		}
 
 		// Store receiver
-		this->receivers[identifier] = receiver;
+		this->receivers[new RleIdentifier(src_tal_id, dst_tal_id)] = receiver;
 		LOG(this->log, LEVEL_DEBUG, "RLE receiver created");
 	}
 	else
 	{
 		LOG(this->log, LEVEL_DEBUG, "Packet requiring an existing RLE receiver");
-		// Get existing identifier and context
-		delete identifier;
-		identifier = it->first;
 		receiver = it->second;
 	}
 
 	// Prepare SDUs structures
-	sdus_max_count = packet->getPayloadLength() / LABEL_SIZE;
-	sdus_capacity = SDU_MAX_SIZE;
-	sdus_count = 0;
-	sdus = new struct rle_sdu[sdus_max_count];
-	for(unsigned int i = 0; i < sdus_max_count; ++i)
-	{
-		sdus[i].size = 0;
-		sdus[i].buffer = new unsigned char[sdus_capacity];
-	}
+	sdus_max_count = payload_length / LABEL_SIZE;
+	sdus = this->getSdus(sdus_max_count);
 	LOG(this->log, LEVEL_DEBUG, "Initialize SDUs before RLE decapsulation (max_count=%u, count=%u)",
 			sdus_max_count, sdus_count);
 
 	// Decapsulate RLE FPDU
-	status = rle_decapsulate(receiver, const_cast<unsigned char *>(packet->getPayload().c_str()), packet->getPayloadLength(),
+	status = rle_decapsulate(receiver, const_cast<unsigned char *>(payload), payload_length,
 		sdus, sdus_max_count, &sdus_count, label_str, LABEL_SIZE);
 	if(status != RLE_DECAP_OK)
 	{
 		LOG(this->log, LEVEL_ERROR,
 			"RLE failed to decaspulate SDU\n");
-		goto error;
+		return false;
 	}
 	LOG(this->log, LEVEL_DEBUG, "Decapsulated SDUs (max_count=%u, count=%u)",
 			sdus_max_count, sdus_count);
@@ -485,7 +476,7 @@ bool Rle::Context::decapNextPacket(NetPacket *packet, NetBurst *burst)
 		{
 			LOG(this->log, LEVEL_ERROR,
 				"Empty RLE decapsulated packet\n");
-			goto error;
+			return false;
 		}
 
 		// Create packet from SDU
@@ -495,36 +486,33 @@ bool Rle::Context::decapNextPacket(NetPacket *packet, NetBurst *burst)
 		{
 			LOG(this->log, LEVEL_ERROR,
 				"RLE failed to create decapsulated packet\n");
-			goto error;
+			return false;
 		}
 
 		// Add SDU to decapsulated packets list
 		burst->add(decap_packet);
-		delete[] sdus[i].buffer;
-		sdus[i].buffer = NULL;
-		sdus[i].size = 0;
 	}
-	for(unsigned int i = sdus_count; i < sdus_max_count; ++i)
-	{
-		delete[] sdus[i].buffer;
-	}
-	delete[] sdus;
 
 	return true;
-	
-error:
-	if(sdus)
+}
+
+struct rle_sdu *Rle::Context::getSdus(size_t count)
+{
+	if(this->sdus.size() < count)
 	{
-		for(unsigned int i = 0; i< sdus_count; ++i)
+		// the buffers may move, set all the SDUs again
+		this->sdus.resize(count);
+		this->sdus_buffers.resize(count * SDU_MAX_SIZE);
+		for(size_t i = 0; i < count; ++i)
 		{
-			if(sdus[i].buffer != NULL)
-			{
-				delete[] sdus[i].buffer;
-			}
+			this->sdus[i].buffer = &this->sdus_buffers[i * SDU_MAX_SIZE];
 		}
-		delete[] sdus;
 	}
-	return false;
+	for(size_t i = 0; i < count; ++i)
+	{
+		this->sdus[i].size = 0;
+	}
+	return count > 0 ? &this->sdus[0] : NULL;
 }
 
 Rle::PacketHandler::PacketHandler(EncapPlugin &plugin):
@@ -601,7 +589,6 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 	struct rle_transmitter *transmitter;
 	vector<NetPacket *>::iterator pkt_it;
 	map<RleIdentifier *, rle_trans_ctxt_t, ltRleIdentifier>::iterator it;
-	RleIdentifier *identifier = NULL;
 	uint8_t label[LABEL_SIZE];
 
 	enum rle_frag_status frag_status;
@@ -613,9 +600,6 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 	size_t fpdu_size;
 	size_t fpdu_cur_pos;
 	size_t prev_queue_size, queue_size;
-
-	Data fpdu;
-	unsigned char *fpdu_buffer;
 	
 	// Set default returned values
 	*encap_packet = NULL;
@@ -667,43 +651,12 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 	frag_id = qos;
 
 	// Get transmitter
-	identifier = new RleIdentifier(src_tal_id, dst_tal_id);
-	it = this->transmitters.find(identifier);
+	it = this->getTransmitter(src_tal_id, dst_tal_id);
 	if(it == this->transmitters.end())
 	{
-		LOG(this->log, LEVEL_DEBUG, "Packet requiring a new RLE transmitter");
-
-		// Create transmitter
-		transmitter = rle_transmitter_new(&this->rle_conf);
-		if(!transmitter)
-		{
-			delete identifier;
-			LOG(this->log, LEVEL_ERROR,
-				"cannot create a RLE transmitter\n");
-			return false;
-		}
-
-		// Store transmitter
-		this->transmitters[identifier] = pair<struct rle_transmitter *, vector<NetPacket *> >(transmitter, vector<NetPacket *>());
-		it = this->transmitters.find(identifier);
-		if(it == this->transmitters.end())
-		{
-			delete identifier;
-			rle_transmitter_destroy(&transmitter);
-			LOG(this->log, LEVEL_ERROR,
-				"cannot store the RLE transmitter\n");
-			return false;
-		}
-		LOG(this->log, LEVEL_DEBUG, "RLE transmitter created");
-	}
-	else
-	{
-		LOG(this->log, LEVEL_DEBUG, "Packet requiring an existing RLE transmitter");
-		// Get existing identifier and context
-		delete identifier;
-		identifier = it->first;
-		transmitter = it->second.first;
+		return false;
 	}
+	transmitter = it->second.first;
 
 	// Check packet has already been partially sent
 	vector<NetPacket *> &sent_packets = it->second.second;
@@ -722,21 +675,19 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 				prev_queue_size);
 		}
 
-		// Build RLE SDU
+		// Build RLE SDU, the transmitter copies it in its own buffer
+		// so it can point to the packet data
 		sdu.protocol_type = packet->getType();
 		sdu.size = packet->getTotalLength();
-		sdu.buffer = new unsigned char[sdu.size];
-		memcpy(sdu.buffer, packet->getData().c_str(), sdu.size);
+		sdu.buffer = const_cast<unsigned char *>(packet->getBuffer().data());
 
 		// Encapsulate RLE SDU
 		if(rle_encapsulate(transmitter, &sdu, frag_id) != 0)
 		{
-			delete[] sdu.buffer;
 			LOG(this->log, LEVEL_ERROR,
 				"RLE failed to encaspulate SDU\n");
 			return false;
 		}
-		delete[] sdu.buffer;
 		sdu.size = 0;
 	}
 	else
@@ -747,6 +698,14 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 	
 	// Update label size
 	label_size = new_burst ? LABEL_SIZE : 0;
+	if(remaining_length <= label_size)
+	{
+		LOG(this->log, LEVEL_INFO,
+		    "Not enough remaining length for the RLE label (%zu bytes)",
+		    remaining_length);
+		partial_encap = true;
+		goto encap_end;
+	}
 	remaining_length -= label_size;
 
 	// Fragment RLE SDU to RLE PPDU
@@ -780,6 +739,7 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 		LOG(this->log, LEVEL_ERROR,
 			"RLE failed to fragment ALPDU (code=%d)\n",
 			(int)frag_status);
+		this->dropSdu(it->second, frag_id, packet);
 		return false;
 	}
 	LOG(this->log, LEVEL_DEBUG, "RLE PPDU len=%u bytes",
@@ -794,15 +754,19 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 			prev_queue_size < queue_size ? "+" : "",
 			(int)queue_size - (int)prev_queue_size);
 
-	// Prepare FPDU
+	// Prepare FPDU, its size is known from the PPDU so the buffer is
+	// only grown when a bigger FPDU is packed
 	fpdu_size = ppdu_size + label_size;
 	fpdu_cur_pos = 0;
-	fpdu_buffer = new unsigned char[fpdu_size];
+	if(this->fpdu_buffer.size() < fpdu_size)
+	{
+		this->fpdu_buffer.resize(fpdu_size);
+	}
 
 	// Pack RLE PPD to RLE FPDU
 	LOG(this->log, LEVEL_DEBUG, "RLE packing (FPDU len=%u bytes, FPDU pos=%u)",
 			fpdu_size, fpdu_cur_pos);
-	pack_status = rle_pack(ppdu, ppdu_size, label, label_size, fpdu_buffer, &fpdu_cur_pos, &fpdu_size);
+	pack_status = rle_pack(ppdu, ppdu_size, label, label_size, &this->fpdu_buffer[0], &fpdu_cur_pos, &fpdu_size);
 	if(pack_status == RLE_PACK_ERR_FPDU_TOO_SMALL)
 	{
 		LOG(this->log, LEVEL_INFO,
@@ -813,15 +777,13 @@ bool Rle::PacketHandler::encapNextPacket(NetPacket *packet,
 	}
 	if(pack_status != 0)
 	{
-		delete[] fpdu_buffer;
 		LOG(this->log, LEVEL_ERROR,
 			"RLE failed to pack PPDU (code=%d)\n",
 			(int)pack_status);
+		this->dropSdu(it->second, frag_id, packet);
 		return false;
 	}
-	fpdu.assign(fpdu_buffer, fpdu_cur_pos);
-	delete[] fpdu_buffer;
-	*encap_packet = new NetPacket(fpdu, fpdu_cur_pos,
+	*encap_packet = new NetPacket(&this->fpdu_buffer[0], fpdu_cur_pos,
 		this->getName(), this->getEtherType(),
 		qos, src_tal_id, dst_tal_id, 0);
 
@@ -841,6 +803,87 @@ encap_end:
 	return true;
 }
 
+map<RleIdentifier *, Rle::PacketHandler::rle_trans_ctxt_t, ltRleIdentifier>::iterator
+	Rle::PacketHandler::getTransmitter(uint8_t src_tal_id, uint8_t dst_tal_id)
+{
+	map<RleIdentifier *, rle_trans_ctxt_t, ltRleIdentifier>::iterator it;
+	struct rle_transmitter *transmitter;
+	RleIdentifier *identifier;
+
+	// the identifier is only allocated to store a new transmitter
+	RleIdentifier key(src_tal_id, dst_tal_id);
+	it = this->transmitters.find(&key);
+	if(it != this->transmitters.end())
+	{
+		LOG(this->log, LEVEL_DEBUG, "Packet requiring an existing RLE transmitter");
+		return it;
+	}
+
+	LOG(this->log, LEVEL_DEBUG, "Packet requiring a new RLE transmitter");
+
+	// Create transmitter
+	transmitter = rle_transmitter_new(&this->rle_conf);
+	if(!transmitter)
+	{
+		LOG(this->log, LEVEL_ERROR,
+			"cannot create a RLE transmitter\n");
+		return this->transmitters.end();
+	}
+
+	// Store transmitter
+	identifier = new RleIdentifier(src_tal_id, dst_tal_id);
+	it = this->transmitters.insert(make_pair(identifier,
+		rle_trans_ctxt_t(transmitter, vector<NetPacket *>()))).first;
+	LOG(this->log, LEVEL_DEBUG, "RLE transmitter created");
+	return it;
+}
+
+void Rle::PacketHandler::dropSdu(rle_trans_ctxt_t &context,
+                                 uint8_t frag_id,
+                                 NetPacket *packet)
+{
+	vector<NetPacket *> &sent_packets = context.second;
+	vector<NetPacket *>::iterator pkt_it;
+
+	// the PPDUs left in the queue are fragmented and thrown away,
+	// the receiver drops the incomplete ALPDU
+	while(0 < rle_transmitter_stats_get_queue_size(context.first, frag_id))
+	{
+		struct rle_transmitter *transmitter;
+		unsigned char *ppdu = NULL;
+		size_t ppdu_size = 0;
+
+		if(rle_fragment(context.first, frag_id, PPDU_DROP_SIZE,
+		                &ppdu, &ppdu_size) == RLE_FRAG_OK)
+		{
+			continue;
+		}
+
+		// the queue cannot be emptied, replace the transmitter, the SDUs
+		// of its other fragment IDs are dropped too
+		LOG(this->log, LEVEL_WARNING,
+		    "cannot drop the RLE SDU of fragment ID %u, reset the "
+		    "transmitter\n", frag_id);
+		transmitter = rle_transmitter_new(&this->rle_conf);
+		if(!transmitter)
+		{
+			LOG(this->log, LEVEL_ERROR,
+				"cannot create a RLE transmitter\n");
+			break;
+		}
+		rle_transmitter_destroy(&context.first);
+		context.first = transmitter;
+		sent_packets.clear();
+		return;
+	}
+
+	pkt_it = std::find(sent_packets.begin(), sent_packets.end(), packet);
+	if(pkt_it != sent_packets.end())
+	{
+		sent_packets.erase(pkt_it);
+	}
+}
+
 bool Rle::PacketHandler::getEncapsulatedPackets(NetContainer *packet,
 	bool &partial_decap,
 	vector<NetPacket *> &decap_packets,
@@ -934,9 +977,18 @@ bool Rle::getLabel(NetPacket *packet, uint8_t label[])
 
 bool Rle::getLabel(const Data &data, uint8_t label[])
 {
-	uint8_t src_tal_id = (uint8_t)(data.at(0));
-	uint8_t dst_tal_id = (uint8_t)(data.at(1));
-	uint8_t qos = (uint8_t)(data.at(2));
+	if(data.length() < LABEL_SIZE)
+	{
+		return false;
+	}
+	return Rle::getLabel(data.c_str(), label);
+}
+
+bool Rle::getLabel(const unsigned char *data, uint8_t label[])
+{
+	uint8_t src_tal_id = (uint8_t)(data[0]);
+	uint8_t dst_tal_id = (uint8_t)(data[1]);
+	uint8_t qos = (uint8_t)(data[2]);
 
 	//DFLTLOG(LEVEL_ERROR, "Src_tal_id = %u (& 0x1F = %u)",
 	//	src_tal_id, src_tal_id & 0x1F);
@@ -93,7 +93,21 @@ class Rle: public EncapPlugin
 		/// Receivers identified by an unique identifier
 		std::map <RleIdentifier *, struct rle_receiver *, ltRleIdentifier> receivers;
 
+		/// The SDUs given to the receivers, kept from one packet to another
+		std::vector<struct rle_sdu> sdus;
+		/// The buffers of the SDUs
+		std::vector<unsigned char> sdus_buffers;
+
 		bool decapNextPacket(NetPacket *packet, NetBurst *burst);
+
+		/**
+		 * @brief Get empty SDUs to decapsulate a packet, the SDUs
+		 *        are only allocated when more are needed
+		 *
+		 * @param count  the number of SDUs
+		 * @return the SDUs
+		 */
+		struct rle_sdu *getSdus(size_t count);
 	};
 
 	/**
@@ -111,6 +125,33 @@ class Rle: public EncapPlugin
 		typedef std::pair<struct rle_transmitter *, std::vector<NetPacket *> > rle_trans_ctxt_t;
 		std::map <RleIdentifier *, rle_trans_ctxt_t, ltRleIdentifier> transmitters;
 
+		/// The buffer the FPDUs are packed in, kept from one packet to another
+		std::vector<unsigned char> fpdu_buffer;
+
+		/**
+		 * @brief Get the transmitter of a source and destination,
+		 *        it is created on first use
+		 *
+		 * @param src_tal_id  the source terminal ID
+		 * @param dst_tal_id  the destination terminal ID
+		 * @return the transmitter context, the end of the transmitters
+		 *         on error
+		 */
+		std::map<RleIdentifier *, rle_trans_ctxt_t, ltRleIdentifier>::iterator
+			getTransmitter(uint8_t src_tal_id, uint8_t dst_tal_id);
+
+		/**
+		 * @brief Drop the SDU of a fragment ID queued in a transmitter,
+		 *        so the next SDU with this fragment ID can be encapsulated
+		 *
+		 * @param context  the transmitter context
+		 * @param frag_id  the fragment ID
+		 * @param packet   the packet of the SDU
+		 */
+		void dropSdu(rle_trans_ctxt_t &context,
+		             uint8_t frag_id,
+		             NetPacket *packet);
+
 	  public:
 
 		PacketHandler(EncapPlugin &plugin);
@@ -154,6 +195,7 @@ class Rle: public EncapPlugin
 
 	static bool getLabel(NetPacket *packet, uint8_t label[]);
 	static bool getLabel(const Data &data, uint8_t label[]);
+	static bool getLabel(const unsigned char *data, uint8_t label[]);
 };
 
 CREATE(Rle, Rle::Context, Rle::PacketHandler, "RLE");
@@ -44,6 +44,7 @@
 #include <ctime>
 
 #define MAX_CID "max_cid"
+#define COMPRESSORS "compressors"
 #define ROHC_SECTION "rohc"
 #define CONF_ROHC_FILE "/etc/opensand/plugins/rohc.conf"
 
@@ -105,7 +106,12 @@ Rohc::Rohc():
 
 
 Rohc::Context::Context(LanAdaptationPlugin &plugin):
-	LanAdaptationPlugin::LanAdaptationContext(plugin)
+	LanAdaptationPlugin::LanAdaptationContext(plugin),
+	shards(),
+	threads(),
+	packets(),
+	compressed(),
+	decompressors()
 {
 }
 
@@ -116,7 +122,7 @@ bool Rohc::Context::init()
 		return false;
 	}
 	unsigned int max_cid;
-	int max_alloc = 0;
+	unsigned int compressors;
 	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
 	bool status;
 	ConfigurationFile config;
@@ -147,69 +153,76 @@ bool Rohc::Context::init()
 		max_cid = std::min(max_cid, (unsigned int)ROHC_LARGE_CID_MAX);
 	}
 
-	// create the ROHC compressor
-	this->comp = rohc_comp_new2(cid_type, max_cid, random_cb, NULL);
-	if(this->comp == NULL)
+	// Retrieving the number of compressors
+	if(!config.getValue(config_section_map[ROHC_SECTION], COMPRESSORS,
+	                    compressors))
 	{
 		LOG(this->log, LEVEL_ERROR,
-		    "cannot create ROHC compressor\n");
+		    "missing %s parameter\n", COMPRESSORS);
 		goto unload;
 	}
-
-	status = rohc_comp_set_traces_cb2(this->comp, rohc_traces, this->log);
-	if(!status)
+	if(compressors == 0)
 	{
 		LOG(this->log, LEVEL_ERROR,
-		    "cannot enable traces\n");
-		goto free_comp;
+		    "there should be at least one ROHC compressor\n");
+		goto unload;
 	}
-	status = rohc_comp_enable_profiles(this->comp,
-	                                   ROHC_PROFILE_UNCOMPRESSED,
-	                                   ROHC_PROFILE_UDP,
-	                                   ROHC_PROFILE_IP,
-	                                   ROHC_PROFILE_UDPLITE,
-	                                   ROHC_PROFILE_RTP,
-	                                   ROHC_PROFILE_ESP,
-	                                   ROHC_PROFILE_TCP, -1);
-	if(!status)
+	LOG(this->log, LEVEL_INFO,
+	    "Compressors: %u\n", compressors);
+
+	// create the ROHC compressors
+	for(unsigned int i = 0; i < compressors; ++i)
 	{
-		LOG(this->log, LEVEL_ERROR,
-		    "cannot enable compression profiles\n");
-		goto free_comp;
+		if(!this->addShard(cid_type, max_cid))
+		{
+			goto unload;
+		}
+	}
+	if(!this->threads.start(compressors, this->log))
+	{
+		goto unload;
 	}
 
+	// create the ROHC decompressors, for the unicast and the broadcast
+	// packets of each terminal
 	for(uint8_t tal_id = 0; tal_id <= BROADCAST_TAL_ID; ++tal_id)
 	{
-		this->decompressors[tal_id] = rohc_decomp_new2(cid_type, max_cid,
-		                                              ROHC_O_MODE);
-		if(this->decompressors[tal_id] == NULL)
-		{
-			LOG(this->log, LEVEL_ERROR,
-			    "cannot create ROHC decompressor\n");
-			goto free_decomp;
-		}
-		max_alloc = tal_id;
-		status = rohc_decomp_set_traces_cb2(this->decompressors[tal_id],
-		                                    rohc_traces, this->log);
-		if(!status)
-		{
-			LOG(this->log, LEVEL_ERROR,
-			    "cannot enable traces\n");
-			goto free_decomp;
-		}
-		status = rohc_decomp_enable_profiles(this->decompressors[tal_id],
-		                                     ROHC_PROFILE_UNCOMPRESSED,
-		                                     ROHC_PROFILE_UDP,
-		                                     ROHC_PROFILE_IP,
-		                                     ROHC_PROFILE_UDPLITE,
-		                                     ROHC_PROFILE_RTP,
-		                                     ROHC_PROFILE_ESP,
-		                                     ROHC_PROFILE_TCP, -1);
-		if(!status)
+		uint8_t destinations[] = {0, BROADCAST_TAL_ID};
+
+		for(unsigned int i = 0; i < 2; ++i)
 		{
-			LOG(this->log, LEVEL_ERROR,
-			    "cannot enable decompression profiles\n");
-			goto free_decomp;
+			struct rohc_decomp *decomp;
+
+			decomp = rohc_decomp_new2(cid_type, max_cid, ROHC_O_MODE);
+			if(decomp == NULL)
+			{
+				LOG(this->log, LEVEL_ERROR,
+				    "cannot create ROHC decompressor\n");
+				goto unload;
+			}
+			this->decompressors[getDecompressorId(tal_id,
+			                                      destinations[i])] = decomp;
+			status = rohc_decomp_set_traces_cb2(decomp, rohc_traces, this->log);
+			if(!status)
+			{
+				LOG(this->log, LEVEL_ERROR,
+				    "cannot enable traces\n");
+				goto unload;
+			}
+			status = rohc_decomp_enable_profiles(decomp,
+			                                     ROHC_PROFILE_UNCOMPRESSED,
+			                                     ROHC_PROFILE_UDP,
+			                                     ROHC_PROFILE_IP,
+			                                     ROHC_PROFILE_UDPLITE,
+			                                     ROHC_PROFILE_RTP,
+			                                     ROHC_PROFILE_ESP,
+			                                     ROHC_PROFILE_TCP, -1);
+			if(!status)
+			{
+				LOG(this->log, LEVEL_ERROR,
+				    "cannot enable decompression profiles\n");
+				goto unload;
+			}
 		}
 	}
 
@@ -217,41 +230,98 @@ bool Rohc::Context::init()
 
 	return true;
 
-free_decomp:
-	for(uint8_t i = 0; i <= max_alloc; ++i)
-	{
-		rohc_decomp_free(this->decompressors[i]);
-	}
-free_comp:
-	rohc_comp_free(this->comp);
 unload:
+	// the compressors and decompressors are released with the context
 	config.unloadConfig();
 error:
-	this->comp = NULL;
 	return false;
 }
 
 Rohc::Context::~Context()
 {
-	// free ROHC compressor/decompressor if created
-	if(this->comp != NULL)
-		rohc_comp_free(this->comp);
+	std::map<uint16_t, struct rohc_decomp *>::iterator it;
 
-	for(uint8_t tal_id = 0; tal_id <= BROADCAST_TAL_ID; ++tal_id)
+	// free ROHC compressors, the threads are stopped with the pool
+	for(unsigned int i = 0; i < this->shards.size(); ++i)
 	{
-		if(this->decompressors[tal_id] != NULL)
-		{
-			rohc_decomp_free(this->decompressors[tal_id]);
-		}
+		rohc_comp_free(this->shards[i]->comp);
+		delete this->shards[i];
+	}
+
+	// free ROHC decompressors
+	for(it = this->decompressors.begin(); it != this->decompressors.end(); ++it)
+	{
+		rohc_decomp_free(it->second);
 	}
 }
 
+bool Rohc::Context::addShard(rohc_cid_type_t cid_type, unsigned int max_cid)
+{
+	rohc_shard_t *shard;
+	bool status;
+
+	shard = new rohc_shard_t;
+	shard->context = this;
+	shard->comp = rohc_comp_new2(cid_type, max_cid, random_cb, NULL);
+	if(shard->comp == NULL)
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "cannot create ROHC compressor\n");
+		delete shard;
+		return false;
+	}
+	this->shards.push_back(shard);
+
+	status = rohc_comp_set_traces_cb2(shard->comp, rohc_traces, this->log);
+	if(!status)
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "cannot enable traces\n");
+		return false;
+	}
+	status = rohc_comp_enable_profiles(shard->comp,
+	                                   ROHC_PROFILE_UNCOMPRESSED,
+	                                   ROHC_PROFILE_UDP,
+	                                   ROHC_PROFILE_IP,
+	                                   ROHC_PROFILE_UDPLITE,
+	                                   ROHC_PROFILE_RTP,
+	                                   ROHC_PROFILE_ESP,
+	                                   ROHC_PROFILE_TCP, -1);
+	if(!status)
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "cannot enable compression profiles\n");
+		return false;
+	}
+	return true;
+}
+
+unsigned int Rohc::Context::getShard(const NetPacket *packet) const
+{
+	unsigned int shards_number = this->shards.size();
+
+	if(shards_number == 1)
+	{
+		return 0;
+	}
+	if(packet->getDstTalId() == BROADCAST_TAL_ID)
+	{
+		return 0;
+	}
+	return 1 + packet->getDstTalId() % (shards_number - 1);
+}
+
+uint16_t Rohc::Context::getDecompressorId(uint8_t src_tal_id,
+                                          uint8_t dst_tal_id)
+{
+	return (src_tal_id << 1) | (dst_tal_id == BROADCAST_TAL_ID ? 1 : 0);
+}
+
 NetBurst *Rohc::Context::encapsulate(NetBurst *burst,
                                      std::map<long, int> &UNUSED(time_contexts))
 {
 	NetBurst *rohc_packets = NULL;
-
-	NetBurst::iterator packet;
+	vector<void *> args;
 
 	if(burst == NULL)
 	{
@@ -269,70 +339,66 @@ NetBurst *Rohc::Context::encapsulate(NetBurst *burst,
 		return NULL;
 	}
 
-	for(packet = burst->begin(); packet != burst->end(); packet++)
+	// give each packet to its shard
+	this->packets.assign(burst->begin(), burst->end());
+	this->compressed.assign(this->packets.size(), NULL);
+	for(size_t i = 0; i < this->packets.size(); ++i)
 	{
-		NetPacket *comp_packet;
-		bool is_eth = false;
-		size_t head_length = 0;
-		unsigned char head_buffer[MAX_ETHERNET_SIZE];
-		NetPacket *payload;
-
 		LOG(this->log, LEVEL_INFO,
-		    "received a packet with type 0x%.4x\n", (*packet)->getType());
-		// handle Ethernet packets
-		if(IS_ETHERNET(this->current_upper->getEtherType()))
-		{
-			is_eth = true;
-
-			if(!extractPacketFromEth(*packet, head_length,
-			                         head_buffer, &payload))
-			{
-				continue;
-			}
+		    "received a packet with type 0x%.4x\n",
+		    this->packets[i]->getType());
+		this->shards[this->getShard(this->packets[i])]->positions.push_back(i);
+	}
 
-		}
-		else
+	// compress the shards in parallel
+	for(unsigned int i = 0; i < this->shards.size(); ++i)
+	{
+		if(!this->shards[i]->positions.empty())
 		{
-			payload = *packet;
+			args.push_back(this->shards[i]);
 		}
-		if(!this->compressRohc(payload, &comp_packet))
+	}
+	this->threads.run(Rohc::Context::runShard, args);
+
+	// keep the burst order
+	for(size_t i = 0; i < this->compressed.size(); ++i)
+	{
+		if(this->compressed[i] != NULL)
 		{
-			continue;
+			rohc_packets->add(this->compressed[i]);
 		}
-		if(is_eth)
-		{
-			delete payload;
-			// modify EtherType for ROHC
-			//head_buffer[head_length -1] = (this->getEtherType() >> 8) & 0xff;
-			//head_buffer[head_length] = this->getEtherType() & 0xff;
-
-			// rebuild ethernet frame
-			NetPacket *rohc_packet = comp_packet;
-			if(!buildEthFromPacket(comp_packet, head_length,
-			                       (unsigned char *)head_buffer,
-			                       &comp_packet))
-			{
-				LOG(this->log, LEVEL_ERROR,
-				    "cannot create Ethernet frame");
-				delete rohc_packet;
-				continue;
-			}
-			delete rohc_packet;
-			if(comp_packet == NULL)
-			{
-				LOG(this->log, LEVEL_ERROR,
-				    "cannot create ETHERNET frame");
-				continue;
-			}
-		}
-		rohc_packets->add(comp_packet);
 	}
+	this->packets.clear();
+	this->compressed.clear();
 
 	// delete the burst and all packets in it
 	delete burst;
 	return rohc_packets;
 }
 
+void Rohc::Context::compressShard(rohc_shard_t *shard)
+{
+	vector<size_t>::const_iterator it;
+
+	for(it = shard->positions.begin(); it != shard->positions.end(); ++it)
+	{
+		NetPacket *comp_packet;
+
+		if(this->compressRohc(shard->comp, this->packets[*it], &comp_packet))
+		{
+			this->compressed[*it] = comp_packet;
+		}
+	}
+	shard->positions.clear();
+}
+
+void Rohc::Context::runShard(void *arg)
+{
+	rohc_shard_t *shard = (rohc_shard_t *)arg;
+
+	shard->context->compressShard(shard);
+}
+
 
 NetBurst *Rohc::Context::deencapsulate(NetBurst *burst)
 {
@@ -352,12 +418,6 @@ NetBurst *Rohc::Context::deencapsulate(NetBurst *burst)
 
 	for(packet = burst->begin(); packet != burst->end(); packet++)
 	{
-		bool is_eth = false;
-		size_t head_length = 0;
-		unsigned char head_buffer[MAX_ETHERNET_SIZE];
-		uint8_t tal_id;
-		NetPacket *payload;
-
 		// packet must be valid
 		if(*packet == NULL)
 		{
@@ -365,67 +425,22 @@ NetBurst *Rohc::Context::deencapsulate(NetBurst *burst)
 			    "encapsulation packet is not valid, drop the packet\n");
 			continue;
 		}
-		// handle Ethernet packets
-		if(IS_ETHERNET(this->current_upper->getEtherType()))
-		{
-			is_eth = true;
-
-			if(!extractPacketFromEth(*packet, head_length,
-			                         head_buffer, &payload))
-			{
-				continue;
-			}
-		}
-		else
-		{
-			payload = *packet;
-		}
-		// payload must be a ROHC packet
-		if(payload->getType() != this->getEtherType())
+		// payload must be a ROHC packet, an Ethernet frame carrying
+		// a ROHC packet is decompressed after its header
+		if(!IS_ETHERNET(this->current_upper->getEtherType()) &&
+		   (*packet)->getType() != this->getEtherType())
 		{
 			LOG(this->log, LEVEL_ERROR,
 			    "payload is not a ROHC packet "
 			    "(type = 0x%04x), drop the packet\n",
-			    payload->getType());
-			delete payload;
-			continue;
-		}
-
-		tal_id = payload->getSrcTalId();
-		if(this->decompressors.find(tal_id) == this->decompressors.end())
-		{
-			LOG(this->log, LEVEL_ERROR,
-			    "Could not find decompressor associated with "
-			    "SRC Tal Id %u\n", tal_id);
+			    (*packet)->getType());
 			continue;
 		}
 
-		if(!this->decompressRohc(payload, &dec_packet))
+		if(!this->decompressRohc(*packet, &dec_packet))
 		{
 			continue;
 		}
-		if(is_eth)
-		{
-			delete payload;
-			// rebuild ethernet frame
-			NetPacket *rohc_packet = dec_packet;
-			if(!buildEthFromPacket(dec_packet, head_length,
-			                       (unsigned char *)head_buffer,
-			                       &dec_packet))
-			{
-				LOG(this->log, LEVEL_ERROR,
-				    "cannot create Ethernet frame");
-				delete rohc_packet;
-				continue;
-			}
-			delete rohc_packet;
-			if(dec_packet == NULL)
-			{
-				LOG(this->log, LEVEL_ERROR,
-				    "cannot create Ethernet frame");
-				continue;
-			}
-		}
 		net_packets->add(dec_packet);
 	}
 
@@ -434,12 +449,15 @@ NetBurst *Rohc::Context::deencapsulate(NetBurst *burst)
 	return net_packets;
 }
 
-bool Rohc::Context::compressRohc(NetPacket *packet,
+bool Rohc::Context::compressRohc(struct rohc_comp *comp,
+                                 NetPacket *packet,
                                  NetPacket **comp_packet)
 {
-	RohcPacket *rohc_packet;
-	unsigned char rohc_data[MAX_ROHC_SIZE];
-	Data packet_data = packet->getData();
+	NetPacket *rohc_packet;
+	// the Ethernet header, if any, is kept before the ROHC packet
+	unsigned char rohc_data[MAX_ETHERNET_SIZE + MAX_ROHC_SIZE];
+	const PacketBuffer &packet_data = packet->getBuffer();
+	size_t head_length = 0;
 	struct rohc_buf packet_buffer;
 	struct rohc_buf rohc_buffer;
 	// keep the destination spot
@@ -451,31 +469,43 @@ bool Rohc::Context::compressRohc(NetPacket *packet,
 	    packet->getTotalLength(), packet->getType());
 
 	// the ROHC compressor must be ready
-	if(this->comp == NULL)
+	if(comp == NULL)
 	{
 		LOG(this->log, LEVEL_ERROR,
 		    "ROHC compressor not ready, drop packet\n");
 		goto drop;
 	}
 
+	// handle Ethernet frames, only the packet after the header is
+	// compressed
+	if(IS_ETHERNET(this->current_upper->getEtherType()))
+	{
+		if(!Rohc::Context::getEthHeaderLength(packet_data, head_length))
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "cannot get Ethernet header, drop packet\n");
+			goto drop;
+		}
+		memcpy(rohc_data, packet_data.data(), head_length);
+	}
+
 	// packet_buffer
 	packet_buffer.time.sec = 0;
 	packet_buffer.time.nsec = 0;
-	packet_buffer.data = (uint8_t *)packet_data.c_str();
-	packet_buffer.max_len = packet->getTotalLength();
+	packet_buffer.data = (uint8_t *)packet_data.data() + head_length;
+	packet_buffer.max_len = packet_data.length() - head_length;
 	packet_buffer.offset = 0;
-	packet_buffer.len = packet->getTotalLength();
+	packet_buffer.len = packet_data.length() - head_length;
 	// rohc_buffer
 	rohc_buffer.time.sec = 0;
 	rohc_buffer.time.nsec = 0;
-	rohc_buffer.data = (uint8_t *)rohc_data;
+	rohc_buffer.data = (uint8_t *)rohc_data + head_length;
 	rohc_buffer.max_len = MAX_ROHC_SIZE;
 	rohc_buffer.offset = 0;
 	rohc_buffer.len = 0;
 
 	// compress the IP packet thanks to the ROHC library
-	ret = rohc_compress4(this->comp,
-	                     packet_buffer, &rohc_buffer);
+	ret = rohc_compress4(comp, packet_buffer, &rohc_buffer);
 	if(ret == ROHC_STATUS_SEGMENT)
 	{
 		LOG(this->log, LEVEL_WARNING,
@@ -488,8 +518,24 @@ bool Rohc::Context::compressRohc(NetPacket *packet,
 		goto drop;
 	}
 
-	// create a ROHC packet from data computed by the ROHC library
-	rohc_packet =  new RohcPacket(rohc_buffer.data, rohc_buffer.len, packet->getType());
+	// create a ROHC packet from data computed by the ROHC library,
+	// after the Ethernet header if any
+	if(head_length == 0)
+	{
+		rohc_packet = new RohcPacket(rohc_buffer.data, rohc_buffer.len,
+		                             packet->getType());
+		rohc_packet->setSrcTalId(packet->getSrcTalId());
+		rohc_packet->setDstTalId(packet->getDstTalId());
+		rohc_packet->setQos(packet->getQos());
+	}
+	else
+	{
+		rohc_packet = new NetPacket(rohc_data, head_length + rohc_buffer.len,
+		                            this->getName(), this->getEtherType(),
+		                            packet->getQos(),
+		                            packet->getSrcTalId(),
+		                            packet->getDstTalId(), 0);
+	}
 	if(rohc_packet == NULL)
 	{
 		LOG(this->log, LEVEL_ERROR,
@@ -497,9 +543,6 @@ bool Rohc::Context::compressRohc(NetPacket *packet,
 		    "drop the network packet\n");
 		goto drop;
 	}
-	rohc_packet->setSrcTalId(packet->getSrcTalId());
-	rohc_packet->setDstTalId(packet->getDstTalId());
-	rohc_packet->setQos(packet->getQos());
 
 	// set the destination spot ID
 	rohc_packet->setSpot(dest_spot);
@@ -522,32 +565,57 @@ bool Rohc::Context::decompressRohc(NetPacket *packet,
                                    NetPacket **dec_packet)
 {
 	NetPacket *net_packet;
-	unsigned char ip_data[MAX_ROHC_SIZE];
-	Data ip_packet;
+	// the Ethernet header, if any, is kept before the IP packet
+	unsigned char ip_data[MAX_ETHERNET_SIZE + MAX_ROHC_SIZE];
 	// keep the destination spot
 	uint16_t dest_spot = packet->getSpot();
 	int ret;
 	struct rohc_buf packet_buffer;
 	struct rohc_buf rohc_buffer;
-	Data pkt_data = packet->getData();
+	const PacketBuffer &pkt_data = packet->getBuffer();
+	size_t head_length = 0;
+	std::map<uint16_t, struct rohc_decomp *>::iterator decomp;
+
+	decomp = this->decompressors.find(
+		getDecompressorId(packet->getSrcTalId(), packet->getDstTalId()));
+	if(decomp == this->decompressors.end())
+	{
+		LOG(this->log, LEVEL_ERROR,
+		    "Could not find decompressor associated with "
+		    "SRC Tal Id %u\n", packet->getSrcTalId());
+		goto drop;
+	}
+
+	// handle Ethernet frames, only the packet after the header is
+	// decompressed
+	if(IS_ETHERNET(this->current_upper->getEtherType()))
+	{
+		if(!Rohc::Context::getEthHeaderLength(pkt_data, head_length))
+		{
+			LOG(this->log, LEVEL_ERROR,
+			    "cannot get Ethernet header, drop packet\n");
+			goto drop;
+		}
+		memcpy(ip_data, pkt_data.data(), head_length);
+	}
 
 	// packet_buffer
 	packet_buffer.time.sec = 0;
 	packet_buffer.time.nsec = 0;
-	packet_buffer.data = (uint8_t *)ip_data;
+	packet_buffer.data = (uint8_t *)ip_data + head_length;
 	packet_buffer.max_len = MAX_ROHC_SIZE;
 	packet_buffer.offset = 0;
 	packet_buffer.len = 0;
 	// rohc_buffer
 	rohc_buffer.time.sec = 0;
 	rohc_buffer.time.nsec = 0;
-	rohc_buffer.max_len = packet->getTotalLength();
+	rohc_buffer.max_len = pkt_data.length() - head_length;
 	rohc_buffer.offset = 0;
-	rohc_buffer.len = packet->getTotalLength();
-	rohc_buffer.data = (uint8_t *)pkt_data.c_str();
+	rohc_buffer.len = pkt_data.length() - head_length;
+	rohc_buffer.data = (uint8_t *)pkt_data.data() + head_length;
 
 	// decompress the IP packet thanks to the ROHC library
-	ret = rohc_decompress3(this->decompressors[packet->getSrcTalId()],
+	ret = rohc_decompress3(decomp->second,
 	                       rohc_buffer, &packet_buffer, NULL, NULL);
 	if (ret != ROHC_STATUS_OK)
 	{
@@ -556,11 +624,24 @@ bool Rohc::Context::decompressRohc(NetPacket *packet,
 		goto drop;
 	}
 
-	ip_packet.append(packet_buffer.data, packet_buffer.len);
-	net_packet = this->current_upper->build(ip_packet, packet_buffer.len,
-	                                        packet->getQos(),
-	                                        packet->getSrcTalId(),
-	                                        packet->getDstTalId());
+	if(head_length == 0)
+	{
+		Data ip_packet(packet_buffer.data, packet_buffer.len);
+
+		net_packet = this->current_upper->build(ip_packet, packet_buffer.len,
+		                                        packet->getQos(),
+		                                        packet->getSrcTalId(),
+		                                        packet->getDstTalId());
+	}
+	else
+	{
+		// rebuild the Ethernet frame around the IP packet
+		net_packet = new NetPacket(ip_data, head_length + packet_buffer.len,
+		                           this->getName(), this->getEtherType(),
+		                           packet->getQos(),
+		                           packet->getSrcTalId(),
+		                           packet->getDstTalId(), 0);
+	}
 	if(net_packet == NULL)
 	{
 		LOG(this->log, LEVEL_ERROR,
@@ -584,65 +665,37 @@ drop:
 	return false;
 }
 
-bool Rohc::Context::extractPacketFromEth(NetPacket *frame,
-                                         size_t &head_length,
-                                         unsigned char *head_buffer,
-                                         NetPacket **payload)
+bool Rohc::Context::getEthHeaderLength(const PacketBuffer &frame,
+                                       size_t &head_length)
 {
-	// build Ethernet frame to get the correct EtherType in
-	// extractPacketFromEth function
-	NetPacket *eth_frame =
-		this->current_upper->build(frame->getData(),
-		                           frame->getTotalLength(),
-		                           frame->getQos(),
-		                           frame->getSrcTalId(),
-		                           frame->getDstTalId());
-	if(eth_frame == NULL)
+	const unsigned char *bytes = frame.data();
+	uint16_t ether_type;
+
+	if(frame.length() < ETHERNET_2_HEADSIZE)
 	{
-		LOG(this->log, LEVEL_ERROR,
-		    "cannot create Ethernet packet");
 		return false;
 	}
-	head_length = eth_frame->getHeaderLength();
-
-	// keep the Ethernet header
-	memcpy(head_buffer, eth_frame->getData().c_str(), head_length);
-	// create a packet without ethernet header
-	*payload = this->createPacket(eth_frame->getPayload(),
-	                              eth_frame->getPayloadLength(),
-	                              frame->getQos(), frame->getSrcTalId(),
-	                              frame->getDstTalId());
-	delete eth_frame;
-	return true;
-}
-
-bool Rohc::Context::buildEthFromPacket(NetPacket *packet,
-                                       size_t head_length,
-                                       unsigned char *head_buffer,
-                                       NetPacket **eth_frame)
-{
-	size_t new_eth_size;
-	Data eth_packet;
-
-	*eth_frame = NULL;
-	new_eth_size = head_length + packet->getTotalLength();
-
-/*	if(new_eth_size > MAX_ETHERNET_SIZE)
+	// same frame types as Ethernet::getFrameType, two 802.1Q tags
+	// are handled as 802.1AD
+	ether_type = (bytes[12] << 8) | bytes[13];
+	if(ether_type == NET_PROTO_802_1AD)
 	{
-		LOG(this->log, LEVEL_ERROR,
-		    "ethernet frame length (%zu) exceeds maximum length (%d)\n",
-		    new_eth_size, MAX_ETHERNET_SIZE);
-		return false;
-	}*/
-	// ethernet frame << eth header << rohc packet data
-	memcpy(head_buffer + head_length, packet->getData().c_str(),
-	       packet->getTotalLength());
-	eth_packet.append(head_buffer, new_eth_size);
-	*eth_frame = this->createPacket(eth_packet, new_eth_size,
-	                                packet->getQos(),
-	                                packet->getSrcTalId(),
-	                                packet->getDstTalId());
-	return true;
+		head_length = ETHERNET_802_1AD_HEADSIZE;
+	}
+	else if(ether_type == NET_PROTO_802_1Q)
+	{
+		head_length = ETHERNET_802_1Q_HEADSIZE;
+		if(frame.length() >= ETHERNET_802_1Q_HEADSIZE &&
+		   ((bytes[16] << 8) | bytes[17]) == NET_PROTO_802_1Q)
+		{
+			head_length = ETHERNET_802_1AD_HEADSIZE;
+		}
+	}
+	else
+	{
+		head_length = ETHERNET_2_HEADSIZE;
+	}
+	return frame.length() >= head_length;
 }
 
 NetPacket *Rohc::PacketHandler::build(const Data &data,
@@ -38,6 +38,7 @@
 #include <LanAdaptationPlugin.h>
 #include <NetPacket.h>
 #include <NetBurst.h>
+#include <WorkerPool.h>
 #include <cassert>
 
 #include <vector>
@@ -71,10 +72,29 @@ class Rohc: public LanAdaptationPlugin
 	{
 	  private:
 
-		/// The ROHC compressor
-		struct rohc_comp *comp;
-		/// The ROHC decompressors
-		std::map<uint8_t, struct rohc_decomp*> decompressors;
+		/**
+		 * @brief A compression shard: a compressor and the packets
+		 *        it compresses
+		 */
+		typedef struct
+		{
+			Context *context;               ///< The ROHC context
+			struct rohc_comp *comp;         ///< The ROHC compressor
+			std::vector<size_t> positions;  ///< The packets to compress
+		} rohc_shard_t;
+
+		/// The compression shards
+		std::vector<rohc_shard_t *> shards;
+		/// The threads compressing the shards, one per shard
+		WorkerPool threads;
+		/// The packets of the burst being compressed
+		std::vector<NetPacket *> packets;
+		/// The compressed packets, at the position of the packets,
+		/// NULL if the compression failed
+		std::vector<NetPacket *> compressed;
+		/// The ROHC decompressors, per source terminal and kind of
+		/// destination (unicast or broadcast)
+		std::map<uint16_t, struct rohc_decomp*> decompressors;
 
 	  public:
 
@@ -98,42 +118,69 @@ class Rohc: public LanAdaptationPlugin
 
 	  private:
 
-		bool compressRohc(NetPacket *packet, NetPacket **comp_packet);
-		bool decompressRohc(NetPacket *packet, NetPacket **dec_packet);
-
 		/**
-		 * Removes the frame's Ethernet header and copies the
-		 * contained packet in a new NetPacket.
-		 * @warning head_buffer should be able to contain a
-		 *          complete Ethernet Frame as it will be used for rebuild
+		 * @brief Create a compression shard
 		 *
-		 * @param frame        The Ethernet frame
-		 * @param head_length  The size of the Ethernet header
-		 * @param head_buffer  The buffer containing the old Ethernet header
-		 * @param payload      The packet contained in the Ethernet frame
+		 * @param cid_type  The type of CID
+		 * @param max_cid   The maximum CID
 		 * @return true on success, false otherwise
 		 */
-		bool extractPacketFromEth(NetPacket *frame,
-		                          size_t &head_length,
-		                          unsigned char *head_buffer,
-		                          NetPacket **payload);
+		bool addShard(rohc_cid_type_t cid_type, unsigned int max_cid);
 
 		/**
-		 * Adds an Ethernet header to the packet and copies the frame
-		 * in a new NetPacket.
-		 * @warning head_buffer should be able to contain a
-		 *          complete Ethernet Frame as it wuill be uszed for rebuild
+		 * @brief Get the compression shard of a packet
 		 *
-		 * @param packet       The packet contained in the Ethernet frame
-		 * @param head_length  The size of the Ethernet header
-		 * @param head_buffer  The buffer containing the old Ethernet header
-		 * @param eth_frame    The Ethernet frame
-		 * @return true on success, false otherwise
+		 * The packets for a terminal are always compressed by the same
+		 * shard, so its decompressor only receives the CIDs of one
+		 * compressor. The broadcast packets have their own shard as they
+		 * are received by all the terminals.
+		 *
+		 * @param packet  The packet
+		 * @return the shard index
+		 */
+		unsigned int getShard(const NetPacket *packet) const;
+
+		/**
+		 * @brief Get the ID of the decompressor for the packets of a source
+		 *        terminal, the unicast and broadcast packets have different
+		 *        decompressors because they come from different shards
+		 *
+		 * @param src_tal_id  The source terminal ID
+		 * @param dst_tal_id  The destination terminal ID
+		 * @return the decompressor ID
+		 */
+		static uint16_t getDecompressorId(uint8_t src_tal_id,
+		                                  uint8_t dst_tal_id);
+
+		/**
+		 * @brief Compress the packets of a shard
+		 *
+		 * @param shard  The shard
+		 */
+		void compressShard(rohc_shard_t *shard);
+
+		/**
+		 * @brief The task compressing the packets of a shard
+		 *
+		 * @param arg  The shard
+		 */
+		static void runShard(void *arg);
+
+		bool compressRohc(struct rohc_comp *comp, NetPacket *packet,
+		                  NetPacket **comp_packet);
+		bool decompressRohc(NetPacket *packet, NetPacket **dec_packet);
+
+		/**
+		 * Get the length of the Ethernet header of a frame, the ROHC
+		 * packets are compressed and decompressed after it, in place
+		 *
+		 * @param frame        The Ethernet frame
+		 * @param head_length  OUT: The size of the Ethernet header
+		 * @return true on success, false if the frame is too short
 		 */
-		bool buildEthFromPacket(NetPacket *packet,
-		                        size_t head_length,
-		                        unsigned char *head_buffer,
-		                        NetPacket **eth_frame);
+		static bool getEthHeaderLength(const PacketBuffer &frame,
+		                               size_t &head_length);
+
 		bool handleTap() {return false;};
 	};
 
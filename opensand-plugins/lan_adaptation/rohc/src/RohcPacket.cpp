@@ -40,14 +40,12 @@ RohcPacket::RohcPacket(const unsigned char *data, size_t length, uint16_t type):
 {
 	this->name = "ROHC";
 	this->type = type;
-	this->data.reserve(1500);
 }
 
 RohcPacket::RohcPacket(const Data &data, uint16_t type): NetPacket(data)
 {
 	this->name = "ROHC";
 	this->type = type;
-	this->data.reserve(1500);
 }
 
 RohcPacket::RohcPacket(const Data &data, size_t length, uint16_t type):
@@ -55,7 +53,6 @@ RohcPacket::RohcPacket(const Data &data, size_t length, uint16_t type):
 {
 	this->name = "ROHC";
 	this->type = type;
-	this->data.reserve(1500);
 }
 
 RohcPacket::RohcPacket(uint16_t type): NetPacket()
@@ -50,6 +50,10 @@
 #include <execinfo.h>
 #include <errno.h>
 #include <cxxabi.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
  
  
 // taken from http://oroboro.com/stack-trace-on-crash/
@@ -160,7 +164,12 @@ static void crash_handler(int sig)
 
 BlockManager::BlockManager():
 	stopped(false),
-	status(true)
+	status(true),
+#if ENABLE_EPOLL
+	event_backend(backend_epoll)
+#else
+	event_backend(backend_select)
+#endif
 {
 }
 
@@ -221,6 +230,8 @@ bool BlockManager::init(void)
 			    (*iter)->getName().c_str());
 			continue;
 		}
+		(*iter)->upward->setEventBackend(this->event_backend);
+		(*iter)->downward->setEventBackend(this->event_backend);
 		if(!(*iter)->init())
 		{
 			// only return false, the block init function should call
@@ -249,6 +260,11 @@ bool BlockManager::init(void)
 }
 
 
+void BlockManager::setEventBackend(event_backend_t backend)
+{
+	this->event_backend = backend;
+}
+
 void BlockManager::reportError(const char *msg, bool critical)
 {
 	if(critical == true)
@@ -128,6 +128,14 @@ class BlockManager
 	 */
 	void reportError(const char *msg, bool critical);
 
+	/**
+	 * @brief Set the backend used by channels to wait for events
+	 *        Should be called before initialization
+	 *
+	 * @param backend  The event backend
+	 */
+	void setEventBackend(event_backend_t backend);
+
 	/**
 	 * @brief Checks if threads and application are alive or should be stopped
 	 *        Exits when application goes stopped
@@ -154,6 +162,9 @@ class BlockManager
 
 	/// whether a critical error was raised
 	bool status;
+
+	/// the backend used by channels to wait for events
+	event_backend_t event_backend;
 };
 
 template<class Bl, class Up, class Down>
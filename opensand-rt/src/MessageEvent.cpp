@@ -47,6 +47,8 @@ MessageEvent::MessageEvent(RtFifo *const fifo,
                            int32_t fd,
                            uint8_t priority):
 	RtEvent(evt_message, name, fd, priority),
+	count(0),
+	current(0),
 	fifo(fifo)
 {
 }
@@ -57,26 +59,22 @@ MessageEvent::~MessageEvent()
 
 bool MessageEvent::handle(void)
 {
-	unsigned char data[strlen(MAGIC_WORD)];
-	int rlen;
-
-	// read the pipe to clear it, and check that if contains
-	// the correct signaling
-	rlen = read(this->fd, data, strlen(MAGIC_WORD));
-	if(rlen != strlen(MAGIC_WORD) ||
-	   strncmp((char *)data, MAGIC_WORD, strlen(MAGIC_WORD)) != 0)
+	// the fd is an eventfd readable while the fifo contains data,
+	// the fifo clears it once empty
+	this->current = 0;
+	if(!this->fifo->pop(this->messages, MAX_MESSAGES_PER_EVENT, this->count))
 	{
-		Rt::reportError(this->name, pthread_self(), false,
-		                "pipe signaling message from previous block contain wrong data ",
-		                "[%u: %s]", errno, strerror(errno));
 		return false;
 	}
+	return true;
+}
 
-	// set the event content
-	if(!this->fifo->pop(this->message))
+bool MessageEvent::next(void)
+{
+	if(this->current + 1 >= this->count)
 	{
 		return false;
 	}
+	this->current++;
 	return true;
-
 }
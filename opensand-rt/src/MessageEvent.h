@@ -45,6 +45,9 @@
 using std::string;
 using std::pair;
 
+/// the maximum number of messages got from fifo on each event
+#define MAX_MESSAGES_PER_EVENT 32
+
 
 class RtFifo;
 
@@ -52,6 +55,9 @@ class RtFifo;
   * @class MessageEvent
   * @brief Event describing a message transmitted between blocks
   *
+  * Up to MAX_MESSAGES_PER_EVENT messages are got from the fifo on
+  * each event, the channel processes them one by one, the accessors
+  * refer to the message being processed.
   */
 class MessageEvent: public RtEvent
 {
@@ -77,36 +83,49 @@ class MessageEvent: public RtEvent
 	 *
 	 * @return the message
 	 */
-	rt_msg_t getMessage() const {return this->message;};
+	rt_msg_t getMessage() const {return this->messages[this->current];};
 
 	/**
 	 * @brief Get the message type
 	 *
 	 * @return the message type
 	 */
-	uint8_t getMessageType() const {return this->message.type;};
+	uint8_t getMessageType() const {return this->messages[this->current].type;};
 
 	/**
 	 * @brief Get the message content
 	 *
 	 * @return the message conetnt
 	 */
-	void *getData() const {return this->message.data;};
+	void *getData() const {return this->messages[this->current].data;};
 	
 	/**
 	 * @brief Get the message length
 	 *
 	 * @return the message length
 	 */
-	size_t getLength() const {return this->message.length;};
+	size_t getLength() const {return this->messages[this->current].length;};
+
+	/**
+	 * @brief Go to the next message got on this event
+	 *
+	 * @return true if there is a next message, false otherwise
+	 */
+	virtual bool next(void);
 
 
 	virtual bool handle(void);
 
   protected:
 
-	/// the message
-	rt_msg_t message;
+	/// the messages got on this event
+	rt_msg_t messages[MAX_MESSAGES_PER_EVENT];
+
+	/// the number of messages got on this event
+	size_t count;
+
+	/// the index of the message being processed
+	size_t current;
 
 	/// the fifo
 	RtFifo *const fifo;
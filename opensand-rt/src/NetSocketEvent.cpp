@@ -38,72 +38,287 @@
 
 #include <opensand_output/Output.h>
 
+#include <cstdlib>
 #include <cstring>
 #include <unistd.h>
 #include <errno.h>
 
 
+/// The maximum number of released buffers kept for reuse
+#define NET_SOCKET_POOL_SIZE (2 * NET_SOCKET_BATCH)
+
+
+/**
+ * @brief Allocate a reception buffer with malloc
+ *
+ * @param size  The buffer size
+ * @return the buffer
+ */
+static unsigned char *mallocBuffer(size_t size)
+{
+	return (unsigned char *)malloc(size);
+}
+
+/**
+ * @brief Release a reception buffer allocated with malloc
+ *
+ * @param buf  The buffer
+ */
+static void freeBuffer(unsigned char *buf)
+{
+	free(buf);
+}
+
 // TODO add send functions
 
+NetSocketEvent::NetSocketEvent(const string &name,
+                               int32_t fd,
+                               size_t max_size,
+                               uint8_t priority,
+                               const net_buffer_allocator_t *allocator):
+	FileEvent(name, fd, max_size, priority, evt_net_socket),
+	sock_type(0),
+	count(0),
+	current(0),
+	pool()
+{
+	memset(&this->src_addr, 0, sizeof(this->src_addr));
+	memset(this->buffers, 0, sizeof(this->buffers));
+	memset(this->sizes, 0, sizeof(this->sizes));
+	this->pool.reserve(NET_SOCKET_POOL_SIZE);
+	if(allocator)
+	{
+		this->allocator = *allocator;
+	}
+	else
+	{
+		this->allocator.allocate = mallocBuffer;
+		this->allocator.release = freeBuffer;
+	}
+}
+
 NetSocketEvent::~NetSocketEvent()
 {
-	if(this->data)
+	// data always points on one of the buffers
+	this->data = NULL;
+	for(unsigned int i = 0; i < NET_SOCKET_BATCH; i++)
+	{
+		if(this->buffers[i])
+		{
+			this->allocator.release(this->buffers[i]);
+		}
+	}
+	for(vector<unsigned char *>::iterator it = this->pool.begin();
+	    it != this->pool.end(); ++it)
 	{
-		free(this->data);
+		this->allocator.release(*it);
 	}
 }
 
 bool NetSocketEvent::handle(void)
+{
+	this->checkHandled();
+	this->count = 0;
+	this->current = 0;
+	this->data = NULL;
+	this->size = 0;
+
+	if(!this->sock_type)
+	{
+		socklen_t optlen = sizeof(this->sock_type);
+
+		if(getsockopt(this->fd, SOL_SOCKET, SO_TYPE,
+		              &this->sock_type, &optlen) < 0)
+		{
+			// not a socket, read it as a stream
+			this->sock_type = SOCK_STREAM;
+		}
+	}
+
+	if(this->sock_type == SOCK_DGRAM)
+	{
+		return this->handleDatagrams();
+	}
+	return this->handleStream();
+}
+
+bool NetSocketEvent::handleDatagrams(void)
 {
 	int ret;
-	socklen_t addrlen;
-	if(this->data)
+
+	for(unsigned int i = 0; i < NET_SOCKET_BATCH; i++)
+	{
+		if(!this->buffers[i])
+		{
+			this->buffers[i] = this->getBuffer();
+		}
+		this->iovecs[i].iov_base = this->buffers[i];
+		this->iovecs[i].iov_len = this->max_size;
+		memset(&this->msgs[i], 0, sizeof(struct mmsghdr));
+		this->msgs[i].msg_hdr.msg_name = &this->addrs[i];
+		this->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		this->msgs[i].msg_hdr.msg_iov = &this->iovecs[i];
+		this->msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	// the socket is readable so we do not block on the first datagram,
+	// then only get the datagrams that are already there
+	ret = recvmmsg(this->fd, this->msgs, NET_SOCKET_BATCH,
+	               MSG_WAITFORONE, NULL);
+	if(ret < 0)
 	{
 		Rt::reportError(this->name, pthread_self(), false,
-		                "event %s: previous data was not handled\n",
-		                this->name.c_str());
-		free(this->data);
+		                "event %s: unable to read on socket [%u: %s]",
+		                this->name.c_str(), errno, strerror(errno));
+		return false;
+	}
+
+	// keep the valid datagrams at the beginning of the arrays
+	for(int i = 0; i < ret; i++)
+	{
+		size_t len = this->msgs[i].msg_len;
+		unsigned char *buf;
+
+		if(this->msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+		{
+			Rt::reportError(this->name, pthread_self(), false,
+			                "event %s: too many data received (> %zu)\n",
+			                this->name.c_str(), this->max_size);
+			continue;
+		}
+		else if(len == 0)
+		{
+			Rt::reportError(this->name, pthread_self(), false,
+			                "event %s: empty datagram received\n",
+			                this->name.c_str());
+			continue;
+		}
+		buf = this->buffers[i];
+		this->buffers[i] = this->buffers[this->count];
+		this->buffers[this->count] = buf;
+		// one more byte so we can use it as char*
+		buf[len] = '\0';
+		this->sizes[this->count] = len;
+		this->addrs[this->count] = this->addrs[i];
+		this->count++;
+	}
+	if(!this->count)
+	{
+		return false;
+	}
+	this->selectCurrent();
+
+	return true;
+}
+
+bool NetSocketEvent::handleStream(void)
+{
+	int ret;
+	socklen_t addrlen;
+
+	if(!this->buffers[0])
+	{
+		this->buffers[0] = this->getBuffer();
 	}
-	// one more byte so we can use it as char*
-	this->data = (unsigned char *)calloc(this->max_size + 1, sizeof(unsigned char));
 
 	addrlen = sizeof(struct sockaddr_in);
-	ret = recvfrom(this->fd, this->data, this->max_size, 0,
-	               (struct sockaddr *) &(this->src_addr), &addrlen);
+	ret = recvfrom(this->fd, this->buffers[0], this->max_size, 0,
+	               (struct sockaddr *) &(this->addrs[0]), &addrlen);
 	if(ret < 0)
 	{
 		Rt::reportError(this->name, pthread_self(), false,
 		                "event %s: unable to read on socket [%u: %s]",
 		                this->name.c_str(), errno, strerror(errno));
-		goto error;
+		return false;
 	}
 	else if((size_t)ret > this->max_size)
 	{
 		Rt::reportError(this->name, pthread_self(), false,
-		                "event %s: too many data received (%zu > %zu)\n",
-		                this->name.c_str(), this->size, this->max_size);
-		goto error;
+		                "event %s: too many data received (%d > %zu)\n",
+		                this->name.c_str(), ret, this->max_size);
+		return false;
 	}
 	else if(ret == 0)
 	{
 		Rt::reportError(this->name, pthread_self(), false,
 		                 "event %s: distant host disconnected\n",
 		                 this->name.c_str());
-		goto error;
+		return false;
 	}
-	this->size = ret;
+	// one more byte so we can use it as char*
+	this->buffers[0][ret] = '\0';
+	this->sizes[0] = ret;
+	this->count = 1;
+	this->selectCurrent();
 
 	return true;
-error:
-	free(this->data);
-	this->data = NULL;
-	return false;
 }
 
+bool NetSocketEvent::next(void)
+{
+	if(this->current + 1 >= this->count)
+	{
+		return false;
+	}
+	this->checkHandled();
+	this->current++;
+	this->selectCurrent();
+	return true;
+}
+
+void NetSocketEvent::selectCurrent(void)
+{
+	this->data = this->buffers[this->current];
+	this->size = this->sizes[this->current];
+	this->src_addr = this->addrs[this->current];
+}
+
+void NetSocketEvent::checkHandled(void)
+{
+	if(this->data)
+	{
+		Rt::reportError(this->name, pthread_self(), false,
+		                "event %s: previous data was not handled\n",
+		                this->name.c_str());
+		this->data = NULL;
+	}
+}
+
+unsigned char *NetSocketEvent::getBuffer(void)
+{
+	unsigned char *buf;
+
+	if(this->pool.empty())
+	{
+		// one more byte so we can use it as char*
+		return this->allocator.allocate(this->max_size + 1);
+	}
+	buf = this->pool.back();
+	this->pool.pop_back();
+	return buf;
+}
 
 unsigned char *NetSocketEvent::getData(void)
 {
 	unsigned char *buf = this->data;
+	if(buf)
+	{
+		this->buffers[this->current] = NULL;
+	}
 	this->data = NULL;
 	return buf;
 }
+
+void NetSocketEvent::releaseData(unsigned char *buf)
+{
+	if(!buf)
+	{
+		return;
+	}
+	if(this->pool.size() >= NET_SOCKET_POOL_SIZE)
+	{
+		this->allocator.release(buf);
+		return;
+	}
+	this->pool.push_back(buf);
+}
@@ -44,6 +44,12 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <vector>
+
+using std::vector;
+
+/// The maximum number of datagrams read in one system call
+#define NET_SOCKET_BATCH 32
 
 /**
   * @class NetSocketEvent
@@ -60,25 +66,48 @@ class NetSocketEvent: public FileEvent
 	 *
 	 * @param name      The name of the event
 	 * @param fd        The file descriptor to monitor for the event
-	 * @param max_size  The maximum data size
-	 * @param priority  The priority of the event
+	 * @param max_size   The maximum data size
+	 * @param priority   The priority of the event
+	 * @param allocator  The functions allocating the reception buffers,
+	 *                   malloc and free if NULL
 	 */
 	NetSocketEvent(const string &name,
 	               int32_t fd = -1,
 	               size_t max_size = MAX_SOCK_SIZE,
-	               uint8_t priority = 4):
-		FileEvent(name, fd, max_size, priority, evt_net_socket)
-	{};
+	               uint8_t priority = 4,
+	               const net_buffer_allocator_t *allocator = NULL);
 
 	~NetSocketEvent();
 
 	/**
 	 * @brief Get the message content
+	 *        The caller takes ownership of the buffer, it should give it
+	 *        back with releaseData once handled, or release it with
+	 *        the event allocator
 	 *
 	 * @return the data contained in the message, it can be casted as a char*
 	 */
 	unsigned char *getData(void);
 
+	/**
+	 * @brief Give back a buffer obtained with getData on this event
+	 *        so it can be reused for the next receptions
+	 *
+	 * @param buf  The buffer to release
+	 */
+	void releaseData(unsigned char *buf);
+
+	/**
+	 * @brief Get the functions allocating and releasing the buffers
+	 *        of this event, to release the buffers kept after handling
+	 *
+	 * @return the functions allocating and releasing the buffers
+	 */
+	const net_buffer_allocator_t &getAllocator(void) const
+	{
+		return this->allocator;
+	};
+
 	/**
 	 * @brief Get the message source address
 	 *
@@ -88,11 +117,78 @@ class NetSocketEvent: public FileEvent
 
 	virtual bool handle(void);
 
+	/**
+	 * @brief Go to the next datagram read on this event
+	 *
+	 * @return true if there is a next datagram, false otherwise
+	 */
+	virtual bool next(void);
+
   protected:
 
+	/**
+	 * @brief Read a batch of datagrams on the socket
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool handleDatagrams(void);
+
+	/**
+	 * @brief Read the available data on a stream socket
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool handleStream(void);
+
+	/**
+	 * @brief Point the event data on the current datagram
+	 */
+	void selectCurrent(void);
+
+	/**
+	 * @brief Report the current data if it was not handled
+	 *        The buffer is kept for the next receptions
+	 */
+	void checkHandled(void);
+
+	/**
+	 * @brief Get a reception buffer, from the pool if possible
+	 *
+	 * @return the buffer
+	 */
+	unsigned char *getBuffer(void);
+
 	/// The source address of the message;
 	struct sockaddr_in src_addr;
 
+	/// The socket type, 0 if not known yet
+	int sock_type;
+
+	/// The reception buffers, NULL when given to the user
+	unsigned char *buffers[NET_SOCKET_BATCH];
+
+	/// The size of the data in each buffer
+	size_t sizes[NET_SOCKET_BATCH];
+
+	/// The source address of each datagram
+	struct sockaddr_in addrs[NET_SOCKET_BATCH];
+
+	/// The scatter/gather arrays for recvmmsg
+	struct iovec iovecs[NET_SOCKET_BATCH];
+	struct mmsghdr msgs[NET_SOCKET_BATCH];
+
+	/// The number of datagrams read on the last reception
+	size_t count;
+
+	/// The index of the datagram being processed
+	size_t current;
+
+	/// The buffers released by the user, ready to be reused
+	vector<unsigned char *> pool;
+
+	/// The functions allocating and releasing the reception buffers
+	net_buffer_allocator_t allocator;
+
 };
 
 #endif
@@ -44,6 +44,11 @@ BlockManager Rt::manager;
 
 using std::max;
 
+void Rt::setEventBackend(event_backend_t backend)
+{
+	manager.setEventBackend(backend);
+}
+
 bool Rt::init(void)
 {
 	return manager.init();
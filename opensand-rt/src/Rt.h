@@ -99,6 +99,14 @@ class Rt
 	                          Block *const upper,
 	                          T specific);
 
+	/**
+	 * @brief Set the backend used by channels to wait for events
+	 *        (select or epoll), must be called before initialization
+	 *
+	 * @param backend  The event backend
+	 */
+	static void setEventBackend(event_backend_t backend);
+
 	/**
 	 * @brief Initialize the blocks
 	 *
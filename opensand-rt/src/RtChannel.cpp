@@ -49,9 +49,10 @@
 #include <stdio.h>
 #include <signal.h>
 #include <stdarg.h>
+#include <sys/epoll.h>
+#include <algorithm>
 #ifdef TIME_REPORTS
 	#include <numeric>
-	#include <algorithm>
 #endif
 
 #define SIG_STRUCT_SIZE 128
@@ -70,12 +71,15 @@ RtChannel::RtChannel(const string &name, const string &type):
 	block_initialized(false),
 	previous_fifo(NULL),
 	in_opp_fifo(NULL),
+	backend(backend_select),
 	max_input_fd(-1),
+	epoll_fd(-1),
 	stop_fd(-1),
 	w_sel_break(-1),
 	r_sel_break(-1)
 {
 	FD_ZERO(&(this->input_fd_set));
+	memset(this->priority_mask, 0, sizeof(this->priority_mask));
 }
 
 RtChannel::~RtChannel()
@@ -99,6 +103,10 @@ RtChannel::~RtChannel()
 	}
 	close(this->w_sel_break);
 	close(this->r_sel_break);
+	if(this->epoll_fd >= 0)
+	{
+		close(this->epoll_fd);
+	}
 #ifdef TIME_REPORTS
 	this->getDurationsStatistics();
 #endif
@@ -114,6 +122,16 @@ bool RtChannel::shareMessage(void **data, size_t size, uint8_t type)
 	return this->pushMessage(this->out_opp_fifo, data, size, type);
 }
 
+bool RtChannel::enqueueMessages(vector<rt_msg_t> &messages)
+{
+	return this->pushMessages(this->next_fifo, messages);
+}
+
+bool RtChannel::shareMessages(vector<rt_msg_t> &messages)
+{
+	return this->pushMessages(this->out_opp_fifo, messages);
+}
+
 bool RtChannel::init(void)
 {
 	sigset_t signal_mask;
@@ -136,6 +154,22 @@ bool RtChannel::init(void)
 	LOG(this->log_init, LEVEL_INFO,
 	    "Starting initialization\n");
 
+	if(this->backend != backend_select)
+	{
+		this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if(this->epoll_fd < 0)
+		{
+			this->reportError(true,
+			                  "cannot create epoll instance [%u: %s]\n",
+			                  errno, strerror(errno));
+			return false;
+		}
+	}
+	LOG(this->log_init, LEVEL_INFO,
+	    "Use %s backend for events\n",
+	    this->backend == backend_select ? "select" :
+	    (this->backend == backend_epoll ? "epoll" : "edge-triggered epoll"));
+
 	// pipe used to break select when a new event is received
 	if(pipe(pipefd) != 0)
 	{
@@ -145,7 +179,12 @@ bool RtChannel::init(void)
 	}
 	this->r_sel_break = pipefd[0];
 	this->w_sel_break = pipefd[1];
-	this->addInputFd(this->r_sel_break);
+	if(!this->addInputFd(this->r_sel_break))
+	{
+		this->reportError(true,
+		                  "cannot monitor pipe\n");
+		return false;
+	}
 
 	// create the signal mask for stop (highest priority)
 	sigemptyset(&signal_mask);
@@ -191,6 +230,11 @@ void RtChannel::setIsBlockInitialized(bool initialized)
 	this->block_initialized = initialized;
 }
 
+void RtChannel::setEventBackend(event_backend_t backend)
+{
+	this->backend = backend;
+}
+
 int32_t RtChannel::addTimerEvent(const string &name,
                                  double duration_ms,
                                  bool auto_rearm,
@@ -260,12 +304,14 @@ int32_t RtChannel::addFileEvent(const string &name,
 int32_t RtChannel::addNetSocketEvent(const string &name,
                                      int32_t fd,
                                      size_t max_size,
-                                     uint8_t priority)
+                                     uint8_t priority,
+                                     const net_buffer_allocator_t *allocator)
 {
 	NetSocketEvent *event = new NetSocketEvent(name,
 	                                           fd,
 	                                           max_size,
-	                                           priority);
+	                                           priority,
+	                                           allocator);
 	if(!event)
 	{
 		this->reportError(true, "cannot create net socket event\n");
@@ -363,7 +409,11 @@ void RtChannel::updateEvents(void)
 		LOG(this->log_rt, LEVEL_INFO,
 		    "Add new event \"%s\" in list\n",
 		    (*iter)->getName().c_str());
-		this->addInputFd((*iter)->getFd());
+		if(!this->addInputFd((*iter)->getFd(), *iter))
+		{
+			this->reportError(true, "cannot monitor event \"%s\"\n",
+			                  (*iter)->getName().c_str());
+		}
 		this->events[(*iter)->getFd()] = *iter;
 	}
 	this->new_events.clear();
@@ -380,12 +430,8 @@ void RtChannel::updateEvents(void)
 			LOG(this->log_rt, LEVEL_INFO,
 			    "Remove event \"%s\" from list\n",
 			    (*it).second->getName().c_str());
-			// remove fd from set
-			FD_CLR((*it).first, &(this->input_fd_set));
-			if((*it).first == this->max_input_fd)
-			{
-				this->updateMaxFd();
-			}
+			// remove fd from monitored fds
+			this->removeInputFd((*it).first);
 			// remove fd from map
 			delete (*it).second;
 			this->events.erase(it);
@@ -496,13 +542,86 @@ bool RtChannel::raiseTimer(event_id_t id)
 	return true;
 }
 
-void RtChannel::addInputFd(int32_t fd)
+bool RtChannel::addInputFd(int32_t fd, RtEvent *event)
 {
-	if(fd > this->max_input_fd)
+	struct epoll_event epoll_evt;
+
+	if(this->backend == backend_select)
 	{
-		this->max_input_fd = fd;
+		if(fd >= FD_SETSIZE)
+		{
+			LOG(this->log_rt, LEVEL_ERROR,
+			    "fd %d is too high for select (limit %d), use "
+			    "epoll backend\n", fd, FD_SETSIZE);
+			return false;
+		}
+		if(fd > this->max_input_fd)
+		{
+			this->max_input_fd = fd;
+		}
+		FD_SET(fd, &(this->input_fd_set));
+		return true;
+	}
+
+	// the event is directly retrieved from epoll data,
+	// NULL is used for the internal pipe
+	memset(&epoll_evt, 0, sizeof(epoll_evt));
+	epoll_evt.events = EPOLLIN;
+	if(this->backend == backend_epoll_edge && event &&
+	   event->isEdgeTriggerSafe())
+	{
+		epoll_evt.events |= EPOLLET;
+	}
+	epoll_evt.data.ptr = event;
+	if(epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &epoll_evt) != 0)
+	{
+		if(errno == EPERM && event)
+		{
+			// regular files are not supported by epoll
+			LOG(this->log_rt, LEVEL_INFO,
+			    "fd %d cannot be monitored by epoll, consider it "
+			    "as always ready\n", fd);
+			this->always_ready_events.push_back(event);
+			return true;
+		}
+		LOG(this->log_rt, LEVEL_ERROR,
+		    "cannot add fd %d in epoll [%u: %s]\n",
+		    fd, errno, strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+void RtChannel::removeInputFd(int32_t fd)
+{
+	if(this->backend == backend_select)
+	{
+		FD_CLR(fd, &(this->input_fd_set));
+		if(fd == this->max_input_fd)
+		{
+			this->updateMaxFd();
+		}
+		return;
+	}
+
+	for(vector<RtEvent *>::iterator iter = this->always_ready_events.begin();
+	    iter != this->always_ready_events.end(); ++iter)
+	{
+		if(*(*iter) == fd)
+		{
+			this->always_ready_events.erase(iter);
+			return;
+		}
+	}
+
+	// fd would be removed on close but the event pointer
+	// must not be returned anymore
+	if(epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, NULL) != 0)
+	{
+		LOG(this->log_rt, LEVEL_WARNING,
+		    "cannot remove fd %d from epoll [%u: %s]\n",
+		    fd, errno, strerror(errno));
 	}
-	FD_SET(fd, &(this->input_fd_set));
 }
 
 void RtChannel::removeEvent(event_id_t id)
@@ -519,105 +638,203 @@ void *RtChannel::startThread(void *pthis)
 
 void RtChannel::executeThread(void)
 {
-	int32_t number_fd;
-	int32_t handled;
-	fd_set readfds;
-
-	list<RtEvent *> priority_sorted_events;
-
 	while(true)
 	{
-		handled = 0;
-		
 		// get the new events for the next loop
 		this->updateEvents();
-		readfds = this->input_fd_set;
 
-		// wait for any event
-		// we need a timeout in order to refresh event list
-		number_fd = select(this->max_input_fd + 1, &readfds, NULL, NULL, NULL);
-		if(number_fd < 0)
+		// wait for any event and handle the raised ones
+		if(this->backend == backend_select)
+		{
+			this->waitSelectEvents();
+		}
+		else
 		{
-			this->reportError(true, "select failed: [%u: %s]\n", errno, strerror(errno));
+			this->waitEpollEvents();
 		}
-		// unfortunately, FD_ISSET is the only usable thing
-		priority_sorted_events.clear();
 
-		// check for select break
-		if(FD_ISSET(this->r_sel_break, &readfds))
+		// call processEvent on each event
+		this->processEvents();
+	}
+}
+
+void RtChannel::waitSelectEvents(void)
+{
+	int32_t number_fd;
+	int32_t handled = 0;
+	fd_set readfds = this->input_fd_set;
+
+	// wait for any event
+	// we need a timeout in order to refresh event list
+	number_fd = select(this->max_input_fd + 1, &readfds, NULL, NULL, NULL);
+	if(number_fd < 0)
+	{
+		this->reportError(true, "select failed: [%u: %s]\n", errno, strerror(errno));
+		return;
+	}
+	// unfortunately, FD_ISSET is the only usable thing
+
+	// check for select break
+	if(FD_ISSET(this->r_sel_break, &readfds))
+	{
+		unsigned char data[strlen(MAGIC_WORD)];
+		if(read(this->r_sel_break, data, strlen(MAGIC_WORD)) < 0)
 		{
+			LOG(this->log_rt, LEVEL_ERROR,
+			    "failed to read in pipe");
+		}
+		handled++;
+	}
+
+	// handle each event
+	for(map<event_id_t, RtEvent *>::iterator iter = this->events.begin();
+		iter != this->events.end(); ++iter)
+	{
+		RtEvent *event = (*iter).second;
+		if(handled >= number_fd)
+		{
+			// all events treated, no need to continue the loop
+			break;
+		}
+		// if this event FD has raised
+		if(!FD_ISSET(event->getFd(), &readfds))
+		{
+			continue;
+		}
+		handled++;
+
+		this->handleEvent(event);
+	}
+}
+
+void RtChannel::waitEpollEvents(void)
+{
+	struct epoll_event raised[RT_MAX_EPOLL_EVENTS];
+	int32_t number_fd;
+
+	// do not wait if some events are always ready
+	number_fd = epoll_wait(this->epoll_fd, raised, RT_MAX_EPOLL_EVENTS,
+	                       this->always_ready_events.empty() ? -1 : 0);
+	if(number_fd < 0)
+	{
+		if(errno != EINTR)
+		{
+			this->reportError(true, "epoll_wait failed: [%u: %s]\n",
+			                  errno, strerror(errno));
+		}
+		return;
+	}
+
+	// events pointers are valid here because removed events
+	// are only deleted in updateEvents
+	for(int32_t i = 0; i < number_fd; i++)
+	{
+		RtEvent *event = (RtEvent *)raised[i].data.ptr;
+		if(event == NULL)
+		{
+			// this is the break pipe
 			unsigned char data[strlen(MAGIC_WORD)];
 			if(read(this->r_sel_break, data, strlen(MAGIC_WORD)) < 0)
 			{
 				LOG(this->log_rt, LEVEL_ERROR,
 				    "failed to read in pipe");
 			}
-			handled++;
+			continue;
 		}
+		this->handleEvent(event);
+	}
 
-		// handle each event
-		for(map<event_id_t, RtEvent *>::iterator iter = this->events.begin();
-			iter != this->events.end(); ++iter)
-		{
-			RtEvent *event = (*iter).second;
-			if(handled >= number_fd)
-			{
-				// all events treated, no need to continue the loop
-				break;
-			}
-			// if this event FD has raised
-			if(!FD_ISSET(event->getFd(), &readfds))
-			{
-				continue;
-			}
-			handled++;
+	for(vector<RtEvent *>::iterator iter = this->always_ready_events.begin();
+	    iter != this->always_ready_events.end(); ++iter)
+	{
+		this->handleEvent(*iter);
+	}
+}
 
-			// fd is set
-			if(!event->handle())
-			{
-				if(event->getType() == evt_signal)
-				{
-					// this is the only case where it is critical as
-					// stop event is a signal
-					this->reportError(true, "unable to handle signal event\n");
-					pthread_exit(NULL);
-				}
-				this->reportError(false, "unable to handle event\n");
-				// ignore this event
-				continue;
-			}
-			priority_sorted_events.push_back(event);
-			if(*event == this->stop_fd)
-			{
-				// we have to stop
-				LOG(this->log_rt, LEVEL_INFO,
-				    "stop signal received\n");
-				pthread_exit(NULL);
-			}
+void RtChannel::handleEvent(RtEvent *event)
+{
+	uint8_t priority;
+
+	// fd is set
+	if(!event->handle())
+	{
+		if(event->getType() == evt_signal)
+		{
+			// this is the only case where it is critical as
+			// stop event is a signal
+			this->reportError(true, "unable to handle signal event\n");
+			pthread_exit(NULL);
 		}
-		// sort the list according to priority
-		priority_sorted_events.sort(RtEvent::compareEvents);
+		this->reportError(false, "unable to handle event\n");
+		// ignore this event
+		return;
+	}
+	if(*event == this->stop_fd)
+	{
+		// we have to stop
+		LOG(this->log_rt, LEVEL_INFO,
+		    "stop signal received\n");
+		pthread_exit(NULL);
+	}
 
-		// call processEvent on each event
-		for(list<RtEvent *>::iterator iter = priority_sorted_events.begin();
-			iter != priority_sorted_events.end(); ++iter)
+	// events are processed by priority bucket, then sorted by trigger
+	// time in their bucket (see processEvents)
+	priority = event->getPriority();
+	this->priority_buckets[priority].push_back(event);
+	this->priority_mask[priority / 64] |= (uint64_t)1 << (priority % 64);
+}
+
+void RtChannel::processEvents(void)
+{
+	for(unsigned int word = 0; word < RT_PRIORITY_MASK_WORDS; word++)
+	{
+		while(this->priority_mask[word] != 0)
 		{
-			(*iter)->setTriggerTime();
-			LOG(this->log_rt, LEVEL_DEBUG, "event received (%s)",
-			    (*iter)->getName().c_str());
-			if(!this->onEvent(*iter))
+			// lowest bit is the highest priority
+			unsigned int bit = __builtin_ctzll(this->priority_mask[word]);
+			vector<RtEvent *> &bucket = this->priority_buckets[word * 64 + bit];
+
+			this->priority_mask[word] &= this->priority_mask[word] - 1;
+			// as before the buckets, the events with the same priority are
+			// processed by trigger time, that is the least recently
+			// processed first, not in file descriptors order
+			if(bucket.size() > 1)
 			{
-				LOG(this->log_rt, LEVEL_ERROR,
-				    "failed to process event %s\n",
-				    (*iter)->getName().c_str());
+				std::stable_sort(bucket.begin(), bucket.end(),
+				                 RtEvent::compareEvents);
 			}
+			for(vector<RtEvent *>::iterator iter = bucket.begin();
+			    iter != bucket.end(); ++iter)
+			{
+				(*iter)->setTriggerTime();
+				LOG(this->log_rt, LEVEL_DEBUG, "event received (%s)",
+				    (*iter)->getName().c_str());
+				// an event may contain several messages or datagrams
+				do
+				{
+					if(!this->onEvent(*iter))
+					{
+						LOG(this->log_rt, LEVEL_ERROR,
+						    "failed to process event %s\n",
+						    (*iter)->getName().c_str());
+					}
+				}
+				while((*iter)->next());
 #ifdef TIME_REPORTS
-			timeval time = (*iter)->getTimeFromTrigger();
-			double val = time.tv_sec * 1000000L + time.tv_usec;
-			this->durations[(*iter)->getName()].push_back(val);
+				timeval time = (*iter)->getTimeFromTrigger();
+				double val = time.tv_sec * 1000000L + time.tv_usec;
+				this->durations[(*iter)->getName()].push_back(val);
 #endif
+			}
+			// clear keeps capacity, no allocation in steady state
+			bucket.clear();
 		}
 	}
+	if(!this->onEventsProcessed())
+	{
+		LOG(this->log_rt, LEVEL_ERROR,
+		    "failed to complete events processing\n");
+	}
 }
 
 void RtChannel::reportError(bool critical, const char *msg_format, ...)
@@ -677,6 +894,38 @@ bool RtChannel::pushMessage(RtFifo *out_fifo, void **data, size_t size, uint8_t
 	return success;
 }
 
+bool RtChannel::pushMessages(RtFifo *out_fifo, vector<rt_msg_t> &messages)
+{
+	size_t pushed = 0;
+	bool success = true;
+
+	if(messages.empty())
+	{
+		return true;
+	}
+
+	// check that block is initialized (i.e. we are in event processing)
+	if(!this->block_initialized)
+	{
+		LOG(this->log_send, LEVEL_NOTICE,
+		    "Be careful, some message are sent while process are not "
+		    "started. If too many messages are sent we may block because "
+		    "fifo is full\n");
+	}
+
+	if(!out_fifo->push(&messages[0], messages.size(), pushed))
+	{
+		this->reportError(false,
+		                  "cannot push %zu/%zu data in fifo for next block\n",
+		                  messages.size() - pushed, messages.size());
+		success = false;
+	}
+
+	// only keep the messages that were not pushed
+	messages.erase(messages.begin(), messages.begin() + pushed);
+	return success;
+}
+
 #ifdef TIME_REPORTS
 void RtChannel::getDurationsStatistics(void) const
 {
@@ -46,6 +46,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include <sys/select.h>
 
 
@@ -56,9 +57,17 @@ class RtEvent;
 using std::list;
 using std::map;
 using std::string;
+using std::vector;
 
 //#define TIME_REPORTS
 
+/// the number of event priority levels (priority is an uint8_t)
+#define RT_PRIORITY_LEVELS 256
+/// the number of 64-bits words in the mask of raised priorities
+#define RT_PRIORITY_MASK_WORDS (RT_PRIORITY_LEVELS / 64)
+/// the maximum number of events retrieved by one epoll_wait call
+#define RT_MAX_EPOLL_EVENTS 64
+
 /**
  * @class RtChannel
  * @brief describes a single channel
@@ -122,6 +131,14 @@ class RtChannel
 	 */
 	virtual bool onEvent(const RtEvent *const event) = 0;
 
+	/**
+	 * @brief Called once the events raised together were all processed
+	 *        Can be used to flush the work batched in onEvent
+	 *
+	 * @return true on success, false otherwise
+	 */
+	virtual bool onEventsProcessed(void) {return true;};
+
   public:
 
 	/**
@@ -152,14 +169,17 @@ class RtChannel
 	 *
 	 * @param name      The name of the event
 	 * @param fd        The file descriptor to monitor
-	 * @param max_size  The maximum data size
-	 * @param priority  The priority of the event (small for high priority)
+	 * @param max_size   The maximum data size
+	 * @param priority   The priority of the event (small for high priority)
+	 * @param allocator  The functions allocating the reception buffers,
+	 *                   malloc and free if NULL
 	 * @return the event id on success, -1 otherwise
 	 */
 	int32_t addNetSocketEvent(const string &name,
 	                          int32_t fd,
 	                          size_t max_size = MAX_SOCK_SIZE,
-	                          uint8_t priority = 3);
+	                          uint8_t priority = 3,
+	                          const net_buffer_allocator_t *allocator = NULL);
 
 	 /**
 	  * @brief Add a tcp listen event to the channel
@@ -267,6 +287,27 @@ class RtChannel
 	 */
 	bool shareMessage(void **data, size_t size=0, uint8_t type=0);
 
+	/**
+	 * @brief Add several messages in the next channel queue at once
+	 *        The next channel is signaled once for the whole batch
+	 * @warning The messages shall not be reused in the channel after this
+	 *          call because will be used in other blocks
+	 *
+	 * @param messages  IN: The messages to enqueue
+	 *                  OUT: The messages that could not be enqueued
+	 * @return true on success, false otherwise
+	 */
+	bool enqueueMessages(vector<rt_msg_t> &messages);
+
+	/**
+	 * @brief Transmit several messages to the opposite channel at once
+	 *
+	 * @param messages  IN: The messages to enqueue
+	 *                  OUT: The messages that could not be enqueued
+	 * @return true on success, false otherwise
+	 */
+	bool shareMessages(vector<rt_msg_t> &messages);
+
   protected:
 
 	/**
@@ -284,6 +325,14 @@ class RtChannel
 	 */
 	void setIsBlockInitialized(bool initialized);
 	
+	/**
+	 * @brief Set the backend used to wait for events
+	 *        Should be called before channel initialization
+	 *
+	 * @param backend  The event backend
+	 */
+	void setEventBackend(event_backend_t backend);
+
 	/**
 	 * @brief Set the fifo for previous channel message
 	 *
@@ -352,12 +401,28 @@ class RtChannel
 	/// The fifo for outgoing messages to opposite channel
 	RtFifo *out_opp_fifo;
 
-	/// contains the highest FD of input events
+	/// the backend used to wait for events
+	event_backend_t backend;
+
+	/// contains the highest FD of input events (select backend)
 	int32_t max_input_fd;
 
-	/// fd_set containing monitored input FDs
+	/// fd_set containing monitored input FDs (select backend)
 	fd_set input_fd_set;
 
+	/// the epoll instance file descriptor (epoll backends)
+	int32_t epoll_fd;
+
+	/// the events on regular files that epoll cannot monitor, they are
+	/// always ready as with select (epoll backends)
+	vector<RtEvent *> always_ready_events;
+
+	/// the raised events of the current loop, one bucket per priority
+	vector<RtEvent *> priority_buckets[RT_PRIORITY_LEVELS];
+
+	/// the mask of priority buckets containing raised events
+	uint64_t priority_mask[RT_PRIORITY_MASK_WORDS];
+
 	/// fd o the stop signal event
 	int32_t stop_fd;
 
@@ -382,6 +447,32 @@ class RtChannel
 	 */
 	void executeThread(void);
 
+	/**
+	 * @brief Wait for events with select and handle the raised ones
+	 *
+	 */
+	void waitSelectEvents(void);
+
+	/**
+	 * @brief Wait for events with epoll and handle the raised ones
+	 *
+	 */
+	void waitEpollEvents(void);
+
+	/**
+	 * @brief Handle a raised event and put it in its priority bucket
+	 *
+	 * @param event  The raised event
+	 */
+	void handleEvent(RtEvent *event);
+
+	/**
+	 * @brief Process the handled events by priority order
+	 *        and empty the priority buckets
+	 *
+	 */
+	void processEvents(void);
+
 	/**
 	 * @brief Add an event in event map
 	 *
@@ -405,12 +496,21 @@ class RtChannel
 	void updateMaxFd(void);
 
 	/**
-	 * @brief Add a fd to input_fd_set
+	 * @brief Add a fd to the monitored fds
 	 *        Should be called each time the channel got a new event
 	 *
-	 * @param fd  The file descriptor to monitor
+	 * @param fd     The file descriptor to monitor
+	 * @param event  The event associated to the fd, NULL for internal fds
+	 * @return true on success, false otherwise
 	 */
-	void addInputFd(int32_t fd);
+	bool addInputFd(int32_t fd, RtEvent *event = NULL);
+
+	/**
+	 * @brief Remove a fd from the monitored fds
+	 *
+	 * @param fd  The file descriptor to stop monitoring
+	 */
+	void removeInputFd(int32_t fd);
 
 	/**
 	 * @brief Get a timer
@@ -432,6 +532,16 @@ class RtChannel
 	 */
 	bool pushMessage(RtFifo *fifo, void **data, size_t size, uint8_t type=0);
 
+	/**
+	 * @brief Push several messages in another channel fifo
+	 *
+	 * @param fifo      The fifo
+	 * @param messages  IN: The messages to enqueue
+	 *                  OUT: The messages that could not be enqueued
+	 * @return true on success, false otherwise
+	 */
+	bool pushMessages(RtFifo *fifo, vector<rt_msg_t> &messages);
+
 };
 
 template<class T>
@@ -445,12 +555,15 @@ RtChannel::RtChannel(const string &name, const string &type, T specific):
 	block_initialized(false),
 	previous_fifo(NULL),
 	in_opp_fifo(NULL),
+	backend(backend_select),
 	max_input_fd(-1),
+	epoll_fd(-1),
 	stop_fd(-1),
 	w_sel_break(-1),
 	r_sel_break(-1)
 {
 	FD_ZERO(&(this->input_fd_set));
+	memset(this->priority_mask, 0, sizeof(this->priority_mask));
 };
 
 #endif
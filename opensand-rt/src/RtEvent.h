@@ -117,6 +117,23 @@ class RtEvent
 	 */
 	virtual bool handle(void) = 0;
 
+	/**
+	 * @brief Go to the next element got when handling the event,
+	 *        for events that read several elements at once
+	 *
+	 * @return true if there is a next element, false otherwise
+	 */
+	virtual bool next(void) {return false;};
+
+	/**
+	 * @brief Whether the event can be monitored in edge-triggered mode
+	 *        This is only true if handling the event always leaves its
+	 *        file descriptor empty, else some data would never be notified
+	 *
+	 * @return true if the event supports edge trigger, false otherwise
+	 */
+	virtual bool isEdgeTriggerSafe(void) const {return false;};
+
 	/**
 	 * @brief Update the trigger time
 	 *
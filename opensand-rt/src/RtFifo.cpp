@@ -41,20 +41,33 @@
 #include <cstring>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/eventfd.h>
 
-#define DEFAULT_FIFO_SIZE 3
+// a fifo should be able to contain a superframe worth of messages
+// sent in one batch
+#define DEFAULT_FIFO_SIZE 64
 
 RtFifo::RtFifo():
-	fifo(),
 	max_size(DEFAULT_FIFO_SIZE),
-	fifo_mutex("fifo")
+	capacity(1),
+	ring(NULL),
+	sig_fd(-1),
+	space_fd(-1),
+	tail(0),
+	producer_waiting(false),
+	head(0),
+	signaled(false)
 {
+	while(this->capacity < this->max_size)
+	{
+		this->capacity <<= 1;
+	}
 }
 
 RtFifo::~RtFifo()
 {
-	close(this->r_sig_pipe);
-	close(this->w_sig_pipe);
+	close(this->sig_fd);
+	close(this->space_fd);
 
 /*	while(!this->fifo.empty())
 	{
@@ -62,29 +75,31 @@ RtFifo::~RtFifo()
 	}
 	delete msg.data*/
 
-	sem_destroy(&(this->fifo_size_sem));
+	delete [] this->ring;
 }
 
 bool RtFifo::init()
 {
-	int32_t pipefd[2];
-	int ret;
+	this->ring = new rt_msg_t[this->capacity];
 
-	ret = sem_init(&(this->fifo_size_sem), 0, this->max_size);
-	if(ret != 0)
+	// the consumer only reads the eventfd when it is signaled,
+	// it can stay in blocking mode
+	this->sig_fd = eventfd(0, EFD_CLOEXEC);
+	if(this->sig_fd < 0)
 	{
 		Rt::reportError("fifo", pthread_self(), false,
-		                "Failed to initialize semaphore on FIFO [%d: %s]\n",
-		                ret, strerror(ret));
+		                "Failed to create signaling eventfd [%d: %s]\n",
+		                errno, strerror(errno));
 		goto error;
 	}
-
-	if(pipe(pipefd) != 0)
+	this->space_fd = eventfd(0, EFD_CLOEXEC);
+	if(this->space_fd < 0)
 	{
+		Rt::reportError("fifo", pthread_self(), false,
+		                "Failed to create eventfd for FIFO full [%d: %s]\n",
+		                errno, strerror(errno));
 		goto error;
 	}
-	this->r_sig_pipe = pipefd[0];
-	this->w_sig_pipe = pipefd[1];
 
 	return true;
 
@@ -92,98 +107,152 @@ error:
 	return false;
 }
 
-
-bool RtFifo::push(void *data, size_t size, uint8_t type)
+bool RtFifo::signalData(void)
 {
-	fd_set wset;
-	bool status = false;
-	rt_msg_t msg;
-	int ret;
-	
-	// we need a semaphore here to block while fifo is full
-	ret = sem_wait(&(this->fifo_size_sem));
-	if(ret != 0)
+	uint64_t value = 1;
+
+	// only one signal until the consumer empties the fifo
+	if(__atomic_exchange_n(&this->signaled, true, __ATOMIC_SEQ_CST))
 	{
-		Rt::reportError("fifo", pthread_self(), false,
-		                "Failed to lock mutex for FIFO full [%d: %s]\n",
-		                ret, strerror(ret));
-		return false;
+		return true;
 	}
-
-	// lock mutex on fifo, we cannot use RAII method here due to semaphore
-	this->fifo_mutex.acquireLock();
-
-	//assert(this->fifo.size() < this->max_size);
-	if(this->fifo.size() >= this->max_size)
+	if(write(this->sig_fd, &value, sizeof(value)) != sizeof(value))
 	{
 		Rt::reportError("fifo", pthread_self(), false,
-		                "Size is greater than maximum size (%u > %u), "
-		                "this should not happend\n",
-		                this->fifo.size(), this->max_size);
+		                "Failed to write on eventfd [%d: %s]\n",
+		                errno, strerror(errno));
+		return false;
 	}
+	return true;
+}
+
+bool RtFifo::push(void *data, size_t size, uint8_t type)
+{
+	rt_msg_t msg;
+	size_t pushed;
 
 	msg.data = data;
 	msg.length = size;
 	msg.type = type;
-	this->fifo.push(msg);
-	FD_ZERO(&wset);
-	FD_SET(this->w_sig_pipe, &wset);
-	if(select(this->w_sig_pipe + 1, NULL, &wset, NULL, NULL) < 0)
-	{
-		Rt::reportError("fifo", pthread_self(), false,
-		                "Select failed on pipe [%d: %s]\n",
-		                errno, strerror(errno));
-		goto error;
-	}
-	if(write(this->w_sig_pipe, MAGIC_WORD, strlen(MAGIC_WORD)) != strlen(MAGIC_WORD))
+	return this->push(&msg, 1, pushed);
+}
+
+bool RtFifo::push(const rt_msg_t *messages, size_t count, size_t &pushed)
+{
+	uint64_t value;
+	uint64_t free_space;
+	uint64_t tail;
+
+	pushed = 0;
+	while(pushed < count)
 	{
-		Rt::reportError("fifo", pthread_self(), false,
-		                "Failed to write on pipe\n");
-		goto error;
-	}
-	status = true;
+		// block while fifo is full, the consumer writes on space_fd
+		// when it pops elements while we are waiting
+		while(this->tail - __atomic_load_n(&this->head, __ATOMIC_ACQUIRE) >=
+		      this->max_size)
+		{
+			__atomic_store_n(&this->producer_waiting, true, __ATOMIC_SEQ_CST);
+			if(this->tail - __atomic_load_n(&this->head, __ATOMIC_SEQ_CST) <
+			   this->max_size)
+			{
+				// the consumer popped before seeing we are waiting
+				break;
+			}
+			if(read(this->space_fd, &value, sizeof(value)) != sizeof(value))
+			{
+				Rt::reportError("fifo", pthread_self(), false,
+				                "Failed to wait for FIFO space [%d: %s]\n",
+				                errno, strerror(errno));
+				return false;
+			}
+		}
 
-error:
-	// unlock mutex on fifo
-	this->fifo_mutex.releaseLock();
-	return status;
+		// copy as many elements as possible before publishing them
+		free_space = this->max_size -
+		             (this->tail - __atomic_load_n(&this->head, __ATOMIC_ACQUIRE));
+		tail = this->tail;
+		for(uint64_t i = 0; i < free_space && pushed < count; i++)
+		{
+			this->ring[tail & (this->capacity - 1)] = messages[pushed];
+			tail++;
+			pushed++;
+		}
+		// publish the elements then check if the consumer should be
+		// woken up, if the batch does not fit the consumer has to
+		// be signaled before we wait for space
+		__atomic_store_n(&this->tail, tail, __ATOMIC_SEQ_CST);
+		if(!this->signalData())
+		{
+			return false;
+		}
+	}
 
+	return true;
 }
 
 bool RtFifo::pop(rt_msg_t &elem)
+{
+	size_t count;
+
+	return this->pop(&elem, 1, count);
+}
+
+bool RtFifo::pop(rt_msg_t *messages, size_t max_count, size_t &count)
 {
 	bool status = true;
-	
-	// lock mutex on fifo, we cannot use RAII method here due to semaphore
-	this->fifo_mutex.acquireLock();
+	uint64_t value;
+	uint64_t tail = __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE);
 
-	// assert(!this->fifo.empty());
-	if(this->fifo.empty())
+	count = 0;
+	if(this->head == tail)
 	{
 		Rt::reportError("fifo", pthread_self(), false,
 		                "Fifo is already empty, this should not happend\n");
-		status = false;
+		return false;
 	}
-	else
+
+	// get elements in ring and release their slots at once
+	while(this->head + count != tail && count < max_count)
 	{
-		// get element in queue
-		elem = this->fifo.front();
+		messages[count] = this->ring[(this->head + count) & (this->capacity - 1)];
+		count++;
+	}
+	__atomic_store_n(&this->head, this->head + count, __ATOMIC_SEQ_CST);
 
-		// remove element from queue
-		this->fifo.pop();
+	// fifo has empty space, wake up the producer if it waits
+	if(__atomic_exchange_n(&this->producer_waiting, false, __ATOMIC_SEQ_CST))
+	{
+		value = 1;
+		if(write(this->space_fd, &value, sizeof(value)) != sizeof(value))
+		{
+			Rt::reportError("fifo", pthread_self(), false,
+			                "Failed to unlock FIFO full [%d: %s]\n",
+			                errno, strerror(errno));
+			status = false;
+		}
 	}
 
-	// unlock mutex on fifo
-	this->fifo_mutex.releaseLock();
+	// while there is data, the eventfd stays readable and the event
+	// is raised again on next loop
+	if(this->head != __atomic_load_n(&this->tail, __ATOMIC_SEQ_CST))
+	{
+		return status;
+	}
 
-	// fifo has empty space, we can unlock it
-	if(sem_post(&(this->fifo_size_sem)) != 0)
+	// fifo is empty, clear the signal then check that the producer
+	// did not push in the meantime without signaling
+	if(read(this->sig_fd, &value, sizeof(value)) != sizeof(value))
 	{
 		Rt::reportError("fifo", pthread_self(), false,
-		                "Failed to unlock mutex for FIFO full\n");
+		                "Failed to read on eventfd [%d: %s]\n",
+		                errno, strerror(errno));
 		status = false;
 	}
+	__atomic_store_n(&this->signaled, false, __ATOMIC_SEQ_CST);
+	if(this->head != __atomic_load_n(&this->tail, __ATOMIC_SEQ_CST))
+	{
+		status = this->signalData() && status;
+	}
 	return status;
 }
 
-
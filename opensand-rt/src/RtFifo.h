@@ -37,20 +37,25 @@
 #define RT_FIFO_H
 
 #include "Types.h"
-#include "RtMutex.h"
 
-#include <queue>
 #include <stdint.h>
 #include <pthread.h>
-#include <semaphore.h>
 
 #define MAGIC_WORD "GO"
 
-using std::queue;
+/// the size of a cache line, used to separate producer and consumer data
+#define RT_CACHE_LINE_SIZE 64
 
 /**
  * @class RtFifo
  * @brief A fifo between two blocks
+ *
+ * The fifo is a bounded lock-free ring with exactly one producer
+ * (the channel pushing messages) and one consumer (the channel
+ * owning the associated MessageEvent).
+ * The consumer is only signaled through an eventfd when it emptied
+ * the fifo, and the producer only waits on another eventfd when the
+ * fifo is full, so in steady state a message costs no system call.
  */
 class RtFifo
 {
@@ -76,49 +81,95 @@ class RtFifo
 	
 	/**
 	 * @brief Add a new element in the fifo
+	 *        Block while the fifo is full
 	 * 
 	 * @param the data part of the element to add in the fifo
 	 * @param the size of the element to add in the fifo
 	 * @return true on success, false otherwise
 	 */
 	bool push(void *data, size_t size, uint8_t type);
+
+	/**
+	 * @brief Add several elements in the fifo
+	 *        The consumer is signaled once for the whole batch unless
+	 *        the batch does not fit in fifo
+	 *
+	 * @param messages  the elements to add in the fifo
+	 * @param count     the number of elements
+	 * @param pushed    OUT: the number of elements added in the fifo
+	 * @return true on success, false otherwise
+	 */
+	bool push(const rt_msg_t *messages, size_t count, size_t &pushed);
 	
 	/**
-	 * @brief Access the first element but do not delete it
+	 * @brief Get and remove the first element
+	 *        Should only be called when the signaling fd is readable
 	 * 
 	 * @param elem  the first element in the fifo
 	 * @return true on success, false otherwise
 	 */
 	bool pop(rt_msg_t &message);
+
+	/**
+	 * @brief Get and remove up to max_count elements
+	 *        Should only be called when the signaling fd is readable
+	 *
+	 * @param messages   OUT: the first elements in the fifo
+	 * @param max_count  the maximum number of elements to get
+	 * @param count      OUT: the number of elements got
+	 * @return true on success, false otherwise
+	 */
+	bool pop(rt_msg_t *messages, size_t max_count, size_t &count);
 	
 	/**
 	 * 	@brief Get the file descriptor signaling data
 	 * 	
-	 * 	@return the read end of the pipe for data signaling
+	 * 	@return the eventfd readable while there is data in fifo
 	 */
-	int32_t getSigFd(void) const {return this->r_sig_pipe;};
+	int32_t getSigFd(void) const {return this->sig_fd;};
 
   private:
 
-	/// the queue
-	queue<rt_msg_t> fifo;
-  
+	/**
+	 * @brief Signal the consumer that there is data in fifo,
+	 *        if this is not already done
+	 *
+	 * @return true on success, false otherwise
+	 */
+	bool signalData(void);
+
 	/// The fifo size
 	size_t max_size;
-	
-	/// The signaling pipe file descriptor for writing operations
-	int32_t w_sig_pipe;
-	
-	/// The signaling pipe file descriptor for reading operations
-	int32_t r_sig_pipe;
-	
-	/// The mutex on fifo access
-	RtMutex fifo_mutex;
-	
-	/// The mutex for fifo full (we need a semaphore here because it is
-	//  lock and unlocked by different threads
-	//  This semaphore is intialized with the fifo size
-	sem_t fifo_size_sem;
+
+	/// The ring capacity (power of 2 greater than the fifo size)
+	size_t capacity;
+
+	/// The ring, indexed by the counters below modulo capacity
+	rt_msg_t *ring;
+
+	/// The eventfd readable while the fifo contains data
+	int32_t sig_fd;
+
+	/// The eventfd on which the producer waits while fifo is full
+	int32_t space_fd;
+
+	char pad_prod[RT_CACHE_LINE_SIZE];
+
+	/// The number of pushed elements, only written by the producer
+	uint64_t tail;
+
+	/// Whether the producer is waiting for space in fifo
+	bool producer_waiting;
+
+	char pad_cons[RT_CACHE_LINE_SIZE];
+
+	/// The number of popped elements, only written by the consumer
+	uint64_t head;
+
+	/// Whether the signaling eventfd is readable (or is about to be)
+	bool signaled;
+
+	char pad_end[RT_CACHE_LINE_SIZE];
 };
 
 #endif
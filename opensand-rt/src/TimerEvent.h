@@ -115,6 +115,9 @@ class TimerEvent: public RtEvent
 
 	virtual bool handle(void);
 
+	/// the timer is rearmed or disabled on handling, this resets the timerfd
+	virtual bool isEdgeTriggerSafe(void) const {return true;};
+
   protected:
 
 	/// Timer duration in milliseconds
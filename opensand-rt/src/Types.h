@@ -64,6 +64,14 @@ typedef enum
 	downward_chan, ///< downward channel
 } chan_type_t;
 
+/// the backend used by channels to wait for events
+typedef enum
+{
+	backend_select,      ///< select() on a fd_set, limited to FD_SETSIZE
+	backend_epoll,       ///< level-triggered epoll
+	backend_epoll_edge,  ///< epoll, edge-triggered for the events allowing it
+} event_backend_t;
+
 typedef int32_t event_id_t;
 
 typedef struct
@@ -73,4 +81,13 @@ typedef struct
 	uint8_t type;
 } rt_msg_t;
 
+/// The functions allocating and releasing the reception buffers
+typedef struct
+{
+	/// Allocate a buffer of the given size
+	unsigned char *(*allocate)(size_t size);
+	/// Release a buffer got with allocate
+	void (*release)(unsigned char *buf);
+} net_buffer_allocator_t;
+
 #endif
@@ -97,7 +97,8 @@ using std::ostringstream;
 static void usage(void)
 {
 	std::cerr << "Test multi blocks: test the opensand rt library" << std::endl
-	          << "usage: test_multi_blocks -i input_file" << std::endl;
+	          << "usage: test_multi_blocks -i input_file [-b backend]" << std::endl
+	          << "  -b backend  select, epoll or epoll_edge" << std::endl;
 }
 
 
@@ -291,14 +292,20 @@ bool MiddleBlock::Upward::onEvent(const RtEvent *const event)
 
 bool MiddleBlock::Downward::onEvent(const RtEvent *const event)
 {
+	vector<rt_msg_t> messages;
+	rt_msg_t message;
 	char *data = read_msg((MessageEvent *)event, this->getName(), "upper");
 	if(!data)
 	{
 		return false;
 	}
 
-	// transmit to lower layer
-	if(!this->enqueueMessage((void **)(&data), strlen(data)))
+	// transmit to lower layer with the batch interface
+	message.data = data;
+	message.length = strlen(data);
+	message.type = 0;
+	messages.push_back(message);
+	if(!this->enqueueMessages(messages))
 	{
 		Rt::reportError(this->getName(), pthread_self(), true, "cannot send data to lower block");
 	}
@@ -454,7 +461,7 @@ HeapLeakChecker heap_checker("test_multi_blocks");
 	int args_used;
 
 	/* parse program arguments, print the help message in case of failure */
-	if(argc <= 1 || argc > 3)
+	if(argc <= 1 || argc > 5)
 	{
 		usage();
 		return 1;
@@ -476,6 +483,28 @@ HeapLeakChecker heap_checker("test_multi_blocks");
 			input_file = argv[1];
 			args_used++;
 		}
+		else if(!strcmp(*argv, "-b") && argc > 1)
+		{
+			/* get the event backend used by channels */
+			if(!strcmp(argv[1], "select"))
+			{
+				Rt::setEventBackend(backend_select);
+			}
+			else if(!strcmp(argv[1], "epoll"))
+			{
+				Rt::setEventBackend(backend_epoll);
+			}
+			else if(!strcmp(argv[1], "epoll_edge"))
+			{
+				Rt::setEventBackend(backend_epoll_edge);
+			}
+			else
+			{
+				usage();
+				return 1;
+			}
+			args_used++;
+		}
 		else
 		{
 			usage();
@@ -31,5 +31,7 @@ env HEAPCHECK=strict > /dev/null ${TEST} 2>&1 1>/dev/null || env HEAPCHECK=stric
 if [ "$?" -ne "0" ]; then
     exit 1
 fi
-echo "Check multi blocks"
-env HEAPCHECK=strict > /dev/null ${TEST_MULTI} 2>&1 1>/dev/null || env HEAPCHECK=strict ${TEST_MULTI} || exit $?
+for BACKEND in select epoll epoll_edge ; do
+	echo "Check multi blocks with ${BACKEND} backend"
+	env HEAPCHECK=strict > /dev/null ${TEST_MULTI} -b ${BACKEND} 2>&1 1>/dev/null || env HEAPCHECK=strict ${TEST_MULTI} -b ${BACKEND} || exit $?
+done